@@ -3,9 +3,20 @@
 bool archive_custom_event_callback(void* context, uint32_t event) {
     furi_assert(context);
     ArchiveApp* archive = (ArchiveApp*)context;
+    if(event == ArchiveBrowserEventFavoritesFlush) {
+        archive_favorites_flush(archive->browser->favorites);
+        return true;
+    }
     return scene_manager_handle_custom_event(archive->scene_manager, event);
 }
 
+static void archive_favorites_flush_callback(void* context) {
+    furi_assert(context);
+    ArchiveApp* archive = (ArchiveApp*)context;
+    view_dispatcher_send_custom_event(
+        archive->view_dispatcher, ArchiveBrowserEventFavoritesFlush);
+}
+
 bool archive_back_event_callback(void* context) {
     furi_assert(context);
     ArchiveApp* archive = (ArchiveApp*)context;
@@ -32,6 +43,8 @@ ArchiveApp* archive_alloc() {
         archive->view_dispatcher, archive_back_event_callback);
 
     archive->browser = browser_alloc();
+    archive_favorites_set_flush_callback(
+        archive->browser->favorites, archive_favorites_flush_callback, archive);
 
     view_dispatcher_add_view(
         archive->view_dispatcher, ArchiveViewBrowser, archive_browser_get_view(archive->browser));
@@ -49,13 +62,18 @@ ArchiveApp* archive_alloc() {
 void archive_free(ArchiveApp* archive) {
     furi_assert(archive);
 
+    // Pending changes are written before flush event can't be delivered anymore
+    archive_favorites_set_flush_callback(archive->browser->favorites, NULL, NULL);
+    archive_favorites_flush(archive->browser->favorites);
+
     view_dispatcher_remove_view(archive->view_dispatcher, ArchiveViewBrowser);
     view_dispatcher_remove_view(archive->view_dispatcher, ArchiveViewTextInput);
     view_dispatcher_remove_view(archive->view_dispatcher, ArchiveViewWidget);
     widget_free(archive->widget);
+    // Directory worker sends events to view dispatcher until it is stopped
+    browser_free(archive->browser);
     view_dispatcher_free(archive->view_dispatcher);
     scene_manager_free(archive->scene_manager);
-    browser_free(archive->browser);
 
     text_input_free(archive->text_input);
 
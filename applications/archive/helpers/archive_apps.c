@@ -63,9 +63,7 @@ void archive_app_delete_file(void* context, const char* path) {
         res |= file_worker_remove(file_worker, "/any/u2f/cnt.u2f");
         file_worker_free(file_worker);
 
-        if(archive_is_favorite("/app:u2f/U2F Token")) {
-            archive_favorites_delete("/app:u2f/U2F Token");
-        }
+        archive_favorites_delete(browser->favorites, "/app:u2f/U2F Token");
     }
 
     if(res) {
@@ -7,7 +7,7 @@ void archive_update_offset(ArchiveBrowserView* browser) {
     furi_assert(browser);
     with_view_model(
         browser->view, (ArchiveBrowserViewModel * model) {
-            size_t array_size = files_array_size(model->files);
+            size_t array_size = model->item_cnt;
             uint16_t bounds = array_size > 3 ? 2 : array_size;
 
             if(array_size > 3 && model->idx >= array_size - 1) {
@@ -26,13 +26,112 @@ void archive_update_offset(ArchiveBrowserView* browser) {
         });
 }
 
+void archive_update_window(ArchiveBrowserView* browser) {
+    furi_assert(browser);
+
+    bool load = false;
+    uint16_t offset = 0;
+    ArchiveFile_t anchor;
+    ArchiveFile_t_init(&anchor);
+    bool anchor_valid = false;
+    uint16_t anchor_idx = 0;
+
+    with_view_model(
+        browser->view, (ArchiveBrowserViewModel * model) {
+            if(model->folder_loading || !model->item_cnt) return false;
+
+            // Window being loaded, if any, otherwise current one
+            uint16_t start = model->list_loading ? model->load_offset : model->array_offset;
+            uint16_t end = model->list_loading ?
+                               MIN(start + ARCHIVE_WINDOW_SIZE, model->item_cnt) :
+                               start + files_array_size(model->files);
+
+            if((model->idx < start) || (model->idx >= end) ||
+               (start && (model->idx < start + ARCHIVE_WINDOW_MARGIN)) ||
+               ((end < model->item_cnt) && (model->idx + ARCHIVE_WINDOW_MARGIN >= end))) {
+                offset = (model->idx > ARCHIVE_WINDOW_SIZE / 2) ?
+                             model->idx - ARCHIVE_WINDOW_SIZE / 2 :
+                             0;
+                if(model->item_cnt > ARCHIVE_WINDOW_SIZE) {
+                    offset = MIN(offset, model->item_cnt - ARCHIVE_WINDOW_SIZE);
+                } else {
+                    offset = 0;
+                }
+                load = (offset != start);
+            }
+
+            if(load) {
+                // Loaded entry next to new window makes load a single pass,
+                // the last one before it shortens the walk
+                for(size_t i = 0; i < files_array_size(model->files); i++) {
+                    uint16_t idx = model->array_offset + i;
+                    if(idx > offset + ARCHIVE_WINDOW_SIZE) break;
+                    ArchiveFile_t_set(&anchor, files_array_get(model->files, i));
+                    anchor_valid = true;
+                    anchor_idx = idx;
+                    if(idx + 1 >= offset) break;
+                }
+                model->load_offset = offset;
+                model->list_loading = true;
+            }
+            return false;
+        });
+
+    if(load) {
+        archive_dir_worker_load(
+            browser->worker, offset, anchor_valid ? &anchor : NULL, anchor_idx);
+    }
+    ArchiveFile_t_clear(&anchor);
+}
+
+void archive_update_list(ArchiveBrowserView* browser) {
+    furi_assert(browser);
+
+    bool folder_empty = false;
+    with_view_model(
+        browser->view, (ArchiveBrowserViewModel * model) {
+            uint16_t item_cnt = 0;
+            uint16_t idx = 0;
+            uint16_t offset = 0;
+            if(archive_dir_worker_take_folder(browser->worker, &item_cnt, &idx)) {
+                model->item_cnt = item_cnt;
+                model->idx = idx;
+                model->folder_loading = false;
+                folder_empty = !item_cnt && !model->depth &&
+                               (model->tab_idx != ArchiveTabBrowser);
+            }
+            if(archive_dir_worker_take_list(browser->worker, &offset, model->files)) {
+                model->array_offset = offset;
+                model->list_loading = false;
+            }
+            return true;
+        });
+
+    if(folder_empty) {
+        archive_switch_tab(browser, DEFAULT_TAB_DIR);
+    } else {
+        archive_update_offset(browser);
+        archive_update_window(browser);
+    }
+}
+
 void archive_update_focus(ArchiveBrowserView* browser, const char* target) {
     furi_assert(browser);
     furi_assert(target);
 
-    archive_get_filenames(browser, string_get_cstr(browser->path));
+    archive_get_filenames(browser, string_get_cstr(browser->path), target);
 
-    if(!archive_file_array_size(browser) && !archive_get_depth(browser)) {
+    bool loading = false;
+    with_view_model(
+        browser->view, (ArchiveBrowserViewModel * model) {
+            loading = model->folder_loading;
+            return false;
+        });
+
+    if(loading) {
+        // Focused by worker, see archive_update_list
+        return;
+    } else if(!archive_file_array_size(browser) && !archive_get_depth(browser)) {
         archive_switch_tab(browser, DEFAULT_TAB_DIR);
     } else {
         with_view_model(
@@ -57,7 +156,7 @@ size_t archive_file_array_size(ArchiveBrowserView* browser) {
     uint16_t size = 0;
     with_view_model(
         browser->view, (ArchiveBrowserViewModel * model) {
-            size = files_array_size(model->files);
+            size = model->item_cnt;
             return false;
         });
     return size;
@@ -66,8 +165,12 @@ size_t archive_file_array_size(ArchiveBrowserView* browser) {
 void archive_file_array_rm_selected(ArchiveBrowserView* browser) {
     with_view_model(
         browser->view, (ArchiveBrowserViewModel * model) {
-            files_array_remove_v(model->files, model->idx, model->idx + 1);
-            model->idx = CLAMP(model->idx, files_array_size(model->files) - 1, 0);
+            size_t idx = model->idx - model->array_offset;
+            if(archive_model_get_file(model, model->idx)) {
+                files_array_remove_v(model->files, idx, idx + 1);
+                model->item_cnt--;
+            }
+            model->idx = model->item_cnt ? MIN(model->idx, model->item_cnt - 1) : 0;
             return false;
         });
 
@@ -76,6 +179,7 @@ void archive_file_array_rm_selected(ArchiveBrowserView* browser) {
     }
 
     archive_update_offset(browser);
+    archive_update_window(browser);
 }
 
 void archive_file_array_swap(ArchiveBrowserView* browser, int8_t d) {
@@ -104,9 +208,15 @@ void archive_file_array_swap(ArchiveBrowserView* browser, int8_t d) {
 }
 
 void archive_file_array_rm_all(ArchiveBrowserView* browser) {
+    archive_dir_worker_cancel(browser->worker);
+
     with_view_model(
         browser->view, (ArchiveBrowserViewModel * model) {
             files_array_reset(model->files);
+            model->item_cnt = 0;
+            model->array_offset = 0;
+            model->folder_loading = false;
+            model->list_loading = false;
             return false;
         });
 }
@@ -115,8 +225,7 @@ ArchiveFile_t* archive_get_current_file(ArchiveBrowserView* browser) {
     ArchiveFile_t* selected;
     with_view_model(
         browser->view, (ArchiveBrowserViewModel * model) {
-            selected = files_array_size(model->files) ? files_array_get(model->files, model->idx) :
-                                                        NULL;
+            selected = archive_model_get_file(model, model->idx);
             return false;
         });
     return selected;
@@ -124,11 +233,10 @@ ArchiveFile_t* archive_get_current_file(ArchiveBrowserView* browser) {
 
 ArchiveFile_t* archive_get_file_at(ArchiveBrowserView* browser, size_t idx) {
     ArchiveFile_t* selected;
-    idx = CLAMP(idx, archive_file_array_size(browser), 0);
 
     with_view_model(
         browser->view, (ArchiveBrowserViewModel * model) {
-            selected = files_array_size(model->files) ? files_array_get(model->files, idx) : NULL;
+            selected = archive_model_get_file(model, idx);
             return false;
         });
     return selected;
@@ -161,7 +269,7 @@ const char* archive_get_path(ArchiveBrowserView* browser) {
 
 const char* archive_get_name(ArchiveBrowserView* browser) {
     ArchiveFile_t* selected = archive_get_current_file(browser);
-    return string_get_cstr(selected->name);
+    return selected ? string_get_cstr(selected->name) : "";
 }
 
 void archive_set_tab(ArchiveBrowserView* browser, ArchiveTabEnum tab) {
@@ -203,6 +311,7 @@ void archive_add_app_item(ArchiveBrowserView* browser, const char* name) {
     with_view_model(
         browser->view, (ArchiveBrowserViewModel * model) {
             files_array_push_back(model->files, item);
+            model->item_cnt = files_array_size(model->files);
             return false;
         });
     ArchiveFile_t_clear(&item);
@@ -224,6 +333,7 @@ void archive_add_file_item(ArchiveBrowserView* browser, FileInfo* file_info, con
         with_view_model(
             browser->view, (ArchiveBrowserViewModel * model) {
                 files_array_push_back(model->files, item);
+                model->item_cnt = files_array_size(model->files);
                 return false;
             });
         ArchiveFile_t_clear(&item);
@@ -237,9 +347,10 @@ void archive_show_file_menu(ArchiveBrowserView* browser, bool show) {
             model->menu = show;
             model->menu_idx = 0;
 
-            if(show) {
-                ArchiveFile_t* selected = files_array_get(model->files, model->idx);
-                selected->fav = archive_is_favorite("%s", string_get_cstr(selected->name));
+            ArchiveFile_t* selected = archive_model_get_file(model, model->idx);
+            if(show && selected) {
+                selected->fav = archive_is_favorite(
+                    browser->favorites, "%s", string_get_cstr(selected->name));
             }
 
             return true;
@@ -254,12 +365,12 @@ void archive_favorites_move_mode(ArchiveBrowserView* browser, bool active) {
         });
 }
 
-void archive_switch_dir(ArchiveBrowserView* browser, const char* path) {
+void archive_switch_dir(ArchiveBrowserView* browser, const char* path, const char* focus) {
     furi_assert(browser);
     furi_assert(path);
 
     string_set(browser->path, path);
-    archive_get_filenames(browser, string_get_cstr(browser->path));
+    archive_get_filenames(browser, string_get_cstr(browser->path), focus);
     archive_update_offset(browser);
 }
 
@@ -278,7 +389,7 @@ void archive_switch_tab(ArchiveBrowserView* browser, InputKey key) {
     const char* path = archive_get_default_path(tab);
     bool tab_empty = true;
     if(tab == ArchiveTabFavorites) {
-        if(archive_favorites_count(browser) > 0) tab_empty = false;
+        if(archive_favorites_count(browser->favorites) > 0) tab_empty = false;
     } else if(strncmp(path, "/app:", 5) == 0) {
         if(archive_app_is_available(browser, path)) tab_empty = false;
     } else {
@@ -296,7 +407,7 @@ void archive_switch_tab(ArchiveBrowserView* browser, InputKey key) {
                 }
                 return false;
             });
-        archive_switch_dir(browser, archive_get_default_path(tab));
+        archive_switch_dir(browser, archive_get_default_path(tab), NULL);
     }
     archive_set_last_tab(browser, tab);
 }
@@ -315,12 +426,16 @@ void archive_enter_dir(ArchiveBrowserView* browser, string_t name) {
 
     string_set(browser->path, name);
 
-    archive_switch_dir(browser, string_get_cstr(browser->path));
+    archive_switch_dir(browser, string_get_cstr(browser->path), NULL);
 }
 
 void archive_leave_dir(ArchiveBrowserView* browser) {
     furi_assert(browser);
 
+    // Cursor goes back to the folder being left
+    string_t focus;
+    string_init_set(focus, browser->path);
+
     const char* path = archive_get_path(browser);
     char* last_char_ptr = strrchr(path, '/');
 
@@ -336,5 +451,6 @@ void archive_leave_dir(ArchiveBrowserView* browser) {
             return false;
         });
 
-    archive_switch_dir(browser, path);
+    archive_switch_dir(browser, path, string_get_cstr(focus));
+    string_clear(focus);
 }
@@ -57,6 +57,8 @@ inline bool archive_is_known_app(ArchiveFileTypeEnum type) {
 }
 
 void archive_update_offset(ArchiveBrowserView* browser);
+void archive_update_window(ArchiveBrowserView* browser);
+void archive_update_list(ArchiveBrowserView* browser);
 void archive_update_focus(ArchiveBrowserView* browser, const char* target);
 
 size_t archive_file_array_size(ArchiveBrowserView* browser);
@@ -0,0 +1,631 @@
+#include "archive_dir_worker.h"
+#include "archive_browser.h"
+#include <furi.h>
+
+#define TAG "ArchiveDirWorker"
+
+#define ARCHIVE_DIR_WORKER_EVENT_REQUEST (1 << 0)
+#define ARCHIVE_DIR_WORKER_EVENT_STOP (1 << 1)
+#define ARCHIVE_DIR_WORKER_EVENT_ALL \
+    (ARCHIVE_DIR_WORKER_EVENT_REQUEST | ARCHIVE_DIR_WORKER_EVENT_STOP)
+
+typedef enum {
+    ArchiveDirWorkerRequestNone,
+    ArchiveDirWorkerRequestFolder,
+    ArchiveDirWorkerRequestLoad,
+} ArchiveDirWorkerRequest;
+
+typedef enum {
+    ArchiveDirWorkerBoundStart, // Before first entry
+    ArchiveDirWorkerBoundEntry, // Entry given by key
+    ArchiveDirWorkerBoundEnd, // After last entry
+} ArchiveDirWorkerBound;
+
+/** Single pass over directory: entries closest to bound on both sides */
+typedef struct {
+    ArchiveDirWorkerBound bound;
+    ArchiveFile_t key;
+    uint16_t below_max;
+    uint16_t above_max;
+
+    // Largest entries before bound, ascending
+    files_array_t below;
+    // Smallest entries after bound, ascending
+    files_array_t above;
+    ArchiveFile_t entry;
+    bool found;
+    uint16_t total;
+    // Entries before bound
+    uint16_t rank;
+} ArchiveDirWorkerScan;
+
+struct ArchiveDirWorker {
+    FuriThread* thread;
+    osMutexId_t mutex;
+    uint16_t window_size;
+
+    // Guarded by mutex
+    ArchiveDirWorkerRequest request;
+    bool folder_busy;
+    volatile bool abort;
+    string_t request_path;
+    string_t request_filter;
+    string_t request_focus;
+    uint16_t request_offset;
+    bool request_anchor_valid;
+    ArchiveFile_t request_anchor;
+    uint16_t request_anchor_idx;
+
+    // Worker thread only
+    string_t path;
+    string_t filter;
+    uint16_t item_cnt;
+
+    // Results, guarded by mutex
+    bool folder_ready;
+    uint16_t result_item_cnt;
+    uint16_t result_item_idx;
+    bool list_ready;
+    uint16_t result_offset;
+    files_array_t result_files;
+
+    ArchiveDirWorkerCallback callback;
+    void* context;
+};
+
+/** Folders first, then files, by name */
+static int archive_dir_worker_compare(const ArchiveFile_t* a, const ArchiveFile_t* b) {
+    bool a_folder = (a->type == ArchiveFileTypeFolder);
+    bool b_folder = (b->type == ArchiveFileTypeFolder);
+    if(a_folder != b_folder) {
+        return a_folder ? -1 : 1;
+    }
+
+    int result = strcasecmp(string_get_cstr(a->name), string_get_cstr(b->name));
+    return result ? result : strcmp(string_get_cstr(a->name), string_get_cstr(b->name));
+}
+
+/** Index of first entry greater than file */
+static size_t archive_dir_worker_upper_bound(files_array_t array, const ArchiveFile_t* file) {
+    size_t low = 0;
+    size_t high = files_array_size(array);
+    while(low < high) {
+        size_t mid = (low + high) / 2;
+        if(archive_dir_worker_compare(files_array_get(array, mid), file) <= 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+static void archive_dir_worker_keep_largest(
+    files_array_t array,
+    size_t max_size,
+    const ArchiveFile_t* file) {
+    size_t size = files_array_size(array);
+    if(!max_size) return;
+    if(size == max_size && archive_dir_worker_compare(file, files_array_get(array, 0)) <= 0) {
+        return;
+    }
+
+    files_array_push_at(array, archive_dir_worker_upper_bound(array, file), *file);
+    if(size == max_size) {
+        files_array_remove_v(array, 0, 1);
+    }
+}
+
+static void archive_dir_worker_keep_smallest(
+    files_array_t array,
+    size_t max_size,
+    const ArchiveFile_t* file) {
+    size_t size = files_array_size(array);
+    if(!max_size) return;
+    if(size == max_size && archive_dir_worker_compare(file, files_array_back(array)) >= 0) {
+        return;
+    }
+
+    files_array_push_at(array, archive_dir_worker_upper_bound(array, file), *file);
+    if(size == max_size) {
+        files_array_pop_back(NULL, array);
+    }
+}
+
+static void archive_dir_worker_scan_init(ArchiveDirWorkerScan* scan) {
+    ArchiveFile_t_init(&scan->key);
+    ArchiveFile_t_init(&scan->entry);
+    files_array_init(scan->below);
+    files_array_init(scan->above);
+}
+
+static void archive_dir_worker_scan_clear(ArchiveDirWorkerScan* scan) {
+    ArchiveFile_t_clear(&scan->key);
+    ArchiveFile_t_clear(&scan->entry);
+    files_array_clear(scan->below);
+    files_array_clear(scan->above);
+}
+
+/** Returns false if aborted or directory can't be read */
+static bool archive_dir_worker_scan(ArchiveDirWorker* worker, ArchiveDirWorkerScan* scan) {
+    const char* path = string_get_cstr(worker->path);
+    const char* filter = string_get_cstr(worker->filter);
+    Storage* fs_api = furi_record_open("storage");
+    File* directory = storage_file_alloc(fs_api);
+    FileInfo file_info;
+    ArchiveFile_t file;
+    ArchiveFile_t_init(&file);
+    char* name = malloc(MAX_NAME_LEN);
+    size_t path_len = snprintf(name, MAX_NAME_LEN, "%s/", path);
+
+    files_array_reset(scan->below);
+    files_array_reset(scan->above);
+    scan->found = false;
+    scan->total = 0;
+    scan->rank = 0;
+
+    bool result = storage_dir_open(directory, path);
+    while(result) {
+        if(worker->abort) {
+            result = false;
+            break;
+        }
+        if(!storage_dir_read(directory, &file_info, &name[path_len], MAX_NAME_LEN - path_len)) {
+            break;
+        }
+        if(storage_file_get_error(directory) != FSE_OK) {
+            result = false;
+            break;
+        }
+        if(!filter_by_extension(&file_info, filter, name)) {
+            continue;
+        }
+
+        string_set_str(file.name, name);
+        set_file_type(&file, &file_info, path, false);
+        scan->total++;
+
+        int compare = 0;
+        if(scan->bound == ArchiveDirWorkerBoundStart) {
+            compare = 1;
+        } else if(scan->bound == ArchiveDirWorkerBoundEnd) {
+            compare = -1;
+        } else {
+            compare = archive_dir_worker_compare(&file, &scan->key);
+        }
+
+        if(compare < 0) {
+            scan->rank++;
+            archive_dir_worker_keep_largest(scan->below, scan->below_max, &file);
+        } else if(compare > 0) {
+            archive_dir_worker_keep_smallest(scan->above, scan->above_max, &file);
+        } else {
+            scan->found = true;
+            ArchiveFile_t_set(&scan->entry, &file);
+        }
+    }
+
+    storage_dir_close(directory);
+    storage_file_free(directory);
+    furi_record_close("storage");
+    ArchiveFile_t_clear(&file);
+    free(name);
+
+    return result;
+}
+
+/** Take entries of window [offset, offset + window_size) from scan */
+static void archive_dir_worker_scan_get_window(
+    ArchiveDirWorker* worker,
+    ArchiveDirWorkerScan* scan,
+    uint16_t offset,
+    files_array_t window) {
+    size_t end = offset + worker->window_size;
+    size_t below_size = files_array_size(scan->below);
+    size_t index = scan->rank - below_size;
+
+    for(size_t i = 0; i < below_size; i++, index++) {
+        if(index >= offset && index < end) {
+            files_array_push_back(window, *files_array_get(scan->below, i));
+        }
+    }
+    if(scan->found) {
+        if(index >= offset && index < end) {
+            files_array_push_back(window, scan->entry);
+        }
+        index++;
+    }
+    for(size_t i = 0; i < files_array_size(scan->above); i++, index++) {
+        if(index >= offset && index < end) {
+            files_array_push_back(window, *files_array_get(scan->above, i));
+        }
+    }
+}
+
+static uint16_t archive_dir_worker_get_offset(ArchiveDirWorker* worker, uint16_t idx) {
+    uint16_t window_size = worker->window_size;
+    uint16_t offset = (idx > window_size / 2) ? idx - window_size / 2 : 0;
+    if(worker->item_cnt > window_size) {
+        offset = MIN(offset, worker->item_cnt - window_size);
+    } else {
+        offset = 0;
+    }
+    return offset;
+}
+
+/** Store result unless request was cancelled meanwhile */
+static void archive_dir_worker_send(
+    ArchiveDirWorker* worker,
+    bool folder,
+    uint16_t idx,
+    uint16_t offset,
+    files_array_t window) {
+    ArchiveDirWorkerCallback callback = NULL;
+    osMutexAcquire(worker->mutex, osWaitForever);
+    if(!worker->abort) {
+        if(folder) {
+            // Window loads are accepted as soon as folder result can be taken
+            worker->folder_busy = false;
+            worker->folder_ready = true;
+            worker->result_item_cnt = worker->item_cnt;
+            worker->result_item_idx = idx;
+        }
+        worker->list_ready = true;
+        worker->result_offset = offset;
+        files_array_swap(worker->result_files, window);
+        callback = worker->callback;
+    }
+    osMutexRelease(worker->mutex);
+
+    if(callback) {
+        callback(worker->context);
+    }
+}
+
+static void archive_dir_worker_folder_open_process(ArchiveDirWorker* worker, string_t focus) {
+    ArchiveDirWorkerScan scan;
+    archive_dir_worker_scan_init(&scan);
+    files_array_t window;
+    files_array_init(window);
+
+    scan.bound = ArchiveDirWorkerBoundStart;
+    scan.below_max = worker->window_size;
+    scan.above_max = worker->window_size;
+    if(string_size(focus)) {
+        FileInfo file_info;
+        Storage* fs_api = furi_record_open("storage");
+        scan.bound = ArchiveDirWorkerBoundEntry;
+        string_set(scan.key.name, focus);
+        if(storage_common_stat(fs_api, string_get_cstr(focus), &file_info) == FSE_OK) {
+            set_file_type(&scan.key, &file_info, string_get_cstr(worker->path), false);
+        }
+        furi_record_close("storage");
+    }
+
+    bool result = archive_dir_worker_scan(worker, &scan);
+    if(result || !worker->abort) {
+        // Unreadable folder is shown empty
+        worker->item_cnt = result ? scan.total : 0;
+        uint16_t idx = MIN(scan.rank, worker->item_cnt ? worker->item_cnt - 1 : 0);
+        uint16_t offset = archive_dir_worker_get_offset(worker, idx);
+
+        if(result) {
+            archive_dir_worker_scan_get_window(worker, &scan, offset, window);
+        }
+        FURI_LOG_D(TAG, "%s: %u entries", string_get_cstr(worker->path), worker->item_cnt);
+
+        archive_dir_worker_send(worker, true, idx, offset, window);
+    }
+
+    files_array_clear(window);
+    archive_dir_worker_scan_clear(&scan);
+}
+
+static void archive_dir_worker_load_process(
+    ArchiveDirWorker* worker,
+    uint16_t offset,
+    bool anchor_valid,
+    ArchiveFile_t* anchor,
+    uint16_t anchor_idx) {
+    uint16_t window_size = worker->window_size;
+    ArchiveDirWorkerScan scan;
+    archive_dir_worker_scan_init(&scan);
+    files_array_t window;
+    files_array_init(window);
+
+    bool result = true;
+    if(offset && !(anchor_valid && (anchor_idx + 1 >= offset) &&
+                   (anchor_idx <= offset + window_size))) {
+        if(offset + window_size >= worker->item_cnt) {
+            anchor_valid = false;
+        } else {
+            // Walk windows forward from anchor before offset or from start,
+            // last entry of each one is the next bound
+            uint16_t index = 0;
+            scan.bound = ArchiveDirWorkerBoundStart;
+            if(anchor_valid && (anchor_idx < offset)) {
+                scan.bound = ArchiveDirWorkerBoundEntry;
+                ArchiveFile_t_set(&scan.key, anchor);
+                index = anchor_idx + 1;
+            }
+            scan.below_max = 0;
+            scan.above_max = window_size;
+            while(result) {
+                result = archive_dir_worker_scan(worker, &scan);
+                size_t size = files_array_size(scan.above);
+                if(!result || !size) {
+                    anchor_valid = false;
+                    break;
+                }
+
+                ArchiveFile_t_set(anchor, files_array_back(scan.above));
+                anchor_idx = index + size - 1;
+                anchor_valid = true;
+                if(anchor_idx + 1 >= offset) {
+                    anchor_idx = offset - 1;
+                    ArchiveFile_t_set(anchor, files_array_get(scan.above, anchor_idx - index));
+                    break;
+                }
+
+                scan.bound = ArchiveDirWorkerBoundEntry;
+                ArchiveFile_t_set(&scan.key, anchor);
+                index = anchor_idx + 1;
+            }
+        }
+    }
+
+    if(result) {
+        if(!offset) {
+            scan.bound = ArchiveDirWorkerBoundStart;
+            scan.below_max = 0;
+            scan.above_max = window_size;
+        } else if(anchor_valid) {
+            scan.bound = ArchiveDirWorkerBoundEntry;
+            ArchiveFile_t_set(&scan.key, anchor);
+            scan.below_max = (anchor_idx > offset) ? anchor_idx - offset : 0;
+            scan.above_max = (offset + window_size > anchor_idx + 1) ?
+                                 offset + window_size - anchor_idx - 1 :
+                                 0;
+        } else {
+            scan.bound = ArchiveDirWorkerBoundEnd;
+            scan.below_max = (worker->item_cnt > offset) ? worker->item_cnt - offset : 0;
+            scan.above_max = 0;
+        }
+
+        result = archive_dir_worker_scan(worker, &scan);
+    }
+
+    if(result) {
+        // Positions come from scan rank, changed folder gives short window, not wrong one
+        archive_dir_worker_scan_get_window(worker, &scan, offset, window);
+        archive_dir_worker_send(worker, false, 0, offset, window);
+    }
+
+    files_array_clear(window);
+    archive_dir_worker_scan_clear(&scan);
+}
+
+static int32_t archive_dir_worker_thread(void* context) {
+    ArchiveDirWorker* worker = context;
+    string_t focus;
+    string_init(focus);
+    ArchiveFile_t anchor;
+    ArchiveFile_t_init(&anchor);
+
+    while(1) {
+        uint32_t events =
+            osThreadFlagsWait(ARCHIVE_DIR_WORKER_EVENT_ALL, osFlagsWaitAny, osWaitForever);
+        furi_check((events & osFlagsError) == 0);
+        if(events & ARCHIVE_DIR_WORKER_EVENT_STOP) break;
+
+        while(1) {
+            osMutexAcquire(worker->mutex, osWaitForever);
+            ArchiveDirWorkerRequest request = worker->request;
+            uint16_t offset = worker->request_offset;
+            bool anchor_valid = worker->request_anchor_valid;
+            uint16_t anchor_idx = worker->request_anchor_idx;
+            if(request == ArchiveDirWorkerRequestFolder) {
+                string_set(worker->path, worker->request_path);
+                string_set(worker->filter, worker->request_filter);
+                string_set(focus, worker->request_focus);
+                worker->folder_busy = true;
+            } else if(request == ArchiveDirWorkerRequestLoad) {
+                ArchiveFile_t_set(&anchor, &worker->request_anchor);
+            }
+            worker->request = ArchiveDirWorkerRequestNone;
+            worker->abort = false;
+            osMutexRelease(worker->mutex);
+
+            if(request == ArchiveDirWorkerRequestFolder) {
+                archive_dir_worker_folder_open_process(worker, focus);
+                osMutexAcquire(worker->mutex, osWaitForever);
+                worker->folder_busy = false;
+                osMutexRelease(worker->mutex);
+            } else if(request == ArchiveDirWorkerRequestLoad) {
+                archive_dir_worker_load_process(worker, offset, anchor_valid, &anchor, anchor_idx);
+            } else {
+                break;
+            }
+        }
+    }
+
+    ArchiveFile_t_clear(&anchor);
+    string_clear(focus);
+
+    return 0;
+}
+
+ArchiveDirWorker* archive_dir_worker_alloc(uint16_t window_size) {
+    furi_assert(window_size);
+
+    ArchiveDirWorker* worker = malloc(sizeof(ArchiveDirWorker));
+    worker->mutex = osMutexNew(NULL);
+    worker->window_size = window_size;
+
+    worker->request = ArchiveDirWorkerRequestNone;
+    worker->folder_busy = false;
+    worker->abort = false;
+    string_init(worker->request_path);
+    string_init(worker->request_filter);
+    string_init(worker->request_focus);
+    worker->request_offset = 0;
+    worker->request_anchor_valid = false;
+    ArchiveFile_t_init(&worker->request_anchor);
+    worker->request_anchor_idx = 0;
+
+    string_init(worker->path);
+    string_init(worker->filter);
+    worker->item_cnt = 0;
+
+    worker->folder_ready = false;
+    worker->result_item_cnt = 0;
+    worker->result_item_idx = 0;
+    worker->list_ready = false;
+    worker->result_offset = 0;
+    files_array_init(worker->result_files);
+
+    worker->callback = NULL;
+    worker->context = NULL;
+
+    worker->thread = furi_thread_alloc();
+    furi_thread_set_name(worker->thread, "ArchiveDirWorker");
+    furi_thread_set_stack_size(worker->thread, 2048);
+    furi_thread_set_context(worker->thread, worker);
+    furi_thread_set_callback(worker->thread, archive_dir_worker_thread);
+    furi_thread_start(worker->thread);
+
+    return worker;
+}
+
+void archive_dir_worker_free(ArchiveDirWorker* worker) {
+    furi_assert(worker);
+
+    archive_dir_worker_cancel(worker);
+    osThreadFlagsSet(furi_thread_get_thread_id(worker->thread), ARCHIVE_DIR_WORKER_EVENT_STOP);
+    furi_thread_join(worker->thread);
+    furi_thread_free(worker->thread);
+
+    string_clear(worker->request_path);
+    string_clear(worker->request_filter);
+    string_clear(worker->request_focus);
+    ArchiveFile_t_clear(&worker->request_anchor);
+    string_clear(worker->path);
+    string_clear(worker->filter);
+    files_array_clear(worker->result_files);
+    osMutexDelete(worker->mutex);
+
+    free(worker);
+}
+
+void archive_dir_worker_set_callback(
+    ArchiveDirWorker* worker,
+    ArchiveDirWorkerCallback callback,
+    void* context) {
+    furi_assert(worker);
+
+    osMutexAcquire(worker->mutex, osWaitForever);
+    worker->callback = callback;
+    worker->context = context;
+    osMutexRelease(worker->mutex);
+}
+
+void archive_dir_worker_folder_open(
+    ArchiveDirWorker* worker,
+    const char* path,
+    const char* filter_ext,
+    const char* focus) {
+    furi_assert(worker);
+    furi_assert(path);
+    furi_assert(filter_ext);
+
+    osMutexAcquire(worker->mutex, osWaitForever);
+    string_set_str(worker->request_path, path);
+    string_set_str(worker->request_filter, filter_ext);
+    string_set_str(worker->request_focus, focus ? focus : "");
+    worker->request = ArchiveDirWorkerRequestFolder;
+    worker->abort = true;
+    worker->folder_ready = false;
+    worker->list_ready = false;
+    osMutexRelease(worker->mutex);
+
+    osThreadFlagsSet(furi_thread_get_thread_id(worker->thread), ARCHIVE_DIR_WORKER_EVENT_REQUEST);
+}
+
+void archive_dir_worker_load(
+    ArchiveDirWorker* worker,
+    uint16_t offset,
+    const ArchiveFile_t* anchor,
+    uint16_t anchor_idx) {
+    furi_assert(worker);
+
+    bool send = false;
+    osMutexAcquire(worker->mutex, osWaitForever);
+    if(worker->request != ArchiveDirWorkerRequestFolder && !worker->folder_busy) {
+        worker->request = ArchiveDirWorkerRequestLoad;
+        worker->request_offset = offset;
+        worker->request_anchor_valid = (anchor != NULL);
+        if(anchor) {
+            ArchiveFile_t_set(&worker->request_anchor, anchor);
+        }
+        worker->request_anchor_idx = anchor_idx;
+        worker->abort = true;
+        send = true;
+    }
+    osMutexRelease(worker->mutex);
+
+    if(send) {
+        osThreadFlagsSet(
+            furi_thread_get_thread_id(worker->thread), ARCHIVE_DIR_WORKER_EVENT_REQUEST);
+    }
+}
+
+void archive_dir_worker_cancel(ArchiveDirWorker* worker) {
+    furi_assert(worker);
+
+    osMutexAcquire(worker->mutex, osWaitForever);
+    worker->request = ArchiveDirWorkerRequestNone;
+    worker->abort = true;
+    worker->folder_ready = false;
+    worker->list_ready = false;
+    osMutexRelease(worker->mutex);
+}
+
+bool archive_dir_worker_take_folder(
+    ArchiveDirWorker* worker,
+    uint16_t* item_cnt,
+    uint16_t* item_idx) {
+    furi_assert(worker);
+    furi_assert(item_cnt);
+    furi_assert(item_idx);
+
+    osMutexAcquire(worker->mutex, osWaitForever);
+    bool ready = worker->folder_ready;
+    if(ready) {
+        *item_cnt = worker->result_item_cnt;
+        *item_idx = worker->result_item_idx;
+        worker->folder_ready = false;
+    }
+    osMutexRelease(worker->mutex);
+
+    return ready;
+}
+
+bool archive_dir_worker_take_list(
+    ArchiveDirWorker* worker,
+    uint16_t* offset,
+    files_array_t files) {
+    furi_assert(worker);
+    furi_assert(offset);
+
+    osMutexAcquire(worker->mutex, osWaitForever);
+    bool ready = worker->list_ready;
+    if(ready) {
+        *offset = worker->result_offset;
+        files_array_swap(files, worker->result_files);
+        files_array_reset(worker->result_files);
+        worker->list_ready = false;
+    }
+    osMutexRelease(worker->mutex);
+
+    return ready;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "archive_files.h"
+
+/**
+ * Loads directory in windows of sorted entries in a separate thread.
+ * Folders go first, then files, both by name. Memory use is bounded by
+ * window size, not by directory size: every request is a single pass over
+ * directory that keeps only entries of requested window.
+ */
+typedef struct ArchiveDirWorker ArchiveDirWorker;
+
+/** Result is ready, take it with archive_dir_worker_take_folder and
+ * archive_dir_worker_take_list from the thread that makes requests */
+typedef void (*ArchiveDirWorkerCallback)(void* context);
+
+/**
+ * Allocate and start ArchiveDirWorker
+ * @param window_size entries count of one window
+ * @return ArchiveDirWorker* Pointer to a ArchiveDirWorker instance
+ */
+ArchiveDirWorker* archive_dir_worker_alloc(uint16_t window_size);
+
+/**
+ * Stop and free ArchiveDirWorker, request in progress is cancelled
+ * @param worker Pointer to a ArchiveDirWorker instance
+ */
+void archive_dir_worker_free(ArchiveDirWorker* worker);
+
+/**
+ * Set callback, called from worker thread
+ * @param worker Pointer to a ArchiveDirWorker instance
+ * @param callback ArchiveDirWorkerCallback
+ * @param context callback context
+ */
+void archive_dir_worker_set_callback(
+    ArchiveDirWorker* worker,
+    ArchiveDirWorkerCallback callback,
+    void* context);
+
+/**
+ * Open folder: count entries and load window around focused entry.
+ * Cancels any request in progress and drops results not taken yet.
+ * @param worker Pointer to a ArchiveDirWorker instance
+ * @param path folder path
+ * @param filter_ext extension filter, as in filter_by_extension
+ * @param focus full path of entry to focus, if it doesn't exist cursor goes to
+ * the entry that would follow it. NULL or "" for first entry.
+ */
+void archive_dir_worker_folder_open(
+    ArchiveDirWorker* worker,
+    const char* path,
+    const char* filter_ext,
+    const char* focus);
+
+/**
+ * Load window of opened folder. Cancels window load in progress, ignored
+ * while folder is being opened.
+ * @param worker Pointer to a ArchiveDirWorker instance
+ * @param offset index of first entry of window
+ * @param anchor entry with known index. Load is a single pass if the index is in
+ * [offset - 1, offset + window_size], otherwise it takes a pass per window
+ * from anchor before offset, or from folder start. May be NULL.
+ * @param anchor_idx anchor index
+ */
+void archive_dir_worker_load(
+    ArchiveDirWorker* worker,
+    uint16_t offset,
+    const ArchiveFile_t* anchor,
+    uint16_t anchor_idx);
+
+/**
+ * Cancel request in progress and drop results not taken yet
+ * @param worker Pointer to a ArchiveDirWorker instance
+ */
+void archive_dir_worker_cancel(ArchiveDirWorker* worker);
+
+/**
+ * Take result of folder open
+ * @param worker Pointer to a ArchiveDirWorker instance
+ * @param item_cnt total filtered entries count
+ * @param item_idx index of focused entry
+ * @return true if folder was opened since last call
+ */
+bool archive_dir_worker_take_folder(
+    ArchiveDirWorker* worker,
+    uint16_t* item_cnt,
+    uint16_t* item_idx);
+
+/**
+ * Take last loaded window
+ * @param worker Pointer to a ArchiveDirWorker instance
+ * @param offset index of first entry of window
+ * @param files window entries, previous content is dropped
+ * @return true if window was loaded since last call
+ */
+bool archive_dir_worker_take_list(
+    ArchiveDirWorker* worker,
+    uint16_t* offset,
+    files_array_t files);
@@ -1,19 +1,81 @@
-
 #include "archive_favorites.h"
 #include "archive_files.h"
 #include "archive_apps.h"
 #include "archive_browser.h"
+#include <m-dict.h>
 
-uint16_t archive_favorites_count(void* context) {
-    furi_assert(context);
+#define TAG "ArchiveFavorites"
 
-    FileWorker* file_worker = file_worker_alloc(true);
+#define ARCHIVE_FAV_WRITE_BUFFER_SIZE 512
+
+ARRAY_DEF(ArchiveFavoritesList, string_t, STRING_OPLIST)
+DICT_SET_DEF(ArchiveFavoritesSet, string_t, STRING_OPLIST)
+
+struct ArchiveFavorites {
+    // File order, shown in favorites tab
+    ArchiveFavoritesList_t list;
+    // Same entries for membership checks
+    ArchiveFavoritesSet_t set;
+    string_t path;
+    string_t temp_path;
+    bool changed;
+
+    osTimerId_t flush_timer;
+    ArchiveFavoritesFlushCallback callback;
+    void* context;
+};
+
+static void archive_favorites_flush_timer_callback(void* context) {
+    ArchiveFavorites* favorites = context;
+    if(favorites->callback) {
+        favorites->callback(favorites->context);
+    }
+}
+
+static void archive_favorites_changed(ArchiveFavorites* favorites) {
+    favorites->changed = true;
+    if(favorites->callback) {
+        osTimerStart(favorites->flush_timer, ARCHIVE_FAV_FLUSH_DELAY);
+    }
+}
+
+static bool archive_favorites_push(ArchiveFavorites* favorites, const string_t name) {
+    if(ArchiveFavoritesSet_get(favorites->set, name)) {
+        return false;
+    }
+
+    ArchiveFavoritesSet_push(favorites->set, name);
+    ArchiveFavoritesList_push_back(favorites->list, name);
+    return true;
+}
 
+static bool archive_favorites_remove(ArchiveFavorites* favorites, const string_t name) {
+    if(!ArchiveFavoritesSet_erase(favorites->set, name)) {
+        return false;
+    }
+
+    for(size_t i = 0; i < ArchiveFavoritesList_size(favorites->list); i++) {
+        if(string_equal_p(*ArchiveFavoritesList_get(favorites->list, i), name)) {
+            ArchiveFavoritesList_remove_v(favorites->list, i, i + 1);
+            break;
+        }
+    }
+    return true;
+}
+
+static void archive_favorites_load(ArchiveFavorites* favorites) {
+    FileWorker* file_worker = file_worker_alloc(true);
     string_t buffer;
     string_init(buffer);
 
-    bool result = file_worker_open(file_worker, ARCHIVE_FAV_PATH, FSAM_READ, FSOM_OPEN_EXISTING);
-    uint16_t lines = 0;
+    const char* path = string_get_cstr(favorites->path);
+    bool result = file_worker_open(file_worker, path, FSAM_READ, FSOM_OPEN_EXISTING);
+    if(!result) {
+        // Flush was interrupted after old file removal, temporary file is complete
+        if(file_worker_rename(file_worker, string_get_cstr(favorites->temp_path), path)) {
+            result = file_worker_open(file_worker, path, FSAM_READ, FSOM_OPEN_EXISTING);
+        }
+    }
 
     if(result) {
         while(1) {
@@ -23,247 +85,242 @@ uint16_t archive_favorites_count(void* context) {
             if(!string_size(buffer)) {
                 break;
             }
-            ++lines;
+            archive_favorites_push(favorites, buffer);
         }
     }
 
     string_clear(buffer);
     file_worker_close(file_worker);
     file_worker_free(file_worker);
-    return lines;
 }
 
-static bool archive_favourites_rescan() {
+ArchiveFavorites* archive_favorites_alloc(const char* path, const char* temp_path) {
+    furi_assert(path);
+    furi_assert(temp_path);
+
+    ArchiveFavorites* favorites = malloc(sizeof(ArchiveFavorites));
+    ArchiveFavoritesList_init(favorites->list);
+    ArchiveFavoritesSet_init(favorites->set);
+    string_init_set_str(favorites->path, path);
+    string_init_set_str(favorites->temp_path, temp_path);
+    favorites->changed = false;
+    favorites->flush_timer =
+        osTimerNew(archive_favorites_flush_timer_callback, osTimerOnce, favorites, NULL);
+    favorites->callback = NULL;
+    favorites->context = NULL;
+
+    archive_favorites_load(favorites);
+
+    return favorites;
+}
+
+void archive_favorites_free(ArchiveFavorites* favorites) {
+    furi_assert(favorites);
+
+    archive_favorites_flush(favorites);
+    osTimerDelete(favorites->flush_timer);
+
+    ArchiveFavoritesList_clear(favorites->list);
+    ArchiveFavoritesSet_clear(favorites->set);
+    string_clear(favorites->path);
+    string_clear(favorites->temp_path);
+    free(favorites);
+}
+
+void archive_favorites_set_flush_callback(
+    ArchiveFavorites* favorites,
+    ArchiveFavoritesFlushCallback callback,
+    void* context) {
+    furi_assert(favorites);
+
+    favorites->callback = callback;
+    favorites->context = context;
+}
+
+bool archive_favorites_flush(ArchiveFavorites* favorites) {
+    furi_assert(favorites);
+
+    osTimerStop(favorites->flush_timer);
+    if(!favorites->changed) {
+        return true;
+    }
+
+    FileWorker* file_worker = file_worker_alloc(true);
     string_t buffer;
     string_init(buffer);
-    FileWorker* file_worker = file_worker_alloc(true);
 
-    bool result = file_worker_open(file_worker, ARCHIVE_FAV_PATH, FSAM_READ, FSOM_OPEN_EXISTING);
-    if(result) {
-        while(1) {
-            if(!file_worker_read_until(file_worker, buffer, '\n')) {
-                break;
-            }
-            if(!string_size(buffer)) {
-                break;
-            }
+    // Whole list goes to temporary file, then replaces old one
+    const char* temp_path = string_get_cstr(favorites->temp_path);
+    bool result = file_worker_open(file_worker, temp_path, FSAM_WRITE, FSOM_CREATE_ALWAYS);
+    size_t count = ArchiveFavoritesList_size(favorites->list);
 
-            if(string_search(buffer, "/app:") == 0) {
-                if(archive_app_is_available(NULL, string_get_cstr(buffer))) {
-                    archive_file_append(ARCHIVE_FAV_TEMP_PATH, "%s\n", string_get_cstr(buffer));
-                }
-            } else {
-                bool file_exists = false;
-                file_worker_is_file_exist(file_worker, string_get_cstr(buffer), &file_exists);
-                if(file_exists) {
-                    archive_file_append(ARCHIVE_FAV_TEMP_PATH, "%s\n", string_get_cstr(buffer));
-                }
-            }
+    for(size_t i = 0; result && (i < count); i++) {
+        string_cat(buffer, *ArchiveFavoritesList_get(favorites->list, i));
+        string_push_back(buffer, '\n');
+
+        if((string_size(buffer) >= ARCHIVE_FAV_WRITE_BUFFER_SIZE) || (i == count - 1)) {
+            result = file_worker_write(file_worker, string_get_cstr(buffer), string_size(buffer));
+            string_reset(buffer);
         }
     }
+    result &= file_worker_close(file_worker);
 
-    string_clear(buffer);
+    if(result) {
+        const char* path = string_get_cstr(favorites->path);
+        result = file_worker_remove(file_worker, path) &&
+                 file_worker_rename(file_worker, temp_path, path);
+    }
 
-    file_worker_close(file_worker);
-    file_worker_remove(file_worker, ARCHIVE_FAV_PATH);
-    file_worker_rename(file_worker, ARCHIVE_FAV_TEMP_PATH, ARCHIVE_FAV_PATH);
+    if(result) {
+        favorites->changed = false;
+    } else {
+        FURI_LOG_E(TAG, "Flush failed");
+    }
 
+    string_clear(buffer);
     file_worker_free(file_worker);
 
     return result;
 }
 
+uint16_t archive_favorites_count(ArchiveFavorites* favorites) {
+    furi_assert(favorites);
+
+    return ArchiveFavoritesList_size(favorites->list);
+}
+
 bool archive_favorites_read(void* context) {
     furi_assert(context);
 
     ArchiveBrowserView* browser = context;
-    FileWorker* file_worker = file_worker_alloc(true);
-
-    string_t buffer;
+    ArchiveFavorites* favorites = browser->favorites;
+    Storage* fs_api = furi_record_open("storage");
     FileInfo file_info;
-    string_init(buffer);
-
-    bool need_refresh = false;
 
-    bool result = file_worker_open(file_worker, ARCHIVE_FAV_PATH, FSAM_READ, FSOM_OPEN_EXISTING);
+    // Entries are removed while iterating
+    size_t i = 0;
+    while(i < ArchiveFavoritesList_size(favorites->list)) {
+        string_t* name = ArchiveFavoritesList_get(favorites->list, i);
+        bool available = false;
 
-    if(result) {
-        while(1) {
-            if(!file_worker_read_until(file_worker, buffer, '\n')) {
-                break;
-            }
-            if(!string_size(buffer)) {
-                break;
-            }
-
-            if(string_search(buffer, "/app:") == 0) {
-                if(archive_app_is_available(browser, string_get_cstr(buffer))) {
-                    archive_add_app_item(browser, string_get_cstr(buffer));
-                } else {
-                    need_refresh = true;
-                }
-            } else {
-                bool file_exists = false;
-                file_worker_is_file_exist(file_worker, string_get_cstr(buffer), &file_exists);
-
-                if(file_exists)
-                    archive_add_file_item(browser, &file_info, string_get_cstr(buffer));
-                else
-                    need_refresh = true;
+        if(string_search(*name, "/app:") == 0) {
+            if(archive_app_is_available(browser, string_get_cstr(*name))) {
+                archive_add_app_item(browser, string_get_cstr(*name));
+                available = true;
             }
+        } else if(storage_common_stat(fs_api, string_get_cstr(*name), &file_info) == FSE_OK) {
+            archive_add_file_item(browser, &file_info, string_get_cstr(*name));
+            available = true;
+        }
 
-            string_reset(buffer);
+        if(available) {
+            i++;
+        } else {
+            ArchiveFavoritesSet_erase(favorites->set, *name);
+            ArchiveFavoritesList_remove_v(favorites->list, i, i + 1);
+            archive_favorites_changed(favorites);
         }
     }
-    string_clear(buffer);
-    file_worker_close(file_worker);
-    file_worker_free(file_worker);
 
-    if(need_refresh) {
-        archive_favourites_rescan();
-    }
+    furi_record_close("storage");
 
-    return result;
+    return true;
 }
 
-bool archive_favorites_delete(const char* format, ...) {
-    string_t buffer;
+bool archive_favorites_delete(ArchiveFavorites* favorites, const char* format, ...) {
+    furi_assert(favorites);
+
     string_t filename;
     va_list args;
     va_start(args, format);
     string_init_vprintf(filename, format, args);
     va_end(args);
 
-    string_init(buffer);
-    FileWorker* file_worker = file_worker_alloc(true);
-
-    bool result = file_worker_open(file_worker, ARCHIVE_FAV_PATH, FSAM_READ, FSOM_OPEN_EXISTING);
+    bool result = archive_favorites_remove(favorites, filename);
     if(result) {
-        while(1) {
-            if(!file_worker_read_until(file_worker, buffer, '\n')) {
-                break;
-            }
-            if(!string_size(buffer)) {
-                break;
-            }
-
-            if(string_search(buffer, filename)) {
-                archive_file_append(ARCHIVE_FAV_TEMP_PATH, "%s\n", string_get_cstr(buffer));
-            }
-        }
+        archive_favorites_changed(favorites);
     }
 
-    string_clear(buffer);
     string_clear(filename);
 
-    file_worker_close(file_worker);
-    file_worker_remove(file_worker, ARCHIVE_FAV_PATH);
-    file_worker_rename(file_worker, ARCHIVE_FAV_TEMP_PATH, ARCHIVE_FAV_PATH);
-
-    file_worker_free(file_worker);
-
     return result;
 }
 
-bool archive_is_favorite(const char* format, ...) {
-    string_t buffer;
+bool archive_is_favorite(ArchiveFavorites* favorites, const char* format, ...) {
+    furi_assert(favorites);
+
     string_t filename;
     va_list args;
     va_start(args, format);
     string_init_vprintf(filename, format, args);
     va_end(args);
 
-    string_init(buffer);
-    FileWorker* file_worker = file_worker_alloc(true);
+    bool found = ArchiveFavoritesSet_get(favorites->set, filename) != NULL;
 
-    bool found = false;
-    bool result = file_worker_open(file_worker, ARCHIVE_FAV_PATH, FSAM_READ, FSOM_OPEN_EXISTING);
-
-    if(result) {
-        while(1) {
-            if(!file_worker_read_until(file_worker, buffer, '\n')) {
-                break;
-            }
-            if(!string_size(buffer)) {
-                break;
-            }
-            if(!string_search(buffer, filename)) {
-                found = true;
-                break;
-            }
-        }
-    }
-
-    string_clear(buffer);
     string_clear(filename);
-    file_worker_close(file_worker);
-    file_worker_free(file_worker);
 
     return found;
 }
 
-bool archive_favorites_rename(const char* src, const char* dst) {
+bool archive_favorites_rename(ArchiveFavorites* favorites, const char* src, const char* dst) {
+    furi_assert(favorites);
     furi_assert(src);
     furi_assert(dst);
 
-    FileWorker* file_worker = file_worker_alloc(true);
-
     string_t path;
-    string_t buffer;
-
-    string_init(buffer);
-    string_init(path);
-
-    string_printf(path, "%s", src);
-    bool result = file_worker_open(file_worker, ARCHIVE_FAV_PATH, FSAM_READ, FSOM_OPEN_EXISTING);
+    string_init_set_str(path, src);
+    bool result = ArchiveFavoritesSet_erase(favorites->set, path);
 
     if(result) {
-        while(1) {
-            if(!file_worker_read_until(file_worker, buffer, '\n')) {
-                break;
-            }
-            if(!string_size(buffer)) {
+        string_set_str(path, dst);
+        bool duplicate = ArchiveFavoritesSet_get(favorites->set, path) != NULL;
+        ArchiveFavoritesSet_push(favorites->set, path);
+
+        // Keep position of renamed entry
+        for(size_t i = 0; i < ArchiveFavoritesList_size(favorites->list); i++) {
+            string_t* name = ArchiveFavoritesList_get(favorites->list, i);
+            if(!string_cmp_str(*name, src)) {
+                if(duplicate) {
+                    ArchiveFavoritesList_remove_v(favorites->list, i, i + 1);
+                } else {
+                    string_set_str(*name, dst);
+                }
                 break;
             }
-
-            archive_file_append(
-                ARCHIVE_FAV_TEMP_PATH,
-                "%s\n",
-                string_search(buffer, path) ? string_get_cstr(buffer) : dst);
         }
+        archive_favorites_changed(favorites);
     }
 
-    string_clear(buffer);
     string_clear(path);
 
-    file_worker_close(file_worker);
-    file_worker_remove(file_worker, ARCHIVE_FAV_PATH);
-    file_worker_rename(file_worker, ARCHIVE_FAV_TEMP_PATH, ARCHIVE_FAV_PATH);
-
-    file_worker_free(file_worker);
-
     return result;
 }
 
-void archive_add_to_favorites(const char* file_path) {
+void archive_add_to_favorites(ArchiveFavorites* favorites, const char* file_path) {
+    furi_assert(favorites);
     furi_assert(file_path);
 
-    archive_file_append(ARCHIVE_FAV_PATH, "%s\n", file_path);
+    string_t path;
+    string_init_set_str(path, file_path);
+    if(archive_favorites_push(favorites, path)) {
+        archive_favorites_changed(favorites);
+    }
+    string_clear(path);
 }
 
 void archive_favorites_save(void* context) {
     furi_assert(context);
 
     ArchiveBrowserView* browser = context;
-    FileWorker* file_worker = file_worker_alloc(true);
+    ArchiveFavorites* favorites = browser->favorites;
+
+    ArchiveFavoritesList_reset(favorites->list);
+    ArchiveFavoritesSet_reset(favorites->set);
 
     for(size_t i = 0; i < archive_file_array_size(browser); i++) {
         ArchiveFile_t* item = archive_get_file_at(browser, i);
-        archive_file_append(ARCHIVE_FAV_TEMP_PATH, "%s\n", string_get_cstr(item->name));
+        archive_favorites_push(favorites, item->name);
     }
 
-    file_worker_remove(file_worker, ARCHIVE_FAV_PATH);
-    file_worker_rename(file_worker, ARCHIVE_FAV_TEMP_PATH, ARCHIVE_FAV_PATH);
-
-    file_worker_free(file_worker);
-}
\ No newline at end of file
+    archive_favorites_changed(favorites);
+}
@@ -3,11 +3,28 @@
 
 #define ARCHIVE_FAV_PATH "/any/favorites.txt"
 #define ARCHIVE_FAV_TEMP_PATH "/any/favorites.tmp"
+/** Delay between last change and favorites file update, ms */
+#define ARCHIVE_FAV_FLUSH_DELAY 2000
 
-uint16_t archive_favorites_count(void* context);
+/** In-memory favorites list, loaded once and written back on flush */
+typedef struct ArchiveFavorites ArchiveFavorites;
+
+/** Called from timer thread when changes are pending for ARCHIVE_FAV_FLUSH_DELAY,
+ * archive_favorites_flush must be called from the thread that owns favorites */
+typedef void (*ArchiveFavoritesFlushCallback)(void* context);
+
+ArchiveFavorites* archive_favorites_alloc(const char* path, const char* temp_path);
+void archive_favorites_free(ArchiveFavorites* favorites);
+void archive_favorites_set_flush_callback(
+    ArchiveFavorites* favorites,
+    ArchiveFavoritesFlushCallback callback,
+    void* context);
+bool archive_favorites_flush(ArchiveFavorites* favorites);
+
+uint16_t archive_favorites_count(ArchiveFavorites* favorites);
 bool archive_favorites_read(void* context);
-bool archive_favorites_delete(const char* format, ...);
-bool archive_is_favorite(const char* format, ...);
-bool archive_favorites_rename(const char* src, const char* dst);
-void archive_add_to_favorites(const char* file_path);
+bool archive_favorites_delete(ArchiveFavorites* favorites, const char* format, ...);
+bool archive_is_favorite(ArchiveFavorites* favorites, const char* format, ...);
+bool archive_favorites_rename(ArchiveFavorites* favorites, const char* src, const char* dst);
+void archive_add_to_favorites(ArchiveFavorites* favorites, const char* file_path);
 void archive_favorites_save(void* context);
@@ -78,7 +78,7 @@ void set_file_type(ArchiveFile_t* file, FileInfo* file_info, const char* path, b
     }
 }
 
-bool archive_get_filenames(void* context, const char* path) {
+bool archive_get_filenames(void* context, const char* path, const char* focus) {
     furi_assert(context);
 
     bool res;
@@ -90,7 +90,7 @@ bool archive_get_filenames(void* context, const char* path) {
     } else if(strncmp(path, "/app:", 5) == 0) {
         res = archive_app_read_dir(browser, path);
     } else {
-        res = archive_read_dir(browser, path);
+        res = archive_read_dir(browser, path, focus);
     }
     return res;
 }
@@ -135,71 +135,25 @@ bool archive_dir_not_empty(void* context, const char* path) { // can be simpler?
     return files_found;
 }
 
-bool archive_read_dir(void* context, const char* path) {
+bool archive_read_dir(void* context, const char* path, const char* focus) {
     furi_assert(context);
 
     ArchiveBrowserView* browser = context;
-    FileInfo file_info;
-    Storage* fs_api = furi_record_open("storage");
-    File* directory = storage_file_alloc(fs_api);
-    char name[MAX_NAME_LEN];
-    snprintf(name, MAX_NAME_LEN, "%s/", path);
-    size_t path_len = strlen(name);
-    size_t files_cnt = 0;
-
-    if(!storage_dir_open(directory, path)) {
-        storage_dir_close(directory);
-        storage_file_free(directory);
-        return false;
-    }
-
-    while(1) {
-        if(!storage_dir_read(directory, &file_info, &name[path_len], MAX_NAME_LEN - path_len)) {
-            break;
-        }
 
-        if(files_cnt > MAX_FILES) {
-            break;
-        } else if(storage_file_get_error(directory) == FSE_OK) {
-            archive_add_file_item(browser, &file_info, name);
-            ++files_cnt;
-        } else {
-            storage_dir_close(directory);
-            storage_file_free(directory);
-            return false;
-        }
-    }
-    storage_dir_close(directory);
-    storage_file_free(directory);
+    // Entries come in windows from worker, see archive_update_list
+    with_view_model(
+        browser->view, (ArchiveBrowserViewModel * model) {
+            model->folder_loading = true;
+            model->list_loading = true;
+            return true;
+        });
 
-    furi_record_close("storage");
+    archive_dir_worker_folder_open(
+        browser->worker, path, archive_get_tab_ext(archive_get_tab(browser)), focus);
 
     return true;
 }
 
-void archive_file_append(const char* path, const char* format, ...) {
-    furi_assert(path);
-
-    string_t string;
-    va_list args;
-    va_start(args, format);
-    string_init_vprintf(string, format, args);
-    va_end(args);
-
-    FileWorker* file_worker = file_worker_alloc(false);
-
-    if(!file_worker_open(file_worker, path, FSAM_WRITE, FSOM_OPEN_APPEND)) {
-        FURI_LOG_E(TAG, "Append open error");
-    }
-
-    if(!file_worker_write(file_worker, string_get_cstr(string), string_size(string))) {
-        FURI_LOG_E(TAG, "Append write error");
-    }
-
-    file_worker_close(file_worker);
-    file_worker_free(file_worker);
-}
-
 void archive_delete_file(void* context, const char* format, ...) {
     furi_assert(context);
 
@@ -215,9 +169,7 @@ void archive_delete_file(void* context, const char* format, ...) {
     bool res = file_worker_remove(file_worker, string_get_cstr(filename));
     file_worker_free(file_worker);
 
-    if(archive_is_favorite("%s", string_get_cstr(filename))) {
-        archive_favorites_delete("%s", string_get_cstr(filename));
-    }
+    archive_favorites_delete(browser->favorites, "%s", string_get_cstr(filename));
 
     if(res) {
         archive_file_array_rm_selected(browser);
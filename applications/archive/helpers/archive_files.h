@@ -2,8 +2,6 @@
 #include "file_worker.h"
 #include <m-array.h>
 
-#define MAX_FILES 100 //temp
-
 typedef enum {
     ArchiveFileTypeIButton,
     ArchiveFileTypeNFC,
@@ -61,8 +59,7 @@ bool filter_by_extension(FileInfo* file_info, const char* tab_ext, const char* n
 void set_file_type(ArchiveFile_t* file, FileInfo* file_info, const char* path, bool is_app);
 void archive_trim_file_path(char* name, bool ext);
 void archive_get_file_extension(char* name, char* ext);
-bool archive_get_filenames(void* context, const char* path);
+bool archive_get_filenames(void* context, const char* path, const char* focus);
 bool archive_dir_not_empty(void* context, const char* path);
-bool archive_read_dir(void* context, const char* path);
-void archive_file_append(const char* path, const char* format, ...);
+bool archive_read_dir(void* context, const char* path, const char* focus);
 void archive_delete_file(void* context, const char* format, ...);
\ No newline at end of file
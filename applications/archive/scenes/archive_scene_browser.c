@@ -59,7 +59,7 @@ bool archive_scene_browser_on_event(void* context, SceneManagerEvent event) {
     ArchiveFile_t* selected = archive_get_current_file(browser);
 
     const char* name = archive_get_name(browser);
-    bool known_app = archive_is_known_app(selected->type);
+    bool known_app = selected && archive_is_known_app(selected->type);
     bool favorites = archive_get_tab(browser) == ArchiveTabFavorites;
     bool consumed = false;
 
@@ -81,14 +81,14 @@ bool archive_scene_browser_on_event(void* context, SceneManagerEvent event) {
             break;
         case ArchiveBrowserEventFileMenuPin:
             if(favorites) {
-                archive_favorites_delete(name);
+                archive_favorites_delete(browser->favorites, "%s", name);
                 archive_file_array_rm_selected(browser);
                 archive_show_file_menu(browser, false);
             } else if(known_app) {
-                if(archive_is_favorite("%s", name)) {
-                    archive_favorites_delete("%s", name);
+                if(archive_is_favorite(browser->favorites, "%s", name)) {
+                    archive_favorites_delete(browser->favorites, "%s", name);
                 } else {
-                    archive_file_append(ARCHIVE_FAV_PATH, "%s\n", name);
+                    archive_add_to_favorites(browser->favorites, name);
                 }
                 archive_show_file_menu(browser, false);
             }
@@ -109,7 +109,9 @@ bool archive_scene_browser_on_event(void* context, SceneManagerEvent event) {
             consumed = true;
             break;
         case ArchiveBrowserEventEnterDir:
-            archive_enter_dir(browser, selected->name);
+            if(selected) {
+                archive_enter_dir(browser, selected->name);
+            }
             consumed = true;
             break;
         case ArchiveBrowserEventFavMoveUp:
@@ -137,6 +139,11 @@ bool archive_scene_browser_on_event(void* context, SceneManagerEvent event) {
             consumed = true;
             break;
 
+        case ArchiveBrowserEventListLoaded:
+            archive_update_list(browser);
+            consumed = true;
+            break;
+
         case ArchiveBrowserEventExit:
             if(archive_get_depth(browser)) {
                 archive_leave_dir(browser);
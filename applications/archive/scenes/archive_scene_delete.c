@@ -19,12 +19,18 @@ void archive_scene_delete_on_enter(void* context) {
     furi_assert(context);
     ArchiveApp* app = (ArchiveApp*)context;
 
+    // Selection can be outside of loaded window
+    ArchiveFile_t* current = archive_get_current_file(app->browser);
+    if(current == NULL) {
+        scene_manager_previous_scene(app->scene_manager);
+        return;
+    }
+
     widget_add_button_element(
         app->widget, GuiButtonTypeLeft, "Back", archive_scene_delete_widget_callback, app);
     widget_add_button_element(
         app->widget, GuiButtonTypeRight, "Delete", archive_scene_delete_widget_callback, app);
 
-    ArchiveFile_t* current = archive_get_current_file(app->browser);
     strlcpy(app->text_store, string_get_cstr(current->name), MAX_NAME_LEN);
     char* name = strrchr(app->text_store, '/');
     if(name != NULL) {
@@ -48,9 +54,10 @@ bool archive_scene_delete_on_event(void* context, SceneManagerEvent event) {
 
     if(event.type == SceneManagerEventTypeCustom) {
         if(event.event == GuiButtonTypeRight) {
-            if(selected->is_app) {
+            // selection can be lost while scene is shown, nothing is deleted then
+            if(selected && selected->is_app) {
                 archive_app_delete_file(browser, name);
-            } else {
+            } else if(selected) {
                 archive_delete_file(browser, "%s", name);
             }
             archive_show_file_menu(browser, false);
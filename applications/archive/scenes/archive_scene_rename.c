@@ -15,7 +15,12 @@ void archive_scene_rename_on_enter(void* context) {
     ArchiveApp* archive = (ArchiveApp*)context;
 
     TextInput* text_input = archive->text_input;
+    // Selection can be outside of loaded window
     ArchiveFile_t* current = archive_get_current_file(archive->browser);
+    if(current == NULL) {
+        scene_manager_previous_scene(archive->scene_manager);
+        return;
+    }
     strlcpy(archive->text_store, string_get_cstr(current->name), MAX_NAME_LEN);
 
     archive_get_file_extension(archive->text_store, archive->file_extension);
@@ -44,6 +49,11 @@ bool archive_scene_rename_on_event(void* context, SceneManagerEvent event) {
 
     if(event.type == SceneManagerEventTypeCustom) {
         if(event.event == SCENE_RENAME_CUSTOM_EVENT) {
+            ArchiveFile_t* file = archive_get_current_file(archive->browser);
+            if(file == NULL) {
+                return scene_manager_previous_scene(archive->scene_manager);
+            }
+
             Storage* fs_api = furi_record_open("storage");
 
             string_t buffer_src;
@@ -57,16 +67,17 @@ bool archive_scene_rename_on_event(void* context, SceneManagerEvent event) {
             string_init_printf(buffer_dst, "%s/%s", path, archive->text_store);
 
             // append extension
-            ArchiveFile_t* file = archive_get_current_file(archive->browser);
-
             string_cat(buffer_dst, known_ext[file->type]);
             storage_common_rename(
                 fs_api, string_get_cstr(buffer_src), string_get_cstr(buffer_dst));
             furi_record_close("storage");
 
             if(file->fav) {
-                archive_favorites_rename(name, string_get_cstr(buffer_dst));
+                archive_favorites_rename(
+                    archive->browser->favorites, name, string_get_cstr(buffer_dst));
             }
+            // Focus renamed file
+            strlcpy(archive->text_store, string_get_cstr(buffer_dst), MAX_NAME_LEN);
 
             string_clear(buffer_src);
             string_clear(buffer_dst);
@@ -84,7 +95,10 @@ void archive_scene_rename_on_exit(void* context) {
     // Clear view
     void* validator_context = text_input_get_validator_callback_context(archive->text_input);
     text_input_set_validator(archive->text_input, NULL, NULL);
-    validator_is_file_free(validator_context);
+    // not set if scene was left from on_enter
+    if(validator_context) {
+        validator_is_file_free(validator_context);
+    }
 
     text_input_reset(archive->text_input);
 }
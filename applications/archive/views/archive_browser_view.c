@@ -49,7 +49,10 @@ static void render_item_menu(Canvas* canvas, ArchiveBrowserViewModel* model) {
     string_init_set_str(menu[2], "Rename");
     string_init_set_str(menu[3], "Delete");
 
-    ArchiveFile_t* selected = files_array_get(model->files, model->idx);
+    ArchiveFile_t* selected = archive_model_get_file(model, model->idx);
+    if(!selected) {
+        return;
+    }
 
     if(!archive_is_known_app(selected->type)) {
         string_set_str(menu[0], "---");
@@ -99,7 +102,7 @@ static void archive_draw_frame(Canvas* canvas, uint16_t idx, bool scrollbar, boo
 static void draw_list(Canvas* canvas, ArchiveBrowserViewModel* model) {
     furi_assert(model);
 
-    size_t array_size = files_array_size(model->files);
+    size_t array_size = model->item_cnt;
     bool scrollbar = array_size > 4;
 
     for(size_t i = 0; i < MIN(array_size, MENU_ITEMS); ++i) {
@@ -108,11 +111,16 @@ static void draw_list(Canvas* canvas, ArchiveBrowserViewModel* model) {
         size_t idx = CLAMP(i + model->list_offset, array_size, 0);
         uint8_t x_offset = (model->move_fav && model->idx == idx) ? MOVE_OFFSET : 0;
 
-        ArchiveFile_t* file = files_array_get(model->files, CLAMP(idx, array_size - 1, 0));
+        // Entries out of loaded window are shown as placeholders until it moves
+        ArchiveFile_t* file = archive_model_get_file(model, CLAMP(idx, array_size - 1, 0));
 
-        strlcpy(cstr_buff, string_get_cstr(file->name), string_size(file->name) + 1);
-        archive_trim_file_path(cstr_buff, archive_is_known_app(file->type));
-        string_init_set_str(str_buff, cstr_buff);
+        if(file) {
+            strlcpy(cstr_buff, string_get_cstr(file->name), string_size(file->name) + 1);
+            archive_trim_file_path(cstr_buff, archive_is_known_app(file->type));
+            string_init_set_str(str_buff, cstr_buff);
+        } else {
+            string_init_set_str(str_buff, "---");
+        }
         elements_string_fit_width(
             canvas, str_buff, (scrollbar ? MAX_LEN_PX - 6 : MAX_LEN_PX) - x_offset);
 
@@ -122,8 +130,10 @@ static void draw_list(Canvas* canvas, ArchiveBrowserViewModel* model) {
             canvas_set_color(canvas, ColorBlack);
         }
 
-        canvas_draw_icon(
-            canvas, 2 + x_offset, 16 + i * FRAME_HEIGHT, ArchiveItemIcons[file->type]);
+        if(file) {
+            canvas_draw_icon(
+                canvas, 2 + x_offset, 16 + i * FRAME_HEIGHT, ArchiveItemIcons[file->type]);
+        }
         canvas_draw_str(canvas, 15 + x_offset, 24 + i * FRAME_HEIGHT, string_get_cstr(str_buff));
         string_clear(str_buff);
     }
@@ -178,8 +188,11 @@ void archive_view_render(Canvas* canvas, void* model) {
 
     archive_render_status_bar(canvas, model);
 
-    if(files_array_size(m->files)) {
+    if(m->item_cnt) {
         draw_list(canvas, m);
+    } else if(m->folder_loading) {
+        canvas_draw_str_aligned(
+            canvas, GUI_DISPLAY_WIDTH / 2, 40, AlignCenter, AlignCenter, "Loading...");
     } else {
         canvas_draw_str_aligned(
             canvas, GUI_DISPLAY_WIDTH / 2, 40, AlignCenter, AlignCenter, "Empty");
@@ -250,8 +263,9 @@ bool archive_view_input(InputEvent* event, void* context) {
         if(event->key == InputKeyUp || event->key == InputKeyDown) {
             with_view_model(
                 browser->view, (ArchiveBrowserViewModel * model) {
-                    uint16_t num_elements = (uint16_t)files_array_size(model->files);
-                    if((event->type == InputTypeShort || event->type == InputTypeRepeat)) {
+                    uint16_t num_elements = model->item_cnt;
+                    if(num_elements &&
+                       (event->type == InputTypeShort || event->type == InputTypeRepeat)) {
                         if(event->key == InputKeyUp) {
                             model->idx = ((model->idx - 1) + num_elements) % num_elements;
                             if(move_fav_mode) {
@@ -269,6 +283,7 @@ bool archive_view_input(InputEvent* event, void* context) {
                     return true;
                 });
             archive_update_offset(browser);
+            archive_update_window(browser);
         }
 
         if(event->key == InputKeyOk) {
@@ -304,6 +319,13 @@ bool archive_view_input(InputEvent* event, void* context) {
     return true;
 }
 
+static void archive_browser_list_loaded_callback(void* context) {
+    ArchiveBrowserView* browser = context;
+    if(browser->callback) {
+        browser->callback(ArchiveBrowserEventListLoaded, browser->context);
+    }
+}
+
 ArchiveBrowserView* browser_alloc() {
     ArchiveBrowserView* browser = malloc(sizeof(ArchiveBrowserView));
     browser->view = view_alloc();
@@ -313,6 +335,10 @@ ArchiveBrowserView* browser_alloc() {
     view_set_input_callback(browser->view, archive_view_input);
 
     string_init(browser->path);
+    browser->favorites = archive_favorites_alloc(ARCHIVE_FAV_PATH, ARCHIVE_FAV_TEMP_PATH);
+    browser->worker = archive_dir_worker_alloc(ARCHIVE_WINDOW_SIZE);
+    archive_dir_worker_set_callback(
+        browser->worker, archive_browser_list_loaded_callback, browser);
 
     with_view_model(
         browser->view, (ArchiveBrowserViewModel * model) {
@@ -326,6 +352,8 @@ ArchiveBrowserView* browser_alloc() {
 void browser_free(ArchiveBrowserView* browser) {
     furi_assert(browser);
 
+    archive_dir_worker_free(browser->worker);
+
     with_view_model(
         browser->view, (ArchiveBrowserViewModel * model) {
             files_array_clear(model->files);
@@ -333,6 +361,7 @@ void browser_free(ArchiveBrowserView* browser) {
         });
 
     string_clear(browser->path);
+    archive_favorites_free(browser->favorites);
 
     view_free(browser->view);
     free(browser);
@@ -8,6 +8,7 @@
 #include <storage/storage.h>
 #include "../helpers/archive_files.h"
 #include "../helpers/archive_favorites.h"
+#include "../helpers/archive_dir_worker.h"
 
 #define MAX_LEN_PX 110
 #define MAX_NAME_LEN 255
@@ -16,6 +17,10 @@
 #define MENU_ITEMS 4
 #define MAX_DEPTH 32
 #define MOVE_OFFSET 5
+/** Entries of folder kept in memory around cursor */
+#define ARCHIVE_WINDOW_SIZE 50
+/** Window is moved when cursor comes this close to its edge */
+#define ARCHIVE_WINDOW_MARGIN 10
 
 typedef enum {
     ArchiveTabFavorites,
@@ -44,6 +49,8 @@ typedef enum {
     ArchiveBrowserEventExitFavMove,
     ArchiveBrowserEventSaveFavMove,
     ArchiveBrowserEventExit,
+    ArchiveBrowserEventFavoritesFlush,
+    ArchiveBrowserEventListLoaded,
 } ArchiveBrowserEvent;
 
 static const uint8_t file_menu_actions[MENU_ITEMS] = {
@@ -69,6 +76,8 @@ struct ArchiveBrowserView {
     void* context;
 
     string_t path;
+    ArchiveFavorites* favorites;
+    ArchiveDirWorker* worker;
 };
 
 typedef struct {
@@ -86,8 +95,21 @@ typedef struct {
     uint16_t last_offset;
     uint8_t depth;
 
+    // Folder entries count, files hold entries [array_offset, array_offset + size)
+    uint16_t item_cnt;
+    uint16_t array_offset;
+    uint16_t load_offset;
+    bool folder_loading;
+    bool list_loading;
 } ArchiveBrowserViewModel;
 
+/** Entry by index in folder, NULL if it is not loaded */
+static inline ArchiveFile_t* archive_model_get_file(ArchiveBrowserViewModel* model, size_t idx) {
+    if(idx < model->array_offset) return NULL;
+    idx -= model->array_offset;
+    return (idx < files_array_size(model->files)) ? files_array_get(model->files, idx) : NULL;
+}
+
 void archive_browser_set_callback(
     ArchiveBrowserView* browser,
     ArchiveBrowserViewCallback callback,
@@ -0,0 +1,496 @@
+#include "bad_usb_bytecode.h"
+#include <toolbox/crc32.h>
+
+#define TAG "BadUsbBytecode"
+
+#define BAD_USB_BYTECODE_MAGIC (0x43425542) // "BUBC"
+#define BAD_USB_BYTECODE_VERSION (1)
+#define BAD_USB_BYTECODE_BUFFER_SIZE (512)
+
+typedef struct {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t id_set;
+    uint16_t line_nb;
+    uint32_t script_size;
+    uint32_t script_crc;
+    FuriHalUsbHidConfig hid_cfg;
+} __attribute__((packed)) BadUsbBytecodeHeader;
+
+typedef struct {
+    Stream* script;
+    Stream* bytecode;
+    BadUsbScriptInfo* info;
+    string_t line;
+    uint8_t buffer[BAD_USB_BYTECODE_BUFFER_SIZE];
+    size_t buffer_len;
+    bool write_error;
+} BadUsbCompiler;
+
+struct BadUsbBytecodeReader {
+    Stream* stream;
+    uint8_t buffer[BAD_USB_BYTECODE_BUFFER_SIZE];
+    size_t buffer_start;
+    size_t buffer_len;
+};
+
+typedef struct {
+    char* name;
+    uint16_t keycode;
+} DuckyKey;
+
+static const DuckyKey ducky_keys[] = {
+    {"CTRL-ALT", KEY_MOD_LEFT_CTRL | KEY_MOD_LEFT_ALT},
+    {"CTRL-SHIFT", KEY_MOD_LEFT_CTRL | KEY_MOD_LEFT_SHIFT},
+    {"ALT-SHIFT", KEY_MOD_LEFT_ALT | KEY_MOD_LEFT_SHIFT},
+    {"ALT-GUI", KEY_MOD_LEFT_ALT | KEY_MOD_LEFT_GUI},
+
+    {"CTRL", KEY_MOD_LEFT_CTRL},
+    {"CONTROL", KEY_MOD_LEFT_CTRL},
+    {"SHIFT", KEY_MOD_LEFT_SHIFT},
+    {"ALT", KEY_MOD_LEFT_ALT},
+    {"GUI", KEY_MOD_LEFT_GUI},
+    {"WINDOWS", KEY_MOD_LEFT_GUI},
+
+    {"DOWNARROW", KEY_DOWN_ARROW},
+    {"DOWN", KEY_DOWN_ARROW},
+    {"LEFTARROW", KEY_LEFT_ARROW},
+    {"LEFT", KEY_LEFT_ARROW},
+    {"RIGHTARROW", KEY_RIGHT_ARROW},
+    {"RIGHT", KEY_RIGHT_ARROW},
+    {"UPARROW", KEY_UP_ARROW},
+    {"UP", KEY_UP_ARROW},
+
+    {"ENTER", KEY_ENTER},
+    {"BREAK", KEY_PAUSE},
+    {"PAUSE", KEY_PAUSE},
+    {"CAPSLOCK", KEY_CAPS_LOCK},
+    {"DELETE", KEY_DELETE},
+    {"BACKSPACE", KEY_BACKSPACE},
+    {"END", KEY_END},
+    {"ESC", KEY_ESC},
+    {"ESCAPE", KEY_ESC},
+    {"HOME", KEY_HOME},
+    {"INSERT", KEY_INSERT},
+    {"NUMLOCK", KEY_NUM_LOCK},
+    {"PAGEUP", KEY_PAGE_UP},
+    {"PAGEDOWN", KEY_PAGE_DOWN},
+    {"PRINTSCREEN", KEY_PRINT},
+    {"SCROLLOCK", KEY_SCROLL_LOCK},
+    {"SPACE", KEY_SPACE},
+    {"TAB", KEY_TAB},
+    {"MENU", KEY_APPLICATION},
+    {"APP", KEY_APPLICATION},
+
+    {"F1", KEY_F1},
+    {"F2", KEY_F2},
+    {"F3", KEY_F3},
+    {"F4", KEY_F4},
+    {"F5", KEY_F5},
+    {"F6", KEY_F6},
+    {"F7", KEY_F7},
+    {"F8", KEY_F8},
+    {"F9", KEY_F9},
+    {"F10", KEY_F10},
+    {"F11", KEY_F11},
+    {"F12", KEY_F12},
+};
+
+static const char ducky_cmd_comment[] = {"REM"};
+static const char ducky_cmd_id[] = {"ID"};
+static const char ducky_cmd_delay[] = {"DELAY "};
+static const char ducky_cmd_string[] = {"STRING "};
+static const char ducky_cmd_defdelay_1[] = {"DEFAULT_DELAY "};
+static const char ducky_cmd_defdelay_2[] = {"DEFAULTDELAY "};
+static const char ducky_cmd_repeat[] = {"REPEAT "};
+
+static const char ducky_cmd_altchar[] = {"ALTCHAR "};
+static const char ducky_cmd_altstr_1[] = {"ALTSTRING "};
+static const char ducky_cmd_altstr_2[] = {"ALTCODE "};
+
+static bool ducky_get_number(const char* param, uint32_t* val) {
+    uint32_t value = 0;
+    if(sscanf(param, "%lu", &value) == 1) {
+        *val = value;
+        return true;
+    }
+    return false;
+}
+
+static uint32_t ducky_get_command_len(const char* line) {
+    uint32_t len = strlen(line);
+    for(uint32_t i = 0; i < len; i++) {
+        if(line[i] == ' ') return i;
+    }
+    return 0;
+}
+
+static bool ducky_is_line_end(const char chr) {
+    return ((chr == ' ') || (chr == '\0') || (chr == '\r') || (chr == '\n'));
+}
+
+static uint16_t ducky_get_keycode(const char* param, bool accept_chars) {
+    for(uint8_t i = 0; i < (sizeof(ducky_keys) / sizeof(ducky_keys[0])); i++) {
+        uint8_t key_cmd_len = strlen(ducky_keys[i].name);
+        if((strncmp(param, ducky_keys[i].name, key_cmd_len) == 0) &&
+           (ducky_is_line_end(param[key_cmd_len]))) {
+            return ducky_keys[i].keycode;
+        }
+    }
+    if((accept_chars) && (strlen(param) > 0)) {
+        return (HID_ASCII_TO_KEY(param[0]) & 0xFF);
+    }
+    return 0;
+}
+
+static bool ducky_set_usb_id(FuriHalUsbHidConfig* hid_cfg, const char* line) {
+    if(sscanf(line, "%lX:%lX", &hid_cfg->vid, &hid_cfg->pid) == 2) {
+        hid_cfg->manuf[0] = '\0';
+        hid_cfg->product[0] = '\0';
+
+        uint8_t id_len = ducky_get_command_len(line);
+        if(!ducky_is_line_end(line[id_len + 1])) {
+            sscanf(
+                &line[id_len + 1], "%31[^\r\n:]:%31[^\r\n]", hid_cfg->manuf, hid_cfg->product);
+        }
+        FURI_LOG_D(
+            TAG,
+            "set id: %04X:%04X mfr:%s product:%s",
+            hid_cfg->vid,
+            hid_cfg->pid,
+            hid_cfg->manuf,
+            hid_cfg->product);
+        return true;
+    }
+    return false;
+}
+
+static bool ducky_is_altchar(const char* charcode) {
+    if(ducky_is_line_end(charcode[0])) return false;
+    for(size_t i = 0; !ducky_is_line_end(charcode[i]); i++) {
+        if((charcode[i] < '0') || (charcode[i] > '9')) return false;
+    }
+    return true;
+}
+
+static bool ducky_is_altstring(const char* param) {
+    for(size_t i = 0; param[i] != '\0'; i++) {
+        if((param[i] >= ' ') && (param[i] <= '~')) return true;
+    }
+    return false;
+}
+
+static void bad_usb_compiler_write(BadUsbCompiler* compiler, const void* data, size_t size) {
+    const uint8_t* ptr = data;
+    while(size > 0) {
+        if(compiler->buffer_len == BAD_USB_BYTECODE_BUFFER_SIZE) {
+            if(stream_write(compiler->bytecode, compiler->buffer, compiler->buffer_len) !=
+               compiler->buffer_len) {
+                compiler->write_error = true;
+            }
+            compiler->buffer_len = 0;
+        }
+        size_t len = MIN(size, BAD_USB_BYTECODE_BUFFER_SIZE - compiler->buffer_len);
+        memcpy(&compiler->buffer[compiler->buffer_len], ptr, len);
+        compiler->buffer_len += len;
+        ptr += len;
+        size -= len;
+    }
+}
+
+static void bad_usb_compiler_write_op(
+    BadUsbCompiler* compiler,
+    BadUsbOpType type,
+    uint32_t value,
+    const char* text) {
+    uint8_t op_type = type;
+    bad_usb_compiler_write(compiler, &op_type, sizeof(op_type));
+
+    if(type == BadUsbOpKey) {
+        uint16_t keycode = value;
+        bad_usb_compiler_write(compiler, &keycode, sizeof(keycode));
+    } else if(
+        (type == BadUsbOpDelay) || (type == BadUsbOpDefaultDelay) ||
+        (type == BadUsbOpRepeat)) {
+        bad_usb_compiler_write(compiler, &value, sizeof(value));
+    } else if(
+        (type == BadUsbOpString) || (type == BadUsbOpAltChar) ||
+        (type == BadUsbOpAltString)) {
+        size_t len = strlen(text);
+        uint16_t text_len = MIN(len, UINT16_MAX);
+        bad_usb_compiler_write(compiler, &text_len, sizeof(text_len));
+        bad_usb_compiler_write(compiler, text, text_len);
+    }
+}
+
+static void bad_usb_compiler_line(BadUsbCompiler* compiler, const char* line) {
+    uint32_t value = 0;
+
+    // Skip spaces and tabs, skip empty lines
+    while((*line == ' ') || (*line == '\t')) line++;
+    if(*line == '\0') return;
+
+    compiler->info->line_nb++;
+    FURI_LOG_D(TAG, "line:%s", line);
+
+    const char* param = &line[ducky_get_command_len(line) + 1];
+    if(strncmp(line, ducky_cmd_comment, strlen(ducky_cmd_comment)) == 0) {
+        // REM - comment line
+        bad_usb_compiler_write_op(compiler, BadUsbOpNop, 0, NULL);
+    } else if(strncmp(line, ducky_cmd_id, strlen(ducky_cmd_id)) == 0) {
+        // ID - applied before script start, only at first line
+        if(compiler->info->line_nb == 1) {
+            compiler->info->id_set =
+                ducky_set_usb_id(&compiler->info->hid_cfg, &line[strlen(ducky_cmd_id) + 1]);
+        }
+        bad_usb_compiler_write_op(compiler, BadUsbOpNop, 0, NULL);
+    } else if(strncmp(line, ducky_cmd_delay, strlen(ducky_cmd_delay)) == 0) {
+        // DELAY
+        if(ducky_get_number(param, &value) && (value > 0)) {
+            bad_usb_compiler_write_op(compiler, BadUsbOpDelay, value, NULL);
+        } else {
+            bad_usb_compiler_write_op(compiler, BadUsbOpError, 0, NULL);
+        }
+    } else if(
+        (strncmp(line, ducky_cmd_defdelay_1, strlen(ducky_cmd_defdelay_1)) == 0) ||
+        (strncmp(line, ducky_cmd_defdelay_2, strlen(ducky_cmd_defdelay_2)) == 0)) {
+        // DEFAULT_DELAY
+        if(ducky_get_number(param, &value)) {
+            bad_usb_compiler_write_op(compiler, BadUsbOpDefaultDelay, value, NULL);
+        } else {
+            bad_usb_compiler_write_op(compiler, BadUsbOpError, 0, NULL);
+        }
+    } else if(strncmp(line, ducky_cmd_string, strlen(ducky_cmd_string)) == 0) {
+        // STRING
+        bad_usb_compiler_write_op(compiler, BadUsbOpString, 0, param);
+    } else if(strncmp(line, ducky_cmd_altchar, strlen(ducky_cmd_altchar)) == 0) {
+        // ALTCHAR
+        if(ducky_is_altchar(param)) {
+            bad_usb_compiler_write_op(compiler, BadUsbOpAltChar, 0, param);
+        } else {
+            bad_usb_compiler_write_op(compiler, BadUsbOpError, 0, NULL);
+        }
+    } else if(
+        (strncmp(line, ducky_cmd_altstr_1, strlen(ducky_cmd_altstr_1)) == 0) ||
+        (strncmp(line, ducky_cmd_altstr_2, strlen(ducky_cmd_altstr_2)) == 0)) {
+        // ALTSTRING
+        if(ducky_is_altstring(param)) {
+            bad_usb_compiler_write_op(compiler, BadUsbOpAltString, 0, param);
+        } else {
+            bad_usb_compiler_write_op(compiler, BadUsbOpError, 0, NULL);
+        }
+    } else if(strncmp(line, ducky_cmd_repeat, strlen(ducky_cmd_repeat)) == 0) {
+        // REPEAT
+        if(ducky_get_number(param, &value)) {
+            bad_usb_compiler_write_op(compiler, BadUsbOpRepeat, value, NULL);
+        } else {
+            bad_usb_compiler_write_op(compiler, BadUsbOpError, 0, NULL);
+        }
+    } else {
+        // Special keys + modifiers
+        uint16_t key = ducky_get_keycode(line, false);
+        if(key == KEY_NONE) {
+            bad_usb_compiler_write_op(compiler, BadUsbOpError, 0, NULL);
+            return;
+        }
+        if((key & 0xFF00) != 0) {
+            // It's a modifier key
+            key |= ducky_get_keycode(param, true);
+        }
+        bad_usb_compiler_write_op(compiler, BadUsbOpKey, key, NULL);
+    }
+}
+
+static void bad_usb_compiler_line_end(BadUsbCompiler* compiler) {
+    // Drop CR of CRLF line end
+    size_t len = string_size(compiler->line);
+    if((len > 0) && (string_get_char(compiler->line, len - 1) == '\r')) {
+        string_left(compiler->line, len - 1);
+    }
+    bad_usb_compiler_line(compiler, string_get_cstr(compiler->line));
+    string_reset(compiler->line);
+}
+
+void bad_usb_script_info_get(Stream* script, BadUsbScriptInfo* info) {
+    furi_assert(script);
+    furi_assert(info);
+
+    uint8_t* buffer = malloc(BAD_USB_BYTECODE_BUFFER_SIZE);
+    info->script_size = 0;
+    info->script_crc = 0;
+
+    size_t len;
+    while((len = stream_read(script, buffer, BAD_USB_BYTECODE_BUFFER_SIZE)) > 0) {
+        info->script_crc = crc32_calc_buffer(info->script_crc, buffer, len);
+        info->script_size += len;
+    }
+
+    free(buffer);
+}
+
+bool bad_usb_bytecode_compile(Stream* script, Stream* bytecode, BadUsbScriptInfo* info) {
+    furi_assert(script);
+    furi_assert(bytecode);
+    furi_assert(info);
+
+    memset(info, 0, sizeof(BadUsbScriptInfo));
+
+    // Header is written last, incomplete bytecode is not valid
+    BadUsbBytecodeHeader header;
+    memset(&header, 0, sizeof(header));
+    stream_clean(bytecode);
+    bool state = (stream_write(bytecode, (uint8_t*)&header, sizeof(header)) == sizeof(header));
+
+    BadUsbCompiler* compiler = malloc(sizeof(BadUsbCompiler));
+    compiler->script = script;
+    compiler->bytecode = bytecode;
+    compiler->info = info;
+    compiler->buffer_len = 0;
+    compiler->write_error = false;
+    string_init(compiler->line);
+
+    uint8_t* read_buffer = malloc(BAD_USB_BYTECODE_BUFFER_SIZE);
+    size_t len;
+    while(state && (len = stream_read(script, read_buffer, BAD_USB_BYTECODE_BUFFER_SIZE)) > 0) {
+        info->script_crc = crc32_calc_buffer(info->script_crc, read_buffer, len);
+        info->script_size += len;
+        for(size_t i = 0; i < len; i++) {
+            if(read_buffer[i] == '\n') {
+                bad_usb_compiler_line_end(compiler);
+            } else {
+                string_push_back(compiler->line, read_buffer[i]);
+            }
+        }
+        if(compiler->write_error) state = false;
+    }
+    bad_usb_compiler_line_end(compiler);
+    free(read_buffer);
+
+    if(compiler->buffer_len > 0) {
+        if(stream_write(bytecode, compiler->buffer, compiler->buffer_len) !=
+           compiler->buffer_len) {
+            compiler->write_error = true;
+        }
+    }
+    if(compiler->write_error) state = false;
+    string_clear(compiler->line);
+    free(compiler);
+
+    if(state) {
+        header.magic = BAD_USB_BYTECODE_MAGIC;
+        header.version = BAD_USB_BYTECODE_VERSION;
+        header.id_set = info->id_set;
+        header.line_nb = info->line_nb;
+        header.script_size = info->script_size;
+        header.script_crc = info->script_crc;
+        memcpy(&header.hid_cfg, &info->hid_cfg, sizeof(FuriHalUsbHidConfig));
+        state = stream_rewind(bytecode) &&
+                (stream_write(bytecode, (uint8_t*)&header, sizeof(header)) == sizeof(header));
+    }
+
+    FURI_LOG_I(
+        TAG,
+        "Compiled %lu lines, %lu bytes: %s",
+        (uint32_t)info->line_nb,
+        info->script_size,
+        state ? "ok" : "write error");
+    return state;
+}
+
+BadUsbBytecodeReader* bad_usb_bytecode_reader_alloc(Stream* bytecode) {
+    furi_assert(bytecode);
+    BadUsbBytecodeReader* reader = malloc(sizeof(BadUsbBytecodeReader));
+    reader->stream = bytecode;
+    reader->buffer_start = 0;
+    reader->buffer_len = 0;
+    return reader;
+}
+
+void bad_usb_bytecode_reader_free(BadUsbBytecodeReader* reader) {
+    furi_assert(reader);
+    free(reader);
+}
+
+static bool bad_usb_bytecode_reader_read(BadUsbBytecodeReader* reader, void* data, size_t size) {
+    uint8_t* ptr = data;
+    while(size > 0) {
+        if(reader->buffer_len == 0) {
+            reader->buffer_start = 0;
+            reader->buffer_len =
+                stream_read(reader->stream, reader->buffer, BAD_USB_BYTECODE_BUFFER_SIZE);
+            if(reader->buffer_len == 0) return false;
+        }
+        size_t len = MIN(size, reader->buffer_len);
+        memcpy(ptr, &reader->buffer[reader->buffer_start], len);
+        reader->buffer_start += len;
+        reader->buffer_len -= len;
+        ptr += len;
+        size -= len;
+    }
+    return true;
+}
+
+bool bad_usb_bytecode_reader_get_info(BadUsbBytecodeReader* reader, BadUsbScriptInfo* info) {
+    furi_assert(reader);
+    furi_assert(info);
+
+    BadUsbBytecodeHeader header;
+    reader->buffer_len = 0;
+    if(!stream_rewind(reader->stream)) return false;
+    if(stream_read(reader->stream, (uint8_t*)&header, sizeof(header)) != sizeof(header)) {
+        return false;
+    }
+    if((header.magic != BAD_USB_BYTECODE_MAGIC) ||
+       (header.version != BAD_USB_BYTECODE_VERSION)) {
+        return false;
+    }
+
+    info->script_size = header.script_size;
+    info->script_crc = header.script_crc;
+    info->line_nb = header.line_nb;
+    info->id_set = header.id_set;
+    memcpy(&info->hid_cfg, &header.hid_cfg, sizeof(FuriHalUsbHidConfig));
+    return true;
+}
+
+bool bad_usb_bytecode_reader_rewind(BadUsbBytecodeReader* reader) {
+    furi_assert(reader);
+    reader->buffer_len = 0;
+    return stream_seek(reader->stream, sizeof(BadUsbBytecodeHeader), StreamOffsetFromStart);
+}
+
+bool bad_usb_bytecode_reader_next(BadUsbBytecodeReader* reader, BadUsbOp* op) {
+    furi_assert(reader);
+    furi_assert(op);
+
+    uint8_t op_type;
+    if(!bad_usb_bytecode_reader_read(reader, &op_type, sizeof(op_type))) return false;
+
+    op->type = op_type;
+    op->value = 0;
+    string_reset(op->text);
+
+    if(op->type == BadUsbOpKey) {
+        uint16_t keycode;
+        if(!bad_usb_bytecode_reader_read(reader, &keycode, sizeof(keycode))) return false;
+        op->value = keycode;
+    } else if(
+        (op->type == BadUsbOpDelay) || (op->type == BadUsbOpDefaultDelay) ||
+        (op->type == BadUsbOpRepeat)) {
+        if(!bad_usb_bytecode_reader_read(reader, &op->value, sizeof(op->value))) return false;
+    } else if(
+        (op->type == BadUsbOpString) || (op->type == BadUsbOpAltChar) ||
+        (op->type == BadUsbOpAltString)) {
+        uint16_t text_len;
+        if(!bad_usb_bytecode_reader_read(reader, &text_len, sizeof(text_len))) return false;
+        for(uint16_t i = 0; i < text_len; i++) {
+            char chr;
+            if(!bad_usb_bytecode_reader_read(reader, &chr, sizeof(chr))) return false;
+            string_push_back(op->text, chr);
+        }
+    } else if((op->type != BadUsbOpNop) && (op->type != BadUsbOpError)) {
+        return false;
+    }
+
+    return true;
+}
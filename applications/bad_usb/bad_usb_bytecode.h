@@ -0,0 +1,107 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <furi.h>
+#include <furi_hal_usb_hid.h>
+#include <m-string.h>
+#include <toolbox/stream/stream.h>
+
+/** Bytecode file extension, file is kept beside the script */
+#define BAD_USB_BYTECODE_EXTENSION ".bc"
+
+typedef struct BadUsbBytecodeReader BadUsbBytecodeReader;
+
+/** Script line compiled to one operation */
+typedef enum {
+    BadUsbOpNop, /**< REM, ID and empty lines */
+    BadUsbOpError, /**< unknown command or bad argument */
+    BadUsbOpKey, /**< value: key code with modifiers */
+    BadUsbOpDelay, /**< value: delay in ms */
+    BadUsbOpDefaultDelay, /**< value: delay in ms */
+    BadUsbOpRepeat, /**< value: repeat count of previous line */
+    BadUsbOpString, /**< text: string to type */
+    BadUsbOpAltChar, /**< text: decimal char code */
+    BadUsbOpAltString, /**< text: string to type with alt codes */
+} BadUsbOpType;
+
+typedef struct {
+    BadUsbOpType type;
+    uint32_t value;
+    string_t text;
+} BadUsbOp;
+
+/** Script properties stored in bytecode header */
+typedef struct {
+    uint32_t script_size;
+    uint32_t script_crc;
+    uint16_t line_nb;
+    bool id_set;
+    FuriHalUsbHidConfig hid_cfg;
+} BadUsbScriptInfo;
+
+/** Get script size and CRC, bytecode is valid for script with the same ones
+ *
+ * @param      script  script stream, read from current position
+ * @param      info    script info, only size and CRC are set
+ */
+void bad_usb_script_info_get(Stream* script, BadUsbScriptInfo* info);
+
+/** Compile script in one pass
+ *
+ * Every non-empty line is compiled to one operation, lines with errors are
+ * compiled to BadUsbOpError so script fails when it reaches them.
+ *
+ * @param      script    script stream, read from current position
+ * @param      bytecode  bytecode stream, written from current position
+ * @param      info      script info, filled by compiler
+ *
+ * @return     true on success, false on bytecode write error
+ */
+bool bad_usb_bytecode_compile(Stream* script, Stream* bytecode, BadUsbScriptInfo* info);
+
+/** Allocate bytecode reader and check bytecode header
+ *
+ * @param      bytecode  bytecode stream, must be freed after reader
+ *
+ * @return     BadUsbBytecodeReader instance
+ */
+BadUsbBytecodeReader* bad_usb_bytecode_reader_alloc(Stream* bytecode);
+
+/** Free bytecode reader
+ *
+ * @param      reader  BadUsbBytecodeReader instance
+ */
+void bad_usb_bytecode_reader_free(BadUsbBytecodeReader* reader);
+
+/** Read bytecode header
+ *
+ * @param      reader  BadUsbBytecodeReader instance
+ * @param      info    script info from header
+ *
+ * @return     true if header is valid
+ */
+bool bad_usb_bytecode_reader_get_info(BadUsbBytecodeReader* reader, BadUsbScriptInfo* info);
+
+/** Go to first operation
+ *
+ * @param      reader  BadUsbBytecodeReader instance
+ *
+ * @return     true on success
+ */
+bool bad_usb_bytecode_reader_rewind(BadUsbBytecodeReader* reader);
+
+/** Read next operation
+ *
+ * @param      reader  BadUsbBytecodeReader instance
+ * @param      op      operation, text must be initialized
+ *
+ * @return     true on success, false at the end of bytecode or on error
+ */
+bool bad_usb_bytecode_reader_next(BadUsbBytecodeReader* reader, BadUsbOp* op);
+
+#ifdef __cplusplus
+}
+#endif
@@ -5,16 +5,18 @@
 #include <lib/toolbox/args.h>
 #include <furi_hal_usb_hid.h>
 #include <storage/storage.h>
+#include <toolbox/stream/file_stream.h>
+#include <toolbox/stream/string_stream.h>
 #include "bad_usb_script.h"
+#include "bad_usb_bytecode.h"
 #include <dolphin/dolphin.h>
 
 #define TAG "BadUSB"
 #define WORKER_TAG TAG "Worker"
-#define FILE_BUFFER_LEN 16
+#define BAD_USB_POLL_INTERVAL 1
 
 #define SCRIPT_STATE_ERROR (-1)
 #define SCRIPT_STATE_END (-2)
-#define SCRIPT_STATE_NEXT_LINE (-3)
 
 typedef enum {
     WorkerEvtToggle = (1 << 0),
@@ -29,90 +31,14 @@ struct BadUsbScript {
     string_t file_path;
     uint32_t defdelay;
     FuriThread* thread;
-    uint8_t file_buf[FILE_BUFFER_LEN + 1];
-    uint8_t buf_start;
-    uint8_t buf_len;
-    bool file_end;
-    string_t line;
+    Stream* bytecode;
+    BadUsbBytecodeReader* reader;
+    BadUsbOp op;
 
-    string_t line_prev;
+    BadUsbOp op_prev;
     uint32_t repeat_cnt;
 };
 
-typedef struct {
-    char* name;
-    uint16_t keycode;
-} DuckyKey;
-
-static const DuckyKey ducky_keys[] = {
-    {"CTRL-ALT", KEY_MOD_LEFT_CTRL | KEY_MOD_LEFT_ALT},
-    {"CTRL-SHIFT", KEY_MOD_LEFT_CTRL | KEY_MOD_LEFT_SHIFT},
-    {"ALT-SHIFT", KEY_MOD_LEFT_ALT | KEY_MOD_LEFT_SHIFT},
-    {"ALT-GUI", KEY_MOD_LEFT_ALT | KEY_MOD_LEFT_GUI},
-
-    {"CTRL", KEY_MOD_LEFT_CTRL},
-    {"CONTROL", KEY_MOD_LEFT_CTRL},
-    {"SHIFT", KEY_MOD_LEFT_SHIFT},
-    {"ALT", KEY_MOD_LEFT_ALT},
-    {"GUI", KEY_MOD_LEFT_GUI},
-    {"WINDOWS", KEY_MOD_LEFT_GUI},
-
-    {"DOWNARROW", KEY_DOWN_ARROW},
-    {"DOWN", KEY_DOWN_ARROW},
-    {"LEFTARROW", KEY_LEFT_ARROW},
-    {"LEFT", KEY_LEFT_ARROW},
-    {"RIGHTARROW", KEY_RIGHT_ARROW},
-    {"RIGHT", KEY_RIGHT_ARROW},
-    {"UPARROW", KEY_UP_ARROW},
-    {"UP", KEY_UP_ARROW},
-
-    {"ENTER", KEY_ENTER},
-    {"BREAK", KEY_PAUSE},
-    {"PAUSE", KEY_PAUSE},
-    {"CAPSLOCK", KEY_CAPS_LOCK},
-    {"DELETE", KEY_DELETE},
-    {"BACKSPACE", KEY_BACKSPACE},
-    {"END", KEY_END},
-    {"ESC", KEY_ESC},
-    {"ESCAPE", KEY_ESC},
-    {"HOME", KEY_HOME},
-    {"INSERT", KEY_INSERT},
-    {"NUMLOCK", KEY_NUM_LOCK},
-    {"PAGEUP", KEY_PAGE_UP},
-    {"PAGEDOWN", KEY_PAGE_DOWN},
-    {"PRINTSCREEN", KEY_PRINT},
-    {"SCROLLOCK", KEY_SCROLL_LOCK},
-    {"SPACE", KEY_SPACE},
-    {"TAB", KEY_TAB},
-    {"MENU", KEY_APPLICATION},
-    {"APP", KEY_APPLICATION},
-
-    {"F1", KEY_F1},
-    {"F2", KEY_F2},
-    {"F3", KEY_F3},
-    {"F4", KEY_F4},
-    {"F5", KEY_F5},
-    {"F6", KEY_F6},
-    {"F7", KEY_F7},
-    {"F8", KEY_F8},
-    {"F9", KEY_F9},
-    {"F10", KEY_F10},
-    {"F11", KEY_F11},
-    {"F12", KEY_F12},
-};
-
-static const char ducky_cmd_comment[] = {"REM"};
-static const char ducky_cmd_id[] = {"ID"};
-static const char ducky_cmd_delay[] = {"DELAY "};
-static const char ducky_cmd_string[] = {"STRING "};
-static const char ducky_cmd_defdelay_1[] = {"DEFAULT_DELAY "};
-static const char ducky_cmd_defdelay_2[] = {"DEFAULTDELAY "};
-static const char ducky_cmd_repeat[] = {"REPEAT "};
-
-static const char ducky_cmd_altchar[] = {"ALTCHAR "};
-static const char ducky_cmd_altstr_1[] = {"ALTSTRING "};
-static const char ducky_cmd_altstr_2[] = {"ALTCODE "};
-
 static const uint8_t numpad_keys[10] = {
     KEYPAD_0,
     KEYPAD_1,
@@ -126,23 +52,6 @@ static const uint8_t numpad_keys[10] = {
     KEYPAD_9,
 };
 
-static bool ducky_get_number(const char* param, uint32_t* val) {
-    uint32_t value = 0;
-    if(sscanf(param, "%lu", &value) == 1) {
-        *val = value;
-        return true;
-    }
-    return false;
-}
-
-static uint32_t ducky_get_command_len(const char* line) {
-    uint32_t len = strlen(line);
-    for(uint32_t i = 0; i < len; i++) {
-        if(line[i] == ' ') return i;
-    }
-    return 0;
-}
-
 static bool ducky_is_line_end(const char chr) {
     return ((chr == ' ') || (chr == '\0') || (chr == '\r') || (chr == '\n'));
 }
@@ -207,185 +116,125 @@ static bool ducky_string(const char* param) {
     while(param[i] != '\0') {
         uint16_t keycode = HID_ASCII_TO_KEY(param[i]);
         if(keycode != KEY_NONE) {
-            furi_hal_hid_kb_press(keycode);
-            furi_hal_hid_kb_release(keycode);
+            furi_hal_hid_kb_queue_key(keycode);
         }
         i++;
     }
+    furi_hal_hid_kb_queue_flush();
     return true;
 }
 
-static uint16_t ducky_get_keycode(const char* param, bool accept_chars) {
-    for(uint8_t i = 0; i < (sizeof(ducky_keys) / sizeof(ducky_keys[0])); i++) {
-        uint8_t key_cmd_len = strlen(ducky_keys[i].name);
-        if((strncmp(param, ducky_keys[i].name, key_cmd_len) == 0) &&
-           (ducky_is_line_end(param[key_cmd_len]))) {
-            return ducky_keys[i].keycode;
-        }
-    }
-    if((accept_chars) && (strlen(param) > 0)) {
-        return (HID_ASCII_TO_KEY(param[0]) & 0xFF);
-    }
-    return 0;
-}
-
-static int32_t ducky_parse_line(BadUsbScript* bad_usb, string_t line) {
-    uint32_t line_len = string_size(line);
-    const char* line_tmp = string_get_cstr(line);
+static int32_t ducky_execute_op(BadUsbScript* bad_usb, BadUsbOp* op) {
+    const char* text = string_get_cstr(op->text);
     bool state = false;
 
-    for(uint32_t i = 0; i < line_len; i++) {
-        if((line_tmp[i] != ' ') && (line_tmp[i] != '\t') && (line_tmp[i] != '\n')) {
-            line_tmp = &line_tmp[i];
-            break; // Skip spaces and tabs
-        }
-        if(i == line_len - 1) return SCRIPT_STATE_NEXT_LINE; // Skip empty lines
-    }
-
-    FURI_LOG_D(WORKER_TAG, "line:%s", line_tmp);
-
-    // General commands
-    if(strncmp(line_tmp, ducky_cmd_comment, strlen(ducky_cmd_comment)) == 0) {
-        // REM - comment line
-        return (0);
-    } else if(strncmp(line_tmp, ducky_cmd_id, strlen(ducky_cmd_id)) == 0) {
-        // ID - executed in ducky_script_preload
-        return (0);
-    } else if(strncmp(line_tmp, ducky_cmd_delay, strlen(ducky_cmd_delay)) == 0) {
-        // DELAY
-        line_tmp = &line_tmp[ducky_get_command_len(line_tmp) + 1];
-        uint32_t delay_val = 0;
-        state = ducky_get_number(line_tmp, &delay_val);
-        if((state) && (delay_val > 0)) {
-            return (int32_t)delay_val;
-        }
-        return SCRIPT_STATE_ERROR;
-    } else if(
-        (strncmp(line_tmp, ducky_cmd_defdelay_1, strlen(ducky_cmd_defdelay_1)) == 0) ||
-        (strncmp(line_tmp, ducky_cmd_defdelay_2, strlen(ducky_cmd_defdelay_2)) == 0)) {
-        // DEFAULT_DELAY
-        line_tmp = &line_tmp[ducky_get_command_len(line_tmp) + 1];
-        state = ducky_get_number(line_tmp, &bad_usb->defdelay);
+    switch(op->type) {
+    case BadUsbOpNop:
+        return 0;
+    case BadUsbOpKey:
+        furi_hal_hid_kb_press(op->value);
+        furi_hal_hid_kb_release(op->value);
+        return 0;
+    case BadUsbOpDelay:
+        return (int32_t)op->value;
+    case BadUsbOpDefaultDelay:
+        bad_usb->defdelay = op->value;
+        return 0;
+    case BadUsbOpRepeat:
+        bad_usb->repeat_cnt = op->value;
+        return 0;
+    case BadUsbOpString:
+        state = ducky_string(text);
         return (state) ? (0) : SCRIPT_STATE_ERROR;
-    } else if(strncmp(line_tmp, ducky_cmd_string, strlen(ducky_cmd_string)) == 0) {
-        // STRING
-        line_tmp = &line_tmp[ducky_get_command_len(line_tmp) + 1];
-        state = ducky_string(line_tmp);
-        return (state) ? (0) : SCRIPT_STATE_ERROR;
-    } else if(strncmp(line_tmp, ducky_cmd_altchar, strlen(ducky_cmd_altchar)) == 0) {
-        // ALTCHAR
-        line_tmp = &line_tmp[ducky_get_command_len(line_tmp) + 1];
+    case BadUsbOpAltChar:
         ducky_numlock_on();
-        state = ducky_altchar(line_tmp);
+        state = ducky_altchar(text);
         return (state) ? (0) : SCRIPT_STATE_ERROR;
-    } else if(
-        (strncmp(line_tmp, ducky_cmd_altstr_1, strlen(ducky_cmd_altstr_1)) == 0) ||
-        (strncmp(line_tmp, ducky_cmd_altstr_2, strlen(ducky_cmd_altstr_2)) == 0)) {
-        // ALTSTRING
-        line_tmp = &line_tmp[ducky_get_command_len(line_tmp) + 1];
+    case BadUsbOpAltString:
         ducky_numlock_on();
-        state = ducky_altstring(line_tmp);
-        return (state) ? (0) : SCRIPT_STATE_ERROR;
-    } else if(strncmp(line_tmp, ducky_cmd_repeat, strlen(ducky_cmd_repeat)) == 0) {
-        // REPEAT
-        line_tmp = &line_tmp[ducky_get_command_len(line_tmp) + 1];
-        state = ducky_get_number(line_tmp, &bad_usb->repeat_cnt);
+        state = ducky_altstring(text);
         return (state) ? (0) : SCRIPT_STATE_ERROR;
-    } else {
-        // Special keys + modifiers
-        uint16_t key = ducky_get_keycode(line_tmp, false);
-        if(key == KEY_NONE) return SCRIPT_STATE_ERROR;
-        if((key & 0xFF00) != 0) {
-            // It's a modifier key
-            line_tmp = &line_tmp[ducky_get_command_len(line_tmp) + 1];
-            key |= ducky_get_keycode(line_tmp, true);
-        }
-        furi_hal_hid_kb_press(key);
-        furi_hal_hid_kb_release(key);
-        return (0);
+    default:
+        return SCRIPT_STATE_ERROR;
     }
-    return SCRIPT_STATE_ERROR;
 }
 
-static bool ducky_set_usb_id(BadUsbScript* bad_usb, const char* line) {
-    if(sscanf(line, "%lX:%lX", &bad_usb->hid_cfg.vid, &bad_usb->hid_cfg.pid) == 2) {
-        bad_usb->hid_cfg.manuf[0] = '\0';
-        bad_usb->hid_cfg.product[0] = '\0';
-
-        uint8_t id_len = ducky_get_command_len(line);
-        if(!ducky_is_line_end(line[id_len + 1])) {
-            sscanf(
-                &line[id_len + 1],
-                "%31[^\r\n:]:%31[^\r\n]",
-                bad_usb->hid_cfg.manuf,
-                bad_usb->hid_cfg.product);
-        }
-        FURI_LOG_D(
-            WORKER_TAG,
-            "set id: %04X:%04X mfr:%s product:%s",
-            bad_usb->hid_cfg.vid,
-            bad_usb->hid_cfg.pid,
-            bad_usb->hid_cfg.manuf,
-            bad_usb->hid_cfg.product);
-        return true;
-    }
-    return false;
-}
+/* Bytecode is kept in RAM if it can't be stored next to script, e.g. on read-only card */
+static bool
+    ducky_script_compile_to_ram(BadUsbScript* bad_usb, Stream* script, BadUsbScriptInfo* info) {
+    bad_usb_bytecode_reader_free(bad_usb->reader);
+    stream_free(bad_usb->bytecode);
+    bad_usb->bytecode = string_stream_alloc();
+    bad_usb->reader = bad_usb_bytecode_reader_alloc(bad_usb->bytecode);
 
-static bool ducky_script_preload(BadUsbScript* bad_usb, File* script_file) {
-    uint8_t ret = 0;
-    uint32_t line_len = 0;
+    return stream_rewind(script) && bad_usb_bytecode_compile(script, bad_usb->bytecode, info) &&
+           bad_usb_bytecode_reader_get_info(bad_usb->reader, info);
+}
 
-    string_reset(bad_usb->line);
+static bool ducky_script_preload(
+    BadUsbScript* bad_usb,
+    Storage* storage,
+    Stream* script,
+    string_t bytecode_path) {
+    BadUsbScriptInfo script_info;
+    BadUsbScriptInfo info;
+    bool valid = false;
+
+    // Bytecode is compiled again only when script is changed
+    bad_usb_script_info_get(script, &script_info);
+    if(file_stream_open(
+           bad_usb->bytecode, string_get_cstr(bytecode_path), FSAM_READ, FSOM_OPEN_EXISTING)) {
+        valid = bad_usb_bytecode_reader_get_info(bad_usb->reader, &info) &&
+                (info.script_size == script_info.script_size) &&
+                (info.script_crc == script_info.script_crc);
+    }
 
-    do {
-        ret = storage_file_read(script_file, bad_usb->file_buf, FILE_BUFFER_LEN);
-        for(uint16_t i = 0; i < ret; i++) {
-            if(bad_usb->file_buf[i] == '\n' && line_len > 0) {
-                bad_usb->st.line_nb++;
-                line_len = 0;
-            } else {
-                if(bad_usb->st.line_nb == 0) { // Save first line
-                    string_push_back(bad_usb->line, bad_usb->file_buf[i]);
-                }
-                line_len++;
-            }
-        }
-        if(storage_file_eof(script_file)) {
-            if(line_len > 0) {
-                bad_usb->st.line_nb++;
-                break;
-            }
+    if(!valid) {
+        FURI_LOG_I(WORKER_TAG, "Compiling script");
+        file_stream_close(bad_usb->bytecode);
+        if(file_stream_open(
+               bad_usb->bytecode,
+               string_get_cstr(bytecode_path),
+               FSAM_READ_WRITE,
+               FSOM_CREATE_ALWAYS)) {
+            valid = stream_rewind(script) &&
+                    bad_usb_bytecode_compile(script, bad_usb->bytecode, &info) &&
+                    bad_usb_bytecode_reader_get_info(bad_usb->reader, &info);
         }
-    } while(ret > 0);
+    }
 
-    const char* line_tmp = string_get_cstr(bad_usb->line);
-    bool id_set = false; // Looking for ID command at first line
-    if(strncmp(line_tmp, ducky_cmd_id, strlen(ducky_cmd_id)) == 0) {
-        id_set = ducky_set_usb_id(bad_usb, &line_tmp[strlen(ducky_cmd_id) + 1]);
+    if(!valid) {
+        FURI_LOG_W(WORKER_TAG, "Bytecode write error, compiling to RAM");
+        file_stream_close(bad_usb->bytecode);
+        storage_simply_remove(storage, string_get_cstr(bytecode_path));
+        valid = ducky_script_compile_to_ram(bad_usb, script, &info);
     }
 
-    if(id_set) {
+    if(!valid) {
+        FURI_LOG_E(WORKER_TAG, "Script compile error");
+        return false;
+    }
+
+    bad_usb->st.line_nb = info.line_nb;
+
+    furi_hal_hid_set_poll_interval(BAD_USB_POLL_INTERVAL);
+    if(info.id_set) {
+        memcpy(&bad_usb->hid_cfg, &info.hid_cfg, sizeof(FuriHalUsbHidConfig));
         furi_check(furi_hal_usb_set_config(&usb_hid, &bad_usb->hid_cfg));
     } else {
         furi_check(furi_hal_usb_set_config(&usb_hid, NULL));
     }
 
-    storage_file_seek(script_file, 0, true);
-    string_reset(bad_usb->line);
-
     return true;
 }
 
-static int32_t ducky_script_execute_next(BadUsbScript* bad_usb, File* script_file) {
+static int32_t ducky_script_execute_next(BadUsbScript* bad_usb) {
     int32_t delay_val = 0;
 
     if(bad_usb->repeat_cnt > 0) {
         bad_usb->repeat_cnt--;
-        delay_val = ducky_parse_line(bad_usb, bad_usb->line_prev);
-        if(delay_val == SCRIPT_STATE_NEXT_LINE) { // Empty line
-            return 0;
-        } else if(delay_val < 0) { // Script error
+        delay_val = ducky_execute_op(bad_usb, &bad_usb->op_prev);
+        if(delay_val < 0) { // Script error
             bad_usb->st.error_line = bad_usb->st.line_cur - 1;
             FURI_LOG_E(WORKER_TAG, "Unknown command at line %lu", bad_usb->st.line_cur - 1);
             return SCRIPT_STATE_ERROR;
@@ -394,45 +243,21 @@ static int32_t ducky_script_execute_next(BadUsbScript* bad_usb, File* script_fil
         }
     }
 
-    string_set(bad_usb->line_prev, bad_usb->line);
-    string_reset(bad_usb->line);
+    bad_usb->op_prev.type = bad_usb->op.type;
+    bad_usb->op_prev.value = bad_usb->op.value;
+    string_swap(bad_usb->op_prev.text, bad_usb->op.text);
 
-    while(1) {
-        if(bad_usb->buf_len == 0) {
-            bad_usb->buf_len = storage_file_read(script_file, bad_usb->file_buf, FILE_BUFFER_LEN);
-            if(storage_file_eof(script_file)) {
-                if((bad_usb->buf_len < FILE_BUFFER_LEN) && (bad_usb->file_end == false)) {
-                    bad_usb->file_buf[bad_usb->buf_len] = '\n';
-                    bad_usb->buf_len++;
-                    bad_usb->file_end = true;
-                }
-            }
+    if(!bad_usb_bytecode_reader_next(bad_usb->reader, &bad_usb->op)) return SCRIPT_STATE_END;
 
-            bad_usb->buf_start = 0;
-            if(bad_usb->buf_len == 0) return SCRIPT_STATE_END;
-        }
-        for(uint8_t i = bad_usb->buf_start; i < (bad_usb->buf_start + bad_usb->buf_len); i++) {
-            if(bad_usb->file_buf[i] == '\n' && string_size(bad_usb->line) > 0) {
-                bad_usb->st.line_cur++;
-                bad_usb->buf_len = bad_usb->buf_len + bad_usb->buf_start - (i + 1);
-                bad_usb->buf_start = i + 1;
-                delay_val = ducky_parse_line(bad_usb, bad_usb->line);
-                if(delay_val < 0) {
-                    bad_usb->st.error_line = bad_usb->st.line_cur;
-                    FURI_LOG_E(WORKER_TAG, "Unknown command at line %lu", bad_usb->st.line_cur);
-                    return SCRIPT_STATE_ERROR;
-                } else {
-                    return (delay_val + bad_usb->defdelay);
-                }
-            } else {
-                string_push_back(bad_usb->line, bad_usb->file_buf[i]);
-            }
-        }
-        bad_usb->buf_len = 0;
-        if(bad_usb->file_end) return SCRIPT_STATE_END;
+    bad_usb->st.line_cur++;
+    delay_val = ducky_execute_op(bad_usb, &bad_usb->op);
+    if(delay_val < 0) {
+        bad_usb->st.error_line = bad_usb->st.line_cur;
+        FURI_LOG_E(WORKER_TAG, "Unknown command at line %lu", bad_usb->st.line_cur);
+        return SCRIPT_STATE_ERROR;
+    } else {
+        return (delay_val + bad_usb->defdelay);
     }
-
-    return 0;
 }
 
 static void bad_usb_hid_state_callback(bool state, void* context) {
@@ -454,20 +279,28 @@ static int32_t bad_usb_worker(void* context) {
     FuriHalUsbInterface* usb_mode_prev = furi_hal_usb_get_config();
 
     FURI_LOG_I(WORKER_TAG, "Init");
-    File* script_file = storage_file_alloc(furi_record_open("storage"));
-    string_init(bad_usb->line);
-    string_init(bad_usb->line_prev);
+    Storage* storage = furi_record_open("storage");
+    Stream* script = file_stream_alloc(storage);
+    bad_usb->bytecode = file_stream_alloc(storage);
+    bad_usb->reader = bad_usb_bytecode_reader_alloc(bad_usb->bytecode);
+    string_init(bad_usb->op.text);
+    string_init(bad_usb->op_prev.text);
+    string_t bytecode_path;
+    string_init_printf(
+        bytecode_path, "%s%s", string_get_cstr(bad_usb->file_path), BAD_USB_BYTECODE_EXTENSION);
 
     furi_hal_hid_set_state_callback(bad_usb_hid_state_callback, bad_usb);
 
     while(1) {
         if(worker_state == BadUsbStateInit) { // State: initialization
-            if(storage_file_open(
-                   script_file,
+            if(file_stream_open(
+                   script,
                    string_get_cstr(bad_usb->file_path),
                    FSAM_READ,
                    FSOM_OPEN_EXISTING)) {
-                if((ducky_script_preload(bad_usb, script_file)) && (bad_usb->st.line_nb > 0)) {
+                bool preloaded = ducky_script_preload(bad_usb, storage, script, bytecode_path);
+                file_stream_close(script);
+                if(preloaded && (bad_usb->st.line_nb > 0)) {
                     if(furi_hal_hid_is_connected()) {
                         worker_state = BadUsbStateIdle; // Ready to run
                     } else {
@@ -504,12 +337,11 @@ static int32_t bad_usb_worker(void* context) {
             } else if(flags & WorkerEvtToggle) { // Start executing script
                 DOLPHIN_DEED(DolphinDeedBadUsbPlayScript);
                 delay_val = 0;
-                bad_usb->buf_len = 0;
                 bad_usb->st.line_cur = 0;
                 bad_usb->defdelay = 0;
                 bad_usb->repeat_cnt = 0;
-                bad_usb->file_end = false;
-                storage_file_seek(script_file, 0, true);
+                bad_usb->op.type = BadUsbOpNop;
+                bad_usb_bytecode_reader_rewind(bad_usb->reader);
                 worker_state = BadUsbStateRunning;
             } else if(flags & WorkerEvtDisconnect) {
                 worker_state = BadUsbStateNotConnected; // USB disconnected
@@ -539,7 +371,7 @@ static int32_t bad_usb_worker(void* context) {
                     continue;
                 }
                 bad_usb->st.state = BadUsbStateRunning;
-                delay_val = ducky_script_execute_next(bad_usb, script_file);
+                delay_val = ducky_script_execute_next(bad_usb);
                 if(delay_val == SCRIPT_STATE_ERROR) { // Script error
                     delay_val = 0;
                     worker_state = BadUsbStateScriptError;
@@ -573,11 +405,16 @@ static int32_t bad_usb_worker(void* context) {
     furi_hal_hid_set_state_callback(NULL, NULL);
 
     furi_hal_usb_set_config(usb_mode_prev, NULL);
-
-    storage_file_close(script_file);
-    storage_file_free(script_file);
-    string_clear(bad_usb->line);
-    string_clear(bad_usb->line_prev);
+    furi_hal_hid_set_poll_interval(0);
+
+    string_clear(bytecode_path);
+    string_clear(bad_usb->op.text);
+    string_clear(bad_usb->op_prev.text);
+    bad_usb_bytecode_reader_free(bad_usb->reader);
+    stream_free(bad_usb->bytecode);
+    file_stream_close(script);
+    stream_free(script);
+    furi_record_close("storage");
 
     FURI_LOG_I(WORKER_TAG, "End");
 
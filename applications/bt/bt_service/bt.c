@@ -1,6 +1,7 @@
 #include "bt_i.h"
 #include "battery_service.h"
 #include "bt_keys_storage.h"
+#include "bt_serial_tx.h"
 
 #include <notification/notification_messages.h>
 #include <gui/elements.h>
@@ -11,6 +12,8 @@
 #define BT_RPC_EVENT_DISCONNECTED (1UL << 1)
 #define BT_RPC_EVENT_ALL (BT_RPC_EVENT_BUFF_SENT | BT_RPC_EVENT_DISCONNECTED)
 
+#define BT_RPC_TX_TIMEOUT_MS (2000)
+
 static void bt_draw_statusbar_callback(Canvas* canvas, void* context) {
     furi_assert(context);
 
@@ -163,26 +166,33 @@ static uint16_t bt_serial_event_callback(SerialServiceEvent event, void* context
 }
 
 // Called from RPC thread
+static SerialServiceTxStatus bt_rpc_tx_callback(uint8_t* data, uint16_t size, void* context) {
+    UNUSED(context);
+    return furi_hal_bt_serial_tx(data, size);
+}
+
+static bool bt_rpc_tx_wait_callback(void* context) {
+    Bt* bt = context;
+    // Stale sent event only causes one more attempt
+    uint32_t event_flag =
+        osEventFlagsWait(bt->rpc_event, BT_RPC_EVENT_ALL, osFlagsWaitAny, BT_RPC_TX_TIMEOUT_MS);
+    if(event_flag & osFlagsError) {
+        // Lost confirmation or stuck stack must not block RPC forever
+        FURI_LOG_W(TAG, "TX wait failed: %lX", event_flag);
+        return false;
+    }
+    return !(event_flag & BT_RPC_EVENT_DISCONNECTED);
+}
+
 static void bt_rpc_send_bytes_callback(void* context, uint8_t* bytes, size_t bytes_len) {
     furi_assert(context);
     Bt* bt = context;
 
     osEventFlagsClear(bt->rpc_event, BT_RPC_EVENT_ALL);
-    size_t bytes_sent = 0;
-    while(bytes_sent < bytes_len) {
-        size_t bytes_remain = bytes_len - bytes_sent;
-        if(bytes_remain > bt->max_packet_size) {
-            furi_hal_bt_serial_tx(&bytes[bytes_sent], bt->max_packet_size);
-            bytes_sent += bt->max_packet_size;
-        } else {
-            furi_hal_bt_serial_tx(&bytes[bytes_sent], bytes_remain);
-            bytes_sent += bytes_remain;
-        }
-        uint32_t event_flag =
-            osEventFlagsWait(bt->rpc_event, BT_RPC_EVENT_ALL, osFlagsWaitAny, osWaitForever);
-        if(event_flag & BT_RPC_EVENT_DISCONNECTED) {
-            break;
-        }
+    size_t bytes_sent = bt_serial_tx(
+        bytes, bytes_len, bt->max_packet_size, bt_rpc_tx_callback, bt_rpc_tx_wait_callback, bt);
+    if(bytes_sent != bytes_len) {
+        FURI_LOG_W(TAG, "Sent %u of %u bytes", bytes_sent, bytes_len);
     }
 }
 
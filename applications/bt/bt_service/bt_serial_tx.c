@@ -0,0 +1,30 @@
+#include "bt_serial_tx.h"
+#include <furi.h>
+
+size_t bt_serial_tx(
+    uint8_t* data,
+    size_t size,
+    uint16_t packet_size,
+    BtSerialTxCallback tx,
+    BtSerialTxWaitCallback wait,
+    void* context) {
+    furi_assert(data);
+    furi_assert(packet_size);
+    furi_assert(tx);
+    furi_assert(wait);
+
+    size_t bytes_sent = 0;
+    while(bytes_sent < size) {
+        uint16_t packet_len = MIN(size - bytes_sent, packet_size);
+        SerialServiceTxStatus status = tx(&data[bytes_sent], packet_len, context);
+        if(status == SerialServiceTxStatusOk) {
+            bytes_sent += packet_len;
+        } else if(status == SerialServiceTxStatusBusy) {
+            if(!wait(context)) break;
+        } else {
+            break;
+        }
+    }
+
+    return bytes_sent;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <furi_hal_bt_serial.h>
+#include <stddef.h>
+
+/** Send packet callback
+ *
+ * @return SerialServiceTxStatusBusy if TX window is full
+ */
+typedef SerialServiceTxStatus (*BtSerialTxCallback)(uint8_t* data, uint16_t size, void* context);
+
+/** Wait for free space in TX window callback
+ *
+ * @return false if connection is lost
+ */
+typedef bool (*BtSerialTxWaitCallback)(void* context);
+
+/** Split buffer into packets and send them back to back.
+ * Waits only when transport reports that TX window is full.
+ *
+ * @param data          data buffer
+ * @param size          data buffer size
+ * @param packet_size   maximum packet size
+ * @param tx            send packet callback
+ * @param wait          wait for free space callback
+ * @param context       callbacks context
+ *
+ * @return bytes sent
+ */
+size_t bt_serial_tx(
+    uint8_t* data,
+    size_t size,
+    uint16_t packet_size,
+    BtSerialTxCallback tx,
+    BtSerialTxWaitCallback wait,
+    void* context);
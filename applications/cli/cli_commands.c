@@ -335,6 +335,40 @@ void cli_command_free_blocks(Cli* cli, string_t args, void* context) {
     memmgr_heap_printf_free_blocks();
 }
 
+void cli_command_heap_stats(Cli* cli, string_t args, void* context) {
+    MemmgrHeapStats* stats = malloc(sizeof(MemmgrHeapStats));
+    memmgr_heap_get_stats(stats);
+
+    printf("Free heap size: %d\r\n", stats->free_size);
+    printf("Free pool size: %d\r\n", stats->pool_free_size);
+    printf("Maximum heap block: %d\r\n", stats->max_free_block);
+    printf("Free blocks: %d\r\n", stats->free_blocks);
+    for(size_t i = 0; i < MEMMGR_HEAP_HISTOGRAM_BINS; i++) {
+        if(i < MEMMGR_HEAP_HISTOGRAM_BINS - 1) {
+            printf("  < %-6d %d\r\n", 32 << i, stats->free_block_histogram[i]);
+        } else {
+            printf("  >= %-5d %d\r\n", 32 << (i - 1), stats->free_block_histogram[i]);
+        }
+    }
+
+    printf(
+        "\r\nPool pages: %d free of %d\r\n", stats->pool_free_pages, stats->pool_pages);
+    printf("%-6s %-6s %-11s %-10s %s\r\n", "Size", "Pages", "Used/Slots", "Hits", "Misses");
+    for(size_t i = 0; i < MEMMGR_HEAP_POOL_CLASSES; i++) {
+        MemmgrHeapPoolStats* pool = &stats->pools[i];
+        printf(
+            "%-6d %-6d %4d/%-6d %-10lu %lu\r\n",
+            pool->size,
+            pool->pages,
+            pool->used,
+            pool->slots,
+            pool->hits,
+            pool->misses);
+    }
+
+    free(stats);
+}
+
 void cli_command_i2c(Cli* cli, string_t args, void* context) {
     furi_hal_i2c_acquire(&furi_hal_i2c_handle_external);
     printf("Scanning external i2c on PC0(SCL)/PC1(SDA)\r\n"
@@ -367,6 +401,7 @@ void cli_commands_init(Cli* cli) {
     cli_add_command(cli, "ps", CliCommandFlagParallelSafe, cli_command_ps, NULL);
     cli_add_command(cli, "free", CliCommandFlagParallelSafe, cli_command_free, NULL);
     cli_add_command(cli, "free_blocks", CliCommandFlagParallelSafe, cli_command_free_blocks, NULL);
+    cli_add_command(cli, "heap_stats", CliCommandFlagParallelSafe, cli_command_heap_stats, NULL);
 
     cli_add_command(cli, "vibro", CliCommandFlagDefault, cli_command_vibro, NULL);
     cli_add_command(cli, "led", CliCommandFlagDefault, cli_command_led, NULL);
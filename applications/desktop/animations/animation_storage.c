@@ -14,13 +14,50 @@
 #include <assets_dolphin_blocking.h>
 
 #define ANIMATION_META_FILE "meta.txt"
+#define ANIMATION_BUNDLE_FILE "animation.bundle"
+#define ANIMATION_BUNDLE_MAGIC (0x424E4146) // FANB
+#define ANIMATION_BUNDLE_VERSION (1)
 #define ANIMATION_DIR "/ext/dolphin"
 #define ANIMATION_MANIFEST_FILE ANIMATION_DIR "/manifest.txt"
 #define TAG "AnimationStorage"
 
+/*
+ * Bundle: meta and frames of animation in one file
+ * | header | frames order | frame offsets | bubbles | frames |
+ * Frames are stored as in frame_X.bm files, offsets are relative to
+ * frames start. Bubble record is followed by text_size bytes of text.
+ */
+typedef struct {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t width;
+    uint8_t height;
+    uint8_t passive_frames;
+    uint8_t active_frames;
+    uint8_t active_cycles;
+    uint8_t frame_rate;
+    uint8_t frame_count;
+    uint16_t duration;
+    uint16_t active_cooldown;
+    uint8_t bubble_slots;
+    uint8_t bubble_count;
+    uint16_t meta_size;
+    uint32_t frames_size;
+} __attribute__((packed)) AnimationBundleHeader;
+
+typedef struct {
+    uint8_t slot;
+    uint8_t x;
+    uint8_t y;
+    uint8_t align_h;
+    uint8_t align_v;
+    uint8_t start_frame;
+    uint8_t end_frame;
+    uint8_t text_size;
+} __attribute__((packed)) AnimationBundleBubble;
+
 static void animation_storage_free_bubbles(BubbleAnimation* animation);
 static void animation_storage_free_frames(BubbleAnimation* animation);
-static void animation_storage_free_animation(BubbleAnimation** storage_animation);
 static BubbleAnimation* animation_storage_load_animation(const char* name);
 
 static bool animation_storage_load_single_manifest_info(
@@ -201,7 +238,7 @@ void animation_storage_cache_animation(StorageAnimation* storage_animation) {
     }
 }
 
-static void animation_storage_free_animation(BubbleAnimation** animation) {
+void animation_storage_free_animation(BubbleAnimation** animation) {
     furi_assert(animation);
 
     if(*animation) {
@@ -249,17 +286,28 @@ static bool animation_storage_cast_align(string_t align_str, Align* align) {
     return true;
 }
 
+/* Bundle frames are stored in the same allocation right after frames table */
+static bool animation_storage_frames_packed(const Icon* icon) {
+    return icon->frame_count &&
+           (icon->frames[0] == (const uint8_t*)&icon->frames[icon->frame_count]);
+}
+
 static void animation_storage_free_frames(BubbleAnimation* animation) {
     furi_assert(animation);
 
     const Icon* icon = &animation->icon_animation;
-    for(int i = 0; i < icon->frame_count; ++i) {
-        if(icon->frames[i]) {
-            free((void*)icon->frames[i]);
+    if(!icon->frames) return;
+
+    if(!animation_storage_frames_packed(icon)) {
+        for(int i = 0; i < icon->frame_count; ++i) {
+            if(icon->frames[i]) {
+                free((void*)icon->frames[i]);
+            }
         }
     }
 
     free((void*)icon->frames);
+    FURI_CONST_ASSIGN_PTR(icon->frames, NULL);
 }
 
 static bool animation_storage_load_frames(
@@ -427,7 +475,7 @@ static bool animation_storage_load_bubbles(BubbleAnimation* animation, FlipperFo
     return success;
 }
 
-static BubbleAnimation* animation_storage_load_animation(const char* name) {
+BubbleAnimation* animation_storage_load_legacy_animation(const char* name) {
     furi_assert(name);
     BubbleAnimation* animation = malloc(sizeof(BubbleAnimation));
 
@@ -509,6 +557,204 @@ static BubbleAnimation* animation_storage_load_animation(const char* name) {
     return animation;
 }
 
+static bool animation_storage_load_bundle_bubbles(
+    BubbleAnimation* animation,
+    const uint8_t* data,
+    size_t size,
+    uint8_t bubble_count) {
+    furi_assert(!animation->frame_bubble_sequences);
+    if(animation->frame_bubble_sequences_count == 0) {
+        return bubble_count == 0;
+    }
+
+    animation->frame_bubble_sequences =
+        malloc(sizeof(FrameBubble*) * animation->frame_bubble_sequences_count);
+    for(int i = 0; i < animation->frame_bubble_sequences_count; ++i) {
+        FURI_CONST_ASSIGN_PTR(animation->frame_bubble_sequences[i], malloc(sizeof(FrameBubble)));
+    }
+
+    /* same rules as for meta file: slots start from 0 and go in ascending order */
+    const FrameBubble* bubble = animation->frame_bubble_sequences[0];
+    int8_t index = -1;
+    size_t offset = 0;
+    bool error = false;
+    for(int i = 0; i < bubble_count; ++i) {
+        error = true;
+        if(offset + sizeof(AnimationBundleBubble) > size) break;
+        const AnimationBundleBubble* record = (const AnimationBundleBubble*)&data[offset];
+        offset += sizeof(AnimationBundleBubble);
+        if(offset + record->text_size > size) break;
+        if(record->text_size == 0 || record->text_size > 100) break;
+        if(record->align_h > AlignCenter || record->align_v > AlignCenter) break;
+
+        if(record->slot == index && index != -1) {
+            FURI_CONST_ASSIGN_PTR(bubble->next_bubble, malloc(sizeof(FrameBubble)));
+            bubble = bubble->next_bubble;
+        } else if(record->slot == index + 1) {
+            ++index;
+            if(index >= animation->frame_bubble_sequences_count) break;
+            bubble = animation->frame_bubble_sequences[index];
+        } else {
+            break;
+        }
+
+        FURI_CONST_ASSIGN(bubble->bubble.x, record->x);
+        FURI_CONST_ASSIGN(bubble->bubble.y, record->y);
+        *(Align*)&bubble->bubble.align_h = record->align_h;
+        *(Align*)&bubble->bubble.align_v = record->align_v;
+        FURI_CONST_ASSIGN(bubble->start_frame, record->start_frame);
+        FURI_CONST_ASSIGN(bubble->end_frame, record->end_frame);
+        char* text = malloc(record->text_size + 1);
+        memcpy(text, &data[offset], record->text_size);
+        text[record->text_size] = '\0';
+        FURI_CONST_ASSIGN_PTR(bubble->bubble.text, text);
+        offset += record->text_size;
+        error = false;
+    }
+
+    bool success = !error && (offset == size) &&
+                   ((index + 1) == animation->frame_bubble_sequences_count);
+    if(!success) {
+        FURI_LOG_E(TAG, "Failed to load bundle bubbles");
+        animation_storage_free_bubbles(animation);
+    }
+    return success;
+}
+
+static bool animation_storage_load_bundle_frames(
+    File* file,
+    BubbleAnimation* animation,
+    const AnimationBundleHeader* header,
+    const uint8_t* offsets_data) {
+    Icon* icon = (Icon*)&animation->icon_animation;
+    size_t max_filesize = ROUND_UP_TO(header->width, 8) * header->height + 1;
+
+    /* frames must be contiguous, in order and fit into width x height */
+    uint32_t offsets[UINT8_MAX + 1];
+    memcpy(offsets, offsets_data, sizeof(uint32_t) * header->frame_count);
+    offsets[header->frame_count] = header->frames_size;
+    if(offsets[0] != 0) return false;
+    for(int i = 0; i < header->frame_count; ++i) {
+        if(offsets[i + 1] <= offsets[i]) return false;
+        if(offsets[i + 1] - offsets[i] > max_filesize) return false;
+    }
+
+    size_t table_size = sizeof(const uint8_t*) * header->frame_count;
+    uint8_t* block = malloc(table_size + header->frames_size);
+    if(storage_file_read(file, block + table_size, header->frames_size) !=
+       header->frames_size) {
+        free(block);
+        return false;
+    }
+
+    const uint8_t** frames = (const uint8_t**)block;
+    for(int i = 0; i < header->frame_count; ++i) {
+        frames[i] = block + table_size + offsets[i];
+    }
+
+    FURI_CONST_ASSIGN(icon->frame_count, header->frame_count);
+    FURI_CONST_ASSIGN(icon->frame_rate, header->frame_rate);
+    FURI_CONST_ASSIGN(icon->height, header->height);
+    FURI_CONST_ASSIGN(icon->width, header->width);
+    icon->frames = frames;
+    furi_assert(animation_storage_frames_packed(icon));
+
+    return true;
+}
+
+BubbleAnimation* animation_storage_load_bundle_animation(const char* name) {
+    furi_assert(name);
+    BubbleAnimation* animation = malloc(sizeof(BubbleAnimation));
+    Storage* storage = furi_record_open("storage");
+    File* file = storage_file_alloc(storage);
+    uint8_t* meta = NULL;
+    string_t path;
+    string_init_printf(path, ANIMATION_DIR "/%s/" ANIMATION_BUNDLE_FILE, name);
+
+    bool success = false;
+    do {
+        AnimationBundleHeader header;
+
+        if(FSE_OK != storage_sd_status(storage)) break;
+        if(!storage_file_open(file, string_get_cstr(path), FSAM_READ, FSOM_OPEN_EXISTING)) break;
+        if(storage_file_read(file, &header, sizeof(header)) != sizeof(header)) break;
+        if(header.magic != ANIMATION_BUNDLE_MAGIC || header.version != ANIMATION_BUNDLE_VERSION)
+            break;
+
+        uint8_t frames = header.passive_frames + header.active_frames;
+        size_t order_size = frames;
+        size_t offsets_size = sizeof(uint32_t) * header.frame_count;
+        if((header.width == 0) || (header.width > 128) || (header.height == 0) ||
+           (header.height > 64) || (frames == 0) || (header.frame_count == 0) ||
+           (header.frame_count > frames) || (header.bubble_slots > 20) ||
+           (header.meta_size < order_size + offsets_size)) {
+            FURI_LOG_E(TAG, "Invalid bundle '%s'", string_get_cstr(path));
+            break;
+        }
+
+        meta = malloc(header.meta_size);
+        if(storage_file_read(file, meta, header.meta_size) != header.meta_size) break;
+
+        /* The frames should go in order (0...N), without omissions */
+        bool order_ok = true;
+        animation->frame_order = malloc(sizeof(uint8_t) * frames);
+        for(int i = 0; i < frames; ++i) {
+            if(meta[i] >= header.frame_count) order_ok = false;
+            FURI_CONST_ASSIGN(animation->frame_order[i], meta[i]);
+        }
+        if(!order_ok) break;
+
+        animation->passive_frames = header.passive_frames;
+        animation->active_frames = header.active_frames;
+        animation->active_cycles = header.active_cycles;
+        animation->duration = header.duration;
+        animation->active_cooldown = header.active_cooldown;
+        animation->frame_bubble_sequences_count = header.bubble_slots;
+
+        if(!animation_storage_load_bundle_bubbles(
+               animation,
+               meta + order_size + offsets_size,
+               header.meta_size - order_size - offsets_size,
+               header.bubble_count))
+            break;
+
+        if(!animation_storage_load_bundle_frames(file, animation, &header, meta + order_size)) {
+            FURI_LOG_E(TAG, "Failed to load bundle frames '%s'", string_get_cstr(path));
+            animation_storage_free_bubbles(animation);
+            break;
+        }
+
+        success = true;
+    } while(0);
+
+    if(meta) {
+        free(meta);
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+    string_clear(path);
+    furi_record_close("storage");
+
+    if(!success) {
+        if(animation->frame_order) {
+            free((void*)animation->frame_order);
+        }
+        free(animation);
+        animation = NULL;
+    }
+
+    return animation;
+}
+
+static BubbleAnimation* animation_storage_load_animation(const char* name) {
+    /* bundle is read with one open, legacy layout is a fallback */
+    BubbleAnimation* animation = animation_storage_load_bundle_animation(name);
+    if(!animation) {
+        animation = animation_storage_load_legacy_animation(name);
+    }
+    return animation;
+}
+
 static void animation_storage_free_bubbles(BubbleAnimation* animation) {
     if(!animation->frame_bubble_sequences) return;
 
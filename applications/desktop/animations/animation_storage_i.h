@@ -7,3 +7,26 @@ struct StorageAnimation {
     bool external;
     StorageAnimationManifestInfo manifest_info;
 };
+
+/**
+ * Load animation from bundle file.
+ *
+ * @name        name of animation
+ * @return      animation, NULL if there is no valid bundle
+ */
+BubbleAnimation* animation_storage_load_bundle_animation(const char* name);
+
+/**
+ * Load animation from meta file and separate frame files.
+ *
+ * @name        name of animation
+ * @return      animation, NULL if failed
+ */
+BubbleAnimation* animation_storage_load_legacy_animation(const char* name);
+
+/**
+ * Free animation, which previously loaded by Animation Storage.
+ *
+ * @animation   animation to free. NULL-ed after all.
+ */
+void animation_storage_free_animation(BubbleAnimation** animation);
@@ -361,11 +361,11 @@ void canvas_draw_xbm(
     u8g2_DrawXBM(&canvas->fb, x, y, w, h, bitmap);
 }
 
-void canvas_draw_glyph(Canvas* canvas, uint8_t x, uint8_t y, uint16_t ch) {
+uint8_t canvas_draw_glyph(Canvas* canvas, uint8_t x, uint8_t y, uint16_t ch) {
     furi_assert(canvas);
     x += canvas->offset_x;
     y += canvas->offset_y;
-    u8g2_DrawGlyph(&canvas->fb, x, y, ch);
+    return u8g2_DrawGlyph(&canvas->fb, x, y, ch);
 }
 
 void canvas_set_bitmap_mode(Canvas* canvas, bool alpha) {
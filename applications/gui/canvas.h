@@ -313,8 +313,10 @@ void canvas_draw_triangle(
  * @param      x       x coordinate
  * @param      y       y coordinate
  * @param      ch      character
+ *
+ * @return     glyph width, offset of next glyph
  */
-void canvas_draw_glyph(Canvas* canvas, uint8_t x, uint8_t y, uint16_t ch);
+uint8_t canvas_draw_glyph(Canvas* canvas, uint8_t x, uint8_t y, uint16_t ch);
 
 /** Set transparency mode
  *
@@ -11,6 +11,7 @@
 #include <m-string.h>
 #include <furi.h>
 #include "canvas_i.h"
+#include "text_layout.h"
 
 #include <string.h>
 #include <stdint.h>
@@ -275,22 +276,15 @@ void elements_multiline_text(Canvas* canvas, uint8_t x, uint8_t y, const char* t
     furi_assert(text);
 
     uint8_t font_height = canvas_current_font_height(canvas);
-    string_t str;
-    string_init(str);
     const char* start = text;
-    char* end;
+    const char* end;
     do {
         end = strchr(start, '\n');
-        if(end) {
-            string_set_strn(str, start, end - start);
-        } else {
-            string_set_str(str, start);
-        }
-        canvas_draw_str(canvas, x, y, string_get_cstr(str));
+        size_t length = end ? (size_t)(end - start) : strlen(start);
+        text_layout_draw_str(canvas, x, y, start, length);
         start = end + 1;
         y += font_height;
     } while(end && y < 64);
-    string_clear(str);
 }
 
 void elements_multiline_text_framed(Canvas* canvas, uint8_t x, uint8_t y, const char* text) {
@@ -4,6 +4,25 @@
 #include <storage/storage.h>
 
 #define FILENAME_COUNT 4
+#define FILENAME_MAX_LENGTH 100
+
+/* Names cached around visible files. Directory stays open after window is read, so scrolling
+ * forward continues from there, other window moves read directory from start. */
+#define CACHE_WINDOW_COUNT 32
+#define CACHE_NAMES_SIZE_INITIAL 256
+
+/* Window of filtered directory: zero terminated names stored one after another */
+typedef struct {
+    char* names;
+    uint16_t names_size;
+    uint16_t names_capacity;
+
+    uint16_t offsets[CACHE_WINDOW_COUNT];
+    uint16_t first;
+    uint16_t count;
+
+    volatile bool valid;
+} FileSelectCache;
 
 struct FileSelect {
     // public
@@ -19,6 +38,13 @@ struct FileSelect {
 
     char* buffer;
     uint8_t buffer_size;
+
+    FileSelectCache cache;
+    FuriPubSubSubscription* storage_subscription;
+
+    // Open directory, positioned after last cached name
+    File* directory;
+    uint16_t directory_position;
 };
 
 typedef struct {
@@ -180,10 +206,53 @@ static bool file_select_init_inner(FileSelect* file_select) {
     return result;
 }
 
+/* Compares paths after storage prefix if folder is on "/any" storage */
+static bool file_select_is_in_folder(const char* folder, const char* path) {
+    const size_t prefix_length = strlen("/any");
+    if(strncmp(folder, "/any", prefix_length) == 0 && strlen(path) >= prefix_length) {
+        folder += prefix_length;
+        path += prefix_length;
+    }
+
+    size_t folder_length = strlen(folder);
+    if(strncmp(folder, path, folder_length) != 0 || path[folder_length] != '/') {
+        return false;
+    }
+
+    // files in subfolders are not listed
+    return strchr(&path[folder_length + 1], '/') == NULL;
+}
+
+static void file_select_storage_callback(const void* message, void* context) {
+    const StorageEvent* storage_event = message;
+    FileSelect* file_select = context;
+
+    // card (un)mount or file change in viewed folder makes cache outdated
+    bool outdated = true;
+    if(storage_event->type == StorageEventTypeFileClose && file_select->path &&
+       storage_event->path) {
+        outdated = file_select_is_in_folder(file_select->path, storage_event->path);
+    }
+
+    if(outdated) {
+        file_select->cache.valid = false;
+    }
+}
+
+static void file_select_directory_close(FileSelect* file_select) {
+    if(file_select->directory) {
+        storage_dir_close(file_select->directory);
+        storage_file_free(file_select->directory);
+        file_select->directory = NULL;
+    }
+}
+
 FileSelect* file_select_alloc() {
     FileSelect* file_select = malloc(sizeof(FileSelect));
     file_select->view = view_alloc();
     file_select->fs_api = furi_record_open("storage");
+    file_select->storage_subscription = furi_pubsub_subscribe(
+        storage_get_pubsub(file_select->fs_api), file_select_storage_callback, file_select);
 
     view_set_context(file_select->view, file_select);
     view_allocate_model(file_select->view, ViewModelTypeLockFree, sizeof(FileSelectModel));
@@ -214,6 +283,10 @@ void file_select_free(FileSelect* file_select) {
             return false;
         });
     view_free(file_select->view);
+    furi_pubsub_unsubscribe(
+        storage_get_pubsub(file_select->fs_api), file_select->storage_subscription);
+    file_select_directory_close(file_select);
+    free(file_select->cache.names);
     free(file_select);
     furi_record_close("storage");
 }
@@ -232,6 +305,7 @@ void file_select_set_filter(FileSelect* file_select, const char* path, const cha
     furi_assert(file_select);
     file_select->path = path;
     file_select->extension = extension;
+    file_select->cache.valid = false;
 }
 
 void file_select_set_result_buffer(FileSelect* file_select, char* buffer, uint8_t buffer_size) {
@@ -266,20 +340,140 @@ static bool filter_file(FileSelect* file_select, FileInfo* file_info, char* name
     return result;
 }
 
-bool file_select_fill_strings(FileSelect* file_select) {
+static void file_select_set_filename(FileSelect* file_select, uint8_t index, const char* name) {
+    with_view_model(
+        file_select->view, (FileSelectModel * model) {
+            string_set_str(model->filename[index], name);
+
+            if(strcmp(file_select->extension, "*") != 0) {
+                string_replace_all_str(model->filename[index], file_select->extension, "");
+            }
+
+            return true;
+        });
+}
+
+static void file_select_cache_reset(FileSelectCache* cache, uint16_t first) {
+    cache->names_size = 0;
+    cache->first = first;
+    cache->count = 0;
+}
+
+static void file_select_cache_push(FileSelectCache* cache, const char* name) {
+    furi_assert(cache->count < CACHE_WINDOW_COUNT);
+    size_t name_size = strlen(name) + 1;
+
+    if(cache->names_size + name_size > cache->names_capacity) {
+        size_t capacity = MAX(cache->names_capacity, CACHE_NAMES_SIZE_INITIAL);
+        while(capacity < cache->names_size + name_size) capacity *= 2;
+        cache->names = realloc(cache->names, capacity);
+        cache->names_capacity = capacity;
+    }
+
+    memcpy(&cache->names[cache->names_size], name, name_size);
+    cache->offsets[cache->count] = cache->names_size;
+    cache->names_size += name_size;
+    cache->count++;
+}
+
+/* Keeps names from first to end of window */
+static void file_select_cache_drop_front(FileSelectCache* cache, uint16_t first) {
+    uint16_t drop = first - cache->first;
+    if(drop >= cache->count) {
+        file_select_cache_reset(cache, first);
+        return;
+    }
+
+    uint16_t names_offset = cache->offsets[drop];
+    memmove(cache->names, &cache->names[names_offset], cache->names_size - names_offset);
+    cache->names_size -= names_offset;
+    for(uint16_t i = 0; i < cache->count - drop; i++) {
+        cache->offsets[i] = cache->offsets[i + drop] - names_offset;
+    }
+    cache->first = first;
+    cache->count -= drop;
+}
+
+static bool file_select_cache_contains(FileSelectCache* cache, uint16_t index) {
+    return (index >= cache->first) && (index - cache->first < cache->count);
+}
+
+static const char* file_select_cache_get(FileSelectCache* cache, uint16_t index) {
+    furi_assert(file_select_cache_contains(cache, index));
+    return &cache->names[cache->offsets[index - cache->first]];
+}
+
+/* Window start that leaves room for scrolling in both directions */
+static uint16_t file_select_cache_window_first(uint16_t first_file_index) {
+    const uint16_t margin = (CACHE_WINDOW_COUNT - FILENAME_COUNT) / 2;
+    return first_file_index > margin ? first_file_index - margin : 0;
+}
+
+/* Stores names of window starting at first. Counts all filtered files if file_count is given,
+ * otherwise stops when window is full and keeps directory open for next forward move */
+static bool
+    file_select_cache_read(FileSelect* file_select, uint16_t first, uint16_t* file_count) {
+    FileSelectCache* cache = &file_select->cache;
+    FileInfo file_info;
+
+    const uint8_t name_length = FILENAME_MAX_LENGTH;
+    char* name = malloc(name_length);
+    bool result = true;
+    bool directory_end = true;
+
+    if(!file_count && file_select->directory && (first >= cache->first)) {
+        // Open directory is right after cached names
+        file_select_cache_drop_front(cache, first);
+    } else {
+        file_select_directory_close(file_select);
+        file_select_cache_reset(cache, first);
+        file_select->directory = storage_file_alloc(file_select->fs_api);
+        file_select->directory_position = 0;
+        if(!storage_dir_open(file_select->directory, file_select->path)) {
+            file_select_directory_close(file_select);
+        }
+    }
+
+    while(file_select->directory &&
+          storage_dir_read(file_select->directory, &file_info, name, name_length)) {
+        if(storage_file_get_error(file_select->directory) != FSE_OK) {
+            result = false;
+            break;
+        }
+
+        if(filter_file(file_select, &file_info, name)) {
+            if(file_select->directory_position >= first && cache->count < CACHE_WINDOW_COUNT) {
+                file_select_cache_push(cache, name);
+            }
+            file_select->directory_position++;
+            if(!file_count && cache->count == CACHE_WINDOW_COUNT) {
+                directory_end = false;
+                break;
+            }
+        }
+    }
+
+    if(file_count) {
+        *file_count = file_select->directory_position;
+    }
+
+    if(!result || directory_end) {
+        file_select_directory_close(file_select);
+    }
+    free(name);
+    return result;
+}
+
+/* Counts filtered files and caches window around current position */
+static bool file_select_cache_update(FileSelect* file_select) {
     furi_assert(file_select);
     furi_assert(file_select->fs_api);
     furi_assert(file_select->path);
     furi_assert(file_select->extension);
 
-    FileInfo file_info;
-    File* directory = storage_file_alloc(file_select->fs_api);
-
-    uint8_t string_counter = 0;
-    uint16_t file_counter = 0;
-    const uint8_t name_length = 100;
-    char* name = malloc(name_length);
+    FileSelectCache* cache = &file_select->cache;
     uint16_t first_file_index = 0;
+    uint16_t file_counter = 0;
 
     with_view_model(
         file_select->view, (FileSelectModel * model) {
@@ -287,72 +481,102 @@ bool file_select_fill_strings(FileSelect* file_select) {
             return false;
         });
 
-    if(!storage_dir_open(directory, file_select->path)) {
-        storage_dir_close(directory);
-        storage_file_free(directory);
-        free(name);
-        return true;
+    // storage events, received while we are reading, will invalidate cache again
+    cache->valid = true;
+    bool result = file_select_cache_read(
+        file_select, file_select_cache_window_first(first_file_index), &file_counter);
+
+    if(result) {
+        with_view_model(
+            file_select->view, (FileSelectModel * model) {
+                model->file_count = file_counter;
+
+                // folder content may have changed since last update
+                uint16_t max_first_file_index =
+                    file_counter > FILENAME_COUNT ? file_counter - FILENAME_COUNT : 0;
+                if(model->first_file_index > max_first_file_index) {
+                    model->first_file_index = max_first_file_index;
+                }
+                if(file_counter == 0) {
+                    model->position = 0;
+                } else if(model->first_file_index + model->position >= file_counter) {
+                    model->position = file_counter - 1 - model->first_file_index;
+                }
+                return false;
+            });
+    } else {
+        cache->valid = false;
     }
 
-    while(1) {
-        if(!storage_dir_read(directory, &file_info, name, name_length)) {
-            break;
-        }
+    return result;
+}
 
-        if(storage_file_get_error(directory) == FSE_OK) {
-            if(filter_file(file_select, &file_info, name)) {
-                if(file_counter >= first_file_index) {
-                    with_view_model(
-                        file_select->view, (FileSelectModel * model) {
-                            string_set_str(model->filename[string_counter], name);
+bool file_select_fill_strings(FileSelect* file_select) {
+    furi_assert(file_select);
+    furi_assert(file_select->fs_api);
+    furi_assert(file_select->path);
+    furi_assert(file_select->extension);
 
-                            if(strcmp(file_select->extension, "*") != 0) {
-                                string_replace_all_str(
-                                    model->filename[string_counter], file_select->extension, "");
-                            }
+    FileSelectCache* cache = &file_select->cache;
 
-                            return true;
-                        });
-                    string_counter++;
+    if(!cache->valid) {
+        if(!file_select_cache_update(file_select)) {
+            return false;
+        }
+    }
 
-                    if(string_counter >= FILENAME_COUNT) {
-                        break;
-                    }
-                }
-                file_counter++;
-            }
-        } else {
-            storage_dir_close(directory);
-            storage_file_free(directory);
-            free(name);
+    uint16_t first_file_index = 0;
+    uint16_t file_count = 0;
+    with_view_model(
+        file_select->view, (FileSelectModel * model) {
+            first_file_index = model->first_file_index;
+            file_count = model->file_count;
+            return false;
+        });
+
+    uint16_t visible_count =
+        file_count > first_file_index ? MIN(FILENAME_COUNT, file_count - first_file_index) : 0;
+    if(visible_count &&
+       (!file_select_cache_contains(cache, first_file_index) ||
+        !file_select_cache_contains(cache, first_file_index + visible_count - 1))) {
+        if(!file_select_cache_read(
+               file_select, file_select_cache_window_first(first_file_index), NULL)) {
             return false;
         }
     }
 
-    storage_dir_close(directory);
-    storage_file_free(directory);
-    free(name);
+    for(uint8_t i = 0; i < visible_count; i++) {
+        // folder could shrink since it was counted, next update will fix position
+        if(!file_select_cache_contains(cache, first_file_index + i)) break;
+        file_select_set_filename(
+            file_select, i, file_select_cache_get(cache, first_file_index + i));
+    }
+
     return true;
 }
 
 bool file_select_fill_count(FileSelect* file_select) {
-    furi_assert(file_select);
-    furi_assert(file_select->fs_api);
-    furi_assert(file_select->path);
-    furi_assert(file_select->extension);
+    return file_select_cache_update(file_select);
+}
 
+/* Returns false if file not found */
+static bool file_select_find_file_in_storage(
+    FileSelect* file_select,
+    const char* filename,
+    uint16_t* file_position) {
     FileInfo file_info;
     File* directory = storage_file_alloc(file_select->fs_api);
 
-    uint16_t file_counter = 0;
-    const uint8_t name_length = 100;
+    const uint8_t name_length = FILENAME_MAX_LENGTH;
     char* name = malloc(name_length);
+    bool file_found = false;
+    *file_position = 0;
 
     if(!storage_dir_open(directory, file_select->path)) {
         storage_dir_close(directory);
         storage_file_free(directory);
         free(name);
-        return true;
+        return false;
     }
 
     while(1) {
@@ -362,26 +586,22 @@ bool file_select_fill_count(FileSelect* file_select) {
 
         if(storage_file_get_error(directory) == FSE_OK) {
             if(filter_file(file_select, &file_info, name)) {
-                file_counter++;
+                if(strcmp(filename, name) == 0) {
+                    file_found = true;
+                    break;
+                }
+
+                (*file_position)++;
             }
         } else {
-            storage_dir_close(directory);
-            storage_file_free(directory);
-            free(name);
-            return false;
+            break;
         }
     }
 
-    with_view_model(
-        file_select->view, (FileSelectModel * model) {
-            model->file_count = file_counter;
-            return false;
-        });
-
     storage_dir_close(directory);
     storage_file_free(directory);
     free(name);
-    return true;
+    return file_found;
 }
 
 void file_select_set_selected_file_internal(FileSelect* file_select, const char* filename) {
@@ -393,11 +613,7 @@ void file_select_set_selected_file_internal(FileSelect* file_select, const char*
 
     if(strlen(filename) == 0) return;
 
-    FileInfo file_info;
-    File* directory = storage_file_alloc(file_select->fs_api);
-
-    const uint8_t name_length = 100;
-    char* name = malloc(name_length);
+    FileSelectCache* cache = &file_select->cache;
     uint16_t file_position = 0;
     bool file_found = false;
 
@@ -407,37 +623,26 @@ void file_select_set_selected_file_internal(FileSelect* file_select, const char*
         string_cat_str(filename_str, file_select->extension);
     }
 
-    if(!storage_dir_open(directory, file_select->path)) {
-        string_clear(filename_str);
-        storage_dir_close(directory);
-        storage_file_free(directory);
-        free(name);
-        return;
+    if(!cache->valid) {
+        file_select_cache_update(file_select);
     }
 
-    while(1) {
-        if(!storage_dir_read(directory, &file_info, name, name_length)) {
-            break;
-        }
-
-        if(storage_file_get_error(directory) == FSE_OK) {
-            if(filter_file(file_select, &file_info, name)) {
-                if(strcmp(string_get_cstr(filename_str), name) == 0) {
-                    file_found = true;
-                    break;
-                }
-
-                file_position++;
+    if(cache->valid) {
+        for(file_position = cache->first; file_position < cache->first + cache->count;
+            file_position++) {
+            const char* name = file_select_cache_get(cache, file_position);
+            if(strcmp(string_get_cstr(filename_str), name) == 0) {
+                file_found = true;
+                break;
             }
-        } else {
-            string_clear(filename_str);
-            storage_dir_close(directory);
-            storage_file_free(directory);
-            free(name);
-            return;
         }
     }
 
+    if(!file_found) {
+        file_found = file_select_find_file_in_storage(
+            file_select, string_get_cstr(filename_str), &file_position);
+    }
+
     if(file_found) {
         with_view_model(
             file_select->view, (FileSelectModel * model) {
@@ -461,9 +666,6 @@ void file_select_set_selected_file_internal(FileSelect* file_select, const char*
     }
 
     string_clear(filename_str);
-    storage_dir_close(directory);
-    storage_file_free(directory);
-    free(name);
 }
 
 void file_select_set_selected_file(FileSelect* file_select, const char* filename) {
@@ -3,21 +3,23 @@
 #include <m-string.h>
 #include <furi.h>
 #include <gui/elements.h>
+#include <gui/text_layout.h>
 #include <stdint.h>
 
+#define TEXT_BOX_WIDTH 120
+#define TEXT_BOX_X 3
+#define TEXT_BOX_Y 11
+
 struct TextBox {
     View* view;
 };
 
 typedef struct {
-    const char* text;
-    char* text_pos;
-    string_t text_formatted;
+    TextLayout* text_layout;
+    size_t lines_count;
     int32_t scroll_pos;
     int32_t scroll_num;
-    TextBoxFont font;
     TextBoxFocus focus;
-    bool formatted;
 } TextBoxModel;
 
 static void text_box_process_down(TextBox* text_box) {
@@ -25,9 +27,6 @@ static void text_box_process_down(TextBox* text_box) {
         text_box->view, (TextBoxModel * model) {
             if(model->scroll_pos < model->scroll_num - 1) {
                 model->scroll_pos++;
-                // Search next line start
-                while(*model->text_pos++ != '\n')
-                    ;
             }
             return true;
         });
@@ -38,57 +37,20 @@ static void text_box_process_up(TextBox* text_box) {
         text_box->view, (TextBoxModel * model) {
             if(model->scroll_pos > 0) {
                 model->scroll_pos--;
-                // Reach last symbol of previous line
-                model->text_pos--;
-                // Search prevous line start
-                while((model->text_pos != model->text) && (*(--model->text_pos) != '\n'))
-                    ;
-                if(*model->text_pos == '\n') {
-                    model->text_pos++;
-                }
             }
             return true;
         });
 }
 
-static void text_box_insert_endline(Canvas* canvas, TextBoxModel* model) {
-    size_t i = 0;
-    size_t line_width = 0;
-    const char* str = model->text;
-    size_t line_num = 0;
-
-    const size_t text_width = 120;
-
-    while(str[i] != '\0') {
-        char symb = str[i++];
-        if(symb != '\n') {
-            size_t glyph_width = canvas_glyph_width(canvas, symb);
-            if(line_width + glyph_width > text_width) {
-                line_num++;
-                line_width = 0;
-                string_push_back(model->text_formatted, '\n');
-            }
-            line_width += glyph_width;
-        } else {
-            line_num++;
-            line_width = 0;
-        }
-        string_push_back(model->text_formatted, symb);
-    }
-    line_num++;
-    model->text = string_get_cstr(model->text_formatted);
-    model->text_pos = (char*)model->text;
+static void text_box_update_scroll(TextBoxModel* model) {
+    int32_t line_num = model->lines_count;
+
+    model->scroll_num = MAX(line_num - 4, 0);
     if(model->focus == TextBoxFocusEnd && line_num > 5) {
         // Set text position to 5th line from the end
-        for(uint8_t i = 0; i < line_num - 5; i++) {
-            while(*model->text_pos++ != '\n') {
-            };
-        }
-        model->scroll_num = line_num - 4;
         model->scroll_pos = line_num - 5;
-    } else {
-        model->scroll_num = MAX(line_num - 4, 0);
-        model->scroll_pos = 0;
+    } else if(model->scroll_pos >= model->scroll_num) {
+        model->scroll_pos = MAX(model->scroll_num - 1, 0);
     }
 }
 
@@ -96,19 +58,21 @@ static void text_box_view_draw_callback(Canvas* canvas, void* _model) {
     TextBoxModel* model = _model;
 
     canvas_clear(canvas);
-    if(model->font == TextBoxFontText) {
-        canvas_set_font(canvas, FontSecondary);
-    } else if(model->font == TextBoxFontHex) {
-        canvas_set_font(canvas, FontKeyboard);
-    }
 
-    if(!model->formatted) {
-        text_box_insert_endline(canvas, model);
-        model->formatted = true;
+    // Only text added since last draw is split into lines
+    text_layout_update(model->text_layout, canvas);
+    size_t lines_count = text_layout_get_lines_count(model->text_layout);
+    if(model->lines_count != lines_count) {
+        model->lines_count = lines_count;
+        text_box_update_scroll(model);
     }
 
+    uint8_t font_height = canvas_current_font_height(canvas);
+    size_t lines_num = (canvas_height(canvas) - TEXT_BOX_Y + font_height - 1) / font_height;
+
     elements_slightly_rounded_frame(canvas, 0, 0, 124, 64);
-    elements_multiline_text(canvas, 3, 11, model->text_pos);
+    text_layout_draw(
+        model->text_layout, canvas, TEXT_BOX_X, TEXT_BOX_Y, model->scroll_pos, lines_num);
     elements_scrollbar(canvas, model->scroll_pos, model->scroll_num);
 }
 
@@ -139,10 +103,11 @@ TextBox* text_box_alloc() {
 
     with_view_model(
         text_box->view, (TextBoxModel * model) {
-            model->text = NULL;
-            string_init_set_str(model->text_formatted, "");
-            model->formatted = false;
-            model->font = TextBoxFontText;
+            model->text_layout = text_layout_alloc(TEXT_BOX_WIDTH);
+            model->lines_count = 0;
+            model->scroll_pos = 0;
+            model->scroll_num = 0;
+            model->focus = TextBoxFocusStart;
             return true;
         });
 
@@ -154,7 +119,7 @@ void text_box_free(TextBox* text_box) {
 
     with_view_model(
         text_box->view, (TextBoxModel * model) {
-            string_clear(model->text_formatted);
+            text_layout_free(model->text_layout);
             return true;
         });
     view_free(text_box->view);
@@ -171,9 +136,11 @@ void text_box_reset(TextBox* text_box) {
 
     with_view_model(
         text_box->view, (TextBoxModel * model) {
-            model->text = NULL;
-            string_set_str(model->text_formatted, "");
-            model->font = TextBoxFontText;
+            text_layout_reset(model->text_layout);
+            text_layout_set_font(model->text_layout, FontSecondary);
+            model->lines_count = 0;
+            model->scroll_pos = 0;
+            model->scroll_num = 0;
             model->focus = TextBoxFocusStart;
             return true;
         });
@@ -185,10 +152,20 @@ void text_box_set_text(TextBox* text_box, const char* text) {
 
     with_view_model(
         text_box->view, (TextBoxModel * model) {
-            model->text = text;
-            string_reset(model->text_formatted);
-            string_reserve(model->text_formatted, strlen(text));
-            model->formatted = false;
+            text_layout_set_text(model->text_layout, text);
+            model->lines_count = 0;
+            model->scroll_pos = 0;
+            return true;
+        });
+}
+
+void text_box_extend_text(TextBox* text_box, const char* text) {
+    furi_assert(text_box);
+    furi_assert(text);
+
+    with_view_model(
+        text_box->view, (TextBoxModel * model) {
+            text_layout_extend_text(model->text_layout, text);
             return true;
         });
 }
@@ -198,7 +175,12 @@ void text_box_set_font(TextBox* text_box, TextBoxFont font) {
 
     with_view_model(
         text_box->view, (TextBoxModel * model) {
-            model->font = font;
+            if(font == TextBoxFontText) {
+                text_layout_set_font(model->text_layout, FontSecondary);
+            } else if(font == TextBoxFontHex) {
+                text_layout_set_font(model->text_layout, FontKeyboard);
+            }
+            model->lines_count = 0;
             return true;
         });
 }
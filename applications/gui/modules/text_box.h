@@ -51,12 +51,22 @@ View* text_box_get_view(TextBox* text_box);
 void text_box_reset(TextBox* text_box);
 
 /** Set text for text_box
+ * Text is not copied and must stay valid while text_box shows it
  *
  * @param      text_box  TextBox instance
  * @param      text      text to set
  */
 void text_box_set_text(TextBox* text_box, const char* text);
 
+/** Set text that starts with current text_box text
+ * Only added part is split into lines, use it for logs. Text buffer may be
+ * reallocated, same as for text_box_set_text() it is not copied
+ *
+ * @param      text_box  TextBox instance
+ * @param      text      extended text
+ */
+void text_box_extend_text(TextBox* text_box, const char* text);
+
 /** Set TextBox font
  *
  * @param      text_box  TextBox instance
@@ -0,0 +1,190 @@
+#include "text_layout.h"
+#include <furi.h>
+#include <m-array.h>
+
+/* Glyph widths are cached for ASCII symbols only */
+#define TEXT_LAYOUT_GLYPH_CACHE_SIZE 128
+#define TEXT_LAYOUT_GLYPH_WIDTH_UNKNOWN 0xFF
+
+ARRAY_DEF(TextLayoutLineArray, size_t, M_DEFAULT_OPLIST);
+
+struct TextLayout {
+    // caller's text, not copied
+    const char* text;
+    // offsets of lines start in text
+    TextLayoutLineArray_t lines;
+    // amount of text bytes split into lines
+    size_t processed;
+    uint16_t line_width;
+    uint8_t width;
+    Font font;
+    uint8_t glyph_widths[TEXT_LAYOUT_GLYPH_CACHE_SIZE];
+};
+
+static void text_layout_clear_lines(TextLayout* text_layout) {
+    TextLayoutLineArray_reset(text_layout->lines);
+    TextLayoutLineArray_push_back(text_layout->lines, 0);
+    text_layout->processed = 0;
+    text_layout->line_width = 0;
+}
+
+static uint8_t text_layout_glyph_width(TextLayout* text_layout, Canvas* canvas, char symbol) {
+    uint8_t index = symbol;
+
+    if(index >= TEXT_LAYOUT_GLYPH_CACHE_SIZE) {
+        return canvas_glyph_width(canvas, symbol);
+    }
+
+    if(text_layout->glyph_widths[index] == TEXT_LAYOUT_GLYPH_WIDTH_UNKNOWN) {
+        text_layout->glyph_widths[index] = canvas_glyph_width(canvas, symbol);
+    }
+
+    return text_layout->glyph_widths[index];
+}
+
+TextLayout* text_layout_alloc(uint8_t width) {
+    TextLayout* text_layout = malloc(sizeof(TextLayout));
+    text_layout->text = "";
+    TextLayoutLineArray_init(text_layout->lines);
+    text_layout->width = width;
+    text_layout->font = FontSecondary;
+    memset(
+        text_layout->glyph_widths,
+        TEXT_LAYOUT_GLYPH_WIDTH_UNKNOWN,
+        sizeof(text_layout->glyph_widths));
+    text_layout_clear_lines(text_layout);
+
+    return text_layout;
+}
+
+void text_layout_free(TextLayout* text_layout) {
+    furi_assert(text_layout);
+
+    TextLayoutLineArray_clear(text_layout->lines);
+    free(text_layout);
+}
+
+void text_layout_reset(TextLayout* text_layout) {
+    furi_assert(text_layout);
+
+    text_layout->text = "";
+    text_layout_clear_lines(text_layout);
+}
+
+void text_layout_set_text(TextLayout* text_layout, const char* text) {
+    furi_assert(text_layout);
+    furi_assert(text);
+
+    text_layout->text = text;
+    text_layout_clear_lines(text_layout);
+}
+
+void text_layout_set_font(TextLayout* text_layout, Font font) {
+    furi_assert(text_layout);
+
+    if(text_layout->font != font) {
+        text_layout->font = font;
+        memset(
+            text_layout->glyph_widths,
+            TEXT_LAYOUT_GLYPH_WIDTH_UNKNOWN,
+            sizeof(text_layout->glyph_widths));
+        text_layout_clear_lines(text_layout);
+    }
+}
+
+Font text_layout_get_font(TextLayout* text_layout) {
+    furi_assert(text_layout);
+    return text_layout->font;
+}
+
+void text_layout_extend_text(TextLayout* text_layout, const char* text) {
+    furi_assert(text_layout);
+    furi_assert(text);
+
+    // previous buffer may be already freed, it is not accessed
+    text_layout->text = text;
+}
+
+void text_layout_update(TextLayout* text_layout, Canvas* canvas) {
+    furi_assert(text_layout);
+    furi_assert(canvas);
+
+    const char* text = text_layout->text;
+    // text before processed part is already checked for terminator
+    size_t text_size = text_layout->processed + strlen(&text[text_layout->processed]);
+
+    canvas_set_font(canvas, text_layout->font);
+
+    for(size_t i = text_layout->processed; i < text_size; i++) {
+        char symbol = text[i];
+        if(symbol == '\n') {
+            TextLayoutLineArray_push_back(text_layout->lines, i + 1);
+            text_layout->line_width = 0;
+        } else {
+            uint8_t glyph_width = text_layout_glyph_width(text_layout, canvas, symbol);
+            if(text_layout->line_width + glyph_width > text_layout->width) {
+                // symbol doesn't fit, move it to the next line
+                TextLayoutLineArray_push_back(text_layout->lines, i);
+                text_layout->line_width = 0;
+            }
+            text_layout->line_width += glyph_width;
+        }
+    }
+    text_layout->processed = text_size;
+}
+
+size_t text_layout_get_lines_count(TextLayout* text_layout) {
+    furi_assert(text_layout);
+    return TextLayoutLineArray_size(text_layout->lines);
+}
+
+const char* text_layout_get_line(TextLayout* text_layout, size_t index, size_t* length) {
+    furi_assert(text_layout);
+    furi_assert(length);
+
+    size_t lines_count = TextLayoutLineArray_size(text_layout->lines);
+    furi_assert(index < lines_count);
+
+    size_t start = *TextLayoutLineArray_get(text_layout->lines, index);
+    size_t end = (index + 1 < lines_count) ?
+                     *TextLayoutLineArray_get(text_layout->lines, index + 1) :
+                     text_layout->processed;
+    if((end > start) && (text_layout->text[end - 1] == '\n')) {
+        end--;
+    }
+
+    *length = end - start;
+    return &text_layout->text[start];
+}
+
+void text_layout_draw(
+    TextLayout* text_layout,
+    Canvas* canvas,
+    uint8_t x,
+    uint8_t y,
+    size_t first_line,
+    size_t lines_num) {
+    furi_assert(text_layout);
+    furi_assert(canvas);
+
+    size_t lines_count = TextLayoutLineArray_size(text_layout->lines);
+    uint8_t font_height = canvas_current_font_height(canvas);
+
+    for(size_t i = first_line; (i < lines_count) && (i < first_line + lines_num); i++) {
+        size_t length = 0;
+        const char* line = text_layout_get_line(text_layout, i, &length);
+        text_layout_draw_str(canvas, x, y, line, length);
+        y += font_height;
+    }
+}
+
+void text_layout_draw_str(Canvas* canvas, uint8_t x, uint8_t y, const char* text, size_t length) {
+    furi_assert(canvas);
+    furi_assert(text);
+
+    uint16_t glyph_x = x;
+    uint8_t width = canvas_width(canvas);
+    for(size_t i = 0; (i < length) && (glyph_x < width); i++) {
+        glyph_x += canvas_draw_glyph(canvas, glyph_x, y, (uint8_t)text[i]);
+    }
+}
@@ -0,0 +1,135 @@
+/**
+ * @file text_layout.h
+ * GUI: TextLayout API
+ *
+ * Splits caller's text into lines that fit given width. Text is not copied.
+ * Text can be extended, only new part of text is processed. Glyph widths
+ * are cached.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "canvas.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** TextLayout anonymous structure */
+typedef struct TextLayout TextLayout;
+
+/** Allocate and initialize TextLayout
+ *
+ * @param      width  maximum line width in pixels
+ *
+ * @return     TextLayout instance
+ */
+TextLayout* text_layout_alloc(uint8_t width);
+
+/** Deinitialize and free TextLayout
+ *
+ * @param      text_layout  TextLayout instance
+ */
+void text_layout_free(TextLayout* text_layout);
+
+/** Remove all text
+ *
+ * @param      text_layout  TextLayout instance
+ */
+void text_layout_reset(TextLayout* text_layout);
+
+/** Set text
+ * Text is not copied and must stay valid until it is replaced or layout is
+ * reset, lines are calculated on next text_layout_update() call
+ *
+ * @param      text_layout  TextLayout instance
+ * @param      text         zero terminated text
+ */
+void text_layout_set_text(TextLayout* text_layout, const char* text);
+
+/** Set font, text will be split into lines again
+ *
+ * @param      text_layout  TextLayout instance
+ * @param      font         Font
+ */
+void text_layout_set_font(TextLayout* text_layout, Font font);
+
+/** Get font
+ *
+ * @param      text_layout  TextLayout instance
+ *
+ * @return     Font
+ */
+Font text_layout_get_font(TextLayout* text_layout);
+
+/** Set text that starts with current text
+ * Use it when text buffer is appended, buffer may be reallocated and previous
+ * one freed before the call. Only new part is split into lines on next
+ * text_layout_update() call
+ *
+ * @param      text_layout  TextLayout instance
+ * @param      text         zero terminated text, current text is its prefix
+ */
+void text_layout_extend_text(TextLayout* text_layout, const char* text);
+
+/** Split appended text into lines
+ * Sets layout font on canvas
+ *
+ * @param      text_layout  TextLayout instance
+ * @param      canvas       Canvas instance, used to get glyph widths
+ */
+void text_layout_update(TextLayout* text_layout, Canvas* canvas);
+
+/** Get lines count
+ * Empty text and text ending with newline have empty last line
+ *
+ * @param      text_layout  TextLayout instance
+ *
+ * @return     lines count
+ */
+size_t text_layout_get_lines_count(TextLayout* text_layout);
+
+/** Get line
+ * text_layout_update() must be called before
+ *
+ * @param      text_layout  TextLayout instance
+ * @param      index        line index, less than lines count
+ * @param      length       line length without newline
+ *
+ * @return     line start in text, line is not zero terminated
+ */
+const char* text_layout_get_line(TextLayout* text_layout, size_t index, size_t* length);
+
+/** Draw lines
+ * text_layout_update() must be called before
+ *
+ * @param      text_layout  TextLayout instance
+ * @param      canvas       Canvas instance
+ * @param      x            x coordinate of lines
+ * @param      y            baseline of first line
+ * @param      first_line   index of first line to draw
+ * @param      lines_num    maximum lines to draw
+ */
+void text_layout_draw(
+    TextLayout* text_layout,
+    Canvas* canvas,
+    uint8_t x,
+    uint8_t y,
+    size_t first_line,
+    size_t lines_num);
+
+/** Draw part of string without copying it, stops at canvas edge
+ *
+ * @param      canvas  Canvas instance
+ * @param      x       x coordinate of string
+ * @param      y       baseline of string
+ * @param      text    string start
+ * @param      length  amount of symbols to draw
+ */
+void text_layout_draw_str(Canvas* canvas, uint8_t x, uint8_t y, const char* text, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
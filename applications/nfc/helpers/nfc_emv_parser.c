@@ -1,34 +1,403 @@
 #include "nfc_emv_parser.h"
 #include <flipper_format/flipper_format.h>
+#include <flipper_format/flipper_format_i.h>
+#include <toolbox/hex.h>
+#include <toolbox/crc32.h>
+#include <m-array.h>
+
+#define TAG "NfcEmvParser"
+
+#define NFC_EMV_INDEX_MAGIC (0x49564D45) // EMVI
+#define NFC_EMV_INDEX_VERSION (2)
+#define NFC_EMV_INDEX_KEY_SIZE (16)
+#define NFC_EMV_SOURCE_READ_SIZE (256)
+#define NFC_EMV_SOURCE_CACHE_SIZE (3)
+#define NFC_EMV_ASSETS_FOLDER "/ext/nfc/assets/"
+#define NFC_EMV_SOURCE_EXTENSION ".nfc"
 
 static const char* nfc_resources_header = "Flipper EMV resources";
 static const uint32_t nfc_resources_file_version = 1;
 
-static bool nfc_emv_parser_search_data(
+/*
+ * Index file is generated from resources file on first use and rebuilt when
+ * resources file size or CRC32 changes: edited file may keep its size, and
+ * there is no modification time in storage API. Records are sorted by key,
+ * names are stored after records:
+ * | header | record 0 | ... | record N-1 | names |
+ */
+typedef struct {
+    uint32_t magic;
+    uint8_t version;
+    uint32_t source_size;
+    uint32_t source_crc;
+    uint16_t count;
+    uint16_t names_size;
+} __attribute__((packed)) NfcEmvIndexHeader;
+
+typedef struct {
+    uint8_t key_size;
+    uint8_t key[NFC_EMV_INDEX_KEY_SIZE];
+    uint16_t name_offset;
+    uint8_t name_size;
+} __attribute__((packed)) NfcEmvIndexRecord;
+
+typedef struct {
+    NfcEmvIndexRecord record;
+    uint16_t order;
+} NfcEmvIndexItem;
+
+ARRAY_DEF(NfcEmvIndexItemArray, NfcEmvIndexItem, M_POD_OPLIST)
+
+/*
+ * Resources file CRC32 is calculated on first lookup and kept until storage
+ * reports that a resources file is closed or card is (un)mounted: any of them
+ * moves generation forward and invalidates all cached entries. Closing after
+ * our own reads does it too, so after index rebuild CRC is calculated again
+ * once.
+ */
+typedef struct {
+    const char* file_name;
+    uint32_t source_size;
+    uint32_t source_crc;
+    uint32_t generation;
+} NfcEmvSourceCacheEntry;
+
+static NfcEmvSourceCacheEntry nfc_emv_source_cache[NFC_EMV_SOURCE_CACHE_SIZE];
+// starts after generation of zeroed entries
+static volatile uint32_t nfc_emv_source_generation = 1;
+static FuriPubSubSubscription* nfc_emv_source_subscription = NULL;
+
+static int nfc_emv_parser_key_cmp(
+    const uint8_t* key_a,
+    uint8_t key_a_size,
+    const uint8_t* key_b,
+    uint8_t key_b_size) {
+    if(key_a_size != key_b_size) {
+        return key_a_size < key_b_size ? -1 : 1;
+    }
+    return memcmp(key_a, key_b, key_a_size);
+}
+
+static int nfc_emv_parser_item_cmp(const void* a, const void* b) {
+    const NfcEmvIndexItem* item_a = a;
+    const NfcEmvIndexItem* item_b = b;
+    int result = nfc_emv_parser_key_cmp(
+        item_a->record.key, item_a->record.key_size, item_b->record.key, item_b->record.key_size);
+    if(result == 0) {
+        // keep file order for duplicates, first one wins
+        result = (int)item_a->order - (int)item_b->order;
+    }
+    return result;
+}
+
+static bool nfc_emv_parser_parse_line(string_t line, NfcEmvIndexRecord* record, string_t name) {
+    size_t delimiter = string_search_char(line, ':');
+    if(delimiter == STRING_FAILURE || delimiter % 2 || delimiter == 0 ||
+       delimiter > NFC_EMV_INDEX_KEY_SIZE * 2) {
+        return false;
+    }
+
+    const char* str = string_get_cstr(line);
+    for(size_t i = 0; i < delimiter / 2; i++) {
+        if(!hex_chars_to_uint8(str[i * 2], str[i * 2 + 1], &record->key[i])) return false;
+    }
+    record->key_size = delimiter / 2;
+
+    // skip ": ", drop line ending
+    string_set_str(name, &str[MIN(delimiter + 2, string_size(line))]);
+    while(string_size(name)) {
+        char last = string_get_char(name, string_size(name) - 1);
+        if(last != '\n' && last != '\r') break;
+        string_left(name, string_size(name) - 1);
+    }
+    return string_size(name) > 0 && string_size(name) <= UINT8_MAX;
+}
+
+static bool nfc_emv_parser_index_build(
     Storage* storage,
     const char* file_name,
-    string_t key,
-    string_t data) {
-    bool parsed = false;
-    FlipperFormat* file = flipper_format_file_alloc(storage);
-    string_t temp_str;
-    string_init(temp_str);
+    const char* index_name,
+    uint32_t source_size,
+    uint32_t source_crc) {
+    bool built = false;
+    FlipperFormat* source = flipper_format_file_alloc(storage);
+    File* index = storage_file_alloc(storage);
+    NfcEmvIndexItemArray_t items;
+    NfcEmvIndexItemArray_init(items);
+    string_t line, name, names;
+    string_init(line);
+    string_init(name);
+    string_init(names);
 
     do {
         // Open file
-        if(!flipper_format_file_open_existing(file, file_name)) break;
+        if(!flipper_format_file_open_existing(source, file_name)) break;
         // Read file header and version
         uint32_t version = 0;
-        if(!flipper_format_read_header(file, temp_str, &version)) break;
-        if(string_cmp_str(temp_str, nfc_resources_header) ||
-           (version != nfc_resources_file_version))
+        if(!flipper_format_read_header(source, line, &version)) break;
+        if(string_cmp_str(line, nfc_resources_header) || (version != nfc_resources_file_version))
+            break;
+
+        Stream* stream = flipper_format_get_raw_stream(source);
+        uint16_t order = 0;
+        NfcEmvIndexItem item = {0};
+        while(stream_read_line(stream, line)) {
+            // comments and malformed lines are skipped
+            if(!nfc_emv_parser_parse_line(line, &item.record, name)) continue;
+            if(string_size(names) + string_size(name) > UINT16_MAX) break;
+            item.record.name_offset = string_size(names);
+            item.record.name_size = string_size(name);
+            item.order = order++;
+            string_cat(names, name);
+            NfcEmvIndexItemArray_push_back(items, item);
+        }
+
+        size_t count = NfcEmvIndexItemArray_size(items);
+        if(count == 0 || count > UINT16_MAX) break;
+        qsort(
+            NfcEmvIndexItemArray_get(items, 0),
+            count,
+            sizeof(NfcEmvIndexItem),
+            nfc_emv_parser_item_cmp);
+
+        if(!storage_file_open(index, index_name, FSAM_WRITE, FSOM_CREATE_ALWAYS)) break;
+        // Header is written last, incomplete index is rejected and rebuilt
+        NfcEmvIndexHeader header = {0};
+        if(storage_file_write(index, &header, sizeof(header)) != sizeof(header)) break;
+
+        const NfcEmvIndexRecord* previous = NULL;
+        bool write_error = false;
+        for(size_t i = 0; i < count; i++) {
+            const NfcEmvIndexRecord* record = &NfcEmvIndexItemArray_get(items, i)->record;
+            // duplicates follow the first occurrence after sort
+            if(previous && previous->key_size == record->key_size &&
+               memcmp(previous->key, record->key, record->key_size) == 0) {
+                continue;
+            }
+            if(storage_file_write(index, record, sizeof(NfcEmvIndexRecord)) !=
+               sizeof(NfcEmvIndexRecord)) {
+                write_error = true;
+                break;
+            }
+            previous = record;
+            header.count++;
+        }
+        if(write_error) break;
+
+        header.names_size = string_size(names);
+        if(storage_file_write(index, string_get_cstr(names), header.names_size) !=
+           header.names_size)
+            break;
+
+        header.magic = NFC_EMV_INDEX_MAGIC;
+        header.version = NFC_EMV_INDEX_VERSION;
+        header.source_size = source_size;
+        header.source_crc = source_crc;
+        if(!storage_file_seek(index, 0, true)) break;
+        if(storage_file_write(index, &header, sizeof(header)) != sizeof(header)) break;
+
+        FURI_LOG_I(TAG, "Index for %s built, %d records", file_name, header.count);
+        built = true;
+    } while(false);
+
+    storage_file_close(index);
+    storage_file_free(index);
+    flipper_format_free(source);
+    NfcEmvIndexItemArray_clear(items);
+    string_clear(line);
+    string_clear(name);
+    string_clear(names);
+
+    if(!built) {
+        storage_simply_remove(storage, index_name);
+    }
+    return built;
+}
+
+static bool nfc_emv_parser_source_crc(
+    Storage* storage,
+    const char* file_name,
+    uint32_t* source_size,
+    uint32_t* source_crc) {
+    File* source = storage_file_alloc(storage);
+    uint8_t* buffer = malloc(NFC_EMV_SOURCE_READ_SIZE);
+    bool result = false;
+
+    if(storage_file_open(source, file_name, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        *source_size = storage_file_size(source);
+        *source_crc = 0;
+        size_t read_size = 0;
+        uint32_t total_size = 0;
+        while((read_size = storage_file_read(source, buffer, NFC_EMV_SOURCE_READ_SIZE)) > 0) {
+            *source_crc = crc32_calc_buffer(*source_crc, buffer, read_size);
+            total_size += read_size;
+        }
+        result = (storage_file_get_error(source) == FSE_OK) && (total_size == *source_size);
+    }
+
+    storage_file_close(source);
+    storage_file_free(source);
+    free(buffer);
+    return result;
+}
+
+static void nfc_emv_parser_storage_callback(const void* message, void* context) {
+    UNUSED(context);
+    const StorageEvent* storage_event = message;
+
+    // index files are written in the same folder, they don't change resources
+    bool outdated = true;
+    if(storage_event->type == StorageEventTypeFileClose && storage_event->path) {
+        outdated = strncmp(
+                       storage_event->path,
+                       NFC_EMV_ASSETS_FOLDER,
+                       strlen(NFC_EMV_ASSETS_FOLDER)) == 0 &&
+                   strstr(storage_event->path, NFC_EMV_SOURCE_EXTENSION) != NULL;
+    }
+
+    if(outdated) {
+        nfc_emv_source_generation++;
+    }
+}
+
+static bool nfc_emv_parser_source_check(
+    Storage* storage,
+    const char* file_name,
+    uint32_t* source_size,
+    uint32_t* source_crc) {
+    if(nfc_emv_source_subscription == NULL) {
+        // Lives until reboot, as the cache
+        nfc_emv_source_subscription = furi_pubsub_subscribe(
+            storage_get_pubsub(storage), nfc_emv_parser_storage_callback, NULL);
+    }
+
+    NfcEmvSourceCacheEntry* entry = NULL;
+    for(size_t i = 0; i < NFC_EMV_SOURCE_CACHE_SIZE; i++) {
+        NfcEmvSourceCacheEntry* current = &nfc_emv_source_cache[i];
+        if(current->file_name == NULL || strcmp(current->file_name, file_name) == 0) {
+            entry = current;
+            break;
+        }
+    }
+
+    if(entry && entry->generation == nfc_emv_source_generation) {
+        *source_size = entry->source_size;
+        *source_crc = entry->source_crc;
+        return true;
+    }
+
+    if(!nfc_emv_parser_source_crc(storage, file_name, source_size, source_crc)) return false;
+
+    // Generation is taken after source is closed: closing it for reading sends event too
+    if(entry) {
+        entry->file_name = file_name;
+        entry->source_size = *source_size;
+        entry->source_crc = *source_crc;
+        entry->generation = nfc_emv_source_generation;
+    }
+    return true;
+}
+
+static bool nfc_emv_parser_index_check(
+    File* index,
+    uint32_t source_size,
+    uint32_t source_crc,
+    NfcEmvIndexHeader* header) {
+    if(storage_file_read(index, header, sizeof(NfcEmvIndexHeader)) != sizeof(NfcEmvIndexHeader)) {
+        return false;
+    }
+    return header->magic == NFC_EMV_INDEX_MAGIC && header->version == NFC_EMV_INDEX_VERSION &&
+           header->source_size == source_size && header->source_crc == source_crc &&
+           storage_file_size(index) == sizeof(NfcEmvIndexHeader) +
+                                           header->count * sizeof(NfcEmvIndexRecord) +
+                                           header->names_size;
+}
+
+static bool nfc_emv_parser_index_open(
+    Storage* storage,
+    File* index,
+    const char* file_name,
+    const char* index_name,
+    NfcEmvIndexHeader* header) {
+    uint32_t source_size = 0;
+    uint32_t source_crc = 0;
+    if(!nfc_emv_parser_source_check(storage, file_name, &source_size, &source_crc)) return false;
+
+    if(storage_file_open(index, index_name, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        if(nfc_emv_parser_index_check(index, source_size, source_crc, header)) return true;
+    }
+    storage_file_close(index);
+
+    if(!nfc_emv_parser_index_build(storage, file_name, index_name, source_size, source_crc))
+        return false;
+
+    if(storage_file_open(index, index_name, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        if(nfc_emv_parser_index_check(index, source_size, source_crc, header)) return true;
+    }
+    storage_file_close(index);
+    return false;
+}
+
+static bool nfc_emv_parser_search_data(
+    Storage* storage,
+    const char* file_name,
+    const char* index_name,
+    const uint8_t* key,
+    uint8_t key_size,
+    string_t data) {
+    bool parsed = false;
+    File* index = storage_file_alloc(storage);
+    NfcEmvIndexHeader header;
+    NfcEmvIndexRecord record;
+
+    do {
+        if(!nfc_emv_parser_index_open(storage, index, file_name, index_name, &header)) {
+            FURI_LOG_E(TAG, "Failed to open index for %s", file_name);
+            break;
+        }
+
+        // Binary search over fixed size records
+        int32_t left = 0;
+        int32_t right = header.count - 1;
+        bool found = false;
+        while(left <= right) {
+            int32_t middle = (left + right) / 2;
+            if(!storage_file_seek(
+                   index,
+                   sizeof(NfcEmvIndexHeader) + middle * sizeof(NfcEmvIndexRecord),
+                   true))
+                break;
+            if(storage_file_read(index, &record, sizeof(NfcEmvIndexRecord)) !=
+               sizeof(NfcEmvIndexRecord))
+                break;
+            int result = nfc_emv_parser_key_cmp(record.key, record.key_size, key, key_size);
+            if(result == 0) {
+                found = true;
+                break;
+            } else if(result < 0) {
+                left = middle + 1;
+            } else {
+                right = middle - 1;
+            }
+        }
+        if(!found) break;
+
+        // Single seek to name
+        char name[UINT8_MAX + 1];
+        if(!storage_file_seek(
+               index,
+               sizeof(NfcEmvIndexHeader) + header.count * sizeof(NfcEmvIndexRecord) +
+                   record.name_offset,
+               true))
             break;
-        if(!flipper_format_read_string(file, string_get_cstr(key), data)) break;
+        if(storage_file_read(index, name, record.name_size) != record.name_size) break;
+        name[record.name_size] = '\0';
+        string_set_str(data, name);
         parsed = true;
     } while(false);
 
-    string_clear(temp_str);
-    flipper_format_free(file);
+    storage_file_close(index);
+    storage_file_free(index);
     return parsed;
 }
 
@@ -38,44 +407,35 @@ bool nfc_emv_parser_get_aid_name(
     uint8_t aid_len,
     string_t aid_name) {
     furi_assert(storage);
-    bool parsed = false;
-    string_t key;
-    string_init(key);
-    for(uint8_t i = 0; i < aid_len; i++) {
-        string_cat_printf(key, "%02X", aid[i]);
-    }
-    if(nfc_emv_parser_search_data(storage, "/ext/nfc/assets/aid.nfc", key, aid_name)) {
-        parsed = true;
-    }
-    string_clear(key);
-    return parsed;
+    if(aid_len == 0 || aid_len > NFC_EMV_INDEX_KEY_SIZE) return false;
+    return nfc_emv_parser_search_data(
+        storage, "/ext/nfc/assets/aid.nfc", "/ext/nfc/assets/aid.idx", aid, aid_len, aid_name);
 }
 
 bool nfc_emv_parser_get_country_name(
     Storage* storage,
     uint16_t country_code,
     string_t country_name) {
-    bool parsed = false;
-    string_t key;
-    string_init_printf(key, "%04X", country_code);
-    if(nfc_emv_parser_search_data(storage, "/ext/nfc/assets/country_code.nfc", key, country_name)) {
-        parsed = true;
-    }
-    string_clear(key);
-    return parsed;
+    uint8_t key[] = {country_code >> 8, country_code & 0xFF};
+    return nfc_emv_parser_search_data(
+        storage,
+        "/ext/nfc/assets/country_code.nfc",
+        "/ext/nfc/assets/country_code.idx",
+        key,
+        sizeof(key),
+        country_name);
 }
 
 bool nfc_emv_parser_get_currency_name(
     Storage* storage,
     uint16_t currency_code,
     string_t currency_name) {
-    bool parsed = false;
-    string_t key;
-    string_init_printf(key, "%04X", currency_code);
-    if(nfc_emv_parser_search_data(
-           storage, "/ext/nfc/assets/currency_code.nfc", key, currency_name)) {
-        parsed = true;
-    }
-    string_clear(key);
-    return parsed;
+    uint8_t key[] = {currency_code >> 8, currency_code & 0xFF};
+    return nfc_emv_parser_search_data(
+        storage,
+        "/ext/nfc/assets/currency_code.nfc",
+        "/ext/nfc/assets/currency_code.idx",
+        key,
+        sizeof(key),
+        currency_name);
 }
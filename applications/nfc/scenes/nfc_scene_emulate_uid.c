@@ -101,7 +101,7 @@ bool nfc_scene_emulate_uid_on_event(void* context, SceneManagerEvent event) {
             }
             string_push_back(nfc->text_box_store, '\n');
             memset(reader_data, 0, sizeof(NfcReaderRequestData));
-            text_box_set_text(nfc->text_box, string_get_cstr(nfc->text_box_store));
+            text_box_extend_text(nfc->text_box, string_get_cstr(nfc->text_box_store));
             consumed = true;
         } else if(event.event == GuiButtonTypeCenter && state == NfcSceneEmulateUidStateWidget) {
             view_dispatcher_switch_to_view(nfc->view_dispatcher, NfcViewTextBox);
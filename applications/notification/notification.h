@@ -71,6 +71,14 @@ typedef const NotificationMessage* NotificationSequence[];
 void notification_message(NotificationApp* app, const NotificationSequence* sequence);
 void notification_message_block(NotificationApp* app, const NotificationSequence* sequence);
 
+/**
+ * @brief Stop running notification sequence, outputs used by it are reset.
+ * 
+ * @param app notification record content
+ * @param sequence notification sequence
+ */
+void notification_message_cancel(NotificationApp* app, const NotificationSequence* sequence);
+
 /**
  * @brief Send internal (apply to permanent layer) notification message. Think twice before use.
  * 
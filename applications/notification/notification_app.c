@@ -110,8 +110,13 @@ void notification_reset_notification_layer(NotificationApp* app, uint8_t reset_m
     }
 }
 
-static void notification_apply_notification_leds(NotificationApp* app, const uint8_t* values) {
+static void notification_apply_notification_leds(
+    NotificationApp* app,
+    const uint8_t* values,
+    uint32_t outputs) {
     for(uint8_t i = 0; i < NOTIFICATION_LED_COUNT; i++) {
+        // led masks match led indexes
+        if(!(outputs & (1 << i))) continue;
         notification_apply_notification_led_layer(
             &app->led[i], notification_settings_get_rgb_led_brightness(app, values[i]));
     }
@@ -155,151 +160,253 @@ static void notification_display_timer(void* ctx) {
 }
 
 // message processing
-void notification_process_notification_message(
-    NotificationApp* app,
-    NotificationAppMessage* message) {
-    uint32_t notification_message_index = 0;
-    const NotificationMessage* notification_message;
-    notification_message = (*message->sequence)[notification_message_index];
+typedef enum {
+    NotificationSequenceStageRun,
+    NotificationSequenceStageLedOn,
+    NotificationSequenceStageEnd,
+} NotificationSequenceStage;
+
+typedef struct {
+    const NotificationSequence* sequence;
+    osEventFlagsId_t back_event;
+    NotificationSequenceStage stage;
+    uint32_t index;
+    uint32_t delay;
+
+    bool led_active;
+    uint8_t display_led_lock;
+    uint8_t led_values[NOTIFICATION_LED_COUNT];
+    bool reset_notifications;
+    float speaker_volume_setting;
+    bool vibro_setting;
+    float display_brightness_setting;
+    uint8_t reset_mask;
+} NotificationSequenceState;
+
+static uint32_t notification_ms_to_ticks(uint32_t ms) {
+    return ms * osKernelGetTickFreq() / 1000;
+}
+
+static uint32_t notification_sequence_get_outputs(const NotificationSequence* sequence) {
+    uint32_t outputs = 0;
+    for(size_t i = 0; (*sequence)[i] != NULL; i++) {
+        switch((*sequence)[i]->type) {
+        case NotificationMessageTypeLedDisplay:
+            outputs |= reset_display_mask;
+            break;
+        case NotificationMessageTypeLedRed:
+            outputs |= reset_red_mask;
+            break;
+        case NotificationMessageTypeLedGreen:
+            outputs |= reset_green_mask;
+            break;
+        case NotificationMessageTypeLedBlue:
+            outputs |= reset_blue_mask;
+            break;
+        case NotificationMessageTypeVibro:
+            outputs |= reset_vibro_mask;
+            break;
+        case NotificationMessageTypeSoundOn:
+        case NotificationMessageTypeSoundOff:
+            outputs |= reset_sound_mask;
+            break;
+        default:
+            break;
+        }
+    }
+    return outputs;
+}
 
-    bool led_active = false;
-    uint8_t display_led_lock = 0;
-    uint8_t led_values[NOTIFICATION_LED_COUNT] = {0x00, 0x00, 0x00};
-    bool reset_notifications = true;
-    float speaker_volume_setting = app->settings.speaker_volume;
-    bool vibro_setting = app->settings.vibro_on;
-    float display_brightness_setting = app->settings.display_brightness;
+// runs sequence until next delay, returns delay in ticks
+static uint32_t notification_sequence_step(void* context, void* item, uint32_t outputs) {
+    NotificationApp* app = context;
+    NotificationSequenceState* state = item;
+
+    if(state->stage == NotificationSequenceStageLedOn) {
+        // minimal delay with leds off is over, show leds for the rest of delay
+        notification_apply_notification_leds(app, state->led_values, outputs);
+        state->stage = NotificationSequenceStageRun;
+        return notification_ms_to_ticks(state->delay);
+    } else if(state->stage == NotificationSequenceStageEnd) {
+        return NOTIFICATION_TIMELINE_DONE;
+    }
 
-    uint8_t reset_mask = 0;
+    const NotificationMessage* notification_message;
+    while((notification_message = (*state->sequence)[state->index]) != NULL) {
+        state->index++;
 
-    while(notification_message != NULL) {
         switch(notification_message->type) {
         case NotificationMessageTypeLedDisplay:
+            if(!(outputs & reset_display_mask)) break;
             // if on - switch on and start timer
             // if off - switch off and stop timer
             // on timer - switch off
             if(notification_message->data.led.value > 0x00) {
                 notification_apply_notification_led_layer(
                     &app->display,
-                    notification_message->data.led.value * display_brightness_setting);
+                    notification_message->data.led.value * state->display_brightness_setting);
             } else {
                 notification_reset_notification_led_layer(&app->display);
                 if(osTimerIsRunning(app->display_timer)) {
                     osTimerStop(app->display_timer);
                 }
             }
-            reset_mask |= reset_display_mask;
+            state->reset_mask |= reset_display_mask;
             break;
         case NotificationMessageTypeLedDisplayLock:
-            furi_assert(display_led_lock < UINT8_MAX);
-            display_led_lock++;
-            if(display_led_lock == 1) {
+            furi_assert(state->display_led_lock < UINT8_MAX);
+            state->display_led_lock++;
+            if(state->display_led_lock == 1) {
                 notification_apply_internal_led_layer(
                     &app->display,
-                    notification_message->data.led.value * display_brightness_setting);
+                    notification_message->data.led.value * state->display_brightness_setting);
             }
             break;
         case NotificationMessageTypeLedDisplayUnlock:
-            furi_assert(display_led_lock > 0);
-            display_led_lock--;
-            if(display_led_lock == 0) {
+            furi_assert(state->display_led_lock > 0);
+            state->display_led_lock--;
+            if(state->display_led_lock == 0) {
                 notification_apply_internal_led_layer(
                     &app->display,
-                    notification_message->data.led.value * display_brightness_setting);
+                    notification_message->data.led.value * state->display_brightness_setting);
             }
             break;
         case NotificationMessageTypeLedRed:
             // store and send on delay or after seq
-            led_active = true;
-            led_values[0] = notification_message->data.led.value;
-            reset_mask |= reset_red_mask;
+            state->led_active = true;
+            state->led_values[0] = notification_message->data.led.value;
+            state->reset_mask |= reset_red_mask;
             break;
         case NotificationMessageTypeLedGreen:
             // store and send on delay or after seq
-            led_active = true;
-            led_values[1] = notification_message->data.led.value;
-            reset_mask |= reset_green_mask;
+            state->led_active = true;
+            state->led_values[1] = notification_message->data.led.value;
+            state->reset_mask |= reset_green_mask;
             break;
         case NotificationMessageTypeLedBlue:
             // store and send on delay or after seq
-            led_active = true;
-            led_values[2] = notification_message->data.led.value;
-            reset_mask |= reset_blue_mask;
+            state->led_active = true;
+            state->led_values[2] = notification_message->data.led.value;
+            state->reset_mask |= reset_blue_mask;
             break;
         case NotificationMessageTypeVibro:
+            if(!(outputs & reset_vibro_mask)) break;
             if(notification_message->data.vibro.on) {
-                if(vibro_setting) notification_vibro_on();
+                if(state->vibro_setting) notification_vibro_on();
             } else {
                 notification_vibro_off();
             }
-            reset_mask |= reset_vibro_mask;
+            state->reset_mask |= reset_vibro_mask;
             break;
         case NotificationMessageTypeSoundOn:
+            if(!(outputs & reset_sound_mask)) break;
             notification_sound_on(
                 notification_message->data.sound.frequency,
-                notification_message->data.sound.volume * speaker_volume_setting);
-            reset_mask |= reset_sound_mask;
+                notification_message->data.sound.volume * state->speaker_volume_setting);
+            state->reset_mask |= reset_sound_mask;
             break;
         case NotificationMessageTypeSoundOff:
+            if(!(outputs & reset_sound_mask)) break;
             notification_sound_off();
-            reset_mask |= reset_sound_mask;
+            state->reset_mask |= reset_sound_mask;
             break;
         case NotificationMessageTypeDelay:
-            if(led_active) {
+            if(state->led_active) {
+                state->led_active = false;
+                state->reset_mask |= reset_red_mask;
+                state->reset_mask |= reset_green_mask;
+                state->reset_mask |= reset_blue_mask;
+
                 if(notification_is_any_led_layer_internal_and_not_empty(app)) {
-                    notification_apply_notification_leds(app, led_off_values);
-                    furi_hal_delay_ms(minimal_delay);
+                    notification_apply_notification_leds(app, led_off_values, outputs);
+                    state->delay = notification_message->data.delay.length;
+                    state->stage = NotificationSequenceStageLedOn;
+                    return notification_ms_to_ticks(minimal_delay);
                 }
 
-                led_active = false;
-
-                notification_apply_notification_leds(app, led_values);
-                reset_mask |= reset_red_mask;
-                reset_mask |= reset_green_mask;
-                reset_mask |= reset_blue_mask;
+                notification_apply_notification_leds(app, state->led_values, outputs);
             }
 
-            furi_hal_delay_ms(notification_message->data.delay.length);
-            break;
+            return notification_ms_to_ticks(notification_message->data.delay.length);
         case NotificationMessageTypeDoNotReset:
-            reset_notifications = false;
+            state->reset_notifications = false;
             break;
         case NotificationMessageTypeForceSpeakerVolumeSetting:
-            speaker_volume_setting = notification_message->data.forced_settings.speaker_volume;
+            state->speaker_volume_setting =
+                notification_message->data.forced_settings.speaker_volume;
             break;
         case NotificationMessageTypeForceVibroSetting:
-            vibro_setting = notification_message->data.forced_settings.vibro;
+            state->vibro_setting = notification_message->data.forced_settings.vibro;
             break;
         case NotificationMessageTypeForceDisplayBrightnessSetting:
-            display_brightness_setting =
+            state->display_brightness_setting =
                 notification_message->data.forced_settings.display_brightness;
         }
-        notification_message_index++;
-        notification_message = (*message->sequence)[notification_message_index];
     };
 
     // send and do minimal delay
-    if(led_active) {
+    if(state->led_active) {
         bool need_minimal_delay = false;
         if(notification_is_any_led_layer_internal_and_not_empty(app)) {
             need_minimal_delay = true;
         }
 
-        led_active = false;
-        notification_apply_notification_leds(app, led_values);
-        reset_mask |= reset_red_mask;
-        reset_mask |= reset_green_mask;
-        reset_mask |= reset_blue_mask;
+        state->led_active = false;
+        notification_apply_notification_leds(app, state->led_values, outputs);
+        state->reset_mask |= reset_red_mask;
+        state->reset_mask |= reset_green_mask;
+        state->reset_mask |= reset_blue_mask;
 
         if(need_minimal_delay) {
-            notification_apply_notification_leds(app, led_off_values);
-            furi_hal_delay_ms(minimal_delay);
+            notification_apply_notification_leds(app, led_off_values, outputs);
+            state->stage = NotificationSequenceStageEnd;
+            return notification_ms_to_ticks(minimal_delay);
         }
     }
 
-    if(reset_notifications) {
-        notification_reset_notification_layer(app, reset_mask);
+    return NOTIFICATION_TIMELINE_DONE;
+}
+
+static void
+    notification_sequence_end(void* context, void* item, uint32_t outputs, bool cancelled) {
+    NotificationApp* app = context;
+    NotificationSequenceState* state = item;
+
+    // cancelled sequence is stopped regardless of reset settings
+    if(state->reset_notifications || cancelled) {
+        notification_reset_notification_layer(app, state->reset_mask & outputs);
     }
+
+    if(state->back_event != NULL) {
+        osEventFlagsSet(state->back_event, NOTIFICATION_EVENT_COMPLETE);
+    }
+
+    free(state);
+}
+
+void notification_process_notification_message(
+    NotificationApp* app,
+    NotificationAppMessage* message) {
+    NotificationSequenceState* state = malloc(sizeof(NotificationSequenceState));
+    state->sequence = message->sequence;
+    state->back_event = message->back_event;
+    state->stage = NotificationSequenceStageRun;
+    state->index = 0;
+    state->led_active = false;
+    state->display_led_lock = 0;
+    memset(state->led_values, 0x00, NOTIFICATION_LED_COUNT);
+    state->reset_notifications = true;
+    state->speaker_volume_setting = app->settings.speaker_volume;
+    state->vibro_setting = app->settings.vibro_on;
+    state->display_brightness_setting = app->settings.display_brightness;
+    state->reset_mask = 0;
+
+    notification_timeline_add(
+        app->timeline,
+        message->sequence,
+        state,
+        notification_sequence_get_outputs(message->sequence),
+        osKernelGetTickCount());
 }
 
 void notification_process_internal_message(NotificationApp* app, NotificationAppMessage* message) {
@@ -425,6 +532,8 @@ static NotificationApp* notification_app_alloc() {
     NotificationApp* app = malloc(sizeof(NotificationApp));
     app->queue = osMessageQueueNew(8, sizeof(NotificationAppMessage), NULL);
     app->display_timer = osTimerNew(notification_display_timer, osTimerOnce, app, NULL);
+    app->timeline =
+        notification_timeline_alloc(notification_sequence_step, notification_sequence_end, app);
 
     app->settings.speaker_volume = 1.0f;
     app->settings.display_brightness = 1.0f;
@@ -480,24 +589,31 @@ int32_t notification_srv(void* p) {
     furi_record_create("notification", app);
 
     NotificationAppMessage message;
+    uint32_t timeout = osWaitForever;
     while(1) {
-        furi_check(osMessageQueueGet(app->queue, &message, NULL, osWaitForever) == osOK);
+        if(osMessageQueueGet(app->queue, &message, NULL, timeout) == osOK) {
+            switch(message.type) {
+            case NotificationLayerMessage:
+                // back event is set when sequence ends
+                notification_process_notification_message(app, &message);
+                break;
+            case InternalLayerMessage:
+                notification_process_internal_message(app, &message);
+                break;
+            case CancelMessage:
+                notification_timeline_cancel(app->timeline, message.sequence);
+                break;
+            case SaveSettingsMessage:
+                notification_save_settings(app);
+                break;
+            }
 
-        switch(message.type) {
-        case NotificationLayerMessage:
-            notification_process_notification_message(app, &message);
-            break;
-        case InternalLayerMessage:
-            notification_process_internal_message(app, &message);
-            break;
-        case SaveSettingsMessage:
-            notification_save_settings(app);
-            break;
+            if(message.type != NotificationLayerMessage && message.back_event != NULL) {
+                osEventFlagsSet(message.back_event, NOTIFICATION_EVENT_COMPLETE);
+            }
         }
 
-        if(message.back_event != NULL) {
-            osEventFlagsSet(message.back_event, NOTIFICATION_EVENT_COMPLETE);
-        }
+        timeout = notification_timeline_process(app->timeline, osKernelGetTickCount());
     }
 
     return 0;
@@ -10,6 +10,11 @@ void notification_message(NotificationApp* app, const NotificationSequence* sequ
     furi_check(osMessageQueuePut(app->queue, &m, 0, osWaitForever) == osOK);
 };
 
+void notification_message_cancel(NotificationApp* app, const NotificationSequence* sequence) {
+    NotificationAppMessage m = {.type = CancelMessage, .sequence = sequence, .back_event = NULL};
+    furi_check(osMessageQueuePut(app->queue, &m, 0, osWaitForever) == osOK);
+};
+
 void notification_internal_message(NotificationApp* app, const NotificationSequence* sequence) {
     NotificationAppMessage m = {
         .type = InternalLayerMessage, .sequence = sequence, .back_event = NULL};
@@ -0,0 +1,164 @@
+#include "notification_timeline.h"
+#include <furi.h>
+
+typedef struct {
+    const void* key;
+    void* item;
+    uint32_t outputs;
+    uint32_t wakeup;
+    uint32_t order;
+    bool active;
+} NotificationTimelineEntry;
+
+struct NotificationTimeline {
+    NotificationTimelineEntry entries[NOTIFICATION_TIMELINE_SIZE];
+    uint32_t order;
+    NotificationTimelineStepCallback step;
+    NotificationTimelineEndCallback end;
+    void* context;
+};
+
+static void notification_timeline_end(
+    NotificationTimeline* timeline,
+    NotificationTimelineEntry* entry,
+    bool cancelled) {
+    entry->active = false;
+    timeline->end(timeline->context, entry->item, entry->outputs, cancelled);
+}
+
+static void notification_timeline_step(
+    NotificationTimeline* timeline,
+    NotificationTimelineEntry* entry,
+    uint32_t base) {
+    uint32_t delay = timeline->step(timeline->context, entry->item, entry->outputs);
+    if(delay == NOTIFICATION_TIMELINE_DONE) {
+        notification_timeline_end(timeline, entry, false);
+    } else {
+        // count from planned time, so late steps do not stretch sequence
+        entry->wakeup = base + delay;
+    }
+}
+
+static NotificationTimelineEntry* notification_timeline_get_due(
+    NotificationTimeline* timeline,
+    uint32_t now) {
+    NotificationTimelineEntry* due = NULL;
+    for(size_t i = 0; i < NOTIFICATION_TIMELINE_SIZE; i++) {
+        NotificationTimelineEntry* entry = &timeline->entries[i];
+        if(!entry->active || (int32_t)(entry->wakeup - now) > 0) continue;
+        if(due == NULL || (int32_t)(entry->wakeup - due->wakeup) < 0 ||
+           (entry->wakeup == due->wakeup && (int32_t)(entry->order - due->order) < 0)) {
+            due = entry;
+        }
+    }
+    return due;
+}
+
+NotificationTimeline* notification_timeline_alloc(
+    NotificationTimelineStepCallback step,
+    NotificationTimelineEndCallback end,
+    void* context) {
+    furi_assert(step);
+    furi_assert(end);
+
+    NotificationTimeline* timeline = malloc(sizeof(NotificationTimeline));
+    memset(timeline->entries, 0, sizeof(timeline->entries));
+    timeline->order = 0;
+    timeline->step = step;
+    timeline->end = end;
+    timeline->context = context;
+
+    return timeline;
+}
+
+void notification_timeline_free(NotificationTimeline* timeline) {
+    furi_assert(timeline);
+
+    for(size_t i = 0; i < NOTIFICATION_TIMELINE_SIZE; i++) {
+        if(timeline->entries[i].active) {
+            notification_timeline_end(timeline, &timeline->entries[i], true);
+        }
+    }
+    free(timeline);
+}
+
+bool notification_timeline_is_full(NotificationTimeline* timeline) {
+    furi_assert(timeline);
+
+    for(size_t i = 0; i < NOTIFICATION_TIMELINE_SIZE; i++) {
+        if(!timeline->entries[i].active) return false;
+    }
+    return true;
+}
+
+void notification_timeline_add(
+    NotificationTimeline* timeline,
+    const void* key,
+    void* item,
+    uint32_t outputs,
+    uint32_t now) {
+    furi_assert(timeline);
+
+    NotificationTimelineEntry* entry = NULL;
+    for(size_t i = 0; i < NOTIFICATION_TIMELINE_SIZE; i++) {
+        NotificationTimelineEntry* current = &timeline->entries[i];
+        if(!current->active) {
+            if(entry == NULL) entry = current;
+        } else if(current->outputs & outputs) {
+            // override: newest sequence owns output
+            current->outputs &= ~outputs;
+            if(current->outputs == 0) {
+                notification_timeline_end(timeline, current, true);
+                if(entry == NULL) entry = current;
+            }
+        }
+    }
+
+    if(entry == NULL) {
+        // timeline is full: oldest sequence gives way to new one
+        entry = &timeline->entries[0];
+        for(size_t i = 1; i < NOTIFICATION_TIMELINE_SIZE; i++) {
+            NotificationTimelineEntry* current = &timeline->entries[i];
+            if((int32_t)(current->order - entry->order) < 0) entry = current;
+        }
+        notification_timeline_end(timeline, entry, true);
+    }
+
+    entry->key = key;
+    entry->item = item;
+    entry->outputs = outputs;
+    entry->wakeup = now;
+    entry->order = timeline->order++;
+    entry->active = true;
+
+    notification_timeline_step(timeline, entry, now);
+}
+
+void notification_timeline_cancel(NotificationTimeline* timeline, const void* key) {
+    furi_assert(timeline);
+
+    for(size_t i = 0; i < NOTIFICATION_TIMELINE_SIZE; i++) {
+        NotificationTimelineEntry* entry = &timeline->entries[i];
+        if(entry->active && entry->key == key) {
+            notification_timeline_end(timeline, entry, true);
+        }
+    }
+}
+
+uint32_t notification_timeline_process(NotificationTimeline* timeline, uint32_t now) {
+    furi_assert(timeline);
+
+    NotificationTimelineEntry* entry;
+    while((entry = notification_timeline_get_due(timeline, now)) != NULL) {
+        notification_timeline_step(timeline, entry, entry->wakeup);
+    }
+
+    uint32_t timeout = UINT32_MAX;
+    for(size_t i = 0; i < NOTIFICATION_TIMELINE_SIZE; i++) {
+        NotificationTimelineEntry* entry = &timeline->entries[i];
+        if(entry->active && entry->wakeup - now < timeout) {
+            timeout = entry->wakeup - now;
+        }
+    }
+    return timeout;
+}
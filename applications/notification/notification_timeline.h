@@ -0,0 +1,113 @@
+/**
+ * @file notification_timeline.h
+ * Notification sequences scheduler
+ *
+ * Runs notification sequences side by side without blocking the service
+ * thread. Sequence is executed by step callback until next delay, then it
+ * waits on timeline while other sequences run. Every output (led, vibro,
+ * sound, display) is owned by the newest sequence that uses it.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Maximum amount of sequences running at the same time */
+#define NOTIFICATION_TIMELINE_SIZE 8
+
+/** Step callback return value for completed sequence */
+#define NOTIFICATION_TIMELINE_DONE UINT32_MAX
+
+/** Sequence step callback, runs sequence until next delay
+ *
+ * @param      context  callback context
+ * @param      item     sequence item
+ * @param      outputs  outputs owned by sequence, writes to others must be skipped
+ *
+ * @return     ticks to next step or NOTIFICATION_TIMELINE_DONE
+ */
+typedef uint32_t (*NotificationTimelineStepCallback)(void* context, void* item, uint32_t outputs);
+
+/** Sequence end callback
+ *
+ * @param      context    callback context
+ * @param      item       sequence item
+ * @param      outputs    outputs owned by sequence at the end
+ * @param      cancelled  true if sequence was cancelled or overridden
+ */
+typedef void (*NotificationTimelineEndCallback)(
+    void* context,
+    void* item,
+    uint32_t outputs,
+    bool cancelled);
+
+typedef struct NotificationTimeline NotificationTimeline;
+
+/** Allocate timeline
+ *
+ * @param      step     step callback
+ * @param      end      end callback
+ * @param      context  callbacks context
+ *
+ * @return     NotificationTimeline instance
+ */
+NotificationTimeline* notification_timeline_alloc(
+    NotificationTimelineStepCallback step,
+    NotificationTimelineEndCallback end,
+    void* context);
+
+/** Cancel all sequences and free timeline
+ *
+ * @param      timeline  NotificationTimeline instance
+ */
+void notification_timeline_free(NotificationTimeline* timeline);
+
+/** Check if there is no room for new sequence
+ *
+ * @param      timeline  NotificationTimeline instance
+ *
+ * @return     true if full
+ */
+bool notification_timeline_is_full(NotificationTimeline* timeline);
+
+/** Add sequence and run its first step
+ * Outputs are taken over from running sequences, sequence left without outputs
+ * is cancelled. If timeline is full, oldest sequence is cancelled.
+ *
+ * @param      timeline  NotificationTimeline instance
+ * @param      key       key used to cancel sequence
+ * @param      item      sequence item passed to callbacks
+ * @param      outputs   outputs used by sequence
+ * @param      now       current tick
+ */
+void notification_timeline_add(
+    NotificationTimeline* timeline,
+    const void* key,
+    void* item,
+    uint32_t outputs,
+    uint32_t now);
+
+/** Cancel all sequences with key
+ *
+ * @param      timeline  NotificationTimeline instance
+ * @param      key       sequence key
+ */
+void notification_timeline_cancel(NotificationTimeline* timeline, const void* key);
+
+/** Run steps that are due, earliest first
+ *
+ * @param      timeline  NotificationTimeline instance
+ * @param      now       current tick
+ *
+ * @return     ticks to next step, UINT32_MAX if timeline is empty
+ */
+uint32_t notification_timeline_process(NotificationTimeline* timeline, uint32_t now);
+
+#ifdef __cplusplus
+}
+#endif
@@ -9,7 +9,6 @@
 #include "storage/filesystem_api_defines.h"
 #include "storage/storage.h"
 #include <stdint.h>
-#include <lib/toolbox/md5.h>
 
 #define RPC_TAG "RPC_STORAGE"
 #define MAX_NAME_LENGTH 255
@@ -450,6 +449,25 @@ static void rpc_system_storage_mkdir_process(const PB_Main* request, void* conte
     rpc_send_and_release_empty(session, request->command_id, status);
 }
 
+/* Hashing is done by storage service for any StorageHashType. Only MD5 has RPC messages,
+ * SHA-256 needs Sha256sum request and response in flipperzero-protobuf first. */
+static PB_CommandStatus
+    rpc_system_storage_hash(const char* path, StorageHashType type, char* hash_string) {
+    uint8_t hash[STORAGE_HASH_SIZE_MAX];
+
+    Storage* fs_api = furi_record_open("storage");
+    FS_Error error = storage_common_hash(fs_api, path, type, hash);
+    furi_record_close("storage");
+
+    if(error == FSE_OK) {
+        for(size_t i = 0; i < storage_hash_get_size(type); i++) {
+            hash_string += sprintf(hash_string, "%02x", hash[i]);
+        }
+    }
+
+    return rpc_system_storage_get_error(error);
+}
+
 static void rpc_system_storage_md5sum_process(const PB_Main* request, void* context) {
     furi_assert(request);
     furi_assert(request->which_content == PB_Main_storage_md5sum_request_tag);
@@ -467,52 +485,23 @@ static void rpc_system_storage_md5sum_process(const PB_Main* request, void* cont
         return;
     }
 
-    Storage* fs_api = furi_record_open("storage");
-    File* file = storage_file_alloc(fs_api);
+    PB_Main response = {
+        .command_id = request->command_id,
+        .which_content = PB_Main_storage_md5sum_response_tag,
+        .has_next = false,
+    };
 
-    if(storage_file_open(file, filename, FSAM_READ, FSOM_OPEN_EXISTING)) {
-        const uint16_t read_size = 512;
-        const uint8_t hash_size = 16;
-        uint8_t* data = malloc(read_size);
-        uint8_t* hash = malloc(sizeof(uint8_t) * hash_size);
-        md5_context* md5_ctx = malloc(sizeof(md5_context));
-
-        md5_starts(md5_ctx);
-        while(true) {
-            uint16_t readed_size = storage_file_read(file, data, read_size);
-            if(readed_size == 0) break;
-            md5_update(md5_ctx, data, readed_size);
-        }
-        md5_finish(md5_ctx, hash);
-        free(md5_ctx);
-
-        PB_Main response = {
-            .command_id = request->command_id,
-            .command_status = PB_CommandStatus_OK,
-            .which_content = PB_Main_storage_md5sum_response_tag,
-            .has_next = false,
-        };
-
-        char* md5sum = response.content.storage_md5sum_response.md5sum;
-        size_t md5sum_size = sizeof(response.content.storage_md5sum_response.md5sum);
-        (void)md5sum_size;
-        furi_assert(hash_size <= ((md5sum_size - 1) / 2));
-        for(uint8_t i = 0; i < hash_size; i++) {
-            md5sum += sprintf(md5sum, "%02x", hash[i]);
-        }
+    char* md5sum = response.content.storage_md5sum_response.md5sum;
+    furi_assert(
+        storage_hash_get_size(StorageHashMd5) * 2 <
+        sizeof(response.content.storage_md5sum_response.md5sum));
+    response.command_status = rpc_system_storage_hash(filename, StorageHashMd5, md5sum);
 
-        free(hash);
-        free(data);
-        storage_file_close(file);
+    if(response.command_status == PB_CommandStatus_OK) {
         rpc_send_and_release(session, &response);
     } else {
-        rpc_send_and_release_empty(
-            session, request->command_id, rpc_system_storage_get_file_error(file));
+        rpc_send_and_release_empty(session, request->command_id, response.command_status);
     }
-
-    storage_file_free(file);
-
-    furi_record_close("storage");
 }
 
 static void rpc_system_storage_rename_process(const PB_Main* request, void* context) {
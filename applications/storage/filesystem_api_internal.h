@@ -146,6 +146,14 @@ typedef struct {
  *      @param path path to file/directory
  *      @return FS_Error error info
  * 
+ *  @var FS_Common_Api::rename
+ *      @brief Rename file/directory within storage,
+ *          file/directory must not be opened,
+ *          new path must not exist
+ *      @param old_path old path to file/directory
+ *      @param new_path new path to file/directory
+ *      @return FS_Error error info
+ * 
  *  @var FS_Common_Api::mkdir
  *      @brief Create new directory
  *      @param path path to new directory
@@ -161,6 +169,7 @@ typedef struct {
 typedef struct {
     FS_Error (*const stat)(void* context, const char* path, FileInfo* fileinfo);
     FS_Error (*const remove)(void* context, const char* path);
+    FS_Error (*const rename)(void* context, const char* old_path, const char* new_path);
     FS_Error (*const mkdir)(void* context, const char* path);
     FS_Error (*const fs_info)(
         void* context,
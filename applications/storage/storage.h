@@ -28,8 +28,16 @@ typedef enum {
 
 typedef struct {
     StorageEventType type;
+    const char* path; /**< Closed file path with real storage prefix, only for FileClose */
 } StorageEvent;
 
+typedef enum {
+    StorageHashMd5,
+    StorageHashSha256,
+} StorageHashType;
+
+#define STORAGE_HASH_SIZE_MAX 32
+
 /**
  * Get storage pubsub.
  * Storage will send StorageEvent messages.
@@ -167,7 +175,9 @@ FS_Error storage_common_stat(Storage* storage, const char* path, FileInfo* filei
  */
 FS_Error storage_common_remove(Storage* storage, const char* path);
 
-/** Renames file/directory, file/directory must not be open
+/** Renames file/directory, file/directory and files inside of it must not be open
+ * Data is moved without copy within one storage, between storages it is copied recursively
+ * Directory can't be moved inside of itself, FSE_INVALID_PARAMETER is returned
  * @param app pointer to the api
  * @param old_path old path
  * @param new_path new path
@@ -203,6 +213,23 @@ FS_Error storage_common_fs_info(
     uint64_t* total_space,
     uint64_t* free_space);
 
+/** Calculates file hash, file must not be open
+ * File is read and hashed by the storage service in large blocks, without a round trip for every block
+ * @param app pointer to the api
+ * @param path file path
+ * @param type hash algorithm
+ * @param hash hash output, storage_hash_get_size bytes
+ * @return FS_Error operation result
+ */
+FS_Error
+    storage_common_hash(Storage* storage, const char* path, StorageHashType type, uint8_t* hash);
+
+/** Gets hash size
+ * @param type hash algorithm
+ * @return size_t hash size in bytes
+ */
+size_t storage_hash_get_size(StorageHashType type);
+
 /******************* Error Functions *******************/
 
 /** Retrieves the error text from the error id
@@ -4,6 +4,7 @@
 #include "storage_i.h"
 #include "storage_message.h"
 #include <toolbox/stream/file_stream.h>
+#include <toolbox/sha256.h>
 
 #define MAX_NAME_LENGTH 256
 
@@ -297,10 +298,64 @@ FS_Error storage_common_remove(Storage* storage, const char* path) {
     return S_RETURN_ERROR;
 }
 
+static FS_Error
+    storage_common_copy_recursive(Storage* storage, const char* old_path, const char* new_path) {
+    FileInfo fileinfo;
+    FS_Error error = storage_common_stat(storage, old_path, &fileinfo);
+    if(error != FSE_OK) return error;
+
+    error = storage_common_copy(storage, old_path, new_path);
+    if(error != FSE_OK || !(fileinfo.flags & FSF_DIRECTORY)) return error;
+
+    char* name = malloc(MAX_NAME_LENGTH + 1);
+    File* dir = storage_file_alloc(storage);
+    string_t old_child;
+    string_t new_child;
+    string_init(old_child);
+    string_init(new_child);
+
+    if(storage_dir_open(dir, old_path)) {
+        while(storage_dir_read(dir, NULL, name, MAX_NAME_LENGTH)) {
+            string_printf(old_child, "%s/%s", old_path, name);
+            string_printf(new_child, "%s/%s", new_path, name);
+            error = storage_common_copy_recursive(
+                storage, string_get_cstr(old_child), string_get_cstr(new_child));
+            if(error != FSE_OK) break;
+        }
+    } else {
+        error = storage_file_get_error(dir);
+    }
+    storage_dir_close(dir);
+
+    string_clear(old_child);
+    string_clear(new_child);
+    storage_file_free(dir);
+    free(name);
+
+    return error;
+}
+
 FS_Error storage_common_rename(Storage* storage, const char* old_path, const char* new_path) {
-    FS_Error error = storage_common_copy(storage, old_path, new_path);
-    if(error == FSE_OK) {
-        error = storage_common_remove(storage, old_path);
+    S_API_PROLOGUE;
+
+    SAData data = {
+        .crename = {
+            .old_path = old_path,
+            .new_path = new_path,
+        }};
+
+    S_API_MESSAGE(StorageCommandCommonRename);
+    S_API_EPILOGUE;
+
+    FS_Error error = S_RETURN_ERROR;
+
+    // Paths are on different storages, data must be copied
+    // Storage thread has checked for open files before reporting this
+    if(error == FSE_NOT_IMPLEMENTED) {
+        error = storage_common_copy_recursive(storage, old_path, new_path);
+        if(error == FSE_OK && !storage_simply_remove_recursive(storage, old_path)) {
+            error = FSE_INTERNAL;
+        }
     }
 
     return error;
@@ -365,6 +420,35 @@ FS_Error storage_common_fs_info(
     return S_RETURN_ERROR;
 }
 
+FS_Error
+    storage_common_hash(Storage* storage, const char* path, StorageHashType type, uint8_t* hash) {
+    S_API_PROLOGUE;
+
+    SAData data = {
+        .chash = {
+            .path = path,
+            .type = type,
+            .hash = hash,
+        }};
+
+    S_API_MESSAGE(StorageCommandCommonHash);
+    S_API_EPILOGUE;
+    return S_RETURN_ERROR;
+}
+
+size_t storage_hash_get_size(StorageHashType type) {
+    size_t size = 0;
+    switch(type) {
+    case StorageHashMd5:
+        size = 16;
+        break;
+    case StorageHashSha256:
+        size = SHA256_DIGEST_SIZE;
+        break;
+    }
+    return size;
+}
+
 /****************** ERROR ******************/
 
 const char* storage_error_get_desc(FS_Error error_id) {
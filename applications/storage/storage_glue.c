@@ -120,6 +120,27 @@ bool storage_path_already_open(string_t path, StorageFileList_t array) {
     return open;
 }
 
+bool storage_path_or_child_already_open(string_t path, StorageFileList_t array) {
+    bool open = false;
+    size_t path_size = string_size(path);
+
+    StorageFileList_it_t it;
+
+    for(StorageFileList_it(it, array); !StorageFileList_end_p(it); StorageFileList_next(it)) {
+        const StorageFile* storage_file = StorageFileList_cref(it);
+        const char* file_path = string_get_cstr(storage_file->path);
+
+        // Path itself or anything inside it, but not "/dir_other" for "/dir"
+        if(strncmp(file_path, string_get_cstr(path), path_size) == 0 &&
+           (file_path[path_size] == '\0' || file_path[path_size] == '/')) {
+            open = true;
+            break;
+        }
+    }
+
+    return open;
+}
+
 void storage_set_storage_file_data(const File* file, void* file_data, StorageData* storage) {
     StorageFile* founded_file = NULL;
 
@@ -160,6 +181,26 @@ void* storage_get_storage_file_data(const File* file, StorageData* storage) {
     return founded_file->file_data;
 }
 
+const char* storage_get_storage_file_path(const File* file, StorageData* storage) {
+    const StorageFile* founded_file = NULL;
+
+    StorageFileList_it_t it;
+
+    for(StorageFileList_it(it, storage->files); !StorageFileList_end_p(it);
+        StorageFileList_next(it)) {
+        const StorageFile* storage_file = StorageFileList_cref(it);
+
+        if(storage_file->file->file_id == file->file_id) {
+            founded_file = storage_file;
+            break;
+        }
+    }
+
+    furi_check(founded_file != NULL);
+
+    return string_get_cstr(founded_file->path);
+}
+
 void storage_push_storage_file(File* file, string_t path, StorageType type, StorageData* storage) {
     StorageFile* storage_file = StorageFileList_push_new(storage->files);
     furi_check(storage_file != NULL);
@@ -47,12 +47,23 @@ typedef struct {
     FileInfo* fileinfo;
 } SADataCStat;
 
+typedef struct {
+    const char* old_path;
+    const char* new_path;
+} SADataCRename;
+
 typedef struct {
     const char* fs_path;
     uint64_t* total_space;
     uint64_t* free_space;
 } SADataCFSInfo;
 
+typedef struct {
+    const char* path;
+    StorageHashType type;
+    uint8_t* hash;
+} SADataCHash;
+
 typedef struct {
     uint32_t id;
 } SADataError;
@@ -79,7 +90,9 @@ typedef union {
     SADataDRead dread;
 
     SADataCStat cstat;
+    SADataCRename crename;
     SADataCFSInfo cfsinfo;
+    SADataCHash chash;
 
     SADataError error;
 
@@ -114,8 +127,10 @@ typedef enum {
     StorageCommandDirRewind,
     StorageCommandCommonStat,
     StorageCommandCommonRemove,
+    StorageCommandCommonRename,
     StorageCommandCommonMkDir,
     StorageCommandCommonFSInfo,
+    StorageCommandCommonHash,
     StorageCommandSDFormat,
     StorageCommandSDUnmount,
     StorageCommandSDInfo,
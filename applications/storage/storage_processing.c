@@ -2,6 +2,11 @@
 #include <m-list.h>
 #include <m-dict.h>
 #include <m-string.h>
+#include <lib/toolbox/md5.h>
+#include <lib/toolbox/sha256.h>
+
+// Multiple of sector size: FatFS reads whole sectors to the buffer directly
+#define STORAGE_HASH_BUFFER_SIZE 4096
 
 #define FS_CALL(_storage, _fn)   \
     storage_data_lock(_storage); \
@@ -126,10 +131,14 @@ bool storage_process_file_close(Storage* app, File* file) {
         file->error_id = FSE_INVALID_PARAMETER;
     } else {
         FS_CALL(storage, file.close(storage, file));
+
+        string_t path;
+        string_init_set_str(path, storage_get_storage_file_path(file, storage));
         storage_pop_storage_file(file, storage);
 
-        StorageEvent event = {.type = StorageEventTypeFileClose};
+        StorageEvent event = {.type = StorageEventTypeFileClose, .path = string_get_cstr(path)};
         furi_pubsub_publish(app->pubsub, &event);
+        string_clear(path);
     }
 
     return ret;
@@ -365,6 +374,65 @@ static FS_Error storage_process_common_remove(Storage* app, const char* path) {
     return ret;
 }
 
+static FS_Error
+    storage_process_common_rename(Storage* app, const char* old_path, const char* new_path) {
+    FS_Error ret = FSE_OK;
+    StorageType old_type = storage_get_type_by_path(app, old_path);
+    StorageType new_type = storage_get_type_by_path(app, new_path);
+
+    string_t real_old_path;
+    string_t real_new_path;
+    string_init_set(real_old_path, old_path);
+    string_init_set(real_new_path, new_path);
+    storage_path_change_to_real_storage(real_old_path, old_type);
+    storage_path_change_to_real_storage(real_new_path, new_type);
+
+    do {
+        if(storage_type_is_not_valid(old_type) || storage_type_is_not_valid(new_type)) {
+            ret = FSE_INVALID_NAME;
+            break;
+        }
+
+        // Directory can't be moved inside itself
+        size_t old_size = string_size(real_old_path);
+        if(string_size(real_new_path) > old_size &&
+           string_start_with_string_p(real_new_path, real_old_path) &&
+           string_get_char(real_new_path, old_size) == '/') {
+            ret = FSE_INVALID_PARAMETER;
+            break;
+        }
+
+        // Files inside of renamed directory are open too
+        StorageData* storage = storage_get_storage_by_type(app, old_type);
+        StorageData* new_storage = storage_get_storage_by_type(app, new_type);
+        if(storage_path_or_child_already_open(real_old_path, storage->files) ||
+           storage_path_already_open(real_new_path, new_storage->files)) {
+            ret = FSE_ALREADY_OPEN;
+            break;
+        }
+
+        // Different storages, caller must copy data
+        if(old_type != new_type) {
+            ret = FSE_NOT_IMPLEMENTED;
+            break;
+        }
+
+        // Don't overwrite, LittleFS and FatFS behave differently here
+        FS_CALL(storage, common.stat(storage, remove_vfs(new_path), NULL));
+        if(ret == FSE_OK) {
+            ret = FSE_EXIST;
+            break;
+        }
+
+        FS_CALL(storage, common.rename(storage, remove_vfs(old_path), remove_vfs(new_path)));
+    } while(false);
+
+    string_clear(real_old_path);
+    string_clear(real_new_path);
+
+    return ret;
+}
+
 static FS_Error storage_process_common_mkdir(Storage* app, const char* path) {
     FS_Error ret = FSE_OK;
     StorageType type = storage_get_type_by_path(app, path);
@@ -397,6 +465,61 @@ static FS_Error storage_process_common_fs_info(
     return ret;
 }
 
+static FS_Error storage_process_common_hash(
+    Storage* app,
+    const char* path,
+    StorageHashType type,
+    uint8_t* hash) {
+    FS_Error ret = FSE_OK;
+    File file = {0};
+
+    if(storage_process_file_open(app, &file, path, FSAM_READ, FSOM_OPEN_EXISTING)) {
+        uint8_t* buffer = malloc(STORAGE_HASH_BUFFER_SIZE);
+        union {
+            md5_context md5;
+            sha256_context sha256;
+        }* context = malloc(sizeof(*context));
+
+        if(type == StorageHashMd5) {
+            md5_starts(&context->md5);
+        } else {
+            sha256_start(&context->sha256);
+        }
+
+        while(true) {
+            uint16_t read_size =
+                storage_process_file_read(app, &file, buffer, STORAGE_HASH_BUFFER_SIZE);
+            if(file.error_id != FSE_OK) {
+                ret = file.error_id;
+                break;
+            }
+            if(read_size == 0) break;
+
+            if(type == StorageHashMd5) {
+                md5_update(&context->md5, buffer, read_size);
+            } else {
+                sha256_update(&context->sha256, buffer, read_size);
+            }
+        }
+
+        if(type == StorageHashMd5) {
+            md5_finish(&context->md5, hash);
+        } else {
+            sha256_finish(&context->sha256, hash);
+        }
+
+        free(context);
+        free(buffer);
+    } else {
+        ret = file.error_id;
+    }
+
+    // File is registered in storage even if open failed
+    storage_process_file_close(app, &file);
+
+    return ret;
+}
+
 /****************** Raw SD API ******************/
 // TODO think about implementing a custom storage API to split that kind of api linkage
 #include "storages/storage_ext.h"
@@ -540,6 +663,10 @@ void storage_process_message_internal(Storage* app, StorageMessage* message) {
         message->return_data->error_value =
             storage_process_common_remove(app, message->data->path.path);
         break;
+    case StorageCommandCommonRename:
+        message->return_data->error_value = storage_process_common_rename(
+            app, message->data->crename.old_path, message->data->crename.new_path);
+        break;
     case StorageCommandCommonMkDir:
         message->return_data->error_value =
             storage_process_common_mkdir(app, message->data->path.path);
@@ -551,6 +678,13 @@ void storage_process_message_internal(Storage* app, StorageMessage* message) {
             message->data->cfsinfo.total_space,
             message->data->cfsinfo.free_space);
         break;
+    case StorageCommandCommonHash:
+        message->return_data->error_value = storage_process_common_hash(
+            app,
+            message->data->chash.path,
+            message->data->chash.type,
+            message->data->chash.hash);
+        break;
     case StorageCommandSDFormat:
         message->return_data->error_value = storage_process_sd_format(app);
         break;
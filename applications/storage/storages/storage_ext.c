@@ -483,6 +483,11 @@ static FS_Error storage_ext_common_remove(void* ctx, const char* path) {
     return storage_ext_parse_error(result);
 }
 
+static FS_Error storage_ext_common_rename(void* ctx, const char* old_path, const char* new_path) {
+    SDError result = f_rename(old_path, new_path);
+    return storage_ext_parse_error(result);
+}
+
 static FS_Error storage_ext_common_mkdir(void* ctx, const char* path) {
     SDError result = f_mkdir(path);
     return storage_ext_parse_error(result);
@@ -548,6 +553,7 @@ static const FS_Api fs_api = {
             .stat = storage_ext_common_stat,
             .mkdir = storage_ext_common_mkdir,
             .remove = storage_ext_common_remove,
+            .rename = storage_ext_common_rename,
             .fs_info = storage_ext_common_fs_info,
         },
 };
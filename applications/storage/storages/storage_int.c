@@ -101,18 +101,11 @@ static int storage_int_device_prog(
         size,
         address);
 
-    int ret = 0;
-    while(size > 0) {
-        if(!furi_hal_flash_write_dword(address, *(uint64_t*)buffer)) {
-            ret = -1;
-            break;
-        }
-        address += c->prog_size;
-        buffer += c->prog_size;
-        size -= c->prog_size;
+    if(furi_hal_flash_program_burst(address, buffer, size)) {
+        return 0;
+    } else {
+        return -1;
     }
-
-    return ret;
 }
 
 static int storage_int_device_erase(const struct lfs_config* c, lfs_block_t block) {
@@ -154,9 +147,10 @@ static LFSData* storage_int_lfs_data_alloc() {
     lfs_data->config.prog_size = furi_hal_flash_get_write_block_size();
     lfs_data->config.block_size = furi_hal_flash_get_page_size();
     lfs_data->config.block_count = furi_hal_flash_get_free_page_count();
-    lfs_data->config.block_cycles = furi_hal_flash_get_cycles_count();
-    lfs_data->config.cache_size = 16;
-    lfs_data->config.lookahead_size = 16;
+    lfs_data->config.block_cycles = STORAGE_INT_BLOCK_CYCLES ? STORAGE_INT_BLOCK_CYCLES :
+                                                               furi_hal_flash_get_cycles_count();
+    lfs_data->config.cache_size = STORAGE_INT_CACHE_SIZE;
+    lfs_data->config.lookahead_size = STORAGE_INT_LOOKAHEAD_SIZE;
 
     return lfs_data;
 };
@@ -636,6 +630,13 @@ static FS_Error storage_int_common_remove(void* ctx, const char* path) {
     return storage_int_parse_error(result);
 }
 
+static FS_Error storage_int_common_rename(void* ctx, const char* old_path, const char* new_path) {
+    StorageData* storage = ctx;
+    lfs_t* lfs = lfs_get_from_storage(storage);
+    int result = lfs_rename(lfs, old_path, new_path);
+    return storage_int_parse_error(result);
+}
+
 static FS_Error storage_int_common_mkdir(void* ctx, const char* path) {
     StorageData* storage = ctx;
     lfs_t* lfs = lfs_get_from_storage(storage);
@@ -690,6 +691,7 @@ static const FS_Api fs_api = {
             .stat = storage_int_common_stat,
             .mkdir = storage_int_common_mkdir,
             .remove = storage_int_common_remove,
+            .rename = storage_int_common_rename,
             .fs_info = storage_int_common_fs_info,
         },
 };
@@ -699,13 +701,16 @@ void storage_int_init(StorageData* storage) {
     LFSData* lfs_data = storage_int_lfs_data_alloc();
     FURI_LOG_I(
         TAG,
-        "Config: start %p, read %d, write %d, page size: %d, page count: %d, cycles: %d",
+        "Config: start %p, read %d, write %d, page size: %d, page count: %d, cycles: %d, "
+        "cache: %d, lookahead: %d",
         lfs_data->start_address,
         lfs_data->config.read_size,
         lfs_data->config.prog_size,
         lfs_data->config.block_size,
         lfs_data->config.block_count,
-        lfs_data->config.block_cycles);
+        lfs_data->config.block_cycles,
+        lfs_data->config.cache_size,
+        lfs_data->config.lookahead_size);
 
     storage_int_lfs_mount(lfs_data, storage);
 
@@ -2,6 +2,22 @@
 #include <furi.h>
 #include "../storage_glue.h"
 
+/* LittleFS profile, can be set by target.
+ * Cache size must be multiple of read and write block size and factor of page size.
+ * Lookahead size must be multiple of 8, every byte covers 8 pages. */
+#ifndef STORAGE_INT_CACHE_SIZE
+#define STORAGE_INT_CACHE_SIZE 16
+#endif
+
+#ifndef STORAGE_INT_LOOKAHEAD_SIZE
+#define STORAGE_INT_LOOKAHEAD_SIZE 16
+#endif
+
+// Flash cycles count is used if not set
+#ifndef STORAGE_INT_BLOCK_CYCLES
+#define STORAGE_INT_BLOCK_CYCLES 0
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -0,0 +1,153 @@
+#include <furi.h>
+#include <storage/storage.h>
+#include <gui/icon_i.h>
+#include <desktop/animations/animation_storage_i.h>
+#include "../minunit.h"
+
+#define TAG "UnitTestsAnimationStorage"
+
+static const char* animation_storage_test_name;
+static volatile size_t animation_storage_test_files;
+
+/* Storage reports every closed file, files of loaded animation are counted */
+static void animation_storage_test_storage_callback(const void* message, void* context) {
+    UNUSED(context);
+    const StorageEvent* storage_event = message;
+    if(storage_event->type == StorageEventTypeFileClose && storage_event->path &&
+       animation_storage_test_name && strstr(storage_event->path, animation_storage_test_name)) {
+        animation_storage_test_files++;
+    }
+}
+
+static size_t animation_storage_test_frame_size(const Icon* icon, uint8_t index) {
+    const uint8_t* frame = icon->frames[index];
+    if(frame[0]) {
+        // compressed: header, 2 bytes of compressed size, data
+        return 4 + (frame[2] | (frame[3] << 8));
+    } else {
+        return 1 + ROUND_UP_TO(icon->width, 8) / 8 * icon->height;
+    }
+}
+
+static void animation_storage_test_compare_bubbles(const FrameBubble* a, const FrameBubble* b) {
+    while(a && b) {
+        mu_assert_int_eq(a->bubble.x, b->bubble.x);
+        mu_assert_int_eq(a->bubble.y, b->bubble.y);
+        mu_assert_int_eq(a->bubble.align_h, b->bubble.align_h);
+        mu_assert_int_eq(a->bubble.align_v, b->bubble.align_v);
+        mu_assert_int_eq(a->start_frame, b->start_frame);
+        mu_assert_int_eq(a->end_frame, b->end_frame);
+        mu_assert_string_eq(a->bubble.text, b->bubble.text);
+        a = a->next_bubble;
+        b = b->next_bubble;
+    }
+    mu_check(a == NULL && b == NULL);
+}
+
+static void animation_storage_test_compare(const char* name) {
+    Storage* storage = furi_record_open("storage");
+    FuriPubSubSubscription* subscription = furi_pubsub_subscribe(
+        storage_get_pubsub(storage), animation_storage_test_storage_callback, NULL);
+    animation_storage_test_name = name;
+
+    animation_storage_test_files = 0;
+    uint32_t start = osKernelGetTickCount();
+    BubbleAnimation* legacy = animation_storage_load_legacy_animation(name);
+    uint32_t legacy_ticks = osKernelGetTickCount() - start;
+    size_t legacy_files = animation_storage_test_files;
+
+    animation_storage_test_files = 0;
+    start = osKernelGetTickCount();
+    BubbleAnimation* bundle = animation_storage_load_bundle_animation(name);
+    uint32_t bundle_ticks = osKernelGetTickCount() - start;
+    size_t bundle_files = animation_storage_test_files;
+
+    animation_storage_test_name = NULL;
+    furi_pubsub_unsubscribe(storage_get_pubsub(storage), subscription);
+    furi_record_close("storage");
+
+    mu_check(legacy);
+    mu_check(bundle);
+    if(!legacy || !bundle) return;
+
+    FURI_LOG_I(
+        TAG,
+        "%s: legacy %lu ticks, %u files, bundle %lu ticks, %u files",
+        name,
+        legacy_ticks,
+        (unsigned)legacy_files,
+        bundle_ticks,
+        (unsigned)bundle_files);
+
+    // meta and every frame file against single bundle file
+    mu_assert_int_eq(1, bundle_files);
+    mu_check(legacy_files >= (size_t)legacy->icon_animation.frame_count + 1);
+
+    mu_assert_int_eq(legacy->passive_frames, bundle->passive_frames);
+    mu_assert_int_eq(legacy->active_frames, bundle->active_frames);
+    mu_assert_int_eq(legacy->active_cycles, bundle->active_cycles);
+    mu_assert_int_eq(legacy->duration, bundle->duration);
+    mu_assert_int_eq(legacy->active_cooldown, bundle->active_cooldown);
+    for(int i = 0; i < legacy->passive_frames + legacy->active_frames; ++i) {
+        mu_assert_int_eq(legacy->frame_order[i], bundle->frame_order[i]);
+    }
+
+    const Icon* legacy_icon = &legacy->icon_animation;
+    const Icon* bundle_icon = &bundle->icon_animation;
+    mu_assert_int_eq(legacy_icon->width, bundle_icon->width);
+    mu_assert_int_eq(legacy_icon->height, bundle_icon->height);
+    mu_assert_int_eq(legacy_icon->frame_rate, bundle_icon->frame_rate);
+    mu_assert_int_eq(legacy_icon->frame_count, bundle_icon->frame_count);
+    for(int i = 0; i < legacy_icon->frame_count; ++i) {
+        size_t size = animation_storage_test_frame_size(legacy_icon, i);
+        mu_assert_int_eq(size, animation_storage_test_frame_size(bundle_icon, i));
+        mu_check(memcmp(legacy_icon->frames[i], bundle_icon->frames[i], size) == 0);
+    }
+
+    mu_assert_int_eq(
+        legacy->frame_bubble_sequences_count, bundle->frame_bubble_sequences_count);
+    for(int i = 0; i < legacy->frame_bubble_sequences_count; ++i) {
+        animation_storage_test_compare_bubbles(
+            legacy->frame_bubble_sequences[i], bundle->frame_bubble_sequences[i]);
+    }
+
+    animation_storage_free_animation(&legacy);
+    animation_storage_free_animation(&bundle);
+    mu_check(!legacy && !bundle);
+}
+
+MU_TEST(animation_storage_test_bundle) {
+    StorageAnimationList_t animation_list;
+    StorageAnimationList_init(animation_list);
+    animation_storage_fill_animation_list(&animation_list);
+
+    size_t count = 0;
+    for
+        M_EACH(item, animation_list, StorageAnimationList_t) {
+            if((*item)->external) {
+                animation_storage_test_compare((*item)->manifest_info.name);
+                count++;
+            }
+        }
+    mu_check(count > 0);
+
+    for
+        M_EACH(item, animation_list, StorageAnimationList_t) {
+            animation_storage_free_storage_animation(item);
+        }
+    StorageAnimationList_clear(animation_list);
+}
+
+MU_TEST(animation_storage_test_missing_bundle) {
+    mu_check(animation_storage_load_bundle_animation("Missing_Animation_128x64") == NULL);
+}
+
+MU_TEST_SUITE(animation_storage_suite) {
+    MU_RUN_TEST(animation_storage_test_bundle);
+    MU_RUN_TEST(animation_storage_test_missing_bundle);
+}
+
+int run_minunit_test_animation_storage() {
+    MU_RUN_SUITE(animation_storage_suite);
+    return MU_EXIT_CODE;
+}
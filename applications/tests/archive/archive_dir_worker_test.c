@@ -0,0 +1,215 @@
+#include <furi.h>
+#include <storage/storage.h>
+#include <archive/helpers/archive_dir_worker.h>
+#include "../minunit.h"
+
+#define TAG "UnitTestsArchiveDirWorker"
+
+#define ARCHIVE_DIR_TEST_PATH "/ext/archive_dir_test"
+#define ARCHIVE_DIR_TEST_DIRS 10
+#define ARCHIVE_DIR_TEST_FILES 300
+#define ARCHIVE_DIR_TEST_OTHER 20
+#define ARCHIVE_DIR_TEST_COUNT (ARCHIVE_DIR_TEST_DIRS + ARCHIVE_DIR_TEST_FILES)
+#define ARCHIVE_DIR_TEST_WINDOW 20
+#define ARCHIVE_DIR_TEST_TIMEOUT 10000
+/* Heap cost of listed entry: entry itself, its name and heap block header with alignment */
+#define ARCHIVE_DIR_TEST_ENTRY_SIZE \
+    (sizeof(ArchiveFile_t) + sizeof(ARCHIVE_DIR_TEST_PATH "/f000.nfc") + 16)
+
+static osSemaphoreId_t archive_dir_test_semaphore;
+
+static void archive_dir_test_callback(void* context) {
+    osSemaphoreRelease(context);
+}
+
+/** Name of entry by its index in sorted folder: folders, then files ignoring case */
+static void archive_dir_test_name(string_t name, size_t index) {
+    if(index < ARCHIVE_DIR_TEST_DIRS) {
+        string_printf(name, "%s/d%02u", ARCHIVE_DIR_TEST_PATH, index);
+    } else {
+        index -= ARCHIVE_DIR_TEST_DIRS;
+        string_printf(
+            name, "%s/%c%03u.nfc", ARCHIVE_DIR_TEST_PATH, (index % 2) ? 'F' : 'f', index);
+    }
+}
+
+static void archive_dir_test_setup() {
+    Storage* storage = furi_record_open("storage");
+    File* file = storage_file_alloc(storage);
+    string_t name;
+    string_init(name);
+
+    storage_simply_remove_recursive(storage, ARCHIVE_DIR_TEST_PATH);
+    storage_simply_mkdir(storage, ARCHIVE_DIR_TEST_PATH);
+
+    // Created out of order, filtered out files in between
+    for(size_t i = 0; i < ARCHIVE_DIR_TEST_COUNT; i++) {
+        archive_dir_test_name(name, (i * 7) % ARCHIVE_DIR_TEST_COUNT);
+        if(string_search_str(name, ".nfc") == STRING_FAILURE) {
+            storage_simply_mkdir(storage, string_get_cstr(name));
+        } else {
+            storage_file_open(file, string_get_cstr(name), FSAM_WRITE, FSOM_CREATE_ALWAYS);
+            storage_file_close(file);
+        }
+
+        if(i < ARCHIVE_DIR_TEST_OTHER) {
+            string_printf(name, "%s/s%02u.sub", ARCHIVE_DIR_TEST_PATH, i);
+            storage_file_open(file, string_get_cstr(name), FSAM_WRITE, FSOM_CREATE_ALWAYS);
+            storage_file_close(file);
+        }
+    }
+
+    string_clear(name);
+    storage_file_free(file);
+    furi_record_close("storage");
+}
+
+static void archive_dir_test_cleanup() {
+    Storage* storage = furi_record_open("storage");
+    storage_simply_remove_recursive(storage, ARCHIVE_DIR_TEST_PATH);
+    furi_record_close("storage");
+}
+
+static void archive_dir_test_check_window(uint16_t offset, files_array_t files) {
+    string_t name;
+    string_init(name);
+
+    size_t size = MIN(ARCHIVE_DIR_TEST_WINDOW, ARCHIVE_DIR_TEST_COUNT - offset);
+    mu_assert_int_eq(size, files_array_size(files));
+    for(size_t i = 0; i < size; i++) {
+        ArchiveFile_t* file = files_array_get(files, i);
+        archive_dir_test_name(name, offset + i);
+        mu_assert_string_eq(string_get_cstr(name), string_get_cstr(file->name));
+        mu_assert(
+            (file->type == ArchiveFileTypeFolder) == (offset + i < ARCHIVE_DIR_TEST_DIRS),
+            "wrong entry type");
+    }
+
+    string_clear(name);
+}
+
+static void archive_dir_test_load(
+    ArchiveDirWorker* worker,
+    uint16_t offset,
+    const ArchiveFile_t* anchor,
+    uint16_t anchor_idx,
+    files_array_t files) {
+    uint16_t window_offset = 0;
+
+    archive_dir_worker_load(worker, offset, anchor, anchor_idx);
+    mu_assert_int_eq(
+        osOK, osSemaphoreAcquire(archive_dir_test_semaphore, ARCHIVE_DIR_TEST_TIMEOUT));
+    mu_check(archive_dir_worker_take_list(worker, &window_offset, files));
+    mu_assert_int_eq(offset, window_offset);
+    archive_dir_test_check_window(offset, files);
+}
+
+MU_TEST(archive_dir_worker_test_paging) {
+    uint16_t item_cnt = 0;
+    uint16_t item_idx = 0;
+    uint16_t offset = 0;
+    files_array_t files;
+    files_array_init(files);
+    string_t name;
+    string_init(name);
+
+    uint32_t setup_time = osKernelGetTickCount();
+    archive_dir_test_setup();
+    setup_time = osKernelGetTickCount() - setup_time;
+
+    ArchiveDirWorker* worker = archive_dir_worker_alloc(ARCHIVE_DIR_TEST_WINDOW);
+    archive_dir_worker_set_callback(worker, archive_dir_test_callback, archive_dir_test_semaphore);
+    size_t heap_before = memmgr_get_free_heap();
+
+    // First window
+    uint32_t open_time = osKernelGetTickCount();
+    archive_dir_worker_folder_open(worker, ARCHIVE_DIR_TEST_PATH, ".nfc", NULL);
+    mu_assert_int_eq(
+        osOK, osSemaphoreAcquire(archive_dir_test_semaphore, ARCHIVE_DIR_TEST_TIMEOUT));
+    open_time = osKernelGetTickCount() - open_time;
+    mu_check(archive_dir_worker_take_folder(worker, &item_cnt, &item_idx));
+    mu_assert_int_eq(ARCHIVE_DIR_TEST_COUNT, item_cnt);
+    mu_assert_int_eq(0, item_idx);
+    mu_check(archive_dir_worker_take_list(worker, &offset, files));
+    mu_assert_int_eq(0, offset);
+    archive_dir_test_check_window(offset, files);
+
+    // Window around focused entry
+    archive_dir_test_name(name, 160);
+    archive_dir_worker_folder_open(worker, ARCHIVE_DIR_TEST_PATH, ".nfc", string_get_cstr(name));
+    mu_assert_int_eq(
+        osOK, osSemaphoreAcquire(archive_dir_test_semaphore, ARCHIVE_DIR_TEST_TIMEOUT));
+    mu_check(archive_dir_worker_take_folder(worker, &item_cnt, &item_idx));
+    mu_assert_int_eq(160, item_idx);
+    mu_check(archive_dir_worker_take_list(worker, &offset, files));
+    mu_check((item_idx >= offset) && (item_idx < offset + files_array_size(files)));
+    archive_dir_test_check_window(offset, files);
+
+    // Next window with anchor: single pass
+    ArchiveFile_t anchor;
+    ArchiveFile_t_init(&anchor);
+    ArchiveFile_t_set(&anchor, files_array_back(files));
+    uint16_t anchor_idx = offset + files_array_size(files) - 1;
+    uint32_t anchor_time = osKernelGetTickCount();
+    archive_dir_test_load(worker, anchor_idx + 1, &anchor, anchor_idx, files);
+    anchor_time = osKernelGetTickCount() - anchor_time;
+    ArchiveFile_t_clear(&anchor);
+
+    // Without anchor: pass per window from start
+    uint32_t walk_time = osKernelGetTickCount();
+    archive_dir_test_load(worker, 100, NULL, 0, files);
+    walk_time = osKernelGetTickCount() - walk_time;
+
+    // Tail and head
+    archive_dir_test_load(
+        worker, ARCHIVE_DIR_TEST_COUNT - ARCHIVE_DIR_TEST_WINDOW, NULL, 0, files);
+    archive_dir_test_load(worker, 0, NULL, 0, files);
+
+    // Memory of one window is held, not of whole folder with names
+    size_t heap_used = heap_before - memmgr_get_free_heap();
+    mu_assert(
+        heap_used < ARCHIVE_DIR_TEST_COUNT * ARCHIVE_DIR_TEST_ENTRY_SIZE, "window too large");
+
+    // Cancelled request gives no result
+    archive_dir_worker_folder_open(worker, ARCHIVE_DIR_TEST_PATH, ".nfc", NULL);
+    archive_dir_worker_cancel(worker);
+    mu_assert_int_eq(osErrorTimeout, osSemaphoreAcquire(archive_dir_test_semaphore, 1000));
+    mu_check(!archive_dir_worker_take_folder(worker, &item_cnt, &item_idx));
+    mu_check(!archive_dir_worker_take_list(worker, &offset, files));
+
+    // Missing folder is empty
+    archive_dir_worker_folder_open(worker, ARCHIVE_DIR_TEST_PATH "/none", ".nfc", NULL);
+    mu_assert_int_eq(
+        osOK, osSemaphoreAcquire(archive_dir_test_semaphore, ARCHIVE_DIR_TEST_TIMEOUT));
+    mu_check(archive_dir_worker_take_folder(worker, &item_cnt, &item_idx));
+    mu_assert_int_eq(0, item_cnt);
+    mu_check(archive_dir_worker_take_list(worker, &offset, files));
+    mu_assert_int_eq(0, files_array_size(files));
+
+    archive_dir_worker_free(worker);
+
+    FURI_LOG_I(
+        TAG,
+        "%u entries: setup %lu ms, first window %lu ms, anchored %lu ms, walk %lu ms, heap %u",
+        ARCHIVE_DIR_TEST_COUNT,
+        setup_time,
+        open_time,
+        anchor_time,
+        walk_time,
+        heap_used);
+
+    string_clear(name);
+    files_array_clear(files);
+    archive_dir_test_cleanup();
+}
+
+MU_TEST_SUITE(archive_dir_worker_suite) {
+    archive_dir_test_semaphore = osSemaphoreNew(1, 0, NULL);
+    MU_RUN_TEST(archive_dir_worker_test_paging);
+    osSemaphoreDelete(archive_dir_test_semaphore);
+}
+
+int run_minunit_test_archive_dir_worker() {
+    MU_RUN_SUITE(archive_dir_worker_suite);
+    return MU_EXIT_CODE;
+}
@@ -0,0 +1,148 @@
+#include <furi.h>
+#include <storage/storage.h>
+#include <archive/helpers/archive_favorites.h>
+#include "../minunit.h"
+
+#define TAG "UnitTestsArchive"
+
+#define ARCHIVE_FAV_TEST_PATH "/ext/favorites_test.txt"
+#define ARCHIVE_FAV_TEST_TEMP_PATH "/ext/favorites_test.tmp"
+#define ARCHIVE_FAV_TEST_COUNT 500
+
+static void archive_favorites_test_name(string_t name, size_t index) {
+    string_printf(name, "/any/nfc/favorite_%03u.nfc", index);
+}
+
+static void archive_favorites_test_cleanup() {
+    Storage* storage = furi_record_open("storage");
+    storage_simply_remove(storage, ARCHIVE_FAV_TEST_PATH);
+    storage_simply_remove(storage, ARCHIVE_FAV_TEST_TEMP_PATH);
+    furi_record_close("storage");
+}
+
+static bool archive_favorites_test_file_exists(const char* path) {
+    Storage* storage = furi_record_open("storage");
+    bool exists = storage_common_stat(storage, path, NULL) == FSE_OK;
+    furi_record_close("storage");
+    return exists;
+}
+
+static void archive_favorites_test_check(ArchiveFavorites* favorites) {
+    string_t name;
+    string_init(name);
+
+    size_t count = 0;
+    for(size_t i = 0; i < ARCHIVE_FAV_TEST_COUNT; i++) {
+        archive_favorites_test_name(name, i);
+        bool expected = (i % 5) && (i != 7);
+        mu_assert(
+            archive_is_favorite(favorites, "%s", string_get_cstr(name)) == expected,
+            "favorite membership mismatch");
+        count += expected;
+    }
+    mu_check(archive_is_favorite(favorites, "/any/nfc/renamed.nfc"));
+    mu_assert_int_eq(count + 1, archive_favorites_count(favorites));
+
+    string_clear(name);
+}
+
+MU_TEST(archive_favorites_test_changes) {
+    string_t name;
+    string_init(name);
+    archive_favorites_test_cleanup();
+
+    ArchiveFavorites* favorites =
+        archive_favorites_alloc(ARCHIVE_FAV_TEST_PATH, ARCHIVE_FAV_TEST_TEMP_PATH);
+    mu_assert_int_eq(0, archive_favorites_count(favorites));
+
+    uint32_t add_time = osKernelGetTickCount();
+    for(size_t i = 0; i < ARCHIVE_FAV_TEST_COUNT; i++) {
+        archive_favorites_test_name(name, i);
+        archive_add_to_favorites(favorites, string_get_cstr(name));
+    }
+    add_time = osKernelGetTickCount() - add_time;
+
+    // Duplicates are not added
+    archive_add_to_favorites(favorites, string_get_cstr(name));
+    mu_assert_int_eq(ARCHIVE_FAV_TEST_COUNT, archive_favorites_count(favorites));
+
+    uint32_t delete_time = osKernelGetTickCount();
+    for(size_t i = 0; i < ARCHIVE_FAV_TEST_COUNT; i += 5) {
+        archive_favorites_test_name(name, i);
+        mu_check(archive_favorites_delete(favorites, "%s", string_get_cstr(name)));
+    }
+    delete_time = osKernelGetTickCount() - delete_time;
+    mu_check(!archive_favorites_delete(favorites, "%s", string_get_cstr(name)));
+
+    archive_favorites_test_name(name, 7);
+    mu_check(archive_favorites_rename(favorites, string_get_cstr(name), "/any/nfc/renamed.nfc"));
+    mu_check(!archive_favorites_rename(favorites, string_get_cstr(name), "/any/nfc/x.nfc"));
+
+    uint32_t lookup_time = osKernelGetTickCount();
+    archive_favorites_test_check(favorites);
+    lookup_time = osKernelGetTickCount() - lookup_time;
+
+    // Changes are kept in memory until flush
+    mu_check(!archive_favorites_test_file_exists(ARCHIVE_FAV_TEST_PATH));
+
+    uint32_t flush_time = osKernelGetTickCount();
+    mu_check(archive_favorites_flush(favorites));
+    flush_time = osKernelGetTickCount() - flush_time;
+    mu_check(archive_favorites_test_file_exists(ARCHIVE_FAV_TEST_PATH));
+    mu_check(!archive_favorites_test_file_exists(ARCHIVE_FAV_TEST_TEMP_PATH));
+    archive_favorites_free(favorites);
+
+    uint32_t load_time = osKernelGetTickCount();
+    favorites = archive_favorites_alloc(ARCHIVE_FAV_TEST_PATH, ARCHIVE_FAV_TEST_TEMP_PATH);
+    load_time = osKernelGetTickCount() - load_time;
+    archive_favorites_test_check(favorites);
+    archive_favorites_free(favorites);
+
+    FURI_LOG_I(
+        TAG,
+        "%u favorites: add %lu ms, delete %lu ms, lookup %lu ms, flush %lu ms, load %lu ms",
+        ARCHIVE_FAV_TEST_COUNT,
+        add_time,
+        delete_time,
+        lookup_time,
+        flush_time,
+        load_time);
+
+    string_clear(name);
+    archive_favorites_test_cleanup();
+}
+
+MU_TEST(archive_favorites_test_interrupted_flush) {
+    archive_favorites_test_cleanup();
+
+    ArchiveFavorites* favorites =
+        archive_favorites_alloc(ARCHIVE_FAV_TEST_PATH, ARCHIVE_FAV_TEST_TEMP_PATH);
+    archive_add_to_favorites(favorites, "/any/nfc/a.nfc");
+    archive_add_to_favorites(favorites, "/any/nfc/b.nfc");
+    archive_favorites_free(favorites);
+
+    // Old file removed, new one is still under temporary name
+    Storage* storage = furi_record_open("storage");
+    mu_assert_int_eq(
+        FSE_OK,
+        storage_common_rename(storage, ARCHIVE_FAV_TEST_PATH, ARCHIVE_FAV_TEST_TEMP_PATH));
+    furi_record_close("storage");
+
+    favorites = archive_favorites_alloc(ARCHIVE_FAV_TEST_PATH, ARCHIVE_FAV_TEST_TEMP_PATH);
+    mu_assert_int_eq(2, archive_favorites_count(favorites));
+    mu_check(archive_is_favorite(favorites, "/any/nfc/b.nfc"));
+    mu_check(archive_favorites_test_file_exists(ARCHIVE_FAV_TEST_PATH));
+    archive_favorites_free(favorites);
+
+    archive_favorites_test_cleanup();
+}
+
+MU_TEST_SUITE(archive_favorites_suite) {
+    MU_RUN_TEST(archive_favorites_test_changes);
+    MU_RUN_TEST(archive_favorites_test_interrupted_flush);
+}
+
+int run_minunit_test_archive() {
+    MU_RUN_SUITE(archive_favorites_suite);
+    return MU_EXIT_CODE;
+}
@@ -0,0 +1,238 @@
+#include <furi.h>
+#include <storage/storage.h>
+#include <toolbox/stream/string_stream.h>
+#include <toolbox/stream/file_stream.h>
+#include <bad_usb/bad_usb_bytecode.h>
+#include "../minunit.h"
+
+#define TAG "UnitTestsBadUsb"
+
+#define BAD_USB_TEST_SCRIPT_PATH "/ext/badusb_test.txt"
+#define BAD_USB_TEST_BYTECODE_PATH BAD_USB_TEST_SCRIPT_PATH BAD_USB_BYTECODE_EXTENSION
+#define BAD_USB_TEST_PAYLOAD_SIZE (100 * 1024)
+
+typedef struct {
+    BadUsbOpType type;
+    uint32_t value;
+    const char* text;
+} BadUsbTestOp;
+
+static const char bad_usb_test_script[] = "ID 1234:abcd Flipper Devices:Keyboard\n"
+                                          "REM Sample script\n"
+                                          "DEFAULT_DELAY 10\r\n"
+                                          "\n"
+                                          "   \t\n"
+                                          "DELAY 500\n"
+                                          "GUI r\n"
+                                          "  STRING notepad\r\n"
+                                          "ENTER\n"
+                                          "CTRL-ALT DELETE\n"
+                                          "CTRL c\n"
+                                          "STRING Hello, World!\n"
+                                          "REPEAT 3\n"
+                                          "ALTCHAR 169\n"
+                                          "ALTSTRING abc\n"
+                                          "ALTCODE \x01\n"
+                                          "DELAY 0\n"
+                                          "FOO\n"
+                                          "F12";
+
+static const BadUsbTestOp bad_usb_test_script_ops[] = {
+    {BadUsbOpNop, 0, ""},
+    {BadUsbOpNop, 0, ""},
+    {BadUsbOpDefaultDelay, 10, ""},
+    {BadUsbOpDelay, 500, ""},
+    {BadUsbOpKey, KEY_MOD_LEFT_GUI | KEY_R, ""},
+    {BadUsbOpString, 0, "notepad"},
+    {BadUsbOpKey, KEY_ENTER, ""},
+    {BadUsbOpKey, KEY_MOD_LEFT_CTRL | KEY_MOD_LEFT_ALT | KEY_DELETE, ""},
+    {BadUsbOpKey, KEY_MOD_LEFT_CTRL | KEY_C, ""},
+    {BadUsbOpString, 0, "Hello, World!"},
+    {BadUsbOpRepeat, 3, ""},
+    {BadUsbOpAltChar, 0, "169"},
+    {BadUsbOpAltString, 0, "abc"},
+    {BadUsbOpError, 0, ""},
+    {BadUsbOpError, 0, ""},
+    {BadUsbOpError, 0, ""},
+    {BadUsbOpKey, KEY_F12, ""},
+};
+
+static size_t bad_usb_test_read_ops(BadUsbBytecodeReader* reader, const BadUsbTestOp* expected) {
+    BadUsbOp op;
+    string_init(op.text);
+    size_t count = 0;
+
+    bad_usb_bytecode_reader_rewind(reader);
+    while(bad_usb_bytecode_reader_next(reader, &op)) {
+        if(expected) {
+            if((op.type != expected[count].type) || (op.value != expected[count].value) ||
+               (strcmp(string_get_cstr(op.text), expected[count].text) != 0)) {
+                FURI_LOG_E(TAG, "Op %u mismatch: %u %lu", count, op.type, op.value);
+                break;
+            }
+        }
+        count++;
+    }
+
+    string_clear(op.text);
+    return count;
+}
+
+MU_TEST(bad_usb_bytecode_test_compile) {
+    Stream* script = string_stream_alloc();
+    Stream* bytecode = string_stream_alloc();
+    BadUsbBytecodeReader* reader = bad_usb_bytecode_reader_alloc(bytecode);
+    BadUsbScriptInfo info;
+    BadUsbScriptInfo header_info;
+    BadUsbScriptInfo script_info;
+
+    stream_write_cstring(script, bad_usb_test_script);
+    stream_rewind(script);
+    mu_check(bad_usb_bytecode_compile(script, bytecode, &info));
+
+    size_t ops_count = COUNT_OF(bad_usb_test_script_ops);
+    mu_assert_int_eq(ops_count, info.line_nb);
+    mu_check(info.id_set);
+    mu_assert_int_eq(0x1234, info.hid_cfg.vid);
+    mu_assert_int_eq(0xabcd, info.hid_cfg.pid);
+    mu_assert_string_eq("Flipper Devices", info.hid_cfg.manuf);
+    mu_assert_string_eq("Keyboard", info.hid_cfg.product);
+
+    // Header keeps script info, bytecode is valid while script size and CRC match
+    mu_check(bad_usb_bytecode_reader_get_info(reader, &header_info));
+    mu_assert_int_eq(info.line_nb, header_info.line_nb);
+    mu_assert_string_eq("Keyboard", header_info.hid_cfg.product);
+    stream_rewind(script);
+    bad_usb_script_info_get(script, &script_info);
+    mu_assert_int_eq(strlen(bad_usb_test_script), script_info.script_size);
+    mu_assert_int_eq(script_info.script_size, header_info.script_size);
+    mu_assert_int_eq(script_info.script_crc, header_info.script_crc);
+
+    mu_assert_int_eq(ops_count, bad_usb_test_read_ops(reader, bad_usb_test_script_ops));
+    // Rewind and read again
+    mu_assert_int_eq(ops_count, bad_usb_test_read_ops(reader, bad_usb_test_script_ops));
+
+    // Changed script has different CRC
+    stream_rewind(script);
+    stream_write_cstring(script, "JD");
+    stream_rewind(script);
+    bad_usb_script_info_get(script, &script_info);
+    mu_assert_int_eq(header_info.script_size, script_info.script_size);
+    mu_check(script_info.script_crc != header_info.script_crc);
+
+    bad_usb_bytecode_reader_free(reader);
+    stream_free(bytecode);
+    stream_free(script);
+}
+
+MU_TEST(bad_usb_bytecode_test_invalid) {
+    Stream* script = string_stream_alloc();
+    Stream* bytecode = string_stream_alloc();
+    BadUsbBytecodeReader* reader = bad_usb_bytecode_reader_alloc(bytecode);
+    BadUsbScriptInfo info;
+
+    // Empty bytecode
+    mu_check(!bad_usb_bytecode_reader_get_info(reader, &info));
+
+    // Empty script
+    mu_check(bad_usb_bytecode_compile(script, bytecode, &info));
+    mu_assert_int_eq(0, info.line_nb);
+    mu_check(!info.id_set);
+    mu_check(bad_usb_bytecode_reader_get_info(reader, &info));
+    mu_assert_int_eq(0, bad_usb_test_read_ops(reader, NULL));
+
+    // Header of incomplete bytecode
+    stream_write_cstring(script, "STRING abc\nENTER\n");
+    stream_rewind(script);
+    mu_check(bad_usb_bytecode_compile(script, bytecode, &info));
+    mu_assert_int_eq(2, info.line_nb);
+    stream_rewind(bytecode);
+    stream_write_char(bytecode, 0);
+    mu_check(!bad_usb_bytecode_reader_get_info(reader, &info));
+
+    // ID is taken only from first line
+    stream_clean(script);
+    stream_write_cstring(script, "REM\nID 1234:abcd\n");
+    stream_rewind(script);
+    mu_check(bad_usb_bytecode_compile(script, bytecode, &info));
+    mu_check(!info.id_set);
+
+    bad_usb_bytecode_reader_free(reader);
+    stream_free(bytecode);
+    stream_free(script);
+}
+
+static size_t bad_usb_test_payload_write(Stream* script) {
+    size_t lines = 0;
+    while(stream_size(script) < BAD_USB_TEST_PAYLOAD_SIZE) {
+        stream_write_cstring(script, "REM open text editor\nGUI r\nDELAY 200\n");
+        stream_write_format(
+            script, "STRING The quick brown fox jumps over the lazy dog, line %u\n", lines);
+        stream_write_cstring(script, "ENTER\nCTRL-SHIFT ESC\nREPEAT 2\nALTCHAR 65\n");
+        lines += 8;
+    }
+    return lines;
+}
+
+MU_TEST(bad_usb_bytecode_test_benchmark) {
+    Storage* storage = furi_record_open("storage");
+    Stream* script = file_stream_alloc(storage);
+    Stream* bytecode = file_stream_alloc(storage);
+    BadUsbBytecodeReader* reader = bad_usb_bytecode_reader_alloc(bytecode);
+    BadUsbScriptInfo info;
+    BadUsbScriptInfo script_info;
+
+    mu_check(
+        file_stream_open(script, BAD_USB_TEST_SCRIPT_PATH, FSAM_READ_WRITE, FSOM_CREATE_ALWAYS));
+    mu_check(file_stream_open(
+        bytecode, BAD_USB_TEST_BYTECODE_PATH, FSAM_READ_WRITE, FSOM_CREATE_ALWAYS));
+    size_t lines = bad_usb_test_payload_write(script);
+
+    stream_rewind(script);
+    uint32_t compile_time = osKernelGetTickCount();
+    mu_check(bad_usb_bytecode_compile(script, bytecode, &info));
+    compile_time = osKernelGetTickCount() - compile_time;
+    mu_assert_int_eq(lines, info.line_nb);
+
+    // Cached bytecode check: script CRC and bytecode header
+    stream_rewind(script);
+    uint32_t check_time = osKernelGetTickCount();
+    bad_usb_script_info_get(script, &script_info);
+    mu_check(bad_usb_bytecode_reader_get_info(reader, &info));
+    check_time = osKernelGetTickCount() - check_time;
+    mu_assert_int_eq(info.script_crc, script_info.script_crc);
+
+    uint32_t read_time = osKernelGetTickCount();
+    mu_assert_int_eq(lines, bad_usb_test_read_ops(reader, NULL));
+    read_time = osKernelGetTickCount() - read_time;
+
+    FURI_LOG_I(
+        TAG,
+        "%lu bytes script, %u bytes bytecode, %u lines: compile %lu ms, check %lu ms, read %lu ms",
+        info.script_size,
+        stream_size(bytecode),
+        lines,
+        compile_time,
+        check_time,
+        read_time);
+
+    bad_usb_bytecode_reader_free(reader);
+    file_stream_close(bytecode);
+    stream_free(bytecode);
+    file_stream_close(script);
+    stream_free(script);
+    storage_simply_remove(storage, BAD_USB_TEST_BYTECODE_PATH);
+    storage_simply_remove(storage, BAD_USB_TEST_SCRIPT_PATH);
+    furi_record_close("storage");
+}
+
+MU_TEST_SUITE(bad_usb_bytecode_suite) {
+    MU_RUN_TEST(bad_usb_bytecode_test_compile);
+    MU_RUN_TEST(bad_usb_bytecode_test_invalid);
+    MU_RUN_TEST(bad_usb_bytecode_test_benchmark);
+}
+
+int run_minunit_test_bad_usb() {
+    MU_RUN_SUITE(bad_usb_bytecode_suite);
+    return MU_EXIT_CODE;
+}
@@ -0,0 +1,192 @@
+#include <furi.h>
+#include <bt/bt_service/bt_serial_tx.h>
+#include "../minunit.h"
+
+#define TAG "UnitTestsBtSerial"
+
+#define BT_SERIAL_SIM_WINDOW_MAX 16
+// ATT MTU 185 is common for phones
+#define BT_SERIAL_TEST_PACKET_SIZE 182
+// RPC storage read response: 512 bytes of data and protobuf header
+#define BT_SERIAL_TEST_RPC_MESSAGE_SIZE 524
+#define BT_SERIAL_TEST_FILE_SIZE (64 * 1024)
+
+typedef struct {
+    uint32_t interval; /**< connection interval, ms */
+    uint8_t packets_per_event; /**< packets link layer delivers in one connection event */
+    uint8_t window; /**< stack TX buffers */
+    bool indication; /**< packet holds TX buffer until confirmed on next event */
+    uint8_t loss; /**< percent of packets retransmitted on next event */
+    uint32_t disconnect_time; /**< 0 - never */
+} BtSerialSimConfig;
+
+typedef struct {
+    const BtSerialSimConfig* config;
+    uint32_t time;
+    uint16_t queue[BT_SERIAL_SIM_WINDOW_MAX];
+    uint8_t queue_start;
+    uint8_t queued;
+    uint8_t confirming;
+    uint32_t random;
+    size_t bytes_accepted;
+    size_t bytes_delivered;
+} BtSerialSim;
+
+static const BtSerialSimConfig bt_serial_stop_and_wait = {
+    .interval = 30,
+    .packets_per_event = 4,
+    .window = 1,
+    .indication = true,
+};
+
+static const BtSerialSimConfig bt_serial_windowed = {
+    .interval = 30,
+    .packets_per_event = 4,
+    .window = 8,
+};
+
+static const BtSerialSimConfig bt_serial_windowed_lossy = {
+    .interval = 30,
+    .packets_per_event = 4,
+    .window = 8,
+    .loss = 20,
+};
+
+static const BtSerialSimConfig bt_serial_windowed_disconnect = {
+    .interval = 30,
+    .packets_per_event = 4,
+    .window = 8,
+    .disconnect_time = 300,
+};
+
+static void bt_serial_sim_init(BtSerialSim* sim, const BtSerialSimConfig* config) {
+    memset(sim, 0, sizeof(BtSerialSim));
+    sim->config = config;
+    sim->random = 0x1234;
+}
+
+static bool bt_serial_sim_lost(BtSerialSim* sim) {
+    sim->random = sim->random * 1103515245 + 12345;
+    return ((sim->random >> 16) % 100) < sim->config->loss;
+}
+
+static void bt_serial_sim_connection_event(BtSerialSim* sim) {
+    sim->time += sim->config->interval;
+    // Confirmations for indications delivered on previous event
+    sim->confirming = 0;
+    for(uint8_t i = 0; i < sim->config->packets_per_event && sim->queued; i++) {
+        if(bt_serial_sim_lost(sim)) continue;
+        sim->bytes_delivered += sim->queue[sim->queue_start];
+        sim->queue_start = (sim->queue_start + 1) % BT_SERIAL_SIM_WINDOW_MAX;
+        sim->queued--;
+        if(sim->config->indication) sim->confirming++;
+    }
+}
+
+static bool bt_serial_sim_window_full(BtSerialSim* sim) {
+    return (sim->queued + sim->confirming) >= sim->config->window;
+}
+
+static bool bt_serial_sim_disconnected(BtSerialSim* sim) {
+    return sim->config->disconnect_time && (sim->time >= sim->config->disconnect_time);
+}
+
+static SerialServiceTxStatus bt_serial_sim_tx(uint8_t* data, uint16_t size, void* context) {
+    UNUSED(data);
+    BtSerialSim* sim = context;
+    if(bt_serial_sim_disconnected(sim)) return SerialServiceTxStatusError;
+    if(bt_serial_sim_window_full(sim)) return SerialServiceTxStatusBusy;
+
+    sim->queue[(sim->queue_start + sim->queued) % BT_SERIAL_SIM_WINDOW_MAX] = size;
+    sim->queued++;
+    sim->bytes_accepted += size;
+    return SerialServiceTxStatusOk;
+}
+
+static bool bt_serial_sim_wait(void* context) {
+    BtSerialSim* sim = context;
+    do {
+        bt_serial_sim_connection_event(sim);
+        if(bt_serial_sim_disconnected(sim)) return false;
+    } while(bt_serial_sim_window_full(sim));
+    return true;
+}
+
+static void bt_serial_sim_drain(BtSerialSim* sim) {
+    while(sim->queued || sim->confirming) {
+        bt_serial_sim_connection_event(sim);
+    }
+}
+
+/* Stream RPC storage read responses through simulated link, return bytes sent */
+static size_t bt_serial_test_file_read(BtSerialSim* sim) {
+    static uint8_t message[BT_SERIAL_TEST_RPC_MESSAGE_SIZE];
+    size_t total = 0;
+    for(size_t read = 0; read < BT_SERIAL_TEST_FILE_SIZE; read += 512) {
+        size_t sent = bt_serial_tx(
+            message,
+            sizeof(message),
+            BT_SERIAL_TEST_PACKET_SIZE,
+            bt_serial_sim_tx,
+            bt_serial_sim_wait,
+            sim);
+        total += sent;
+        if(sent != sizeof(message)) break;
+    }
+    bt_serial_sim_drain(sim);
+    return total;
+}
+
+static uint32_t bt_serial_sim_throughput(BtSerialSim* sim) {
+    return sim->time ? (uint64_t)sim->bytes_delivered * 1000 / sim->time : 0;
+}
+
+MU_TEST(bt_serial_test_throughput) {
+    BtSerialSim sim;
+    bt_serial_sim_init(&sim, &bt_serial_stop_and_wait);
+    mu_assert_int_eq(bt_serial_test_file_read(&sim), sim.bytes_delivered);
+    mu_check(sim.bytes_delivered >= BT_SERIAL_TEST_FILE_SIZE);
+    uint32_t stop_and_wait = bt_serial_sim_throughput(&sim);
+
+    bt_serial_sim_init(&sim, &bt_serial_windowed);
+    mu_assert_int_eq(bt_serial_test_file_read(&sim), sim.bytes_delivered);
+    mu_check(sim.bytes_delivered >= BT_SERIAL_TEST_FILE_SIZE);
+    uint32_t windowed = bt_serial_sim_throughput(&sim);
+
+    FURI_LOG_I(TAG, "File read: stop-and-wait %lu B/s, windowed %lu B/s", stop_and_wait, windowed);
+    mu_check(windowed >= stop_and_wait * 4);
+}
+
+MU_TEST(bt_serial_test_loss) {
+    BtSerialSim sim;
+    bt_serial_sim_init(&sim, &bt_serial_stop_and_wait);
+    bt_serial_test_file_read(&sim);
+    uint32_t stop_and_wait = bt_serial_sim_throughput(&sim);
+
+    bt_serial_sim_init(&sim, &bt_serial_windowed_lossy);
+    mu_assert_int_eq(bt_serial_test_file_read(&sim), sim.bytes_delivered);
+    mu_check(sim.bytes_delivered >= BT_SERIAL_TEST_FILE_SIZE);
+    uint32_t windowed = bt_serial_sim_throughput(&sim);
+
+    FURI_LOG_I(TAG, "File read with 20%% loss: windowed %lu B/s", windowed);
+    mu_check(windowed > stop_and_wait);
+}
+
+MU_TEST(bt_serial_test_disconnect) {
+    BtSerialSim sim;
+    bt_serial_sim_init(&sim, &bt_serial_windowed_disconnect);
+    mu_assert_int_eq(bt_serial_test_file_read(&sim), sim.bytes_delivered);
+    mu_check(sim.bytes_delivered > 0);
+    mu_check(sim.bytes_delivered < BT_SERIAL_TEST_FILE_SIZE);
+}
+
+MU_TEST_SUITE(bt_serial_suite) {
+    MU_RUN_TEST(bt_serial_test_throughput);
+    MU_RUN_TEST(bt_serial_test_loss);
+    MU_RUN_TEST(bt_serial_test_disconnect);
+}
+
+int run_minunit_test_bt_serial() {
+    MU_RUN_SUITE(bt_serial_suite);
+    return MU_EXIT_CODE;
+}
@@ -0,0 +1,187 @@
+#include <furi.h>
+#include <storage/storage.h>
+#include <gui/view_i.h>
+#include <gui/modules/file_select.h>
+#include "../minunit.h"
+
+#define TAG "UnitTestsFileSelect"
+
+#define FILE_SELECT_TEST_PATH "/ext/file_select_test"
+#define FILE_SELECT_TEST_EXTENSION ".txt"
+#define FILE_SELECT_TEST_FILES_COUNT 100
+#define FILE_SELECT_TEST_OTHER_COUNT 10
+#define FILE_SELECT_TEST_FILES_MAX (FILE_SELECT_TEST_FILES_COUNT + 1)
+#define FILE_SELECT_TEST_NAME_SIZE 32
+
+static Storage* storage;
+static FileSelect* file_select;
+static char file_select_test_result[FILE_SELECT_TEST_NAME_SIZE];
+static size_t file_select_test_errors;
+
+/* Names in directory order, without extension, as FileSelect returns them */
+static char file_select_test_names[FILE_SELECT_TEST_FILES_MAX][FILE_SELECT_TEST_NAME_SIZE];
+static size_t file_select_test_names_count;
+
+static void file_select_test_callback(bool result, void* context) {
+    UNUSED(context);
+    if(!result) {
+        file_select_test_errors++;
+    }
+}
+
+static bool file_select_test_create(const char* name) {
+    string_t path;
+    string_init_printf(path, "%s/%s", FILE_SELECT_TEST_PATH, name);
+    File* file = storage_file_alloc(storage);
+    bool result =
+        storage_file_open(file, string_get_cstr(path), FSAM_WRITE, FSOM_CREATE_ALWAYS);
+    storage_file_close(file);
+    storage_file_free(file);
+    string_clear(path);
+    return result;
+}
+
+static void file_select_test_list() {
+    file_select_test_names_count = 0;
+
+    File* directory = storage_file_alloc(storage);
+    FileInfo info;
+    char name[FILE_SELECT_TEST_NAME_SIZE];
+    if(storage_dir_open(directory, FILE_SELECT_TEST_PATH)) {
+        while(storage_dir_read(directory, &info, name, FILE_SELECT_TEST_NAME_SIZE) &&
+              file_select_test_names_count < FILE_SELECT_TEST_FILES_MAX) {
+            char* extension = strstr(name, FILE_SELECT_TEST_EXTENSION);
+            if((info.flags & FSF_DIRECTORY) || extension == NULL) continue;
+            *extension = '\0';
+            strlcpy(
+                file_select_test_names[file_select_test_names_count++],
+                name,
+                FILE_SELECT_TEST_NAME_SIZE);
+        }
+    }
+    storage_dir_close(directory);
+    storage_file_free(directory);
+}
+
+static void file_select_test_setup() {
+    storage = furi_record_open("storage");
+    storage_simply_remove_recursive(storage, FILE_SELECT_TEST_PATH);
+    storage_simply_mkdir(storage, FILE_SELECT_TEST_PATH);
+
+    char name[FILE_SELECT_TEST_NAME_SIZE];
+    for(size_t i = 0; i < FILE_SELECT_TEST_FILES_COUNT; i++) {
+        snprintf(name, sizeof(name), "file_%03u%s", (unsigned)i, FILE_SELECT_TEST_EXTENSION);
+        file_select_test_create(name);
+    }
+    // filtered out, but still read from directory on every window move
+    for(size_t i = 0; i < FILE_SELECT_TEST_OTHER_COUNT; i++) {
+        snprintf(name, sizeof(name), "other_%03u.bin", (unsigned)i);
+        file_select_test_create(name);
+    }
+    file_select_test_list();
+
+    file_select_test_errors = 0;
+    file_select_test_result[0] = '\0';
+    file_select = file_select_alloc();
+    file_select_set_callback(file_select, file_select_test_callback, NULL);
+    file_select_set_filter(file_select, FILE_SELECT_TEST_PATH, FILE_SELECT_TEST_EXTENSION);
+    file_select_set_result_buffer(
+        file_select, file_select_test_result, FILE_SELECT_TEST_NAME_SIZE);
+    file_select_init(file_select);
+}
+
+static void file_select_test_teardown() {
+    file_select_free(file_select);
+    storage_simply_remove_recursive(storage, FILE_SELECT_TEST_PATH);
+    furi_record_close("storage");
+}
+
+static void file_select_test_press(InputKey key) {
+    InputEvent event = {.type = InputTypeShort, .key = key};
+    view_input(file_select_get_view(file_select), &event);
+}
+
+/* Selects current file and compares it with expected one */
+static bool file_select_test_selected(size_t index) {
+    file_select_test_result[0] = '\0';
+    file_select_test_press(InputKeyOk);
+    return strcmp(file_select_test_result, file_select_test_names[index]) == 0;
+}
+
+MU_TEST(file_select_test_window_moves) {
+    mu_assert_int_eq(FILE_SELECT_TEST_FILES_COUNT, file_select_test_names_count);
+
+    // forward, cache continues from open directory
+    size_t mismatches = 0;
+    uint32_t ticks = osKernelGetTickCount();
+    for(size_t i = 0; i < file_select_test_names_count; i++) {
+        if(!file_select_test_selected(i)) mismatches++;
+        file_select_test_press(InputKeyDown);
+    }
+    ticks = osKernelGetTickCount() - ticks;
+    FURI_LOG_I(
+        TAG, "Forward through %u files: %lu ticks", (unsigned)file_select_test_names_count, ticks);
+    mu_assert_int_eq(0, mismatches);
+
+    // wrapped to first file
+    mu_check(file_select_test_selected(0));
+
+    // backward, cache is read from directory start
+    ticks = osKernelGetTickCount();
+    for(size_t i = file_select_test_names_count; i > 0; i--) {
+        file_select_test_press(InputKeyUp);
+        if(!file_select_test_selected(i - 1)) mismatches++;
+    }
+    ticks = osKernelGetTickCount() - ticks;
+    FURI_LOG_I(
+        TAG,
+        "Backward through %u files: %lu ticks",
+        (unsigned)file_select_test_names_count,
+        ticks);
+    mu_assert_int_eq(0, mismatches);
+    mu_assert_int_eq(0, file_select_test_errors);
+}
+
+MU_TEST(file_select_test_invalidation) {
+    // leave directory open in the middle of the list
+    for(size_t i = 0; i < FILE_SELECT_TEST_FILES_COUNT / 2; i++) {
+        file_select_test_press(InputKeyDown);
+    }
+    mu_check(file_select_test_selected(FILE_SELECT_TEST_FILES_COUNT / 2));
+
+    // file close event invalidates cache and count
+    mu_check(file_select_test_create("file_new" FILE_SELECT_TEST_EXTENSION));
+    file_select_test_list();
+    mu_assert_int_eq(FILE_SELECT_TEST_FILES_COUNT + 1, file_select_test_names_count);
+
+    // back to first file, then wrap to last one, which only exists in new count
+    size_t mismatches = 0;
+    for(size_t i = FILE_SELECT_TEST_FILES_COUNT / 2; i > 0; i--) {
+        file_select_test_press(InputKeyUp);
+        if(!file_select_test_selected(i - 1)) mismatches++;
+    }
+    file_select_test_press(InputKeyUp);
+    mu_check(file_select_test_selected(file_select_test_names_count - 1));
+    mu_assert_int_eq(0, mismatches);
+
+    // forward from first file with reopened directory
+    file_select_test_press(InputKeyDown);
+    for(size_t i = 0; i < file_select_test_names_count; i++) {
+        if(!file_select_test_selected(i)) mismatches++;
+        file_select_test_press(InputKeyDown);
+    }
+    mu_assert_int_eq(0, mismatches);
+    mu_assert_int_eq(0, file_select_test_errors);
+}
+
+MU_TEST_SUITE(file_select_test_suite) {
+    MU_SUITE_CONFIGURE(&file_select_test_setup, &file_select_test_teardown);
+
+    MU_RUN_TEST(file_select_test_window_moves);
+    MU_RUN_TEST(file_select_test_invalidation);
+}
+
+int run_minunit_test_file_select() {
+    MU_RUN_SUITE(file_select_test_suite);
+    return MU_EXIT_CODE;
+}
@@ -0,0 +1,129 @@
+#include <furi.h>
+#include <file_worker_i.h>
+#include "../minunit.h"
+
+#define TAG "UnitTestsFileWorker"
+
+#define FILE_WORKER_TEST_PATH "/ext/file_worker_test.txt"
+#define FILE_WORKER_TEST_LINES 1000
+
+static void file_worker_test_write(const char* data) {
+    FileWorker* file_worker = file_worker_alloc(true);
+    mu_check(
+        file_worker_open(file_worker, FILE_WORKER_TEST_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS));
+    mu_check(file_worker_write(file_worker, data, strlen(data)));
+    mu_check(file_worker_close(file_worker));
+    file_worker_free(file_worker);
+}
+
+static void file_worker_test_read_until_check(FileWorker* file_worker, const char* expected) {
+    string_t line;
+    string_init(line);
+    mu_check(file_worker_read_until(file_worker, line, '\n'));
+    mu_assert_string_eq(expected, string_get_cstr(line));
+    string_clear(line);
+}
+
+MU_TEST(file_worker_test_read_until) {
+    FileWorker* file_worker = file_worker_alloc(true);
+    string_t line;
+    string_t expected;
+    string_init(line);
+    string_init(expected);
+
+    mu_check(
+        file_worker_open(file_worker, FILE_WORKER_TEST_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS));
+    for(size_t i = 0; i < FILE_WORKER_TEST_LINES; i++) {
+        string_printf(expected, "Key %u: %s\n", i, (i % 7) ? "value" : "");
+        mu_check(file_worker_write(file_worker, string_get_cstr(expected), string_size(expected)));
+    }
+    mu_check(file_worker_close(file_worker));
+
+    mu_check(
+        file_worker_open(file_worker, FILE_WORKER_TEST_PATH, FSAM_READ, FSOM_OPEN_EXISTING));
+    uint32_t reads = file_worker_get_storage_reads(file_worker);
+    uint32_t read_time = osKernelGetTickCount();
+    for(size_t i = 0; i < FILE_WORKER_TEST_LINES; i++) {
+        mu_check(file_worker_read_until(file_worker, line, '\n'));
+        string_printf(expected, "Key %u: %s", i, (i % 7) ? "value" : "");
+        mu_assert_string_eq(string_get_cstr(expected), string_get_cstr(line));
+    }
+    read_time = osKernelGetTickCount() - read_time;
+    reads = file_worker_get_storage_reads(file_worker) - reads;
+
+    // Storage is read in blocks, not per byte or per line
+    uint64_t size = 0;
+    mu_check(file_worker_tell(file_worker, &size));
+    mu_check(reads > 0);
+    mu_check(reads * 64 < size);
+    mu_check(reads < FILE_WORKER_TEST_LINES / 10);
+
+    // EOF is not an error, result is empty
+    mu_check(file_worker_read_until(file_worker, line, '\n'));
+    mu_assert_int_eq(0, string_size(line));
+    mu_check(file_worker_close(file_worker));
+
+    FURI_LOG_I(
+        TAG,
+        "%u lines, %lu bytes read in %lu ms with %lu storage reads",
+        FILE_WORKER_TEST_LINES,
+        (uint32_t)size,
+        read_time,
+        reads);
+
+    string_clear(expected);
+    string_clear(line);
+    file_worker_free(file_worker);
+}
+
+MU_TEST(file_worker_test_buffer_consistency) {
+    FileWorker* file_worker = file_worker_alloc(true);
+    uint64_t position;
+    char data[3] = {0};
+
+    file_worker_test_write("abc\ndef\n\nghi");
+    mu_check(file_worker_open(
+        file_worker, FILE_WORKER_TEST_PATH, FSAM_READ_WRITE, FSOM_OPEN_EXISTING));
+
+    // Tell and read continue right after separator, not at the end of read ahead data
+    file_worker_test_read_until_check(file_worker, "abc");
+    mu_check(file_worker_tell(file_worker, &position));
+    mu_assert_int_eq(4, position);
+    mu_check(file_worker_read(file_worker, data, 2));
+    mu_assert_string_eq("de", data);
+
+    // Relative seek
+    mu_check(file_worker_seek(file_worker, 2, false));
+    file_worker_test_read_until_check(file_worker, "");
+    file_worker_test_read_until_check(file_worker, "ghi");
+    file_worker_test_read_until_check(file_worker, "");
+
+    // Write goes to the position after separator
+    mu_check(file_worker_seek(file_worker, 0, true));
+    file_worker_test_read_until_check(file_worker, "abc");
+    mu_check(file_worker_write(file_worker, "DE", 2));
+    mu_check(file_worker_tell(file_worker, &position));
+    mu_assert_int_eq(6, position);
+    file_worker_test_read_until_check(file_worker, "f");
+
+    mu_check(file_worker_seek(file_worker, 0, true));
+    file_worker_test_read_until_check(file_worker, "abc");
+    file_worker_test_read_until_check(file_worker, "DEf");
+    mu_check(file_worker_close(file_worker));
+
+    file_worker_free(file_worker);
+}
+
+MU_TEST_SUITE(file_worker_suite) {
+    MU_RUN_TEST(file_worker_test_read_until);
+    MU_RUN_TEST(file_worker_test_buffer_consistency);
+
+    Storage* storage = furi_record_open("storage");
+    storage_simply_remove(storage, FILE_WORKER_TEST_PATH);
+    furi_record_close("storage");
+}
+
+int run_minunit_test_file_worker() {
+    MU_RUN_SUITE(file_worker_suite);
+    return MU_EXIT_CODE;
+}
@@ -0,0 +1,108 @@
+#include <furi.h>
+#include <furi_hal.h>
+#include "../minunit.h"
+
+#define TAG "UnitTestsFlash"
+
+#define FLASH_TEST_ERASED_DWORD 0xFFFFFFFFFFFFFFFFULL
+
+/* Test page is taken from internal storage area, it is restored erased after test */
+static size_t flash_test_address;
+static size_t flash_test_size;
+static uint8_t* flash_test_data;
+
+static bool flash_test_is_erased(size_t address, size_t size) {
+    for(size_t offset = 0; offset < size; offset += sizeof(uint64_t)) {
+        if(*(volatile uint64_t*)(address + offset) != FLASH_TEST_ERASED_DWORD) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void flash_test_erase() {
+    uint8_t page = (flash_test_address - furi_hal_flash_get_base()) /
+                   furi_hal_flash_get_page_size();
+    furi_hal_flash_erase(page);
+}
+
+/* Internal storage keeps no data in erased pages, last one of them is used for test */
+static void flash_test_setup() {
+    flash_test_size = furi_hal_flash_get_page_size();
+    flash_test_address = 0;
+    size_t start = furi_hal_flash_get_free_page_start_address();
+    for(size_t i = furi_hal_flash_get_free_page_count(); i > 0; i--) {
+        size_t address = start + (i - 1) * flash_test_size;
+        if(flash_test_is_erased(address, flash_test_size)) {
+            flash_test_address = address;
+            break;
+        }
+    }
+
+    flash_test_data = malloc(flash_test_size);
+    furi_hal_random_fill_buf(flash_test_data, flash_test_size);
+}
+
+static void flash_test_teardown() {
+    if(flash_test_address) {
+        flash_test_erase();
+    }
+    free(flash_test_data);
+}
+
+MU_TEST(flash_test_burst_write) {
+    mu_assert(flash_test_address, "no erased page");
+
+    // unaligned source buffer
+    mu_check(furi_hal_flash_program_burst(
+        flash_test_address, flash_test_data + 1, flash_test_size - sizeof(uint64_t)));
+    mu_check(memcmp(
+                 (const void*)flash_test_address,
+                 flash_test_data + 1,
+                 flash_test_size - sizeof(uint64_t)) == 0);
+    mu_check(flash_test_is_erased(
+        flash_test_address + flash_test_size - sizeof(uint64_t), sizeof(uint64_t)));
+
+    // programming not erased double word fails, controller error flags are cleared
+    mu_check(!furi_hal_flash_program_burst(flash_test_address, flash_test_data, flash_test_size));
+    flash_test_erase();
+    mu_check(flash_test_is_erased(flash_test_address, flash_test_size));
+}
+
+MU_TEST(flash_test_burst_benchmark) {
+    mu_assert(flash_test_address, "no erased page");
+
+    uint32_t dword_cycles = DWT->CYCCNT;
+    for(size_t offset = 0; offset < flash_test_size; offset += sizeof(uint64_t)) {
+        uint64_t dword;
+        memcpy(&dword, flash_test_data + offset, sizeof(dword));
+        furi_hal_flash_write_dword(flash_test_address + offset, dword);
+    }
+    dword_cycles = DWT->CYCCNT - dword_cycles;
+    flash_test_erase();
+
+    uint32_t burst_cycles = DWT->CYCCNT;
+    mu_check(furi_hal_flash_program_burst(flash_test_address, flash_test_data, flash_test_size));
+    burst_cycles = DWT->CYCCNT - burst_cycles;
+    mu_check(memcmp((const void*)flash_test_address, flash_test_data, flash_test_size) == 0);
+
+    FURI_LOG_I(
+        TAG,
+        "%u bytes: per dword %lu cycles, burst %lu cycles",
+        (unsigned)flash_test_size,
+        dword_cycles,
+        burst_cycles);
+    mu_check(burst_cycles < dword_cycles);
+}
+
+MU_TEST_SUITE(flash_test_suite) {
+    MU_SUITE_CONFIGURE(&flash_test_setup, &flash_test_teardown);
+
+    MU_RUN_TEST(flash_test_burst_write);
+    MU_RUN_TEST(flash_test_burst_benchmark);
+}
+
+int run_minunit_test_furi_hal_flash() {
+    MU_RUN_SUITE(flash_test_suite);
+    return MU_EXIT_CODE;
+}
@@ -0,0 +1,158 @@
+#include <stdio.h>
+#include <string.h>
+#include <furi.h>
+#include <furi_hal.h>
+#include "minunit.h"
+
+#define TAG "UnitTestsLog"
+#define LOG_TEST_PRODUCER_TAG "UnitTestsLogProducer"
+
+#define LOG_TEST_PRODUCERS 4
+#define LOG_TEST_MESSAGES 200
+#define LOG_TEST_TIMEOUT 2000
+#define LOG_BENCHMARK_ITERATIONS 16
+
+typedef struct {
+    volatile uint32_t received;
+    volatile int32_t last[LOG_TEST_PRODUCERS];
+    volatile bool out_of_order;
+} LogTestCapture;
+
+static LogTestCapture log_test_capture;
+
+/* Runs in log thread */
+static void log_test_puts(const char* data) {
+    const char* payload = strstr(data, "[" LOG_TEST_PRODUCER_TAG "]: " FURI_LOG_CLR_RESET);
+    if(!payload) {
+        furi_hal_console_puts(data);
+        return;
+    }
+
+    unsigned int producer = 0;
+    int message = 0;
+    payload += strlen("[" LOG_TEST_PRODUCER_TAG "]: " FURI_LOG_CLR_RESET);
+    if(sscanf(payload, "p%u m%d", &producer, &message) != 2 ||
+       producer >= LOG_TEST_PRODUCERS) {
+        log_test_capture.out_of_order = true;
+        return;
+    }
+
+    // Messages of one producer keep their order
+    if(message <= log_test_capture.last[producer]) {
+        log_test_capture.out_of_order = true;
+    }
+    log_test_capture.last[producer] = message;
+    log_test_capture.received++;
+}
+
+static int32_t log_test_producer(void* context) {
+    uint32_t producer = (uint32_t)context;
+
+    for(int i = 0; i < LOG_TEST_MESSAGES; i++) {
+        FURI_LOG_I(LOG_TEST_PRODUCER_TAG, "p%lu m%d", producer, i);
+        // Give log thread a chance to drain
+        if(i % 8 == 7) osDelay(1);
+    }
+
+    return 0;
+}
+
+void test_furi_log_concurrent() {
+    memset((void*)&log_test_capture, 0, sizeof(log_test_capture));
+    for(size_t i = 0; i < LOG_TEST_PRODUCERS; i++) {
+        log_test_capture.last[i] = -1;
+    }
+
+    uint32_t dropped = furi_log_get_dropped();
+    furi_log_set_puts(log_test_puts);
+
+    FuriThread* producers[LOG_TEST_PRODUCERS];
+    for(size_t i = 0; i < LOG_TEST_PRODUCERS; i++) {
+        producers[i] = furi_thread_alloc();
+        furi_thread_set_name(producers[i], "LogTestProducer");
+        furi_thread_set_stack_size(producers[i], 1024);
+        furi_thread_set_context(producers[i], (void*)i);
+        furi_thread_set_callback(producers[i], log_test_producer);
+        furi_thread_start(producers[i]);
+    }
+
+    for(size_t i = 0; i < LOG_TEST_PRODUCERS; i++) {
+        furi_thread_join(producers[i]);
+        furi_thread_free(producers[i]);
+    }
+
+    // Every message is either written or counted as dropped
+    uint32_t expected = LOG_TEST_PRODUCERS * LOG_TEST_MESSAGES;
+    uint32_t timeout = osKernelGetTickCount() + LOG_TEST_TIMEOUT;
+    while(log_test_capture.received + (furi_log_get_dropped() - dropped) < expected &&
+          osKernelGetTickCount() < timeout) {
+        osDelay(10);
+    }
+    dropped = furi_log_get_dropped() - dropped;
+
+    furi_log_set_puts(furi_hal_console_puts);
+
+    mu_check(!log_test_capture.out_of_order);
+    mu_check(log_test_capture.received <= expected);
+    mu_assert_int_eq(expected, log_test_capture.received + dropped);
+    mu_check(log_test_capture.received > 0);
+}
+
+static volatile bool log_test_truncated;
+
+/* Runs in log thread */
+static void log_test_truncated_puts(const char* data) {
+    if(strstr(data, "[" LOG_TEST_PRODUCER_TAG "]: ")) {
+        const char* end = data + strlen(data) - strlen("...\r\n");
+        log_test_truncated = (strcmp(end, "...\r\n") == 0) && (end[-1] == 'x');
+    } else {
+        furi_hal_console_puts(data);
+    }
+}
+
+void test_furi_log_truncated() {
+    char payload[200];
+    memset(payload, 'x', sizeof(payload) - 1);
+    payload[sizeof(payload) - 1] = '\0';
+
+    log_test_truncated = false;
+    furi_log_set_puts(log_test_truncated_puts);
+    FURI_LOG_I(LOG_TEST_PRODUCER_TAG, "%s", payload);
+    uint32_t timeout = osKernelGetTickCount() + LOG_TEST_TIMEOUT;
+    while(!log_test_truncated && osKernelGetTickCount() < timeout) {
+        osDelay(10);
+    }
+    furi_log_set_puts(furi_hal_console_puts);
+
+    // Cut line is marked
+    mu_check(log_test_truncated);
+}
+
+void test_furi_log_benchmark() {
+    // Drain whatever is queued by now
+    osDelay(100);
+
+    size_t allocations = memmgr_heap_get_alloc_count();
+    uint32_t cycles = DWT->CYCCNT;
+    for(size_t i = 0; i < LOG_BENCHMARK_ITERATIONS; i++) {
+        FURI_LOG_I(TAG, "Benchmark message %u of %u", i, LOG_BENCHMARK_ITERATIONS);
+    }
+    uint32_t queued = (DWT->CYCCNT - cycles) / LOG_BENCHMARK_ITERATIONS;
+    allocations = memmgr_heap_get_alloc_count() - allocations;
+
+    FuriLogLevel level = furi_log_get_level();
+    furi_log_set_level(FuriLogLevelInfo);
+    cycles = DWT->CYCCNT;
+    for(size_t i = 0; i < LOG_BENCHMARK_ITERATIONS; i++) {
+        FURI_LOG_T(TAG, "Benchmark message %u of %u", i, LOG_BENCHMARK_ITERATIONS);
+    }
+    uint32_t filtered = (DWT->CYCCNT - cycles) / LOG_BENCHMARK_ITERATIONS;
+    furi_log_set_level(level);
+
+    osDelay(100);
+    FURI_LOG_I(
+        TAG, "Caller cost: %lu cycles queued, %lu cycles filtered out", queued, filtered);
+
+    // Other threads may allocate meanwhile, logging itself must not
+    mu_assert(allocations < LOG_BENCHMARK_ITERATIONS / 4, "log call allocates");
+}
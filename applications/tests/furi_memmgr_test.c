@@ -2,6 +2,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <furi/memmgr_heap.h>
+#include <furi/log.h>
 
 // this test is not accurate, but gives a basic understanding
 // that memory management is working fine
@@ -11,6 +13,11 @@
 extern size_t memmgr_get_free_heap(void);
 extern size_t memmgr_get_minimum_free_heap(void);
 
+#define TAG "UnitTestsMemmgr"
+
+#define TRACE_SLOTS 32
+#define TRACE_STEPS 2000
+
 // current heap managment realization consume:
 // X bytes after allocate and 0 bytes after allocate and free,
 // where X = sizeof(void*) + sizeof(size_t), look to BlockLink_t
@@ -98,3 +105,97 @@ void test_furi_memmgr() {
     free(original_ptr);
     free(ptr);
 }
+
+typedef struct {
+    size_t free_blocks;
+    size_t max_free_block;
+    uint32_t pool_hits;
+} MemmgrTraceResult;
+
+static uint32_t memmgr_trace_random(uint32_t* seed) {
+    *seed = *seed * 1103515245 + 12345;
+    return *seed >> 8;
+}
+
+// Same trace every run: mostly small strings and messages, some buffers.
+// Every 4th small allocation outlives the rest, like cached names do.
+static MemmgrTraceResult memmgr_trace_replay() {
+    void* slots[TRACE_SLOTS] = {NULL};
+    size_t sizes[TRACE_SLOTS] = {0};
+    uint32_t seed = 7;
+    MemmgrTraceResult result;
+    MemmgrHeapStats* stats = malloc(sizeof(MemmgrHeapStats));
+
+    memmgr_heap_get_stats(stats);
+    result.pool_hits = 0;
+    for(size_t i = 0; i < MEMMGR_HEAP_POOL_CLASSES; i++) {
+        result.pool_hits -= stats->pools[i].hits;
+    }
+
+    for(size_t step = 0; step < TRACE_STEPS; step++) {
+        size_t i = memmgr_trace_random(&seed) % TRACE_SLOTS;
+        free(slots[i]);
+        if(memmgr_trace_random(&seed) % 10 < 7) {
+            sizes[i] = 1 + memmgr_trace_random(&seed) % 256;
+        } else {
+            sizes[i] = 300 + memmgr_trace_random(&seed) % 900;
+        }
+        slots[i] = malloc(sizes[i]);
+    }
+
+    for(size_t i = 0; i < TRACE_SLOTS; i++) {
+        if(sizes[i] > 256 || i % 4) {
+            free(slots[i]);
+            slots[i] = NULL;
+        }
+    }
+
+    memmgr_heap_get_stats(stats);
+    result.free_blocks = stats->free_blocks;
+    result.max_free_block = stats->max_free_block;
+    for(size_t i = 0; i < MEMMGR_HEAP_POOL_CLASSES; i++) {
+        result.pool_hits += stats->pools[i].hits;
+    }
+
+    for(size_t i = 0; i < TRACE_SLOTS; i++) {
+        free(slots[i]);
+    }
+    free(stats);
+
+    return result;
+}
+
+void test_furi_memmgr_fragmentation() {
+    size_t heap_size_old = memmgr_get_free_heap();
+
+    memmgr_heap_set_pool_enabled(false);
+    MemmgrTraceResult heap_only = memmgr_trace_replay();
+    memmgr_heap_set_pool_enabled(true);
+    mu_assert(heap_equal(memmgr_get_free_heap(), heap_size_old), "trace leaked");
+
+    MemmgrTraceResult pooled = memmgr_trace_replay();
+    mu_assert(heap_equal(memmgr_get_free_heap(), heap_size_old), "trace leaked");
+
+    FURI_LOG_I(
+        TAG,
+        "Free blocks after trace: %u heap only, %u with pools. Max block: %u, %u",
+        heap_only.free_blocks,
+        pooled.free_blocks,
+        heap_only.max_free_block,
+        pooled.max_free_block);
+
+    // Long living small allocations stay in pools and don't split heap
+    mu_assert_int_eq(0, heap_only.pool_hits);
+    mu_check(pooled.pool_hits > 0);
+    mu_check(pooled.free_blocks <= heap_only.free_blocks);
+
+    // Pool space is reported apart from heap free size
+    size_t pool_free = memmgr_heap_get_pool_free();
+    size_t heap_free = memmgr_get_free_heap() - pool_free;
+    void* slot = malloc(16);
+    size_t slot_pool_free = memmgr_heap_get_pool_free();
+    size_t slot_heap_free = memmgr_get_free_heap() - slot_pool_free;
+    free(slot);
+    mu_assert_int_eq(pool_free - 16, slot_pool_free);
+    mu_assert_int_eq(heap_free, slot_heap_free);
+}
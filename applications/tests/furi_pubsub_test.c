@@ -1,8 +1,11 @@
 #include <stdio.h>
 #include <string.h>
 #include <furi.h>
+#include <furi_hal.h>
 #include "minunit.h"
 
+#define TAG "UnitTestsPubSub"
+
 const uint32_t context_value = 0xdeadbeef;
 const uint32_t notify_value_0 = 0x12345678;
 const uint32_t notify_value_1 = 0x11223344;
@@ -42,4 +45,235 @@ void test_furi_pubsub() {
 
     // delete pubsub case
     furi_pubsub_free(test_pubsub);
-}
\ No newline at end of file
+}
+typedef struct {
+    FuriPubSub* pubsub;
+    FuriPubSubSubscription* subscription;
+    volatile uint32_t calls;
+    volatile bool alive;
+} PubSubTestSubscriber;
+
+static void test_pubsub_self_unsubscribe_handler(const void* arg, void* ctx) {
+    UNUSED(arg);
+    PubSubTestSubscriber* subscriber = ctx;
+    subscriber->calls++;
+    furi_pubsub_unsubscribe(subscriber->pubsub, subscriber->subscription);
+}
+
+static void test_pubsub_subscribe_other_handler(const void* arg, void* ctx) {
+    UNUSED(arg);
+    PubSubTestSubscriber* subscriber = ctx;
+    subscriber->calls++;
+    if(!subscriber->subscription) {
+        subscriber->subscription =
+            furi_pubsub_subscribe(subscriber->pubsub, test_pubsub_handler, (void*)&context_value);
+    }
+}
+
+void test_furi_pubsub_reentrance() {
+    FuriPubSub* pubsub = furi_pubsub_alloc();
+
+    // unsubscribe from own callback
+    PubSubTestSubscriber self = {.pubsub = pubsub};
+    self.subscription = furi_pubsub_subscribe(pubsub, test_pubsub_self_unsubscribe_handler, &self);
+    furi_pubsub_publish(pubsub, (void*)&notify_value_0);
+    furi_pubsub_publish(pubsub, (void*)&notify_value_0);
+    mu_assert_int_eq(1, self.calls);
+
+    // subscription made in callback receives next message
+    PubSubTestSubscriber other = {.pubsub = pubsub};
+    FuriPubSubSubscription* subscription =
+        furi_pubsub_subscribe(pubsub, test_pubsub_subscribe_other_handler, &other);
+    pubsub_value = 0;
+    furi_pubsub_publish(pubsub, (void*)&notify_value_0);
+    mu_assert_pointers_not_eq(other.subscription, NULL);
+    mu_assert_int_eq(0, pubsub_value);
+    furi_pubsub_publish(pubsub, (void*)&notify_value_1);
+    mu_assert_int_eq(notify_value_1, pubsub_value);
+    mu_assert_int_eq(2, other.calls);
+
+    furi_pubsub_unsubscribe(pubsub, other.subscription);
+    furi_pubsub_unsubscribe(pubsub, subscription);
+    furi_pubsub_free(pubsub);
+}
+
+#define PUBSUB_STRESS_PUBLISHERS 3
+#define PUBSUB_STRESS_MESSAGES 2000
+#define PUBSUB_STRESS_CHURN 200
+
+static volatile uint32_t pubsub_stress_violations = 0;
+
+static void test_pubsub_stress_handler(const void* arg, void* ctx) {
+    UNUSED(arg);
+    PubSubTestSubscriber* subscriber = ctx;
+    FURI_CRITICAL_ENTER();
+    if(!subscriber->alive) pubsub_stress_violations++;
+    subscriber->calls++;
+    FURI_CRITICAL_EXIT();
+}
+
+static void test_pubsub_stress_self_handler(const void* arg, void* ctx) {
+    test_pubsub_stress_handler(arg, ctx);
+    PubSubTestSubscriber* subscriber = ctx;
+    if(subscriber->calls == 1) {
+        furi_pubsub_unsubscribe(subscriber->pubsub, subscriber->subscription);
+        subscriber->alive = false;
+    }
+}
+
+static int32_t test_pubsub_stress_publisher(void* context) {
+    FuriPubSub* pubsub = context;
+    for(uint32_t i = 0; i < PUBSUB_STRESS_MESSAGES; i++) {
+        furi_pubsub_publish(pubsub, &i);
+        if(i % 64 == 0) osThreadYield();
+    }
+    return 0;
+}
+
+void test_furi_pubsub_concurrent() {
+    FuriPubSub* pubsub = furi_pubsub_alloc();
+    pubsub_stress_violations = 0;
+
+    PubSubTestSubscriber counter = {.pubsub = pubsub, .alive = true};
+    counter.subscription = furi_pubsub_subscribe(pubsub, test_pubsub_stress_handler, &counter);
+
+    FuriThread* publishers[PUBSUB_STRESS_PUBLISHERS];
+    for(size_t i = 0; i < PUBSUB_STRESS_PUBLISHERS; i++) {
+        publishers[i] = furi_thread_alloc();
+        furi_thread_set_name(publishers[i], "PubSubStress");
+        furi_thread_set_stack_size(publishers[i], 1024);
+        furi_thread_set_context(publishers[i], pubsub);
+        furi_thread_set_callback(publishers[i], test_pubsub_stress_publisher);
+        furi_thread_start(publishers[i]);
+    }
+
+    // Subscribe and unsubscribe while messages are published
+    PubSubTestSubscriber* churn = malloc(sizeof(PubSubTestSubscriber) * PUBSUB_STRESS_CHURN);
+    for(size_t i = 0; i < PUBSUB_STRESS_CHURN; i++) {
+        churn[i].pubsub = pubsub;
+        churn[i].calls = 0;
+        churn[i].alive = true;
+        bool self = (i % 2);
+        churn[i].subscription = furi_pubsub_subscribe(
+            pubsub,
+            self ? test_pubsub_stress_self_handler : test_pubsub_stress_handler,
+            &churn[i]);
+        osThreadYield();
+        if(!self) {
+            furi_pubsub_unsubscribe(pubsub, churn[i].subscription);
+            churn[i].alive = false;
+        }
+    }
+
+    for(size_t i = 0; i < PUBSUB_STRESS_PUBLISHERS; i++) {
+        furi_thread_join(publishers[i]);
+        furi_thread_free(publishers[i]);
+    }
+
+    // Self unsubscribing subscribers that were never called
+    for(size_t i = 0; i < PUBSUB_STRESS_CHURN; i++) {
+        if(churn[i].alive) {
+            mu_assert_int_eq(0, churn[i].calls);
+            furi_pubsub_unsubscribe(pubsub, churn[i].subscription);
+        }
+    }
+
+    mu_assert_int_eq(0, pubsub_stress_violations);
+    mu_assert_int_eq(PUBSUB_STRESS_PUBLISHERS * PUBSUB_STRESS_MESSAGES, counter.calls);
+
+    free(churn);
+    furi_pubsub_unsubscribe(pubsub, counter.subscription);
+    furi_pubsub_free(pubsub);
+}
+
+#define PUBSUB_SLOW_CHURN 32
+
+static void test_pubsub_slow_handler(const void* arg, void* ctx) {
+    UNUSED(arg);
+    PubSubTestSubscriber* subscriber = ctx;
+    subscriber->calls++;
+    osDelay(100);
+}
+
+static int32_t test_pubsub_slow_publisher(void* context) {
+    furi_pubsub_publish(context, (void*)&notify_value_0);
+    return 0;
+}
+
+void test_furi_pubsub_slow_subscriber() {
+    FuriPubSub* pubsub = furi_pubsub_alloc();
+    PubSubTestSubscriber slow = {.pubsub = pubsub};
+    slow.subscription = furi_pubsub_subscribe(pubsub, test_pubsub_slow_handler, &slow);
+
+    FuriThread* publisher = furi_thread_alloc();
+    furi_thread_set_name(publisher, "PubSubSlow");
+    furi_thread_set_stack_size(publisher, 1024);
+    furi_thread_set_context(publisher, pubsub);
+    furi_thread_set_callback(publisher, test_pubsub_slow_publisher);
+    furi_thread_start(publisher);
+    while(!slow.calls) osDelay(1);
+
+    // Slow callback doesn't block other subscribers
+    uint32_t ticks = osKernelGetTickCount();
+    FuriPubSubSubscription* subscription =
+        furi_pubsub_subscribe(pubsub, test_pubsub_handler, (void*)&context_value);
+    furi_pubsub_unsubscribe(pubsub, subscription);
+    ticks = osKernelGetTickCount() - ticks;
+    mu_check(ticks < 50);
+
+    // Snapshots retired while slow publisher holds its own one are freed right away
+    size_t heap = memmgr_get_free_heap();
+    for(size_t i = 0; i < PUBSUB_SLOW_CHURN; i++) {
+        subscription = furi_pubsub_subscribe(pubsub, test_pubsub_handler, (void*)&context_value);
+        furi_pubsub_unsubscribe(pubsub, subscription);
+    }
+    mu_check(heap - MIN(heap, memmgr_get_free_heap()) < 256);
+
+    furi_thread_join(publisher);
+    furi_thread_free(publisher);
+    furi_pubsub_unsubscribe(pubsub, slow.subscription);
+    furi_pubsub_free(pubsub);
+}
+
+#define PUBSUB_BENCHMARK_MESSAGES 1000
+#define PUBSUB_BENCHMARK_SUBSCRIBERS_MAX 32
+
+static void test_pubsub_benchmark_handler(const void* arg, void* ctx) {
+    UNUSED(arg);
+    (*(uint32_t*)ctx)++;
+}
+
+void test_furi_pubsub_benchmark() {
+    const size_t subscriber_counts[] = {1, 8, PUBSUB_BENCHMARK_SUBSCRIBERS_MAX};
+    FuriPubSubSubscription* subscriptions[PUBSUB_BENCHMARK_SUBSCRIBERS_MAX];
+    FuriPubSub* pubsub = furi_pubsub_alloc();
+    uint32_t calls = 0;
+    size_t subscribed = 0;
+    size_t expected_calls = 0;
+
+    for(size_t i = 0; i < COUNT_OF(subscriber_counts); i++) {
+        while(subscribed < subscriber_counts[i]) {
+            subscriptions[subscribed++] =
+                furi_pubsub_subscribe(pubsub, test_pubsub_benchmark_handler, &calls);
+        }
+
+        uint32_t cycles = DWT->CYCCNT;
+        for(uint32_t message = 0; message < PUBSUB_BENCHMARK_MESSAGES; message++) {
+            furi_pubsub_publish(pubsub, &message);
+        }
+        cycles = DWT->CYCCNT - cycles;
+        expected_calls += subscribed * PUBSUB_BENCHMARK_MESSAGES;
+
+        FURI_LOG_I(
+            TAG,
+            "%u subscribers: %lu cycles per publish",
+            subscribed,
+            cycles / PUBSUB_BENCHMARK_MESSAGES);
+    }
+    mu_assert_int_eq(expected_calls, calls);
+
+    for(size_t i = 0; i < subscribed; i++) {
+        furi_pubsub_unsubscribe(pubsub, subscriptions[i]);
+    }
+    furi_pubsub_free(pubsub);
+}
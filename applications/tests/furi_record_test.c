@@ -1,8 +1,13 @@
 #include <stdio.h>
 #include <string.h>
 #include <furi.h>
+#include <furi_hal.h>
 #include "minunit.h"
 
+#define TAG "UnitTestsRecord"
+
+#define RECORD_BENCHMARK_ITERATIONS 1000
+
 void test_furi_create_open() {
     // 1. Create record
     uint8_t test_data = 0;
@@ -18,3 +23,71 @@ void test_furi_create_open() {
     // 4. Clean up
     furi_record_destroy("test/holding");
 }
+
+void test_furi_record_handle() {
+    uint8_t test_data = 0;
+
+    // Same name gives same handle
+    FuriRecordHandle* handle = furi_record_get_handle("test/handle");
+    mu_assert_pointers_eq(handle, furi_record_get_handle("test/handle"));
+    mu_check(!furi_record_exists("test/handle"));
+
+    // Handle and name refer to same record
+    furi_record_create_handle(handle, &test_data);
+    mu_check(furi_record_exists("test/handle"));
+    mu_assert_pointers_eq(furi_record_open("test/handle"), &test_data);
+    mu_assert_pointers_eq(furi_record_open_handle(handle), &test_data);
+    mu_check(!furi_record_destroy_handle(handle));
+
+    furi_record_close("test/handle");
+    furi_record_close_handle(handle);
+    mu_check(furi_record_destroy_handle(handle));
+    mu_check(!furi_record_exists("test/handle"));
+
+    // Handle outlives record
+    furi_record_create("test/handle", &test_data);
+    mu_assert_pointers_eq(furi_record_open_handle(handle), &test_data);
+    furi_record_close_handle(handle);
+    mu_check(furi_record_destroy("test/handle"));
+}
+
+void test_furi_record_benchmark() {
+    uint8_t test_data = 0;
+    furi_record_create("test/benchmark", &test_data);
+    FuriRecordHandle* handle = furi_record_get_handle("test/benchmark");
+
+    size_t allocations = memmgr_heap_get_alloc_count();
+    uint32_t cycles = DWT->CYCCNT;
+    for(size_t i = 0; i < RECORD_BENCHMARK_ITERATIONS; i++) {
+        furi_record_open("test/benchmark");
+        furi_record_close("test/benchmark");
+    }
+    cycles = DWT->CYCCNT - cycles;
+    allocations = memmgr_heap_get_alloc_count() - allocations;
+    FURI_LOG_I(
+        TAG,
+        "By name: %lu cycles, %u allocations per open/close",
+        cycles / RECORD_BENCHMARK_ITERATIONS,
+        allocations / RECORD_BENCHMARK_ITERATIONS);
+
+    // Other threads may allocate meanwhile, record itself must not
+    mu_assert(allocations < RECORD_BENCHMARK_ITERATIONS / 10, "open by name allocates");
+
+    allocations = memmgr_heap_get_alloc_count();
+    cycles = DWT->CYCCNT;
+    for(size_t i = 0; i < RECORD_BENCHMARK_ITERATIONS; i++) {
+        furi_record_open_handle(handle);
+        furi_record_close_handle(handle);
+    }
+    cycles = DWT->CYCCNT - cycles;
+    allocations = memmgr_heap_get_alloc_count() - allocations;
+    FURI_LOG_I(
+        TAG,
+        "By handle: %lu cycles, %u allocations per open/close",
+        cycles / RECORD_BENCHMARK_ITERATIONS,
+        allocations / RECORD_BENCHMARK_ITERATIONS);
+
+    mu_assert(allocations < RECORD_BENCHMARK_ITERATIONS / 10, "open by handle allocates");
+
+    furi_record_destroy_handle(handle);
+}
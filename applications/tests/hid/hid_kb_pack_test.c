@@ -0,0 +1,333 @@
+#include <furi.h>
+#include <furi_hal.h>
+#include <furi_hal_usb_hid.h>
+#include <furi_hal_usb_hid_i.h>
+#include "../minunit.h"
+
+#define TAG "UnitTestsHid"
+
+#define HID_TEST_REPORTS_MAX 32
+#define HID_TEST_TEXT_SIZE 1024
+
+// Queue wraps around more than twice
+#define HID_TEST_QUEUE_REPORTS 40
+#define HID_TEST_QUEUE_TIMEOUT 1000
+
+// Interrupt endpoint sends one report per polling interval
+#define HID_TEST_POLL_INTERVAL_OLD 10
+#define HID_TEST_POLL_INTERVAL_NEW 1
+
+/* Endpoint stub: records reports and types them like a host does */
+typedef struct {
+    struct HidReportKB reports[HID_TEST_REPORTS_MAX];
+    size_t reports_count;
+    struct HidReportKB prev;
+    char typed[HID_TEST_TEXT_SIZE + 1];
+    size_t typed_len;
+    bool duplicate_key;
+} HidTestHost;
+
+static const char hid_test_text[] =
+    "The quick brown fox jumps over the lazy dog. Lorem ipsum dolor sit amet, consectetur "
+    "adipiscing elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua. "
+    "Sphinx of black quartz, judge my vow! 0123456789 (a + b) * c = [d / e] - {f}\n";
+
+static char hid_test_key_to_char(uint8_t key, uint8_t mods) {
+    uint16_t keycode = key | (mods << 8);
+    for(uint8_t chr = 0; chr < 128; chr++) {
+        if(HID_ASCII_TO_KEY(chr) == keycode) return chr;
+    }
+    return '\0';
+}
+
+static bool hid_test_report_callback(const struct HidReportKB* report, void* context) {
+    HidTestHost* host = context;
+
+    if(host->reports_count < HID_TEST_REPORTS_MAX) {
+        host->reports[host->reports_count] = *report;
+    }
+    host->reports_count++;
+
+    for(uint8_t i = 0; i < HID_KB_MAX_KEYS; i++) {
+        uint8_t key = report->btn[i];
+        if(key == 0) continue;
+
+        bool pressed = false;
+        for(uint8_t j = 0; j < HID_KB_MAX_KEYS; j++) {
+            if(host->prev.btn[j] == key) pressed = true;
+            if((j > i) && (report->btn[j] == key)) host->duplicate_key = true;
+        }
+        // Host types only keys that were not pressed in previous report
+        if(!pressed && (host->typed_len < HID_TEST_TEXT_SIZE)) {
+            host->typed[host->typed_len++] = hid_test_key_to_char(key, report->mods);
+        }
+    }
+    host->prev = *report;
+    return true;
+}
+
+static void hid_test_host_init(HidTestHost* host) {
+    memset(host, 0, sizeof(HidTestHost));
+}
+
+static bool hid_test_type(HidTestHost* host, struct HidReportKB* report, const char* text) {
+    bool state = true;
+    for(size_t i = 0; text[i] != '\0'; i++) {
+        uint16_t keycode = HID_ASCII_TO_KEY(text[i]);
+        if(keycode == KEY_NONE) continue;
+        if(!furi_hal_hid_kb_pack_key(report, keycode, hid_test_report_callback, host)) {
+            state = false;
+        }
+    }
+    if(!furi_hal_hid_kb_pack_release(report, hid_test_report_callback, host)) state = false;
+    host->typed[host->typed_len] = '\0';
+    return state;
+}
+
+static void hid_test_report_check(
+    HidTestHost* host,
+    size_t index,
+    uint8_t mods,
+    const uint8_t keys[HID_KB_MAX_KEYS]) {
+    mu_check(index < host->reports_count);
+    mu_assert_int_eq(mods, host->reports[index].mods);
+    mu_check(memcmp(keys, host->reports[index].btn, HID_KB_MAX_KEYS) == 0);
+}
+
+MU_TEST(hid_kb_pack_test_sequence) {
+    HidTestHost host;
+    struct HidReportKB report = {.report_id = 1};
+
+    // Different keys are packed, single release at the end
+    hid_test_host_init(&host);
+    mu_check(hid_test_type(&host, &report, "abc"));
+    mu_assert_int_eq(4, host.reports_count);
+    hid_test_report_check(&host, 0, 0, (uint8_t[]){KEY_A, 0, 0, 0, 0, 0});
+    hid_test_report_check(&host, 1, 0, (uint8_t[]){KEY_A, KEY_B, 0, 0, 0, 0});
+    hid_test_report_check(&host, 2, 0, (uint8_t[]){KEY_A, KEY_B, KEY_C, 0, 0, 0});
+    hid_test_report_check(&host, 3, 0, (uint8_t[]){0, 0, 0, 0, 0, 0});
+    mu_assert_string_eq("abc", host.typed);
+
+    // Repeated key and modifier change need release
+    hid_test_host_init(&host);
+    mu_check(hid_test_type(&host, &report, "Hell"));
+    mu_assert_int_eq(7, host.reports_count);
+    hid_test_report_check(&host, 0, KEY_MOD_LEFT_SHIFT >> 8, (uint8_t[]){KEY_H, 0, 0, 0, 0, 0});
+    hid_test_report_check(&host, 1, 0, (uint8_t[]){0, 0, 0, 0, 0, 0});
+    hid_test_report_check(&host, 2, 0, (uint8_t[]){KEY_E, 0, 0, 0, 0, 0});
+    hid_test_report_check(&host, 3, 0, (uint8_t[]){KEY_E, KEY_L, 0, 0, 0, 0});
+    hid_test_report_check(&host, 4, 0, (uint8_t[]){0, 0, 0, 0, 0, 0});
+    hid_test_report_check(&host, 5, 0, (uint8_t[]){KEY_L, 0, 0, 0, 0, 0});
+    hid_test_report_check(&host, 6, 0, (uint8_t[]){0, 0, 0, 0, 0, 0});
+    mu_assert_string_eq("Hell", host.typed);
+
+    // Full report is released
+    hid_test_host_init(&host);
+    mu_check(hid_test_type(&host, &report, "qwertyu"));
+    mu_assert_int_eq(9, host.reports_count);
+    hid_test_report_check(&host, 5, 0, (uint8_t[]){KEY_Q, KEY_W, KEY_E, KEY_R, KEY_T, KEY_Y});
+    hid_test_report_check(&host, 6, 0, (uint8_t[]){0, 0, 0, 0, 0, 0});
+    hid_test_report_check(&host, 7, 0, (uint8_t[]){KEY_U, 0, 0, 0, 0, 0});
+    mu_assert_string_eq("qwertyu", host.typed);
+
+    // Modifiers only: press and release
+    hid_test_host_init(&host);
+    mu_check(
+        furi_hal_hid_kb_pack_key(&report, KEY_MOD_LEFT_GUI, hid_test_report_callback, &host));
+    mu_check(furi_hal_hid_kb_pack_release(&report, hid_test_report_callback, &host));
+    mu_assert_int_eq(2, host.reports_count);
+    hid_test_report_check(&host, 0, KEY_MOD_LEFT_GUI >> 8, (uint8_t[]){0, 0, 0, 0, 0, 0});
+    hid_test_report_check(&host, 1, 0, (uint8_t[]){0, 0, 0, 0, 0, 0});
+}
+
+MU_TEST(hid_kb_pack_test_ascii) {
+    HidTestHost host;
+    struct HidReportKB report = {.report_id = 1};
+
+    char text[128];
+    size_t text_len = 0;
+    for(uint8_t chr = 1; chr < 128; chr++) {
+        if(HID_ASCII_TO_KEY(chr) != KEY_NONE) text[text_len++] = chr;
+    }
+    text[text_len] = '\0';
+
+    hid_test_host_init(&host);
+    mu_check(hid_test_type(&host, &report, text));
+    mu_assert_string_eq(text, host.typed);
+    mu_check(!host.duplicate_key);
+    mu_assert_int_eq(0, host.prev.mods);
+}
+
+MU_TEST(hid_kb_pack_test_throughput) {
+    HidTestHost host;
+    struct HidReportKB report = {.report_id = 1};
+
+    hid_test_host_init(&host);
+    uint32_t cycles = DWT->CYCCNT;
+    mu_check(hid_test_type(&host, &report, hid_test_text));
+    cycles = DWT->CYCCNT - cycles;
+    mu_assert_string_eq(hid_test_text, host.typed);
+
+    // Press and release report for every key before
+    size_t chars = strlen(hid_test_text);
+    uint32_t cps_old = chars * 1000 / (chars * 2 * HID_TEST_POLL_INTERVAL_OLD);
+    uint32_t cps_new = chars * 1000 / (host.reports_count * HID_TEST_POLL_INTERVAL_NEW);
+    FURI_LOG_I(
+        TAG,
+        "%u chars, %u reports, %lu cycles: %lu chars/s, was %lu chars/s",
+        chars,
+        host.reports_count,
+        cycles,
+        cps_new,
+        cps_old);
+    mu_check(host.reports_count < chars * 2);
+    mu_check(cps_new >= cps_old * 10);
+}
+
+/* Endpoint stub: usbd_ep_write replacement, records report order */
+typedef struct {
+    HidKbQueue queue;
+    osSemaphoreId_t endpoint;
+    uint8_t written[HID_TEST_QUEUE_REPORTS];
+    volatile size_t written_count;
+    volatile size_t pushed_count;
+} HidTestQueue;
+
+static void hid_test_ep_write(const struct HidReportKB* report, void* context) {
+    HidTestQueue* test = context;
+    if(test->written_count < HID_TEST_QUEUE_REPORTS) {
+        test->written[test->written_count] = report->btn[0];
+    }
+    test->written_count++;
+}
+
+static HidTestQueue* hid_test_queue_alloc() {
+    HidTestQueue* test = malloc(sizeof(HidTestQueue));
+    test->endpoint = osSemaphoreNew(1, 1, NULL);
+    furi_hal_hid_kb_queue_init(&test->queue, test->endpoint, hid_test_ep_write, test);
+    return test;
+}
+
+static void hid_test_queue_free(HidTestQueue* test) {
+    furi_hal_hid_kb_queue_deinit(&test->queue);
+    osSemaphoreDelete(test->endpoint);
+    free(test);
+}
+
+static bool hid_test_queue_push(HidTestQueue* test, uint8_t sequence) {
+    struct HidReportKB report = {.report_id = 1, .btn = {sequence}};
+    return furi_hal_hid_kb_queue_push(&test->queue, &report);
+}
+
+MU_TEST(hid_kb_queue_test_sequence) {
+    HidTestQueue* test = hid_test_queue_alloc();
+
+    // Reports are rejected until reset on connection
+    mu_check(!hid_test_queue_push(test, 1));
+    furi_hal_hid_kb_queue_reset(&test->queue, true);
+
+    // Idle endpoint: first report is written right away, endpoint is taken
+    mu_check(hid_test_queue_push(test, 1));
+    mu_assert_int_eq(1, test->written_count);
+    mu_assert_int_eq(0, osSemaphoreGetCount(test->endpoint));
+    mu_check(hid_test_queue_push(test, 2));
+    mu_check(hid_test_queue_push(test, 3));
+    mu_assert_int_eq(1, test->written_count);
+    mu_assert_int_eq(HID_KB_QUEUE_SIZE - 2, osSemaphoreGetCount(test->queue.free_slots));
+
+    // TX complete events send the rest, endpoint is released after the last one
+    furi_hal_hid_kb_queue_tx_complete(&test->queue);
+    furi_hal_hid_kb_queue_tx_complete(&test->queue);
+    mu_assert_int_eq(3, test->written_count);
+    mu_assert_int_eq(0, osSemaphoreGetCount(test->endpoint));
+    furi_hal_hid_kb_queue_tx_complete(&test->queue);
+    mu_assert_int_eq(3, test->written_count);
+    mu_assert_int_eq(1, osSemaphoreGetCount(test->endpoint));
+    mu_assert_int_eq(HID_KB_QUEUE_SIZE, osSemaphoreGetCount(test->queue.free_slots));
+    mu_check(memcmp(test->written, (uint8_t[]){1, 2, 3}, 3) == 0);
+
+    // Endpoint is busy with other report: queue fills up
+    mu_assert_int_eq(osOK, osSemaphoreAcquire(test->endpoint, 0));
+    for(uint8_t i = 0; i < HID_KB_QUEUE_SIZE; i++) {
+        mu_check(hid_test_queue_push(test, i));
+    }
+    mu_assert_int_eq(3, test->written_count);
+    mu_assert_int_eq(0, osSemaphoreGetCount(test->queue.free_slots));
+
+    // Disconnect drops queued reports and frees slots
+    furi_hal_hid_kb_queue_reset(&test->queue, false);
+    mu_assert_int_eq(HID_KB_QUEUE_SIZE, osSemaphoreGetCount(test->queue.free_slots));
+    mu_check(!hid_test_queue_push(test, 1));
+    furi_hal_hid_kb_queue_tx_complete(&test->queue);
+    mu_assert_int_eq(3, test->written_count);
+    mu_assert_int_eq(1, osSemaphoreGetCount(test->endpoint));
+
+    hid_test_queue_free(test);
+}
+
+static int32_t hid_test_queue_producer(void* context) {
+    HidTestQueue* test = context;
+    for(uint8_t i = 0; i < HID_TEST_QUEUE_REPORTS; i++) {
+        if(!hid_test_queue_push(test, i)) break;
+        test->pushed_count++;
+    }
+    return 0;
+}
+
+MU_TEST(hid_kb_queue_test_ring) {
+    HidTestQueue* test = hid_test_queue_alloc();
+    furi_hal_hid_kb_queue_reset(&test->queue, true);
+
+    FuriThread* producer = furi_thread_alloc();
+    furi_thread_set_name(producer, "HidQueueProducer");
+    furi_thread_set_stack_size(producer, 1024);
+    furi_thread_set_context(producer, test);
+    furi_thread_set_callback(producer, hid_test_queue_producer);
+    furi_thread_start(producer);
+
+    // Without TX complete events producer waits for free slot: one report written, ring full
+    osDelay(10);
+    size_t blocked_written = test->written_count;
+    size_t blocked_pushed = test->pushed_count;
+    uint32_t blocked_free_slots = osSemaphoreGetCount(test->queue.free_slots);
+
+    // Test thread stands for USB interrupt
+    uint8_t count_max = 0;
+    uint32_t timeout = osKernelGetTickCount() + HID_TEST_QUEUE_TIMEOUT;
+    while(test->written_count < HID_TEST_QUEUE_REPORTS && osKernelGetTickCount() < timeout) {
+        furi_hal_hid_kb_queue_tx_complete(&test->queue);
+        count_max = MAX(count_max, test->queue.count);
+        osThreadYield();
+    }
+    // Last written report completes, producer is released if stuck
+    furi_hal_hid_kb_queue_tx_complete(&test->queue);
+    furi_hal_hid_kb_queue_reset(&test->queue, false);
+    furi_thread_join(producer);
+    furi_thread_free(producer);
+
+    mu_assert_int_eq(1, blocked_written);
+    mu_assert_int_eq(HID_KB_QUEUE_SIZE + 1, blocked_pushed);
+    mu_assert_int_eq(0, blocked_free_slots);
+    mu_check(count_max <= HID_KB_QUEUE_SIZE);
+    mu_assert_int_eq(HID_TEST_QUEUE_REPORTS, test->written_count);
+    for(uint8_t i = 0; i < HID_TEST_QUEUE_REPORTS; i++) {
+        mu_assert_int_eq(i, test->written[i]);
+    }
+    mu_assert_int_eq(1, osSemaphoreGetCount(test->endpoint));
+    mu_assert_int_eq(HID_KB_QUEUE_SIZE, osSemaphoreGetCount(test->queue.free_slots));
+
+    hid_test_queue_free(test);
+}
+
+MU_TEST_SUITE(hid_kb_pack_suite) {
+    MU_RUN_TEST(hid_kb_pack_test_sequence);
+    MU_RUN_TEST(hid_kb_pack_test_ascii);
+    MU_RUN_TEST(hid_kb_pack_test_throughput);
+    MU_RUN_TEST(hid_kb_queue_test_sequence);
+    MU_RUN_TEST(hid_kb_queue_test_ring);
+}
+
+int run_minunit_test_hid() {
+    MU_RUN_SUITE(hid_kb_pack_suite);
+    return MU_EXIT_CODE;
+}
@@ -1,4 +1,5 @@
 #include <furi.h>
+#include <furi_hal.h>
 #include "../minunit.h"
 #include "infrared.h"
 #include "common/infrared_common_i.h"
@@ -9,6 +10,8 @@
 #include "test_data/infrared_rc5_test_data.srcdata"
 #include "test_data/infrared_sirc_test_data.srcdata"
 
+#define TAG "UnitTestsInfrared"
+
 #define RUN_ENCODER(data, expected) \
     run_encoder((data), COUNT_OF(data), (expected), COUNT_OF(expected))
 
@@ -17,6 +20,10 @@
 
 #define RUN_ENCODER_DECODER(data) run_encoder_decoder((data), COUNT_OF(data))
 
+#define RUN_DECODER_BENCHMARK(data) run_decoder_benchmark((data), COUNT_OF(data))
+
+#define DECODER_BENCHMARK_ROUNDS 20
+
 static InfraredDecoderHandler* decoder_handler;
 static InfraredEncoderHandler* encoder_handler;
 
@@ -202,6 +209,41 @@ static void run_decoder(
     mu_assert(message_counter == message_expected_len, "decoded less than expected");
 }
 
+/* Returns amount of cycles spent to decode all timings */
+static uint32_t run_decoder_benchmark(const uint32_t* input_delays, uint32_t input_delays_len) {
+    bool level = 0;
+    uint32_t cycles = DWT->CYCCNT;
+
+    for(uint32_t i = 0; i < input_delays_len; ++i) {
+        infrared_decode(decoder_handler, level, input_delays[i]);
+        level = !level;
+    }
+    infrared_check_decoder_ready(decoder_handler);
+
+    return DWT->CYCCNT - cycles;
+}
+
+MU_TEST(test_decoder_benchmark) {
+    uint32_t cycles = 0;
+    uint32_t timings = 0;
+
+    for(int i = 0; i < DECODER_BENCHMARK_ROUNDS; ++i) {
+        cycles += RUN_DECODER_BENCHMARK(test_decoder_nec_input2);
+        cycles += RUN_DECODER_BENCHMARK(test_decoder_necext_input1);
+        cycles += RUN_DECODER_BENCHMARK(test_decoder_samsung32_input1);
+        cycles += RUN_DECODER_BENCHMARK(test_decoder_rc5_input_all_repeats);
+        cycles += RUN_DECODER_BENCHMARK(test_decoder_rc6_input1);
+        cycles += RUN_DECODER_BENCHMARK(test_decoder_sirc_input1);
+        timings += COUNT_OF(test_decoder_nec_input2) + COUNT_OF(test_decoder_necext_input1) +
+                   COUNT_OF(test_decoder_samsung32_input1) +
+                   COUNT_OF(test_decoder_rc5_input_all_repeats) +
+                   COUNT_OF(test_decoder_rc6_input1) + COUNT_OF(test_decoder_sirc_input1);
+    }
+
+    mu_check(timings > 0);
+    FURI_LOG_I(TAG, "Decoder: %lu timings, %lu cycles per timing", timings, cycles / timings);
+}
+
 MU_TEST(test_decoder_samsung32) {
     RUN_DECODER(test_decoder_samsung32_input1, test_decoder_samsung32_expected1);
 }
@@ -322,6 +364,7 @@ MU_TEST_SUITE(test_infrared_decoder_encoder) {
     MU_RUN_TEST(test_decoder_necext1);
     MU_RUN_TEST(test_mix);
     MU_RUN_TEST(test_encoder_decoder_all);
+    MU_RUN_TEST(test_decoder_benchmark);
 }
 
 int run_minunit_test_infrared_decoder_encoder() {
@@ -0,0 +1,225 @@
+#include <furi.h>
+#include <toolbox/kv_store.h>
+#include <toolbox/saved_struct.h>
+#include <storage/storage.h>
+#include "../minunit.h"
+
+#define TAG "UnitTestsKvStore"
+
+#define KV_STORE_TEST_PATH "/ext/unit_tests/kv_store.kv"
+#define KV_STORE_TEST_TMP_PATH KV_STORE_TEST_PATH ".tmp"
+#define KV_STORE_TEST_LEGACY_PATH "/ext/unit_tests/kv_store.struct"
+#define KV_STORE_TEST_UPDATES 1000
+#define KV_STORE_TEST_UPDATES_PER_FLUSH 10
+#define KV_STORE_TEST_FLUSH_DELAY 100
+
+typedef struct {
+    uint32_t counter;
+    uint8_t data[60];
+} KvStoreTestStruct;
+
+static void kv_store_test_setup() {
+    Storage* storage = furi_record_open("storage");
+    storage_simply_mkdir(storage, "/ext/unit_tests");
+    storage_simply_remove(storage, KV_STORE_TEST_PATH);
+    storage_simply_remove(storage, KV_STORE_TEST_TMP_PATH);
+    storage_simply_remove(storage, KV_STORE_TEST_LEGACY_PATH);
+    furi_record_close("storage");
+}
+
+static void kv_store_test_teardown() {
+    Storage* storage = furi_record_open("storage");
+    storage_simply_remove(storage, KV_STORE_TEST_PATH);
+    storage_simply_remove(storage, KV_STORE_TEST_TMP_PATH);
+    storage_simply_remove(storage, KV_STORE_TEST_LEGACY_PATH);
+    furi_record_close("storage");
+}
+
+static uint64_t kv_store_test_file_size(const char* path) {
+    Storage* storage = furi_record_open("storage");
+    FileInfo fileinfo = {0};
+    storage_common_stat(storage, path, &fileinfo);
+    furi_record_close("storage");
+    return fileinfo.size;
+}
+
+MU_TEST(kv_store_test_set_get) {
+    uint32_t value = 0;
+    char name[16] = "flipper";
+
+    KvStore* store = kv_store_alloc(KV_STORE_TEST_PATH, 1000);
+    for(uint32_t i = 0; i < 100; i++) {
+        mu_check(kv_store_set(store, "counter", &i, sizeof(i)));
+    }
+    mu_check(kv_store_set(store, "name", name, sizeof(name)));
+    mu_check(kv_store_get(store, "counter", &value, sizeof(value)));
+    mu_assert_int_eq(99, value);
+    mu_check(!kv_store_get(store, "counter", &value, sizeof(uint16_t)));
+    kv_store_free(store);
+
+    store = kv_store_alloc(KV_STORE_TEST_PATH, 0);
+    mu_check(kv_store_get(store, "counter", &value, sizeof(value)));
+    mu_assert_int_eq(99, value);
+    memset(name, 0, sizeof(name));
+    mu_check(kv_store_get(store, "name", name, sizeof(name)));
+    mu_assert_string_eq("flipper", name);
+
+    mu_check(kv_store_remove(store, "name"));
+    mu_check(!kv_store_get(store, "name", name, sizeof(name)));
+    kv_store_free(store);
+
+    store = kv_store_alloc(KV_STORE_TEST_PATH, 0);
+    mu_check(!kv_store_get(store, "name", name, sizeof(name)));
+    mu_check(kv_store_get(store, "counter", &value, sizeof(value)));
+    kv_store_free(store);
+}
+
+MU_TEST(kv_store_test_power_loss) {
+    uint32_t value = 0;
+    uint64_t valid_size = kv_store_test_file_size(KV_STORE_TEST_PATH);
+
+    // Torn record at the end of journal
+    Storage* storage = furi_record_open("storage");
+    File* file = storage_file_alloc(storage);
+    mu_check(storage_file_open(file, KV_STORE_TEST_PATH, FSAM_WRITE, FSOM_OPEN_APPEND));
+    mu_check(storage_file_write(file, "\x12\x34\x56\x78\x07\x00\x04", 7) == 7);
+    storage_file_close(file);
+    storage_file_free(file);
+
+    KvStore* store = kv_store_alloc(KV_STORE_TEST_PATH, 0);
+    mu_check(kv_store_get(store, "counter", &value, sizeof(value)));
+    mu_assert_int_eq(99, value);
+    kv_store_free(store);
+    mu_check(kv_store_test_file_size(KV_STORE_TEST_PATH) == valid_size);
+
+    // Power loss between old journal removal and new journal rename during compaction
+    mu_assert_int_eq(
+        FSE_OK, storage_common_rename(storage, KV_STORE_TEST_PATH, KV_STORE_TEST_TMP_PATH));
+    store = kv_store_alloc(KV_STORE_TEST_PATH, 0);
+    mu_check(kv_store_get(store, "counter", &value, sizeof(value)));
+    mu_assert_int_eq(99, value);
+    kv_store_free(store);
+    mu_assert_int_eq(FSE_NOT_EXIST, storage_common_stat(storage, KV_STORE_TEST_TMP_PATH, NULL));
+
+    furi_record_close("storage");
+}
+
+/* Stands for owner thread event, store is flushed by test thread */
+static void kv_store_test_flush_callback(void* context) {
+    osSemaphoreRelease(context);
+}
+
+MU_TEST(kv_store_test_delayed_flush) {
+    uint32_t value = 0;
+    osSemaphoreId_t flush_request = osSemaphoreNew(8, 0, NULL);
+    KvStore* store = kv_store_alloc(KV_STORE_TEST_PATH, KV_STORE_TEST_FLUSH_DELAY);
+    kv_store_set_flush_callback(store, kv_store_test_flush_callback, flush_request);
+    uint64_t journal_size = kv_store_test_file_size(KV_STORE_TEST_PATH);
+
+    for(uint32_t i = 0; i < 10; i++) {
+        mu_check(kv_store_set(store, "delayed", &i, sizeof(i)));
+    }
+
+    // Timer only requests flush, changes are coalesced into one request
+    mu_assert_int_eq(osOK, osSemaphoreAcquire(flush_request, KV_STORE_TEST_FLUSH_DELAY * 10));
+    mu_check(kv_store_test_file_size(KV_STORE_TEST_PATH) == journal_size);
+    mu_assert_int_eq(
+        osErrorTimeout, osSemaphoreAcquire(flush_request, KV_STORE_TEST_FLUSH_DELAY * 2));
+    mu_check(kv_store_flush(store));
+    mu_check(kv_store_test_file_size(KV_STORE_TEST_PATH) > journal_size);
+
+    // Torn record of failed append is dropped before next append
+    Storage* storage = furi_record_open("storage");
+    File* file = storage_file_alloc(storage);
+    mu_check(storage_file_open(file, KV_STORE_TEST_PATH, FSAM_WRITE, FSOM_OPEN_APPEND));
+    mu_check(storage_file_write(file, "\x12\x34\x56\x78\x07\x00\x04", 7) == 7);
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close("storage");
+
+    value = 100;
+    mu_check(kv_store_set(store, "delayed", &value, sizeof(value)));
+    mu_assert_int_eq(osOK, osSemaphoreAcquire(flush_request, KV_STORE_TEST_FLUSH_DELAY * 10));
+    mu_check(kv_store_flush(store));
+    kv_store_free(store);
+    osSemaphoreDelete(flush_request);
+
+    value = 0;
+    store = kv_store_alloc(KV_STORE_TEST_PATH, 0);
+    mu_check(kv_store_get(store, "delayed", &value, sizeof(value)));
+    mu_assert_int_eq(100, value);
+    mu_check(kv_store_remove(store, "delayed"));
+    kv_store_free(store);
+}
+
+MU_TEST(kv_store_test_compaction) {
+    KvStoreTestStruct data = {0};
+    size_t saved_struct_size = 0;
+
+    KvStore* store = kv_store_alloc(KV_STORE_TEST_PATH, 0);
+    size_t bytes_written = kv_store_get_bytes_written(store);
+    for(uint32_t i = 0; i < KV_STORE_TEST_UPDATES; i++) {
+        data.counter = i;
+        mu_check(kv_store_set(store, "struct", &data, sizeof(data)));
+        // Callers like dolphin state save every few updates
+        if(i % KV_STORE_TEST_UPDATES_PER_FLUSH == KV_STORE_TEST_UPDATES_PER_FLUSH - 1) {
+            mu_check(kv_store_flush(store));
+            // Whole file is rewritten by saved_struct_save: 8 bytes header and data
+            saved_struct_size += 8 + sizeof(data);
+        }
+    }
+    bytes_written = kv_store_get_bytes_written(store) - bytes_written;
+    kv_store_free(store);
+
+    FURI_LOG_I(
+        TAG,
+        "%d updates: %lu bytes written, saved struct: %lu bytes",
+        KV_STORE_TEST_UPDATES,
+        (uint32_t)bytes_written,
+        (uint32_t)saved_struct_size);
+
+    // Journal must not grow unbounded
+    mu_check(kv_store_test_file_size(KV_STORE_TEST_PATH) < 2048);
+
+    store = kv_store_alloc(KV_STORE_TEST_PATH, 0);
+    mu_check(kv_store_get(store, "struct", &data, sizeof(data)));
+    mu_assert_int_eq(KV_STORE_TEST_UPDATES - 1, data.counter);
+    kv_store_free(store);
+}
+
+MU_TEST(kv_store_test_saved_struct) {
+    KvStoreTestStruct data = {.counter = 0x1234};
+    KvStoreTestStruct loaded = {0};
+    mu_check(saved_struct_save(KV_STORE_TEST_LEGACY_PATH, &data, sizeof(data), 0xAA, 1));
+
+    KvStore* store = kv_store_alloc(KV_STORE_TEST_PATH, 0);
+    // Legacy file is moved to store
+    mu_check(saved_struct_store_load(
+        store, "legacy", KV_STORE_TEST_LEGACY_PATH, &loaded, sizeof(loaded), 0xAA, 1));
+    mu_assert_int_eq(0x1234, loaded.counter);
+    mu_check(kv_store_test_file_size(KV_STORE_TEST_LEGACY_PATH) == 0);
+
+    mu_check(!saved_struct_store_load(
+        store, "legacy", KV_STORE_TEST_LEGACY_PATH, &loaded, sizeof(loaded), 0xAA, 2));
+
+    data.counter = 0x5678;
+    mu_check(saved_struct_store_save(store, "legacy", &data, sizeof(data), 0xAA, 1));
+    mu_check(saved_struct_store_load(store, "legacy", NULL, &loaded, sizeof(loaded), 0xAA, 1));
+    mu_assert_int_eq(0x5678, loaded.counter);
+    kv_store_free(store);
+}
+
+MU_TEST_SUITE(kv_store_suite) {
+    kv_store_test_setup();
+    MU_RUN_TEST(kv_store_test_set_get);
+    MU_RUN_TEST(kv_store_test_power_loss);
+    MU_RUN_TEST(kv_store_test_delayed_flush);
+    MU_RUN_TEST(kv_store_test_compaction);
+    MU_RUN_TEST(kv_store_test_saved_struct);
+    kv_store_test_teardown();
+}
+
+int run_minunit_test_kv_store() {
+    MU_RUN_SUITE(kv_store_suite);
+    return MU_EXIT_CODE;
+}
@@ -0,0 +1,131 @@
+#include <furi.h>
+#include <furi_hal.h>
+#include <uECC.h>
+#include <toolbox/sha256.h>
+#include <toolbox/sha256_uecc.h>
+#include "../minunit.h"
+
+#define TAG "UnitTestsMicroEcc"
+
+#define MICRO_ECC_BENCHMARK_ROUNDS 5
+
+/* RFC 6979 A.2.5, ECDSA with NIST P-256 and SHA-256 */
+static const uint8_t rfc6979_private_key[32] = {
+    0xC9, 0xAF, 0xA9, 0xD8, 0x45, 0xBA, 0x75, 0x16,
+    0x6B, 0x5C, 0x21, 0x57, 0x67, 0xB1, 0xD6, 0x93,
+    0x4E, 0x50, 0xC3, 0xDB, 0x36, 0xE8, 0x9B, 0x12,
+    0x7B, 0x8A, 0x62, 0x2B, 0x12, 0x0F, 0x67, 0x21,
+};
+
+static const uint8_t rfc6979_public_key[64] = {
+    0x60, 0xFE, 0xD4, 0xBA, 0x25, 0x5A, 0x9D, 0x31,
+    0xC9, 0x61, 0xEB, 0x74, 0xC6, 0x35, 0x6D, 0x68,
+    0xC0, 0x49, 0xB8, 0x92, 0x3B, 0x61, 0xFA, 0x6C,
+    0xE6, 0x69, 0x62, 0x2E, 0x60, 0xF2, 0x9F, 0xB6,
+    0x79, 0x03, 0xFE, 0x10, 0x08, 0xB8, 0xBC, 0x99,
+    0xA4, 0x1A, 0xE9, 0xE9, 0x56, 0x28, 0xBC, 0x64,
+    0xF2, 0xF1, 0xB2, 0x0C, 0x2D, 0x7E, 0x9F, 0x51,
+    0x77, 0xA3, 0xC2, 0x94, 0xD4, 0x46, 0x22, 0x99,
+};
+
+static const uint8_t rfc6979_signature_sample[64] = {
+    0xEF, 0xD4, 0x8B, 0x2A, 0xAC, 0xB6, 0xA8, 0xFD,
+    0x11, 0x40, 0xDD, 0x9C, 0xD4, 0x5E, 0x81, 0xD6,
+    0x9D, 0x2C, 0x87, 0x7B, 0x56, 0xAA, 0xF9, 0x91,
+    0xC3, 0x4D, 0x0E, 0xA8, 0x4E, 0xAF, 0x37, 0x16,
+    0xF7, 0xCB, 0x1C, 0x94, 0x2D, 0x65, 0x7C, 0x41,
+    0xD4, 0x36, 0xC7, 0xA1, 0xB6, 0xE2, 0x9F, 0x65,
+    0xF3, 0xE9, 0x00, 0xDB, 0xB9, 0xAF, 0xF4, 0x06,
+    0x4D, 0xC4, 0xAB, 0x2F, 0x84, 0x3A, 0xCD, 0xA8,
+};
+
+static const uint8_t rfc6979_signature_test[64] = {
+    0xF1, 0xAB, 0xB0, 0x23, 0x51, 0x83, 0x51, 0xCD,
+    0x71, 0xD8, 0x81, 0x56, 0x7B, 0x1E, 0xA6, 0x63,
+    0xED, 0x3E, 0xFC, 0xF6, 0xC5, 0x13, 0x2B, 0x35,
+    0x4F, 0x28, 0xD3, 0xB0, 0xB7, 0xD3, 0x83, 0x67,
+    0x01, 0x9F, 0x41, 0x13, 0x74, 0x2A, 0x2B, 0x14,
+    0xBD, 0x25, 0x92, 0x6B, 0x49, 0xC6, 0x49, 0x15,
+    0x5F, 0x26, 0x7E, 0x60, 0xD3, 0x81, 0x4B, 0x4C,
+    0x0C, 0xC8, 0x42, 0x50, 0xE4, 0x6F, 0x00, 0x83,
+};
+
+static void micro_ecc_hash_message(const char* message, uint8_t* hash) {
+    sha256_context sha_ctx;
+    sha256_start(&sha_ctx);
+    sha256_update(&sha_ctx, (const uint8_t*)message, strlen(message));
+    sha256_finish(&sha_ctx, hash);
+}
+
+static void micro_ecc_test_sign(const char* message, const uint8_t* expected_signature) {
+    const struct uECC_Curve_t* curve = uECC_secp256r1();
+    sha256_uecc_context hash_ctx;
+    uint8_t hash[32];
+    uint8_t signature[64];
+
+    sha256_uecc_init(&hash_ctx);
+    micro_ecc_hash_message(message, hash);
+
+    mu_check(uECC_sign_deterministic(
+        rfc6979_private_key, hash, sizeof(hash), &hash_ctx.uECC, signature, curve));
+    mu_check(memcmp(expected_signature, signature, sizeof(signature)) == 0);
+    mu_check(uECC_verify(rfc6979_public_key, hash, sizeof(hash), signature, curve));
+
+    // Signature must not verify for other message
+    hash[0] ^= 0x01;
+    mu_check(!uECC_verify(rfc6979_public_key, hash, sizeof(hash), signature, curve));
+}
+
+MU_TEST(micro_ecc_public_key_test) {
+    uint8_t public_key[64];
+
+    mu_check(uECC_compute_public_key(rfc6979_private_key, public_key, uECC_secp256r1()));
+    mu_check(memcmp(rfc6979_public_key, public_key, sizeof(public_key)) == 0);
+    mu_check(uECC_valid_public_key(public_key, uECC_secp256r1()));
+}
+
+MU_TEST(micro_ecc_rfc6979_test) {
+    micro_ecc_test_sign("sample", rfc6979_signature_sample);
+    micro_ecc_test_sign("test", rfc6979_signature_test);
+}
+
+MU_TEST(micro_ecc_benchmark) {
+    const struct uECC_Curve_t* curve = uECC_secp256r1();
+    sha256_uecc_context hash_ctx;
+    uint8_t public_key[64];
+    uint8_t signature[64];
+    uint8_t hash[32];
+    uint32_t cycles_public_key = 0;
+    uint32_t cycles_sign = 0;
+
+    sha256_uecc_init(&hash_ctx);
+    micro_ecc_hash_message("sample", hash);
+
+    for(int i = 0; i < MICRO_ECC_BENCHMARK_ROUNDS; ++i) {
+        uint32_t cycles = DWT->CYCCNT;
+        mu_check(uECC_compute_public_key(rfc6979_private_key, public_key, curve));
+        cycles_public_key += DWT->CYCCNT - cycles;
+
+        cycles = DWT->CYCCNT;
+        mu_check(uECC_sign_deterministic(
+            rfc6979_private_key, hash, sizeof(hash), &hash_ctx.uECC, signature, curve));
+        cycles_sign += DWT->CYCCNT - cycles;
+    }
+
+    FURI_LOG_I(
+        TAG,
+        "Public key: %lu cycles, sign: %lu cycles",
+        cycles_public_key / MICRO_ECC_BENCHMARK_ROUNDS,
+        cycles_sign / MICRO_ECC_BENCHMARK_ROUNDS);
+}
+
+MU_TEST_SUITE(micro_ecc_suite) {
+    MU_RUN_TEST(micro_ecc_public_key_test);
+    MU_RUN_TEST(micro_ecc_rfc6979_test);
+    MU_RUN_TEST(micro_ecc_benchmark);
+}
+
+int run_minunit_test_micro_ecc() {
+    MU_RUN_SUITE(micro_ecc_suite);
+    return MU_EXIT_CODE;
+}
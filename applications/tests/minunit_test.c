@@ -4,11 +4,21 @@
 
 // v2 tests
 void test_furi_create_open();
+void test_furi_record_handle();
+void test_furi_record_benchmark();
 void test_furi_valuemutex();
 void test_furi_concurrent_access();
 void test_furi_pubsub();
-
+void test_furi_pubsub_reentrance();
+void test_furi_pubsub_concurrent();
+void test_furi_pubsub_slow_subscriber();
+void test_furi_pubsub_benchmark();
+
+void test_furi_log_concurrent();
+void test_furi_log_truncated();
+void test_furi_log_benchmark();
 void test_furi_memmgr();
+void test_furi_memmgr_fragmentation();
 
 static int foo = 0;
 
@@ -29,6 +39,14 @@ MU_TEST(mu_test_furi_create_open) {
     test_furi_create_open();
 }
 
+MU_TEST(mu_test_furi_record_handle) {
+    test_furi_record_handle();
+}
+
+MU_TEST(mu_test_furi_record_benchmark) {
+    test_furi_record_benchmark();
+}
+
 MU_TEST(mu_test_furi_valuemutex) {
     test_furi_valuemutex();
 }
@@ -41,12 +59,44 @@ MU_TEST(mu_test_furi_pubsub) {
     test_furi_pubsub();
 }
 
+MU_TEST(mu_test_furi_pubsub_reentrance) {
+    test_furi_pubsub_reentrance();
+}
+
+MU_TEST(mu_test_furi_pubsub_concurrent) {
+    test_furi_pubsub_concurrent();
+}
+
+MU_TEST(mu_test_furi_pubsub_slow_subscriber) {
+    test_furi_pubsub_slow_subscriber();
+}
+
+MU_TEST(mu_test_furi_pubsub_benchmark) {
+    test_furi_pubsub_benchmark();
+}
+
+MU_TEST(mu_test_furi_log_concurrent) {
+    test_furi_log_concurrent();
+}
+
+MU_TEST(mu_test_furi_log_truncated) {
+    test_furi_log_truncated();
+}
+
+MU_TEST(mu_test_furi_log_benchmark) {
+    test_furi_log_benchmark();
+}
+
 MU_TEST(mu_test_furi_memmgr) {
     // this test is not accurate, but gives a basic understanding
     // that memory management is working fine
     test_furi_memmgr();
 }
 
+MU_TEST(mu_test_furi_memmgr_fragmentation) {
+    test_furi_memmgr_fragmentation();
+}
+
 MU_TEST_SUITE(test_suite) {
     MU_SUITE_CONFIGURE(&test_setup, &test_teardown);
 
@@ -54,10 +104,20 @@ MU_TEST_SUITE(test_suite) {
 
     // v2 tests
     MU_RUN_TEST(mu_test_furi_create_open);
+    MU_RUN_TEST(mu_test_furi_record_handle);
+    MU_RUN_TEST(mu_test_furi_record_benchmark);
     MU_RUN_TEST(mu_test_furi_valuemutex);
     MU_RUN_TEST(mu_test_furi_concurrent_access);
     MU_RUN_TEST(mu_test_furi_pubsub);
+    MU_RUN_TEST(mu_test_furi_pubsub_reentrance);
+    MU_RUN_TEST(mu_test_furi_pubsub_concurrent);
+    MU_RUN_TEST(mu_test_furi_pubsub_slow_subscriber);
+    MU_RUN_TEST(mu_test_furi_pubsub_benchmark);
+    MU_RUN_TEST(mu_test_furi_log_concurrent);
+    MU_RUN_TEST(mu_test_furi_log_truncated);
+    MU_RUN_TEST(mu_test_furi_log_benchmark);
     MU_RUN_TEST(mu_test_furi_memmgr);
+    MU_RUN_TEST(mu_test_furi_memmgr_fragmentation);
 }
 
 int run_minunit() {
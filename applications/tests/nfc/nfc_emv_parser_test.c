@@ -0,0 +1,203 @@
+#include <furi.h>
+#include <flipper_format/flipper_format.h>
+#include <flipper_format/flipper_format_i.h>
+#include <toolbox/hex.h>
+#include <nfc/helpers/nfc_emv_parser.h>
+#include "../minunit.h"
+
+#define TAG "UnitTestsNfcEmvParser"
+
+#define NFC_EMV_TEST_ASSETS "/ext/nfc/assets/"
+
+typedef enum {
+    NfcEmvTestFileAid,
+    NfcEmvTestFileCountry,
+    NfcEmvTestFileCurrency,
+} NfcEmvTestFile;
+
+static const char* nfc_emv_test_files[] = {"aid", "country_code", "currency_code"};
+
+static Storage* storage = NULL;
+
+static bool nfc_emv_test_lookup(NfcEmvTestFile type, string_t key, string_t name) {
+    uint8_t data[16];
+    size_t data_size = string_size(key) / 2;
+    if(data_size > sizeof(data)) return false;
+    for(size_t i = 0; i < data_size; i++) {
+        hex_chars_to_uint8(string_get_char(key, i * 2), string_get_char(key, i * 2 + 1), &data[i]);
+    }
+
+    if(type == NfcEmvTestFileAid) {
+        return nfc_emv_parser_get_aid_name(storage, data, data_size, name);
+    } else if(type == NfcEmvTestFileCountry) {
+        return nfc_emv_parser_get_country_name(storage, (data[0] << 8) | data[1], name);
+    } else {
+        return nfc_emv_parser_get_currency_name(storage, (data[0] << 8) | data[1], name);
+    }
+}
+
+// Old way: open text file and scan it for every lookup
+static bool nfc_emv_test_lookup_text(const char* path, string_t key, string_t name) {
+    FlipperFormat* file = flipper_format_file_alloc(storage);
+    string_t header;
+    string_init(header);
+    uint32_t version = 0;
+    bool result = flipper_format_file_open_existing(file, path) &&
+                  flipper_format_read_header(file, header, &version) &&
+                  flipper_format_read_string(file, string_get_cstr(key), name);
+    string_clear(header);
+    flipper_format_free(file);
+    return result;
+}
+
+static void nfc_emv_test_compare(NfcEmvTestFile type) {
+    string_t path, index_path, line, key, name, expected;
+    string_init_printf(path, NFC_EMV_TEST_ASSETS "%s.nfc", nfc_emv_test_files[type]);
+    string_init_printf(index_path, NFC_EMV_TEST_ASSETS "%s.idx", nfc_emv_test_files[type]);
+    string_init(line);
+    string_init(key);
+    string_init(name);
+    string_init(expected);
+
+    // index is built on first lookup
+    storage_simply_remove(storage, string_get_cstr(index_path));
+
+    FlipperFormat* file = flipper_format_file_alloc(storage);
+    mu_check(flipper_format_file_open_existing(file, string_get_cstr(path)));
+    Stream* stream = flipper_format_get_raw_stream(file);
+
+    size_t count = 0;
+    uint32_t index_ticks = 0;
+    uint32_t text_ticks = 0;
+    while(stream_read_line(stream, line)) {
+        size_t delimiter = string_search_char(line, ':');
+        if(string_get_char(line, 0) == '#' || delimiter == STRING_FAILURE) continue;
+        string_set_n(key, line, 0, delimiter);
+        if(string_cmp_str(key, "Filetype") == 0 || string_cmp_str(key, "Version") == 0) continue;
+
+        uint32_t start = osKernelGetTickCount();
+        mu_check(nfc_emv_test_lookup_text(string_get_cstr(path), key, expected));
+        text_ticks += osKernelGetTickCount() - start;
+
+        start = osKernelGetTickCount();
+        mu_check(nfc_emv_test_lookup(type, key, name));
+        index_ticks += osKernelGetTickCount() - start;
+
+        mu_assert_string_eq(string_get_cstr(expected), string_get_cstr(name));
+        count++;
+    }
+    flipper_format_free(file);
+    mu_check(count > 0);
+
+    FURI_LOG_I(
+        TAG,
+        "%s: %d lookups, index %lu/s, text %lu/s",
+        nfc_emv_test_files[type],
+        count,
+        count * osKernelGetTickFreq() / MAX(index_ticks, 1UL),
+        count * osKernelGetTickFreq() / MAX(text_ticks, 1UL));
+
+    string_clear(path);
+    string_clear(index_path);
+    string_clear(line);
+    string_clear(key);
+    string_clear(name);
+    string_clear(expected);
+}
+
+static void nfc_emv_test_setup() {
+    storage = furi_record_open("storage");
+}
+
+static void nfc_emv_test_teardown() {
+    furi_record_close("storage");
+    storage = NULL;
+}
+
+MU_TEST(nfc_emv_test_aid) {
+    nfc_emv_test_compare(NfcEmvTestFileAid);
+}
+
+MU_TEST(nfc_emv_test_country) {
+    nfc_emv_test_compare(NfcEmvTestFileCountry);
+}
+
+MU_TEST(nfc_emv_test_currency) {
+    nfc_emv_test_compare(NfcEmvTestFileCurrency);
+}
+
+MU_TEST(nfc_emv_test_not_found) {
+    string_t name;
+    string_init(name);
+    uint8_t aid[] = {0xA0, 0x00, 0x00, 0x00, 0x99};
+    mu_check(!nfc_emv_parser_get_aid_name(storage, aid, sizeof(aid), name));
+    mu_check(!nfc_emv_parser_get_country_name(storage, 0xFFFF, name));
+    mu_check(!nfc_emv_parser_get_currency_name(storage, 0xFFFF, name));
+    string_clear(name);
+}
+
+static bool nfc_emv_test_write_file(const char* path, const uint8_t* data, size_t size) {
+    File* file = storage_file_alloc(storage);
+    bool result = storage_file_open(file, path, FSAM_WRITE, FSOM_CREATE_ALWAYS) &&
+                  (storage_file_write(file, data, size) == size);
+    storage_file_close(file);
+    storage_file_free(file);
+    return result;
+}
+
+MU_TEST(nfc_emv_test_source_changed) {
+    const char* path = NFC_EMV_TEST_ASSETS "currency_code.nfc";
+    string_t name;
+    string_init(name);
+
+    // Keep original resources file in memory, restored at the end
+    File* file = storage_file_alloc(storage);
+    mu_check(storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING));
+    size_t size = storage_file_size(file);
+    uint8_t* data = malloc(size + 1);
+    mu_check(storage_file_read(file, data, size) == size);
+    data[size] = '\0';
+    storage_file_close(file);
+    storage_file_free(file);
+
+    // Name of first record, "0997: USN" line
+    char* name_start = strstr((char*)data, "\n0997: ");
+    mu_check(name_start);
+    name_start += strlen("\n0997: ");
+    mu_check(nfc_emv_parser_get_currency_name(storage, 0x0997, name));
+    mu_check(string_get_char(name, 0) == *name_start);
+
+    // Same size edit must be noticed, file is restored before checks
+    char original = *name_start;
+    char edited = (original == 'X') ? 'Y' : 'X';
+    *name_start = edited;
+    bool edit_written = nfc_emv_test_write_file(path, data, size);
+    bool edit_found = nfc_emv_parser_get_currency_name(storage, 0x0997, name) &&
+                      string_get_char(name, 0) == edited;
+    *name_start = original;
+    bool restored = nfc_emv_test_write_file(path, data, size);
+    free(data);
+
+    mu_check(edit_written);
+    mu_check(edit_found);
+    mu_check(restored);
+    mu_check(nfc_emv_parser_get_currency_name(storage, 0x0997, name));
+    mu_check(string_get_char(name, 0) == original);
+
+    string_clear(name);
+}
+
+MU_TEST_SUITE(nfc_emv_parser_suite) {
+    MU_SUITE_CONFIGURE(&nfc_emv_test_setup, &nfc_emv_test_teardown);
+
+    MU_RUN_TEST(nfc_emv_test_aid);
+    MU_RUN_TEST(nfc_emv_test_country);
+    MU_RUN_TEST(nfc_emv_test_currency);
+    MU_RUN_TEST(nfc_emv_test_not_found);
+    MU_RUN_TEST(nfc_emv_test_source_changed);
+}
+
+int run_minunit_test_nfc_emv_parser() {
+    MU_RUN_SUITE(nfc_emv_parser_suite);
+    return MU_EXIT_CODE;
+}
@@ -0,0 +1,265 @@
+#include <furi.h>
+#include <notification/notification_timeline.h>
+#include "../minunit.h"
+
+#define TAG "UnitTestsNotification"
+
+#define TIMELINE_TEST_LOG_SIZE 64
+
+#define TIMELINE_TEST_OUTPUT_RED (1 << 0)
+#define TIMELINE_TEST_OUTPUT_VIBRO (1 << 3)
+#define TIMELINE_TEST_OUTPUT_SOUND (1 << 4)
+#define TIMELINE_TEST_OUTPUT_DISPLAY (1 << 5)
+
+typedef struct {
+    char name;
+    const uint32_t* delays;
+    size_t index;
+    uint32_t outputs;
+    bool ended;
+    bool cancelled;
+} TimelineTestSequence;
+
+typedef struct {
+    char name;
+    uint32_t tick;
+    uint32_t outputs;
+} TimelineTestLogEntry;
+
+static NotificationTimeline* timeline = NULL;
+static uint32_t timeline_tick = 0;
+static TimelineTestLogEntry timeline_log[TIMELINE_TEST_LOG_SIZE];
+static size_t timeline_log_size = 0;
+
+// 2 seconds vibro sequence
+static const uint32_t sequence_long[] = {500, 500, 500, 500, NOTIFICATION_TIMELINE_DONE};
+static const uint32_t sequence_short[] = {150, 150, NOTIFICATION_TIMELINE_DONE};
+static const uint32_t sequence_instant[] = {NOTIFICATION_TIMELINE_DONE};
+
+static uint32_t timeline_test_step(void* context, void* item, uint32_t outputs) {
+    UNUSED(context);
+    TimelineTestSequence* sequence = item;
+    if(timeline_log_size < TIMELINE_TEST_LOG_SIZE) {
+        timeline_log[timeline_log_size].name = sequence->name;
+        timeline_log[timeline_log_size].tick = timeline_tick;
+        timeline_log[timeline_log_size].outputs = outputs;
+        timeline_log_size++;
+    }
+    return sequence->delays[sequence->index++];
+}
+
+static void timeline_test_end(void* context, void* item, uint32_t outputs, bool cancelled) {
+    UNUSED(context);
+    TimelineTestSequence* sequence = item;
+    sequence->ended = true;
+    sequence->cancelled = cancelled;
+    sequence->outputs = outputs;
+}
+
+static void timeline_test_sequence_init(
+    TimelineTestSequence* sequence,
+    char name,
+    const uint32_t* delays,
+    uint32_t outputs) {
+    sequence->name = name;
+    sequence->delays = delays;
+    sequence->index = 0;
+    sequence->outputs = outputs;
+    sequence->ended = false;
+    sequence->cancelled = false;
+}
+
+static void timeline_test_add(TimelineTestSequence* sequence) {
+    notification_timeline_add(timeline, sequence, sequence, sequence->outputs, timeline_tick);
+}
+
+// advance virtual clock, jumping straight to next step like service thread does
+static void timeline_test_run_until(uint32_t tick) {
+    while(true) {
+        uint32_t timeout = notification_timeline_process(timeline, timeline_tick);
+        if(timeout == UINT32_MAX || timeline_tick + timeout > tick) break;
+        timeline_tick += timeout;
+    }
+    timeline_tick = tick;
+}
+
+static void timeline_test_setup() {
+    timeline = notification_timeline_alloc(timeline_test_step, timeline_test_end, NULL);
+    timeline_tick = 0;
+    timeline_log_size = 0;
+}
+
+static void timeline_test_teardown() {
+    notification_timeline_free(timeline);
+    timeline = NULL;
+}
+
+MU_TEST(timeline_test_ordering) {
+    TimelineTestSequence sequence_a, sequence_b;
+    timeline_test_sequence_init(&sequence_a, 'A', sequence_long, TIMELINE_TEST_OUTPUT_VIBRO);
+    timeline_test_sequence_init(&sequence_b, 'B', sequence_short, TIMELINE_TEST_OUTPUT_RED);
+
+    timeline_test_add(&sequence_a);
+    timeline_test_run_until(100);
+    timeline_test_add(&sequence_b);
+    timeline_test_run_until(3000);
+
+    const TimelineTestLogEntry expected[] = {
+        {'A', 0, TIMELINE_TEST_OUTPUT_VIBRO},
+        {'B', 100, TIMELINE_TEST_OUTPUT_RED},
+        {'B', 250, TIMELINE_TEST_OUTPUT_RED},
+        {'B', 400, TIMELINE_TEST_OUTPUT_RED},
+        {'A', 500, TIMELINE_TEST_OUTPUT_VIBRO},
+        {'A', 1000, TIMELINE_TEST_OUTPUT_VIBRO},
+        {'A', 1500, TIMELINE_TEST_OUTPUT_VIBRO},
+        {'A', 2000, TIMELINE_TEST_OUTPUT_VIBRO},
+    };
+    mu_assert_int_eq(COUNT_OF(expected), timeline_log_size);
+    for(size_t i = 0; i < COUNT_OF(expected); i++) {
+        mu_assert_int_eq(expected[i].name, timeline_log[i].name);
+        mu_assert_int_eq(expected[i].tick, timeline_log[i].tick);
+        mu_assert_int_eq(expected[i].outputs, timeline_log[i].outputs);
+    }
+
+    mu_check(sequence_a.ended && !sequence_a.cancelled);
+    mu_check(sequence_b.ended && !sequence_b.cancelled);
+    mu_check(notification_timeline_process(timeline, timeline_tick) == UINT32_MAX);
+}
+
+MU_TEST(timeline_test_backlight_latency) {
+    TimelineTestSequence sequence_a, sequence_b;
+    uint32_t latency_max = 0;
+
+    // backlight request at every tick of 2 seconds sequence
+    for(uint32_t request_tick = 0; request_tick < 2000; request_tick += 10) {
+        timeline_test_sequence_init(
+            &sequence_a,
+            'A',
+            sequence_long,
+            TIMELINE_TEST_OUTPUT_VIBRO | TIMELINE_TEST_OUTPUT_SOUND);
+        timeline_test_sequence_init(
+            &sequence_b, 'B', sequence_instant, TIMELINE_TEST_OUTPUT_DISPLAY);
+        timeline_tick = 0;
+        timeline_log_size = 0;
+
+        timeline_test_add(&sequence_a);
+        timeline_test_run_until(request_tick);
+        timeline_test_add(&sequence_b);
+
+        mu_check(sequence_b.ended);
+        for(size_t i = 0; i < timeline_log_size; i++) {
+            if(timeline_log[i].name == 'B') {
+                latency_max = MAX(latency_max, timeline_log[i].tick - request_tick);
+            }
+        }
+
+        timeline_test_run_until(3000);
+        mu_check(sequence_a.ended && !sequence_a.cancelled);
+    }
+
+    FURI_LOG_I(TAG, "Backlight latency behind 2s sequence: %lu ticks", latency_max);
+    mu_assert_int_eq(0, latency_max);
+}
+
+MU_TEST(timeline_test_override) {
+    TimelineTestSequence sequence_a, sequence_b, sequence_c;
+    timeline_test_sequence_init(
+        &sequence_a, 'A', sequence_long, TIMELINE_TEST_OUTPUT_VIBRO | TIMELINE_TEST_OUTPUT_RED);
+    timeline_test_sequence_init(&sequence_b, 'B', sequence_short, TIMELINE_TEST_OUTPUT_VIBRO);
+    timeline_test_sequence_init(&sequence_c, 'C', sequence_short, TIMELINE_TEST_OUTPUT_RED);
+
+    timeline_test_add(&sequence_a);
+    timeline_test_run_until(100);
+
+    // A keeps red output only
+    timeline_test_add(&sequence_b);
+    mu_check(!sequence_a.ended);
+    timeline_test_run_until(600);
+    mu_assert_int_eq('A', timeline_log[timeline_log_size - 1].name);
+    mu_assert_int_eq(TIMELINE_TEST_OUTPUT_RED, timeline_log[timeline_log_size - 1].outputs);
+
+    // A is left without outputs and cancelled right away
+    timeline_test_add(&sequence_c);
+    mu_check(sequence_a.ended && sequence_a.cancelled);
+    mu_assert_int_eq(0, sequence_a.outputs);
+
+    timeline_test_run_until(3000);
+    mu_check(sequence_c.ended && !sequence_c.cancelled);
+}
+
+MU_TEST(timeline_test_cancel) {
+    TimelineTestSequence sequence_a, sequence_b;
+    timeline_test_sequence_init(&sequence_a, 'A', sequence_long, TIMELINE_TEST_OUTPUT_VIBRO);
+    timeline_test_sequence_init(&sequence_b, 'B', sequence_long, TIMELINE_TEST_OUTPUT_RED);
+
+    timeline_test_add(&sequence_a);
+    timeline_test_add(&sequence_b);
+    mu_assert_int_eq(500, notification_timeline_process(timeline, timeline_tick));
+
+    timeline_test_run_until(700);
+    notification_timeline_cancel(timeline, &sequence_a);
+    mu_check(sequence_a.ended && sequence_a.cancelled);
+    mu_assert_int_eq(TIMELINE_TEST_OUTPUT_VIBRO, sequence_a.outputs);
+    mu_check(!sequence_b.ended);
+    mu_assert_int_eq(300, notification_timeline_process(timeline, timeline_tick));
+
+    timeline_test_run_until(3000);
+    mu_check(sequence_b.ended && !sequence_b.cancelled);
+}
+
+MU_TEST(timeline_test_full) {
+    TimelineTestSequence sequences[NOTIFICATION_TIMELINE_SIZE];
+    for(size_t i = 0; i < NOTIFICATION_TIMELINE_SIZE; i++) {
+        mu_check(!notification_timeline_is_full(timeline));
+        timeline_test_sequence_init(&sequences[i], '0' + i, sequence_short, 0);
+        timeline_test_add(&sequences[i]);
+    }
+    mu_check(notification_timeline_is_full(timeline));
+
+    timeline_test_run_until(3000);
+    mu_check(!notification_timeline_is_full(timeline));
+    for(size_t i = 0; i < NOTIFICATION_TIMELINE_SIZE; i++) {
+        mu_check(sequences[i].ended && !sequences[i].cancelled);
+    }
+}
+
+MU_TEST(timeline_test_full_add) {
+    TimelineTestSequence sequences[NOTIFICATION_TIMELINE_SIZE];
+    for(size_t i = 0; i < NOTIFICATION_TIMELINE_SIZE; i++) {
+        timeline_test_sequence_init(&sequences[i], '0' + i, sequence_short, 0);
+        timeline_test_add(&sequences[i]);
+        timeline_test_run_until(timeline_tick + 10);
+    }
+    mu_check(notification_timeline_is_full(timeline));
+
+    // oldest sequence is cancelled to make room
+    TimelineTestSequence sequence_new;
+    timeline_test_sequence_init(&sequence_new, 'N', sequence_short, 0);
+    timeline_test_add(&sequence_new);
+    mu_check(sequences[0].ended && sequences[0].cancelled);
+    for(size_t i = 1; i < NOTIFICATION_TIMELINE_SIZE; i++) {
+        mu_check(!sequences[i].ended);
+    }
+
+    timeline_test_run_until(3000);
+    mu_check(sequence_new.ended && !sequence_new.cancelled);
+    for(size_t i = 1; i < NOTIFICATION_TIMELINE_SIZE; i++) {
+        mu_check(sequences[i].ended && !sequences[i].cancelled);
+    }
+}
+
+MU_TEST_SUITE(notification_timeline_suite) {
+    MU_SUITE_CONFIGURE(&timeline_test_setup, &timeline_test_teardown);
+
+    MU_RUN_TEST(timeline_test_ordering);
+    MU_RUN_TEST(timeline_test_backlight_latency);
+    MU_RUN_TEST(timeline_test_override);
+    MU_RUN_TEST(timeline_test_cancel);
+    MU_RUN_TEST(timeline_test_full);
+    MU_RUN_TEST(timeline_test_full_add);
+}
+
+int run_minunit_test_notification_timeline() {
+    MU_RUN_SUITE(notification_timeline_suite);
+    return MU_EXIT_CODE;
+}
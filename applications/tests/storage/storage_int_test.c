@@ -0,0 +1,196 @@
+#include <furi.h>
+#include <furi_hal.h>
+#include <lfs.h>
+#include <storage/storages/storage_int.h>
+#include "../minunit.h"
+
+#define TAG "UnitTestsStorageInt"
+
+/* LittleFS profiles are compared on RAM block device with internal flash geometry,
+ * device calls are counted: each flash program and erase call locks core2 */
+#define STORAGE_INT_TEST_BLOCK_COUNT 8
+#define STORAGE_INT_TEST_FILES_COUNT 4
+#define STORAGE_INT_TEST_FILE_SIZE 200
+#define STORAGE_INT_TEST_ROUNDS 16
+#define STORAGE_INT_TEST_WRITE_FLAGS (LFS_O_WRONLY | LFS_O_CREAT | LFS_O_TRUNC)
+
+typedef struct {
+    uint32_t cache_size;
+    uint32_t lookahead_size;
+    int32_t block_cycles;
+} StorageIntTestProfile;
+
+typedef struct {
+    uint8_t* data;
+    size_t reads;
+    size_t progs;
+    size_t erases;
+    size_t prog_bytes;
+    size_t block_erases[STORAGE_INT_TEST_BLOCK_COUNT];
+} StorageIntTestDevice;
+
+static const StorageIntTestProfile storage_int_test_profiles[] = {
+    {STORAGE_INT_CACHE_SIZE, STORAGE_INT_LOOKAHEAD_SIZE, STORAGE_INT_BLOCK_CYCLES},
+    {64, 16, 0},
+    {256, 16, 0},
+    {16, 32, 0},
+    {16, 16, 100},
+    {16, 16, 500},
+};
+
+#define STORAGE_INT_TEST_PROFILES_COUNT COUNT_OF(storage_int_test_profiles)
+
+static StorageIntTestDevice storage_int_test_device;
+static size_t storage_int_test_progs[STORAGE_INT_TEST_PROFILES_COUNT];
+static uint8_t storage_int_test_data[STORAGE_INT_TEST_FILE_SIZE];
+
+static int storage_int_test_read(
+    const struct lfs_config* c,
+    lfs_block_t block,
+    lfs_off_t off,
+    void* buffer,
+    lfs_size_t size) {
+    StorageIntTestDevice* device = c->context;
+    memcpy(buffer, &device->data[block * c->block_size + off], size);
+    device->reads++;
+    return 0;
+}
+
+static int storage_int_test_prog(
+    const struct lfs_config* c,
+    lfs_block_t block,
+    lfs_off_t off,
+    const void* buffer,
+    lfs_size_t size) {
+    StorageIntTestDevice* device = c->context;
+    memcpy(&device->data[block * c->block_size + off], buffer, size);
+    device->progs++;
+    device->prog_bytes += size;
+    return 0;
+}
+
+static int storage_int_test_erase(const struct lfs_config* c, lfs_block_t block) {
+    StorageIntTestDevice* device = c->context;
+    memset(&device->data[block * c->block_size], 0xFF, c->block_size);
+    device->erases++;
+    device->block_erases[block]++;
+    return 0;
+}
+
+static int storage_int_test_sync(const struct lfs_config* c) {
+    UNUSED(c);
+    return 0;
+}
+
+/* Settings-like workload: small files rewritten and read back */
+static bool storage_int_test_workload(lfs_t* lfs) {
+    bool result = true;
+    lfs_file_t file;
+    char name[8];
+    uint8_t buffer[STORAGE_INT_TEST_FILE_SIZE];
+
+    for(size_t round = 0; result && (round < STORAGE_INT_TEST_ROUNDS); round++) {
+        for(size_t i = 0; result && (i < STORAGE_INT_TEST_FILES_COUNT); i++) {
+            snprintf(name, sizeof(name), "f%u", (unsigned)i);
+            storage_int_test_data[0] = round;
+            storage_int_test_data[1] = i;
+            result = lfs_file_open(lfs, &file, name, STORAGE_INT_TEST_WRITE_FLAGS) == 0;
+            if(!result) break;
+            result = lfs_file_write(lfs, &file, storage_int_test_data, sizeof(buffer)) ==
+                     sizeof(buffer);
+            result &= lfs_file_close(lfs, &file) == 0;
+        }
+
+        for(size_t i = 0; result && (i < STORAGE_INT_TEST_FILES_COUNT); i++) {
+            snprintf(name, sizeof(name), "f%u", (unsigned)i);
+            storage_int_test_data[0] = round;
+            storage_int_test_data[1] = i;
+            result = lfs_file_open(lfs, &file, name, LFS_O_RDONLY) == 0;
+            if(!result) break;
+            result = lfs_file_read(lfs, &file, buffer, sizeof(buffer)) == sizeof(buffer) &&
+                     memcmp(buffer, storage_int_test_data, sizeof(buffer)) == 0;
+            result &= lfs_file_close(lfs, &file) == 0;
+        }
+    }
+
+    return result;
+}
+
+static bool storage_int_test_profile(const StorageIntTestProfile* profile, size_t index) {
+    StorageIntTestDevice* device = &storage_int_test_device;
+    size_t data_size = STORAGE_INT_TEST_BLOCK_COUNT * furi_hal_flash_get_page_size();
+    memset(device, 0, sizeof(StorageIntTestDevice));
+    device->data = malloc(data_size);
+    memset(device->data, 0xFF, data_size);
+
+    // Same configuration as in storage_int.c, except block device and block count
+    struct lfs_config config = {
+        .context = device,
+        .read = storage_int_test_read,
+        .prog = storage_int_test_prog,
+        .erase = storage_int_test_erase,
+        .sync = storage_int_test_sync,
+        .read_size = furi_hal_flash_get_read_block_size(),
+        .prog_size = furi_hal_flash_get_write_block_size(),
+        .block_size = furi_hal_flash_get_page_size(),
+        .block_count = STORAGE_INT_TEST_BLOCK_COUNT,
+        .block_cycles = profile->block_cycles ? profile->block_cycles :
+                                                (int32_t)furi_hal_flash_get_cycles_count(),
+        .cache_size = profile->cache_size,
+        .lookahead_size = profile->lookahead_size,
+    };
+
+    lfs_t* lfs = malloc(sizeof(lfs_t));
+    uint32_t cycles = DWT->CYCCNT;
+    bool result = lfs_format(lfs, &config) == 0 && lfs_mount(lfs, &config) == 0;
+    if(result) {
+        result = storage_int_test_workload(lfs);
+        lfs_unmount(lfs);
+    }
+    cycles = DWT->CYCCNT - cycles;
+
+    size_t max_block_erases = 0;
+    for(size_t i = 0; i < STORAGE_INT_TEST_BLOCK_COUNT; i++) {
+        max_block_erases = MAX(max_block_erases, device->block_erases[i]);
+    }
+    // Caches: read, program and one per open file
+    FURI_LOG_I(
+        TAG,
+        "cache %lu, lookahead %lu, block cycles %ld: RAM %lu, "
+        "reads %u, progs %u (%u bytes), erases %u (max %u per block), %lu cycles",
+        config.cache_size,
+        config.lookahead_size,
+        config.block_cycles,
+        config.cache_size * 3 + config.lookahead_size,
+        (unsigned)device->reads,
+        (unsigned)device->progs,
+        (unsigned)device->prog_bytes,
+        (unsigned)device->erases,
+        (unsigned)max_block_erases,
+        cycles);
+    storage_int_test_progs[index] = device->progs;
+
+    free(lfs);
+    free(device->data);
+    return result;
+}
+
+MU_TEST(storage_int_test_profiles_compare) {
+    furi_hal_random_fill_buf(storage_int_test_data, sizeof(storage_int_test_data));
+
+    for(size_t i = 0; i < STORAGE_INT_TEST_PROFILES_COUNT; i++) {
+        mu_check(storage_int_test_profile(&storage_int_test_profiles[i], i));
+    }
+
+    // Bigger cache is programmed in bigger chunks, in fewer flash calls
+    mu_check(storage_int_test_progs[2] < storage_int_test_progs[1]);
+}
+
+MU_TEST_SUITE(storage_int_test_suite) {
+    MU_RUN_TEST(storage_int_test_profiles_compare);
+}
+
+int run_minunit_test_storage_int() {
+    MU_RUN_SUITE(storage_int_test_suite);
+    return MU_EXIT_CODE;
+}
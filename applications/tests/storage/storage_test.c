@@ -2,6 +2,7 @@
 #include <furi.h>
 #include <furi_hal_delay.h>
 #include <storage/storage.h>
+#include <lib/toolbox/md5.h>
 
 #define STORAGE_LOCKED_FILE "/ext/locked_file.test"
 
@@ -74,7 +75,323 @@ MU_TEST_SUITE(storage_file) {
     storage_file_open_lock_teardown();
 }
 
+#define STORAGE_RENAME_TEST_DIR "/ext/rename_test"
+#define STORAGE_RENAME_TEST_DIR_2 "/ext/rename_test_2"
+#define STORAGE_RENAME_TEST_DIR_INT "/int/rename_test"
+#define STORAGE_RENAME_TEST_DATA "0123456789"
+
+static void storage_rename_write_file(Storage* storage, const char* path) {
+    File* file = storage_file_alloc(storage);
+    mu_check(storage_file_open(file, path, FSAM_WRITE, FSOM_CREATE_ALWAYS));
+    mu_check(storage_file_write(file, STORAGE_RENAME_TEST_DATA, 10) == 10);
+    mu_check(storage_file_close(file));
+    storage_file_free(file);
+}
+
+static void storage_rename_check_file(Storage* storage, const char* path) {
+    char data[10];
+    File* file = storage_file_alloc(storage);
+    mu_check(storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING));
+    mu_check(storage_file_read(file, data, 10) == 10);
+    mu_check(memcmp(data, STORAGE_RENAME_TEST_DATA, 10) == 0);
+    mu_check(storage_file_close(file));
+    storage_file_free(file);
+}
+
+static void storage_rename_setup() {
+    Storage* storage = furi_record_open("storage");
+    storage_simply_remove_recursive(storage, STORAGE_RENAME_TEST_DIR);
+    storage_simply_remove_recursive(storage, STORAGE_RENAME_TEST_DIR_2);
+    storage_simply_remove_recursive(storage, STORAGE_RENAME_TEST_DIR_INT);
+    mu_check(storage_simply_mkdir(storage, STORAGE_RENAME_TEST_DIR));
+    mu_check(storage_simply_mkdir(storage, STORAGE_RENAME_TEST_DIR "/dir"));
+    storage_rename_write_file(storage, STORAGE_RENAME_TEST_DIR "/file");
+    storage_rename_write_file(storage, STORAGE_RENAME_TEST_DIR "/dir/file");
+    furi_record_close("storage");
+}
+
+static void storage_rename_teardown() {
+    Storage* storage = furi_record_open("storage");
+    mu_check(storage_simply_remove_recursive(storage, STORAGE_RENAME_TEST_DIR));
+    mu_check(storage_simply_remove_recursive(storage, STORAGE_RENAME_TEST_DIR_2));
+    mu_check(storage_simply_remove_recursive(storage, STORAGE_RENAME_TEST_DIR_INT));
+    furi_record_close("storage");
+}
+
+MU_TEST(storage_rename_file) {
+    Storage* storage = furi_record_open("storage");
+
+    mu_assert_int_eq(
+        FSE_OK,
+        storage_common_rename(
+            storage, STORAGE_RENAME_TEST_DIR "/file", STORAGE_RENAME_TEST_DIR "/file_2"));
+    mu_assert_int_eq(
+        FSE_NOT_EXIST, storage_common_stat(storage, STORAGE_RENAME_TEST_DIR "/file", NULL));
+    storage_rename_check_file(storage, STORAGE_RENAME_TEST_DIR "/file_2");
+
+    // Existing file must not be overwritten
+    storage_rename_write_file(storage, STORAGE_RENAME_TEST_DIR "/file");
+    mu_assert_int_eq(
+        FSE_EXIST,
+        storage_common_rename(
+            storage, STORAGE_RENAME_TEST_DIR "/file", STORAGE_RENAME_TEST_DIR "/file_2"));
+
+    furi_record_close("storage");
+}
+
+MU_TEST(storage_rename_dir) {
+    Storage* storage = furi_record_open("storage");
+
+    // Same storage
+    mu_assert_int_eq(
+        FSE_OK,
+        storage_common_rename(storage, STORAGE_RENAME_TEST_DIR, STORAGE_RENAME_TEST_DIR_2));
+    mu_assert_int_eq(FSE_NOT_EXIST, storage_common_stat(storage, STORAGE_RENAME_TEST_DIR, NULL));
+    storage_rename_check_file(storage, STORAGE_RENAME_TEST_DIR_2 "/dir/file");
+
+    // Different storages, directory is copied recursively
+    mu_assert_int_eq(
+        FSE_OK,
+        storage_common_rename(storage, STORAGE_RENAME_TEST_DIR_2, STORAGE_RENAME_TEST_DIR_INT));
+    mu_assert_int_eq(FSE_NOT_EXIST, storage_common_stat(storage, STORAGE_RENAME_TEST_DIR_2, NULL));
+    storage_rename_check_file(storage, STORAGE_RENAME_TEST_DIR_INT "/dir/file");
+
+    mu_assert_int_eq(
+        FSE_OK,
+        storage_common_rename(storage, STORAGE_RENAME_TEST_DIR_INT, STORAGE_RENAME_TEST_DIR));
+    storage_rename_check_file(storage, STORAGE_RENAME_TEST_DIR "/dir/file");
+
+    furi_record_close("storage");
+}
+
+MU_TEST(storage_rename_restricted) {
+    Storage* storage = furi_record_open("storage");
+
+    // Directory can't be moved inside of itself
+    mu_assert_int_eq(
+        FSE_INVALID_PARAMETER,
+        storage_common_rename(
+            storage, STORAGE_RENAME_TEST_DIR "/dir", STORAGE_RENAME_TEST_DIR "/dir/dir"));
+    mu_assert_int_eq(
+        FSE_INVALID_PARAMETER,
+        storage_common_rename(storage, "/any/rename_test/dir", STORAGE_RENAME_TEST_DIR "/dir/a"));
+
+    // Open file inside of directory blocks rename, on same and different storage
+    File* file = storage_file_alloc(storage);
+    mu_check(storage_file_open(
+        file, STORAGE_RENAME_TEST_DIR "/dir/file", FSAM_READ, FSOM_OPEN_EXISTING));
+    mu_assert_int_eq(
+        FSE_ALREADY_OPEN,
+        storage_common_rename(storage, STORAGE_RENAME_TEST_DIR, STORAGE_RENAME_TEST_DIR_2));
+    mu_assert_int_eq(
+        FSE_ALREADY_OPEN,
+        storage_common_rename(storage, STORAGE_RENAME_TEST_DIR, STORAGE_RENAME_TEST_DIR_INT));
+    mu_assert_int_eq(
+        FSE_NOT_EXIST, storage_common_stat(storage, STORAGE_RENAME_TEST_DIR_INT, NULL));
+
+    // Sibling with common name prefix is not affected
+    mu_assert_int_eq(
+        FSE_OK,
+        storage_common_rename(
+            storage, STORAGE_RENAME_TEST_DIR "/file", STORAGE_RENAME_TEST_DIR "/di"));
+    mu_assert_int_eq(
+        FSE_OK,
+        storage_common_rename(
+            storage, STORAGE_RENAME_TEST_DIR "/di", STORAGE_RENAME_TEST_DIR "/file"));
+    mu_check(storage_file_close(file));
+    storage_file_free(file);
+
+    furi_record_close("storage");
+}
+
+MU_TEST_SUITE(storage_rename) {
+    storage_rename_setup();
+    MU_RUN_TEST(storage_rename_file);
+    MU_RUN_TEST(storage_rename_dir);
+    MU_RUN_TEST(storage_rename_restricted);
+    storage_rename_teardown();
+}
+
+#define STORAGE_HASH_TEST_DIR "/ext/hash_test"
+#define STORAGE_HASH_TEST_DIR_INT "/int/hash_test"
+#define STORAGE_HASH_TEST_BENCHMARK_FILE STORAGE_HASH_TEST_DIR "/benchmark"
+#define STORAGE_HASH_TEST_BENCHMARK_SIZE (2 * 1024 * 1024)
+#define STORAGE_HASH_TEST_CLIENT_READ_SIZE 512
+
+#define TAG "UnitTestsStorage"
+
+static void storage_hash_write_file(Storage* storage, const char* path, const char* data) {
+    File* file = storage_file_alloc(storage);
+    mu_check(storage_file_open(file, path, FSAM_WRITE, FSOM_CREATE_ALWAYS));
+    mu_check(storage_file_write(file, data, strlen(data)) == strlen(data));
+    mu_check(storage_file_close(file));
+    storage_file_free(file);
+}
+
+static void storage_hash_to_string(const uint8_t* hash, size_t size, char* string) {
+    for(size_t i = 0; i < size; i++) {
+        string += sprintf(string, "%02x", hash[i]);
+    }
+}
+
+static void storage_hash_check(
+    Storage* storage,
+    const char* path,
+    StorageHashType type,
+    const char* expected) {
+    uint8_t hash[STORAGE_HASH_SIZE_MAX];
+    char hash_string[STORAGE_HASH_SIZE_MAX * 2 + 1];
+    mu_assert_int_eq(FSE_OK, storage_common_hash(storage, path, type, hash));
+    storage_hash_to_string(hash, storage_hash_get_size(type), hash_string);
+    mu_assert_string_eq(expected, hash_string);
+}
+
+static void storage_hash_setup() {
+    Storage* storage = furi_record_open("storage");
+    storage_simply_remove_recursive(storage, STORAGE_HASH_TEST_DIR);
+    storage_simply_remove_recursive(storage, STORAGE_HASH_TEST_DIR_INT);
+    mu_check(storage_simply_mkdir(storage, STORAGE_HASH_TEST_DIR));
+    mu_check(storage_simply_mkdir(storage, STORAGE_HASH_TEST_DIR_INT));
+    furi_record_close("storage");
+}
+
+static void storage_hash_teardown() {
+    Storage* storage = furi_record_open("storage");
+    mu_check(storage_simply_remove_recursive(storage, STORAGE_HASH_TEST_DIR));
+    mu_check(storage_simply_remove_recursive(storage, STORAGE_HASH_TEST_DIR_INT));
+    furi_record_close("storage");
+}
+
+MU_TEST(storage_hash_vectors) {
+    Storage* storage = furi_record_open("storage");
+    uint8_t hash[STORAGE_HASH_SIZE_MAX];
+
+    mu_assert_int_eq(16, storage_hash_get_size(StorageHashMd5));
+    mu_assert_int_eq(32, storage_hash_get_size(StorageHashSha256));
+
+    storage_hash_write_file(storage, STORAGE_HASH_TEST_DIR "/empty", "");
+    storage_hash_check(
+        storage,
+        STORAGE_HASH_TEST_DIR "/empty",
+        StorageHashMd5,
+        "d41d8cd98f00b204e9800998ecf8427e");
+    storage_hash_check(
+        storage,
+        STORAGE_HASH_TEST_DIR "/empty",
+        StorageHashSha256,
+        "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+
+    storage_hash_write_file(storage, STORAGE_HASH_TEST_DIR_INT "/abc", "abc");
+    storage_hash_check(
+        storage,
+        STORAGE_HASH_TEST_DIR_INT "/abc",
+        StorageHashMd5,
+        "900150983cd24fb0d6963f7d28e17f72");
+    storage_hash_check(
+        storage,
+        STORAGE_HASH_TEST_DIR_INT "/abc",
+        StorageHashSha256,
+        "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+
+    mu_assert_int_eq(
+        FSE_NOT_EXIST,
+        storage_common_hash(storage, STORAGE_HASH_TEST_DIR "/none", StorageHashMd5, hash));
+    mu_assert_int_eq(
+        FSE_INVALID_NAME, storage_common_hash(storage, "/none", StorageHashSha256, hash));
+
+    // Open file is not hashed, storage service must not wait for it
+    File* file = storage_file_alloc(storage);
+    mu_check(storage_file_open(
+        file, STORAGE_HASH_TEST_DIR_INT "/abc", FSAM_READ, FSOM_OPEN_EXISTING));
+    mu_assert_int_eq(
+        FSE_ALREADY_OPEN,
+        storage_common_hash(storage, STORAGE_HASH_TEST_DIR_INT "/abc", StorageHashMd5, hash));
+    storage_file_close(file);
+    storage_file_free(file);
+
+    furi_record_close("storage");
+}
+
+static uint32_t storage_hash_speed(uint32_t time) {
+    // MB/s * 100
+    return (uint64_t)STORAGE_HASH_TEST_BENCHMARK_SIZE * 100 * 1000 / (MAX(time, 1) * 1024 * 1024);
+}
+
+MU_TEST(storage_hash_benchmark) {
+    Storage* storage = furi_record_open("storage");
+    File* file = storage_file_alloc(storage);
+    uint8_t* data = malloc(STORAGE_HASH_TEST_CLIENT_READ_SIZE);
+    uint8_t hash[STORAGE_HASH_SIZE_MAX];
+    uint8_t hash_client[STORAGE_HASH_SIZE_MAX];
+
+    mu_check(storage_file_open(
+        file, STORAGE_HASH_TEST_BENCHMARK_FILE, FSAM_WRITE, FSOM_CREATE_ALWAYS));
+    for(size_t i = 0; i < STORAGE_HASH_TEST_BENCHMARK_SIZE;
+        i += STORAGE_HASH_TEST_CLIENT_READ_SIZE) {
+        for(size_t j = 0; j < STORAGE_HASH_TEST_CLIENT_READ_SIZE; j++) {
+            data[j] = (i + j) * 13 + (i >> 9);
+        }
+        mu_check(
+            storage_file_write(file, data, STORAGE_HASH_TEST_CLIENT_READ_SIZE) ==
+            STORAGE_HASH_TEST_CLIENT_READ_SIZE);
+    }
+    mu_check(storage_file_close(file));
+
+    // Client side loop, round trip to storage service for every block
+    uint32_t client_time = osKernelGetTickCount();
+    md5_context* md5_ctx = malloc(sizeof(md5_context));
+    mu_check(storage_file_open(
+        file, STORAGE_HASH_TEST_BENCHMARK_FILE, FSAM_READ, FSOM_OPEN_EXISTING));
+    md5_starts(md5_ctx);
+    while(true) {
+        uint16_t read_size = storage_file_read(file, data, STORAGE_HASH_TEST_CLIENT_READ_SIZE);
+        if(read_size == 0) break;
+        md5_update(md5_ctx, data, read_size);
+    }
+    md5_finish(md5_ctx, hash_client);
+    mu_check(storage_file_close(file));
+    free(md5_ctx);
+    client_time = osKernelGetTickCount() - client_time;
+
+    uint32_t md5_time = osKernelGetTickCount();
+    mu_assert_int_eq(
+        FSE_OK,
+        storage_common_hash(storage, STORAGE_HASH_TEST_BENCHMARK_FILE, StorageHashMd5, hash));
+    md5_time = osKernelGetTickCount() - md5_time;
+    mu_check(memcmp(hash, hash_client, storage_hash_get_size(StorageHashMd5)) == 0);
+
+    uint32_t sha256_time = osKernelGetTickCount();
+    mu_assert_int_eq(
+        FSE_OK,
+        storage_common_hash(storage, STORAGE_HASH_TEST_BENCHMARK_FILE, StorageHashSha256, hash));
+    sha256_time = osKernelGetTickCount() - sha256_time;
+
+    FURI_LOG_I(
+        TAG,
+        "%u KB: md5 %lu.%02lu MB/s, sha256 %lu.%02lu MB/s, client md5 loop %lu.%02lu MB/s",
+        STORAGE_HASH_TEST_BENCHMARK_SIZE / 1024,
+        storage_hash_speed(md5_time) / 100,
+        storage_hash_speed(md5_time) % 100,
+        storage_hash_speed(sha256_time) / 100,
+        storage_hash_speed(sha256_time) % 100,
+        storage_hash_speed(client_time) / 100,
+        storage_hash_speed(client_time) % 100);
+
+    free(data);
+    storage_file_free(file);
+    furi_record_close("storage");
+}
+
+MU_TEST_SUITE(storage_hash) {
+    storage_hash_setup();
+    MU_RUN_TEST(storage_hash_vectors);
+    MU_RUN_TEST(storage_hash_benchmark);
+    storage_hash_teardown();
+}
+
 int run_minunit_test_storage() {
     MU_RUN_SUITE(storage_file);
+    MU_RUN_SUITE(storage_rename);
+    MU_RUN_SUITE(storage_hash);
     return MU_EXIT_CODE;
 }
\ No newline at end of file
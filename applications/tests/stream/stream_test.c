@@ -2,9 +2,12 @@
 #include <toolbox/stream/stream.h>
 #include <toolbox/stream/string_stream.h>
 #include <toolbox/stream/file_stream.h>
+#include <toolbox/stream/compressed_stream.h>
 #include <storage/storage.h>
 #include "../minunit.h"
 
+#define TAG "UnitTestsStream"
+
 static const char* stream_test_data = "I write differently from what I speak, "
                                       "I speak differently from what I think, "
                                       "I think differently from the way I ought to think, "
@@ -369,10 +372,179 @@ MU_TEST(stream_split_test) {
     furi_record_close("storage");
 }
 
+#define COMPRESSED_TEST_LINES 200
+#define COMPRESSED_TEST_WINDOW_BITS 8
+#define COMPRESSED_TEST_LOOKAHEAD_BITS 4
+
+MU_TEST_1(stream_compressed_subtest, Stream* base) {
+    Stream* stream =
+        compressed_stream_alloc(base, COMPRESSED_TEST_WINDOW_BITS, COMPRESSED_TEST_LOOKAHEAD_BITS);
+    string_t line;
+    string_init(line);
+    uint8_t data[256] = {0};
+
+    // empty stream
+    mu_check(stream_eof(stream));
+    mu_assert_int_eq(0, stream_size(stream));
+    mu_assert_int_eq(0, stream_read(stream, data, sizeof(data)));
+
+    // sequential write, spans several blocks
+    size_t size = 0;
+    for(size_t i = 0; i < COMPRESSED_TEST_LINES; i++) {
+        size += stream_write_format(stream, "%u: %s\n", i, stream_test_data);
+    }
+    mu_assert_int_eq(size, stream_size(stream));
+    mu_assert_int_eq(size, stream_tell(stream));
+    mu_check(compressed_stream_flush(stream));
+    mu_check(stream_size(base) < size / 4);
+
+    // rewind and read
+    mu_check(stream_rewind(stream));
+    for(size_t i = 0; i < COMPRESSED_TEST_LINES; i++) {
+        mu_check(stream_read_line(stream, line));
+        string_t expected;
+        string_init_printf(expected, "%u: %s\n", i, stream_test_data);
+        mu_assert_string_eq(string_get_cstr(expected), string_get_cstr(line));
+        string_clear(expected);
+    }
+    mu_check(stream_eof(stream));
+
+    // writes are allowed only at the end
+    mu_check(stream_seek(stream, 5, StreamOffsetFromStart));
+    mu_assert_int_eq(0, stream_write_cstring(stream, stream_test_left_data));
+    mu_check(!stream_seek(stream, size + 1, StreamOffsetFromStart));
+    mu_assert_int_eq(size, stream_tell(stream));
+
+    // append, then reopen and read back the tail
+    mu_check(stream_seek(stream, 0, StreamOffsetFromEnd));
+    mu_assert_int_eq(
+        strlen(stream_test_left_data), stream_write_cstring(stream, stream_test_left_data));
+    stream_free(stream);
+
+    stream = compressed_stream_alloc(base, COMPRESSED_TEST_WINDOW_BITS + 1, 5);
+    mu_assert_int_eq(size + strlen(stream_test_left_data), stream_size(stream));
+    mu_check(stream_seek(stream, -(int32_t)strlen(stream_test_left_data), StreamOffsetFromEnd));
+    memset(data, 0, sizeof(data));
+    mu_assert_int_eq(strlen(stream_test_left_data), stream_read(stream, data, sizeof(data)));
+    mu_assert_string_eq(stream_test_left_data, (const char*)data);
+
+    // backward seek into another block
+    mu_check(stream_seek(stream, 0, StreamOffsetFromStart));
+    mu_check(stream_read_line(stream, line));
+    mu_check(string_start_with_str_p(line, "0: "));
+
+    stream_clean(stream);
+    mu_assert_int_eq(0, stream_size(stream));
+    mu_assert_int_eq(0, stream_size(base));
+
+    string_clear(line);
+    stream_free(stream);
+}
+MU_TEST(stream_compressed_test) {
+    // test string stream
+    Stream* stream;
+    stream = string_stream_alloc();
+    MU_RUN_TEST_1(stream_compressed_subtest, stream);
+    stream_free(stream);
+
+    // test file stream
+    Storage* storage = furi_record_open("storage");
+    stream = file_stream_alloc(storage);
+    mu_check(file_stream_open(stream, "/ext/filestream.hs", FSAM_READ_WRITE, FSOM_CREATE_ALWAYS));
+    MU_RUN_TEST_1(stream_compressed_subtest, stream);
+    stream_free(stream);
+    furi_record_close("storage");
+}
+
+MU_TEST_1(stream_compressed_benchmark_subtest, Stream* source) {
+    Storage* storage = furi_record_open("storage");
+    Stream* file = file_stream_alloc(storage);
+    mu_check(file_stream_open(file, "/ext/filestream.hs", FSAM_READ_WRITE, FSOM_CREATE_ALWAYS));
+    Stream* stream =
+        compressed_stream_alloc(file, COMPRESSED_TEST_WINDOW_BITS, COMPRESSED_TEST_LOOKAHEAD_BITS);
+
+    uint32_t write_time = osKernelGetTickCount();
+    size_t size = stream_copy_full(source, stream);
+    mu_check(compressed_stream_flush(stream));
+    write_time = osKernelGetTickCount() - write_time;
+    mu_assert_int_eq(stream_size(source), size);
+
+    uint8_t expected[64];
+    uint8_t data[64];
+    mu_check(stream_rewind(source));
+    mu_check(stream_rewind(stream));
+    uint32_t read_time = osKernelGetTickCount();
+    while(!stream_eof(source)) {
+        size_t read = stream_read(source, expected, sizeof(expected));
+        mu_assert_int_eq(read, stream_read(stream, data, sizeof(data)));
+        mu_check(memcmp(expected, data, read) == 0);
+    }
+    read_time = osKernelGetTickCount() - read_time;
+    mu_check(stream_eof(stream));
+
+    size_t compressed_size = stream_size(file);
+    mu_check(compressed_size < size);
+    FURI_LOG_I(
+        TAG,
+        "%u -> %u bytes (%u%%), write %lu ms, read %lu ms",
+        size,
+        compressed_size,
+        compressed_size * 100 / size,
+        write_time,
+        read_time);
+
+    stream_free(stream);
+    stream_free(file);
+    furi_record_close("storage");
+}
+
+MU_TEST(stream_compressed_benchmark) {
+    Storage* storage = furi_record_open("storage");
+    Stream* source = file_stream_alloc(storage);
+    if(file_stream_open(source, "/ext/infrared/assets/tv.ir", FSAM_READ, FSOM_OPEN_EXISTING)) {
+        FURI_LOG_I(TAG, "IR archive");
+        MU_RUN_TEST_1(stream_compressed_benchmark_subtest, source);
+    } else {
+        FURI_LOG_W(TAG, "No IR archive on SD card, skipped");
+    }
+    stream_free(source);
+
+    // SubGhz RAW capture: OOK pulses with receiver jitter, too big for RAM
+    source = file_stream_alloc(storage);
+    mu_check(file_stream_open(source, "/ext/filestream.sub", FSAM_READ_WRITE, FSOM_CREATE_ALWAYS));
+    stream_write_cstring(
+        source,
+        "Filetype: Flipper SubGhz RAW File\nVersion: 1\nFrequency: 433920000\n"
+        "Preset: FuriHalSubGhzPresetOok650Async\nProtocol: RAW\n");
+    // One storage write per line
+    string_t line;
+    string_init(line);
+    uint32_t random = 1;
+    for(size_t i = 0; i < 64; i++) {
+        string_set_str(line, "RAW_Data:");
+        for(size_t j = 0; j < 512; j++) {
+            random = random * 1103515245 + 12345;
+            int32_t jitter = (int32_t)((random >> 8) % 64) - 32;
+            int32_t duration = ((random >> 16) & 1 ? 1200 : 400) + jitter;
+            string_cat_printf(line, " %ld", (j & 1) ? -duration : duration);
+        }
+        string_push_back(line, '\n');
+        stream_write_string(source, line);
+    }
+    string_clear(line);
+    FURI_LOG_I(TAG, "SubGhz RAW capture");
+    MU_RUN_TEST_1(stream_compressed_benchmark_subtest, source);
+    stream_free(source);
+    storage_simply_remove(storage, "/ext/filestream.sub");
+    furi_record_close("storage");
+}
+
 MU_TEST_SUITE(stream_suite) {
     MU_RUN_TEST(stream_write_read_save_load_test);
     MU_RUN_TEST(stream_composite_test);
     MU_RUN_TEST(stream_split_test);
+    MU_RUN_TEST(stream_compressed_test);
+    MU_RUN_TEST(stream_compressed_benchmark);
 }
 
 int run_minunit_test_stream() {
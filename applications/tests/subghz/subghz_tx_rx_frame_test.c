@@ -0,0 +1,360 @@
+#include <furi.h>
+#include <lib/subghz/subghz_tx_rx_frame.h>
+#include "../minunit.h"
+
+#define TAG "UnitTestsSubGhzTxRx"
+
+#define SUBGHZ_TX_RX_TEST_BAUDRATE 9990
+// Preamble 4, sync word 2, length 1 and CRC 2 bytes around payload
+#define SUBGHZ_TX_RX_TEST_PREAMBLE_SIZE 4
+#define SUBGHZ_TX_RX_TEST_OVERHEAD_SIZE 9
+// Length byte, packet and 2 appended status bytes
+#define SUBGHZ_TX_RX_TEST_FIFO_SIZE 64
+#define SUBGHZ_TX_RX_TEST_MESSAGE_SIZE 200
+#define SUBGHZ_TX_RX_TEST_MESSAGES 32
+
+typedef struct {
+    uint32_t tx_start; /**< idle, FIFO write and TX start, us */
+    uint32_t tx_gap; /**< pause between packets, us */
+    uint32_t end_of_packet; /**< end of packet detection latency, us */
+    uint32_t rx_restart; /**< FIFO read, flush and RX start, us */
+    uint8_t loss; /**< percent of packets lost on air */
+} SubGhzTxRxSimConfig;
+
+typedef struct {
+    const SubGhzTxRxSimConfig* config;
+    uint32_t time;
+    uint32_t rx_ready;
+    uint32_t random;
+    uint8_t fifo[SUBGHZ_TX_RX_TEST_FIFO_SIZE];
+    uint8_t fifo_size;
+    bool fifo_overflow;
+    uint32_t packets;
+    uint32_t packets_lost;
+} SubGhzTxRxSim;
+
+// Polling: GDO0 read every tick in 1 ms loop, 10 loop iterations between packets
+static const SubGhzTxRxSimConfig subghz_tx_rx_polling = {
+    .tx_start = 1000,
+    .tx_gap = 20000,
+    .end_of_packet = 1000,
+    .rx_restart = 2000,
+};
+
+// GDO0 EXTI wakes worker thread
+static const SubGhzTxRxSimConfig subghz_tx_rx_interrupt = {
+    .tx_start = 1000,
+    .end_of_packet = 50,
+    .rx_restart = 500,
+};
+
+static const SubGhzTxRxSimConfig subghz_tx_rx_interrupt_lossy = {
+    .tx_start = 1000,
+    .end_of_packet = 50,
+    .rx_restart = 500,
+    .loss = 10,
+};
+
+static void subghz_tx_rx_sim_init(SubGhzTxRxSim* sim, const SubGhzTxRxSimConfig* config) {
+    memset(sim, 0, sizeof(SubGhzTxRxSim));
+    sim->config = config;
+    sim->random = 0x1234;
+}
+
+static uint32_t subghz_tx_rx_sim_air_time(size_t size) {
+    return (size * 8 * 1000000) / SUBGHZ_TX_RX_TEST_BAUDRATE;
+}
+
+/* CC1101 FIFO and GDO0 model: returns true if GDO0 falls with packet in RX FIFO */
+static bool subghz_tx_rx_sim_transfer(SubGhzTxRxSim* sim, const uint8_t* packet, uint8_t size) {
+    uint32_t start = sim->time + sim->config->tx_start;
+    uint32_t end = start + subghz_tx_rx_sim_air_time(size + SUBGHZ_TX_RX_TEST_OVERHEAD_SIZE);
+    // Transmitter waits for GDO0 to fall too
+    sim->time = end + sim->config->end_of_packet + sim->config->tx_gap;
+    sim->packets++;
+
+    sim->random = sim->random * 1103515245 + 12345;
+    bool lost = ((sim->random >> 16) % 100) < sim->config->loss;
+    // Receiver must be in RX before sync word
+    uint32_t sync = start + subghz_tx_rx_sim_air_time(SUBGHZ_TX_RX_TEST_PREAMBLE_SIZE);
+    if(lost || (sim->rx_ready > sync)) {
+        sim->packets_lost++;
+        return false;
+    }
+
+    sim->fifo_overflow = (size + 3) > SUBGHZ_TX_RX_TEST_FIFO_SIZE;
+    sim->fifo_size = MIN(size, SUBGHZ_TX_RX_TEST_FIFO_SIZE);
+    memcpy(sim->fifo, packet, sim->fifo_size);
+    sim->rx_ready = end + sim->config->end_of_packet + sim->config->rx_restart;
+    return !sim->fifo_overflow;
+}
+
+static void subghz_tx_rx_test_fill(uint8_t* data, size_t size, uint8_t seed) {
+    for(size_t i = 0; i < size; i++) {
+        data[i] = seed + i * 7;
+    }
+}
+
+MU_TEST(subghz_tx_rx_frame_test_fragment) {
+    SubGhzTxRxFrameEncoder* encoder = subghz_tx_rx_frame_encoder_alloc();
+    SubGhzTxRxFrameDecoder* decoder = subghz_tx_rx_frame_decoder_alloc();
+    uint8_t message[SUBGHZ_TX_RX_FRAME_MESSAGE_SIZE_MAX + 1];
+    uint8_t packet[SUBGHZ_TX_RX_FRAME_PACKET_SIZE_MAX];
+    subghz_tx_rx_test_fill(message, sizeof(message), 0);
+
+    mu_check(!subghz_tx_rx_frame_encoder_set_message(encoder, message, 0));
+    mu_check(!subghz_tx_rx_frame_encoder_set_message(encoder, message, sizeof(message)));
+
+    // Small message fits one packet
+    mu_check(subghz_tx_rx_frame_encoder_set_message(encoder, message, 10));
+    uint8_t size = subghz_tx_rx_frame_encoder_next(encoder, packet);
+    mu_assert_int_eq(10 + SUBGHZ_TX_RX_FRAME_HEADER_SIZE, size);
+    mu_assert_int_eq(10, subghz_tx_rx_frame_decoder_push(decoder, packet, size));
+    mu_check(memcmp(subghz_tx_rx_frame_decoder_get_message(decoder), message, 10) == 0);
+    mu_assert_int_eq(0, subghz_tx_rx_frame_encoder_next(encoder, packet));
+
+    // Message larger than FIFO is split
+    const uint8_t sizes[] = {60, 60, 45};
+    mu_check(subghz_tx_rx_frame_encoder_set_message(encoder, message, 150));
+    for(size_t i = 0; i < COUNT_OF(sizes); i++) {
+        size = subghz_tx_rx_frame_encoder_next(encoder, packet);
+        mu_assert_int_eq(sizes[i], size);
+        size_t message_size = subghz_tx_rx_frame_decoder_push(decoder, packet, size);
+        mu_assert_int_eq((i == COUNT_OF(sizes) - 1) ? 150 : 0, message_size);
+    }
+    mu_assert_int_eq(0, subghz_tx_rx_frame_encoder_next(encoder, packet));
+    mu_check(memcmp(subghz_tx_rx_frame_decoder_get_message(decoder), message, 150) == 0);
+
+    // Largest message
+    size_t message_size = 0;
+    uint8_t packets = 0;
+    mu_check(subghz_tx_rx_frame_encoder_set_message(
+        encoder, message, SUBGHZ_TX_RX_FRAME_MESSAGE_SIZE_MAX));
+    while((size = subghz_tx_rx_frame_encoder_next(encoder, packet))) {
+        packets++;
+        message_size = subghz_tx_rx_frame_decoder_push(decoder, packet, size);
+    }
+    mu_assert_int_eq(SUBGHZ_TX_RX_FRAME_FRAGMENTS_MAX, packets);
+    mu_assert_int_eq(SUBGHZ_TX_RX_FRAME_MESSAGE_SIZE_MAX, message_size);
+    mu_check(
+        memcmp(
+            subghz_tx_rx_frame_decoder_get_message(decoder),
+            message,
+            SUBGHZ_TX_RX_FRAME_MESSAGE_SIZE_MAX) == 0);
+    mu_assert_int_eq(0, subghz_tx_rx_frame_decoder_get_lost(decoder));
+
+    subghz_tx_rx_frame_decoder_free(decoder);
+    subghz_tx_rx_frame_encoder_free(encoder);
+}
+
+MU_TEST(subghz_tx_rx_frame_test_loss) {
+    SubGhzTxRxFrameEncoder* encoder = subghz_tx_rx_frame_encoder_alloc();
+    SubGhzTxRxFrameDecoder* decoder = subghz_tx_rx_frame_decoder_alloc();
+    uint8_t message[150];
+    uint8_t packets[3][SUBGHZ_TX_RX_FRAME_PACKET_SIZE_MAX];
+    uint8_t sizes[3];
+    subghz_tx_rx_test_fill(message, sizeof(message), 0);
+
+    // Missing fragment drops message
+    mu_check(subghz_tx_rx_frame_encoder_set_message(encoder, message, sizeof(message)));
+    for(size_t i = 0; i < 3; i++) {
+        sizes[i] = subghz_tx_rx_frame_encoder_next(encoder, packets[i]);
+    }
+    mu_assert_int_eq(0, subghz_tx_rx_frame_decoder_push(decoder, packets[0], sizes[0]));
+    mu_assert_int_eq(0, subghz_tx_rx_frame_decoder_push(decoder, packets[2], sizes[2]));
+    mu_assert_int_eq(1, subghz_tx_rx_frame_decoder_get_lost(decoder));
+
+    // Duplicates and malformed packets are ignored
+    mu_check(subghz_tx_rx_frame_encoder_set_message(encoder, message, sizeof(message)));
+    for(size_t i = 0; i < 3; i++) {
+        sizes[i] = subghz_tx_rx_frame_encoder_next(encoder, packets[i]);
+    }
+    mu_assert_int_eq(0, subghz_tx_rx_frame_decoder_push(decoder, packets[0], sizes[0]));
+    mu_assert_int_eq(0, subghz_tx_rx_frame_decoder_push(decoder, packets[0], sizes[0]));
+    mu_assert_int_eq(0, subghz_tx_rx_frame_decoder_push(decoder, packets[1], 2));
+    uint8_t malformed[SUBGHZ_TX_RX_FRAME_HEADER_SIZE + 2];
+    memcpy(malformed, packets[1], sizeof(malformed));
+    malformed[SUBGHZ_TX_RX_FRAME_HEADER_SIZE - 1] = 0x30;
+    mu_assert_int_eq(0, subghz_tx_rx_frame_decoder_push(decoder, malformed, sizeof(malformed)));
+    mu_assert_int_eq(0, subghz_tx_rx_frame_decoder_push(decoder, packets[1], sizes[1]));
+    mu_assert_int_eq(150, subghz_tx_rx_frame_decoder_push(decoder, packets[2], sizes[2]));
+    mu_assert_int_eq(1, subghz_tx_rx_frame_decoder_get_lost(decoder));
+
+    // Tail of message and next message lost
+    mu_check(subghz_tx_rx_frame_encoder_set_message(encoder, message, sizeof(message)));
+    sizes[0] = subghz_tx_rx_frame_encoder_next(encoder, packets[0]);
+    mu_assert_int_eq(0, subghz_tx_rx_frame_decoder_push(decoder, packets[0], sizes[0]));
+    mu_check(subghz_tx_rx_frame_encoder_set_message(encoder, message, 10));
+    mu_check(subghz_tx_rx_frame_encoder_set_message(encoder, message, 20));
+    sizes[0] = subghz_tx_rx_frame_encoder_next(encoder, packets[0]);
+    mu_assert_int_eq(20, subghz_tx_rx_frame_decoder_push(decoder, packets[0], sizes[0]));
+    mu_assert_int_eq(4, subghz_tx_rx_frame_decoder_get_lost(decoder));
+
+    subghz_tx_rx_frame_decoder_reset(decoder);
+    mu_assert_int_eq(0, subghz_tx_rx_frame_decoder_get_lost(decoder));
+
+    subghz_tx_rx_frame_decoder_free(decoder);
+    subghz_tx_rx_frame_encoder_free(encoder);
+}
+
+MU_TEST(subghz_tx_rx_frame_test_senders) {
+    SubGhzTxRxFrameEncoder* encoders[SUBGHZ_TX_RX_FRAME_SENDERS_MAX + 1];
+    SubGhzTxRxFrameDecoder* decoder = subghz_tx_rx_frame_decoder_alloc();
+    uint8_t messages[2][150];
+    uint8_t packets[2][SUBGHZ_TX_RX_FRAME_PACKET_SIZE_MAX];
+    uint8_t sizes[2];
+    subghz_tx_rx_test_fill(messages[0], sizeof(messages[0]), 0);
+    subghz_tx_rx_test_fill(messages[1], sizeof(messages[1]), 1);
+
+    // Senders differ by id only, their sequence numbers are equal
+    for(size_t i = 0; i < COUNT_OF(encoders); i++) {
+        do {
+            encoders[i] = subghz_tx_rx_frame_encoder_alloc();
+            for(size_t j = 0; encoders[i] && (j < i); j++) {
+                if(subghz_tx_rx_frame_encoder_get_sender_id(encoders[i]) ==
+                   subghz_tx_rx_frame_encoder_get_sender_id(encoders[j])) {
+                    subghz_tx_rx_frame_encoder_free(encoders[i]);
+                    encoders[i] = NULL;
+                }
+            }
+        } while(!encoders[i]);
+    }
+
+    // Interleaved fragments of two senders
+    for(size_t i = 0; i < 2; i++) {
+        mu_check(subghz_tx_rx_frame_encoder_set_message(encoders[i], messages[i], 150));
+    }
+    for(size_t fragment = 0; fragment < 3; fragment++) {
+        for(size_t i = 0; i < 2; i++) {
+            sizes[i] = subghz_tx_rx_frame_encoder_next(encoders[i], packets[i]);
+        }
+        for(size_t i = 0; i < 2; i++) {
+            size_t message_size = subghz_tx_rx_frame_decoder_push(decoder, packets[i], sizes[i]);
+            mu_assert_int_eq((fragment == 2) ? 150 : 0, message_size);
+            if(message_size) {
+                mu_check(
+                    memcmp(subghz_tx_rx_frame_decoder_get_message(decoder), messages[i], 150) ==
+                    0);
+            }
+        }
+    }
+    mu_assert_int_eq(0, subghz_tx_rx_frame_decoder_get_lost(decoder));
+
+    // Least recently heard sender is forgotten with its unfinished message
+    mu_check(subghz_tx_rx_frame_encoder_set_message(encoders[0], messages[0], 150));
+    sizes[0] = subghz_tx_rx_frame_encoder_next(encoders[0], packets[0]);
+    mu_assert_int_eq(0, subghz_tx_rx_frame_decoder_push(decoder, packets[0], sizes[0]));
+    for(size_t i = 1; i < COUNT_OF(encoders); i++) {
+        mu_check(subghz_tx_rx_frame_encoder_set_message(encoders[i], messages[1], 10));
+        sizes[1] = subghz_tx_rx_frame_encoder_next(encoders[i], packets[1]);
+        mu_assert_int_eq(10, subghz_tx_rx_frame_decoder_push(decoder, packets[1], sizes[1]));
+    }
+    mu_assert_int_eq(2, subghz_tx_rx_frame_decoder_get_lost(decoder));
+
+    // Packets without frame header, like plain text of older firmware, are ignored
+    const char* text = "Flipper: hello";
+    mu_assert_int_eq(
+        0, subghz_tx_rx_frame_decoder_push(decoder, (const uint8_t*)text, strlen(text)));
+
+    for(size_t i = 0; i < COUNT_OF(encoders); i++) {
+        subghz_tx_rx_frame_encoder_free(encoders[i]);
+    }
+    subghz_tx_rx_frame_decoder_free(decoder);
+}
+
+/* Sends messages through simulated link, returns effective throughput in bytes/s */
+static uint32_t subghz_tx_rx_test_link(SubGhzTxRxSim* sim, bool framing) {
+    SubGhzTxRxFrameEncoder* encoder = subghz_tx_rx_frame_encoder_alloc();
+    SubGhzTxRxFrameDecoder* decoder = subghz_tx_rx_frame_decoder_alloc();
+    uint8_t message[SUBGHZ_TX_RX_TEST_MESSAGE_SIZE];
+    uint8_t packet[SUBGHZ_TX_RX_FRAME_PACKET_SIZE_MAX];
+    size_t delivered = 0;
+    size_t intact = 0;
+    bool state = true;
+
+    for(uint8_t i = 0; i < SUBGHZ_TX_RX_TEST_MESSAGES; i++) {
+        subghz_tx_rx_test_fill(message, sizeof(message), i);
+        uint32_t lost = sim->packets_lost;
+        if(framing) {
+            subghz_tx_rx_frame_encoder_set_message(encoder, message, sizeof(message));
+            uint8_t size;
+            while((size = subghz_tx_rx_frame_encoder_next(encoder, packet))) {
+                if(!subghz_tx_rx_sim_transfer(sim, packet, size)) continue;
+                size_t message_size =
+                    subghz_tx_rx_frame_decoder_push(decoder, sim->fifo, sim->fifo_size);
+                const uint8_t* data = subghz_tx_rx_frame_decoder_get_message(decoder);
+                if(message_size) {
+                    if((message_size != sizeof(message)) ||
+                       (memcmp(data, message, message_size) != 0)) {
+                        state = false;
+                    }
+                    delivered += message_size;
+                }
+            }
+        } else {
+            // Raw chunks, lost data is not detected
+            for(size_t offset = 0; offset < sizeof(message);) {
+                uint8_t size = MIN(sizeof(message) - offset, SUBGHZ_TX_RX_FRAME_PACKET_SIZE_MAX);
+                if(subghz_tx_rx_sim_transfer(sim, &message[offset], size)) {
+                    delivered += sim->fifo_size;
+                }
+                offset += size;
+            }
+        }
+        if(lost == sim->packets_lost) intact++;
+    }
+
+    if(framing) {
+        // Every message without lost packets is delivered, lost packets are detected
+        if(delivered != intact * sizeof(message)) state = false;
+        if(subghz_tx_rx_frame_decoder_get_lost(decoder) > sim->packets_lost) state = false;
+        FURI_LOG_I(
+            TAG,
+            "%lu/%lu packets lost, %lu detected",
+            sim->packets_lost,
+            sim->packets,
+            subghz_tx_rx_frame_decoder_get_lost(decoder));
+    }
+
+    subghz_tx_rx_frame_decoder_free(decoder);
+    subghz_tx_rx_frame_encoder_free(encoder);
+    return state ? (uint64_t)delivered * 1000000 / sim->time : 0;
+}
+
+MU_TEST(subghz_tx_rx_frame_test_link) {
+    SubGhzTxRxSim sim;
+
+    subghz_tx_rx_sim_init(&sim, &subghz_tx_rx_polling);
+    uint32_t throughput_polling = subghz_tx_rx_test_link(&sim, false);
+    mu_assert_int_eq(0, sim.packets_lost);
+
+    subghz_tx_rx_sim_init(&sim, &subghz_tx_rx_interrupt);
+    uint32_t throughput_interrupt = subghz_tx_rx_test_link(&sim, true);
+    mu_assert_int_eq(0, sim.packets_lost);
+
+    subghz_tx_rx_sim_init(&sim, &subghz_tx_rx_interrupt_lossy);
+    uint32_t throughput_lossy = subghz_tx_rx_test_link(&sim, true);
+    mu_check(sim.packets_lost > 0);
+
+    FURI_LOG_I(
+        TAG,
+        "Throughput: interrupt %lu B/s, polling %lu B/s, interrupt with %u%% loss %lu B/s",
+        throughput_interrupt,
+        throughput_polling,
+        subghz_tx_rx_interrupt_lossy.loss,
+        throughput_lossy);
+    mu_check(throughput_interrupt > throughput_polling);
+    mu_check(throughput_lossy > 0);
+}
+
+MU_TEST_SUITE(subghz_tx_rx_frame_suite) {
+    MU_RUN_TEST(subghz_tx_rx_frame_test_fragment);
+    MU_RUN_TEST(subghz_tx_rx_frame_test_loss);
+    MU_RUN_TEST(subghz_tx_rx_frame_test_senders);
+    MU_RUN_TEST(subghz_tx_rx_frame_test_link);
+}
+
+int run_minunit_test_subghz_tx_rx() {
+    MU_RUN_SUITE(subghz_tx_rx_frame_suite);
+    return MU_EXIT_CODE;
+}
@@ -17,6 +17,23 @@ int run_minunit_test_flipper_format();
 int run_minunit_test_flipper_format_string();
 int run_minunit_test_stream();
 int run_minunit_test_storage();
+int run_minunit_test_micro_ecc();
+int run_minunit_test_kv_store();
+int run_minunit_test_notification_timeline();
+int run_minunit_test_nfc_emv_parser();
+int run_minunit_test_animation_storage();
+int run_minunit_test_bt_serial();
+int run_minunit_test_hid();
+int run_minunit_test_bad_usb();
+int run_minunit_test_subghz_tx_rx();
+int run_minunit_test_file_worker();
+int run_minunit_test_archive();
+int run_minunit_test_archive_dir_worker();
+int run_minunit_test_text_layout();
+int run_minunit_test_u2f_data();
+int run_minunit_test_file_select();
+int run_minunit_test_furi_hal_flash();
+int run_minunit_test_storage_int();
 
 void minunit_print_progress(void) {
     static char progress[] = {'\\', '|', '/', '-'};
@@ -60,6 +77,23 @@ void unit_tests_cli(Cli* cli, string_t args, void* context) {
         test_result |= run_minunit_test_flipper_format_string();
         test_result |= run_minunit_test_infrared_decoder_encoder();
         test_result |= run_minunit_test_rpc();
+        test_result |= run_minunit_test_micro_ecc();
+        test_result |= run_minunit_test_kv_store();
+        test_result |= run_minunit_test_notification_timeline();
+        test_result |= run_minunit_test_nfc_emv_parser();
+        test_result |= run_minunit_test_animation_storage();
+        test_result |= run_minunit_test_bt_serial();
+        test_result |= run_minunit_test_hid();
+        test_result |= run_minunit_test_bad_usb();
+        test_result |= run_minunit_test_subghz_tx_rx();
+        test_result |= run_minunit_test_file_worker();
+        test_result |= run_minunit_test_archive();
+        test_result |= run_minunit_test_archive_dir_worker();
+        test_result |= run_minunit_test_text_layout();
+        test_result |= run_minunit_test_u2f_data();
+        test_result |= run_minunit_test_file_select();
+        test_result |= run_minunit_test_furi_hal_flash();
+        test_result |= run_minunit_test_storage_int();
         cycle_counter = (DWT->CYCCNT - cycle_counter);
 
         FURI_LOG_I(TAG, "Consumed: %0.2fs", (float)cycle_counter / (SystemCoreClock));
@@ -0,0 +1,302 @@
+#include <furi.h>
+#include <furi_hal.h>
+#include <gui/gui.h>
+#include <gui/canvas_i.h>
+#include <gui/view_i.h>
+#include <gui/text_layout.h>
+#include <gui/modules/text_box.h>
+#include "../minunit.h"
+
+#define TAG "UnitTestsTextLayout"
+
+#define TEXT_LAYOUT_TEST_WIDTH 120
+#define TEXT_LAYOUT_TEST_DRAW_TIMEOUT 1000
+#define TEXT_LAYOUT_TEST_LINES_MAX 8
+#define TEXT_LAYOUT_TEST_TEXT_SIZE 256
+#define TEXT_LAYOUT_TEST_LOG_SIZE (64 * 1024)
+#define TEXT_LAYOUT_TEST_LOG_LINE_SIZE 64
+
+/* Text area of TextBox: inside of frame, left of scrollbar */
+#define TEXT_LAYOUT_TEST_AREA_X 3
+#define TEXT_LAYOUT_TEST_AREA_WIDTH 117
+#define TEXT_LAYOUT_TEST_AREA_Y 1
+#define TEXT_LAYOUT_TEST_AREA_HEIGHT 62
+
+typedef void (*TextLayoutTestDraw)(Canvas* canvas);
+
+static osSemaphoreId_t text_layout_test_drawn;
+static TextLayoutTestDraw text_layout_test_draw;
+
+static size_t text_layout_test_lines_count;
+static size_t text_layout_test_lengths[TEXT_LAYOUT_TEST_LINES_MAX];
+static uint8_t text_layout_test_glyph_width;
+static bool text_layout_test_extended_equal;
+static int32_t text_layout_test_scroll_pos;
+static uint32_t text_layout_test_log_cycles;
+static uint32_t text_layout_test_full_cycles;
+static bool text_layout_test_log_equal;
+
+static TextBox* text_box;
+static char text_layout_test_text[TEXT_LAYOUT_TEST_TEXT_SIZE];
+
+/* Runs in GUI thread: canvas is only available there */
+static void text_layout_test_draw_callback(Canvas* canvas, void* context) {
+    UNUSED(context);
+    if(text_layout_test_draw) {
+        text_layout_test_draw(canvas);
+        text_layout_test_draw = NULL;
+        osSemaphoreRelease(text_layout_test_drawn);
+    }
+}
+
+static void text_layout_test_run_draw(TextLayoutTestDraw draw) {
+    text_layout_test_drawn = osSemaphoreNew(1, 0, NULL);
+    ViewPort* view_port = view_port_alloc();
+    view_port_draw_callback_set(view_port, text_layout_test_draw_callback, NULL);
+
+    Gui* gui = furi_record_open("gui");
+    text_layout_test_draw = draw;
+    gui_add_view_port(gui, view_port, GuiLayerFullscreen);
+    view_port_update(view_port);
+    mu_assert(
+        osSemaphoreAcquire(text_layout_test_drawn, TEXT_LAYOUT_TEST_DRAW_TIMEOUT) == osOK,
+        "draw timeout");
+
+    gui_remove_view_port(gui, view_port);
+    furi_record_close("gui");
+    view_port_free(view_port);
+    osSemaphoreDelete(text_layout_test_drawn);
+}
+
+static void text_layout_test_line_breaks_draw(Canvas* canvas) {
+    canvas_set_font(canvas, FontSecondary);
+    text_layout_test_glyph_width = canvas_glyph_width(canvas, 'a');
+    size_t line_symbols = TEXT_LAYOUT_TEST_WIDTH / text_layout_test_glyph_width;
+
+    // newline, empty line, two full wrapped lines and one symbol, empty last line
+    char* text = text_layout_test_text;
+    text += sprintf(text, "first\n\n");
+    memset(text, 'a', line_symbols * 2 + 1);
+    text[line_symbols * 2 + 1] = '\n';
+    text[line_symbols * 2 + 2] = '\0';
+
+    TextLayout* text_layout = text_layout_alloc(TEXT_LAYOUT_TEST_WIDTH);
+    text_layout_set_text(text_layout, text_layout_test_text);
+    text_layout_update(text_layout, canvas);
+
+    text_layout_test_lines_count = text_layout_get_lines_count(text_layout);
+    for(size_t i = 0; i < MIN(text_layout_test_lines_count, TEXT_LAYOUT_TEST_LINES_MAX); i++) {
+        text_layout_get_line(text_layout, i, &text_layout_test_lengths[i]);
+    }
+
+    text_layout_free(text_layout);
+}
+
+MU_TEST(text_layout_test_line_breaks) {
+    text_layout_test_run_draw(text_layout_test_line_breaks_draw);
+
+    size_t line_symbols = TEXT_LAYOUT_TEST_WIDTH / text_layout_test_glyph_width;
+    mu_assert_int_eq(6, text_layout_test_lines_count);
+    mu_assert_int_eq(strlen("first"), text_layout_test_lengths[0]);
+    mu_assert_int_eq(0, text_layout_test_lengths[1]);
+    mu_assert_int_eq(line_symbols, text_layout_test_lengths[2]);
+    mu_assert_int_eq(line_symbols, text_layout_test_lengths[3]);
+    mu_assert_int_eq(1, text_layout_test_lengths[4]);
+    mu_assert_int_eq(0, text_layout_test_lengths[5]);
+}
+
+static void text_layout_test_extend_draw(Canvas* canvas) {
+    const char* text_start = "one\ntwo";
+    const char* text_end = "three\nfour five six seven eight nine ten eleven twelve thirteen";
+
+    // extended text is in a different buffer, previous one is freed, as after reallocation
+    char* text = malloc(strlen(text_start) + 1);
+    strcpy(text, text_start);
+    TextLayout* extended = text_layout_alloc(TEXT_LAYOUT_TEST_WIDTH);
+    text_layout_set_text(extended, text);
+    text_layout_update(extended, canvas);
+
+    snprintf(text_layout_test_text, sizeof(text_layout_test_text), "%s%s", text_start, text_end);
+    free(text);
+    text_layout_extend_text(extended, text_layout_test_text);
+    text_layout_update(extended, canvas);
+
+    TextLayout* full = text_layout_alloc(TEXT_LAYOUT_TEST_WIDTH);
+    text_layout_set_text(full, text_layout_test_text);
+    text_layout_update(full, canvas);
+
+    size_t lines_count = text_layout_get_lines_count(full);
+    text_layout_test_extended_equal = (lines_count > 2) &&
+                                      (lines_count == text_layout_get_lines_count(extended));
+    for(size_t i = 0; text_layout_test_extended_equal && (i < lines_count); i++) {
+        size_t full_length = 0;
+        size_t extended_length = 0;
+        const char* full_line = text_layout_get_line(full, i, &full_length);
+        const char* extended_line = text_layout_get_line(extended, i, &extended_length);
+        text_layout_test_extended_equal = (full_length == extended_length) &&
+                                          (full_line == extended_line);
+    }
+
+    text_layout_free(full);
+    text_layout_free(extended);
+}
+
+MU_TEST(text_layout_test_extend) {
+    text_layout_test_run_draw(text_layout_test_extend_draw);
+    mu_check(text_layout_test_extended_equal);
+}
+
+/* Log view: lines are appended one by one and laid out after each append */
+static void text_layout_test_log_draw(Canvas* canvas) {
+    char* log = malloc(TEXT_LAYOUT_TEST_LOG_SIZE);
+    size_t size = 0;
+    log[0] = '\0';
+
+    TextLayout* extended = text_layout_alloc(TEXT_LAYOUT_TEST_WIDTH);
+    text_layout_set_text(extended, log);
+    uint32_t cycles = DWT->CYCCNT;
+    for(size_t i = 0; size + TEXT_LAYOUT_TEST_LOG_LINE_SIZE < TEXT_LAYOUT_TEST_LOG_SIZE; i++) {
+        size += snprintf(
+            &log[size],
+            TEXT_LAYOUT_TEST_LOG_LINE_SIZE,
+            "%05u: log message long enough to be wrapped\n",
+            (unsigned)i);
+        text_layout_extend_text(extended, log);
+        text_layout_update(extended, canvas);
+    }
+    text_layout_test_log_cycles = DWT->CYCCNT - cycles;
+
+    TextLayout* full = text_layout_alloc(TEXT_LAYOUT_TEST_WIDTH);
+    text_layout_set_text(full, log);
+    cycles = DWT->CYCCNT;
+    text_layout_update(full, canvas);
+    text_layout_test_full_cycles = DWT->CYCCNT - cycles;
+
+    text_layout_test_log_equal = text_layout_get_lines_count(full) ==
+                                 text_layout_get_lines_count(extended);
+    FURI_LOG_I(
+        TAG,
+        "%u bytes, %u lines: appended %lu cycles, laid out at once %lu cycles",
+        (unsigned)size,
+        (unsigned)text_layout_get_lines_count(full),
+        text_layout_test_log_cycles,
+        text_layout_test_full_cycles);
+
+    text_layout_free(full);
+    text_layout_free(extended);
+    free(log);
+}
+
+MU_TEST(text_layout_test_log) {
+    text_layout_test_run_draw(text_layout_test_log_draw);
+    mu_check(text_layout_test_log_equal);
+    // each append lays out only new line, total is linear in log size
+    mu_check(text_layout_test_log_cycles < text_layout_test_full_cycles * 4);
+}
+
+static bool text_layout_test_get_pixel(Canvas* canvas, uint8_t x, uint8_t y) {
+    uint8_t* buffer = canvas_get_buffer(canvas);
+    return buffer[(y / 8) * canvas_width(canvas) + x] & (1 << (y % 8));
+}
+
+/* Finds which first line TextBox shows by drawing lines from each position */
+static void text_layout_test_scroll_draw(Canvas* canvas) {
+    static bool text_box_pixels[TEXT_LAYOUT_TEST_AREA_WIDTH * TEXT_LAYOUT_TEST_AREA_HEIGHT];
+
+    view_draw(text_box_get_view(text_box), canvas);
+    for(uint8_t y = 0; y < TEXT_LAYOUT_TEST_AREA_HEIGHT; y++) {
+        for(uint8_t x = 0; x < TEXT_LAYOUT_TEST_AREA_WIDTH; x++) {
+            text_box_pixels[y * TEXT_LAYOUT_TEST_AREA_WIDTH + x] = text_layout_test_get_pixel(
+                canvas, TEXT_LAYOUT_TEST_AREA_X + x, TEXT_LAYOUT_TEST_AREA_Y + y);
+        }
+    }
+
+    TextLayout* text_layout = text_layout_alloc(TEXT_LAYOUT_TEST_WIDTH);
+    text_layout_set_text(text_layout, text_layout_test_text);
+    text_layout_update(text_layout, canvas);
+    // same lines as TextBox draws, last one can be cut by screen edge
+    uint8_t font_height = canvas_current_font_height(canvas);
+    size_t lines_num = (canvas_height(canvas) - 11 + font_height - 1) / font_height;
+
+    text_layout_test_scroll_pos = -1;
+    for(size_t first_line = 0; first_line < text_layout_get_lines_count(text_layout);
+        first_line++) {
+        canvas_clear(canvas);
+        text_layout_draw(text_layout, canvas, 3, 11, first_line, lines_num);
+
+        bool equal = true;
+        for(uint8_t y = 0; equal && (y < TEXT_LAYOUT_TEST_AREA_HEIGHT); y++) {
+            for(uint8_t x = 0; equal && (x < TEXT_LAYOUT_TEST_AREA_WIDTH); x++) {
+                equal = text_box_pixels[y * TEXT_LAYOUT_TEST_AREA_WIDTH + x] ==
+                        text_layout_test_get_pixel(
+                            canvas, TEXT_LAYOUT_TEST_AREA_X + x, TEXT_LAYOUT_TEST_AREA_Y + y);
+            }
+        }
+        if(equal) {
+            text_layout_test_scroll_pos = first_line;
+            break;
+        }
+    }
+
+    text_layout_free(text_layout);
+}
+
+static void text_layout_test_scroll_press(InputKey key, size_t count) {
+    InputEvent event = {.type = InputTypeShort, .key = key};
+    for(size_t i = 0; i < count; i++) {
+        view_input(text_box_get_view(text_box), &event);
+    }
+}
+
+MU_TEST(text_layout_test_scroll) {
+    // 10 lines, 5 of them fit on screen
+    char* text = text_layout_test_text;
+    for(size_t i = 0; i < 10; i++) {
+        text += sprintf(text, "%sline %u", i ? "\n" : "", i);
+    }
+
+    text_box = text_box_alloc();
+    text_box_set_text(text_box, text_layout_test_text);
+
+    text_layout_test_run_draw(text_layout_test_scroll_draw);
+    mu_assert_int_eq(0, text_layout_test_scroll_pos);
+
+    text_layout_test_scroll_press(InputKeyDown, 3);
+    text_layout_test_run_draw(text_layout_test_scroll_draw);
+    mu_assert_int_eq(3, text_layout_test_scroll_pos);
+
+    // scrolling stops when last line is shown
+    text_layout_test_scroll_press(InputKeyDown, 10);
+    text_layout_test_run_draw(text_layout_test_scroll_draw);
+    mu_assert_int_eq(5, text_layout_test_scroll_pos);
+
+    text_layout_test_scroll_press(InputKeyUp, 10);
+    text_layout_test_run_draw(text_layout_test_scroll_draw);
+    mu_assert_int_eq(0, text_layout_test_scroll_pos);
+
+    // focus on end shows last lines when text is extended
+    text_box_reset(text_box);
+    text_box_set_font(text_box, TextBoxFontText);
+    text_box_set_focus(text_box, TextBoxFocusEnd);
+    text_box_set_text(text_box, "line 0");
+    text_layout_test_run_draw(text_layout_test_scroll_draw);
+    mu_assert_int_eq(0, text_layout_test_scroll_pos);
+
+    text_box_extend_text(text_box, text_layout_test_text);
+    text_layout_test_run_draw(text_layout_test_scroll_draw);
+    mu_assert_int_eq(5, text_layout_test_scroll_pos);
+
+    text_box_free(text_box);
+}
+
+MU_TEST_SUITE(text_layout_suite) {
+    MU_RUN_TEST(text_layout_test_line_breaks);
+    MU_RUN_TEST(text_layout_test_extend);
+    MU_RUN_TEST(text_layout_test_log);
+    MU_RUN_TEST(text_layout_test_scroll);
+}
+
+int run_minunit_test_text_layout() {
+    MU_RUN_SUITE(text_layout_suite);
+    return MU_EXIT_CODE;
+}
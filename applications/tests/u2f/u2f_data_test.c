@@ -0,0 +1,138 @@
+#include <furi.h>
+#include <storage/storage.h>
+#include <u2f/u2f_data.h>
+#include "../minunit.h"
+
+#define TAG "UnitTestsU2f"
+
+/* Same paths as in u2f_data.c, real counter is kept in backup during tests */
+#define U2F_TEST_CNT_FILE "/any/u2f/cnt.u2f"
+#define U2F_TEST_CNT_TEMP_FILE "/any/u2f/cnt.tmp"
+#define U2F_TEST_CNT_BACKUP_FILE "/any/u2f/cnt.bak"
+
+static Storage* storage;
+static bool u2f_test_has_backup;
+
+static void u2f_test_setup() {
+    storage = furi_record_open("storage");
+    storage_common_mkdir(storage, "/any/u2f");
+    if(storage_common_stat(storage, U2F_TEST_CNT_FILE, NULL) == FSE_NOT_EXIST) {
+        // Real counter may be left in temporary file by interrupted write
+        storage_common_rename(storage, U2F_TEST_CNT_TEMP_FILE, U2F_TEST_CNT_FILE);
+    }
+    if(storage_common_stat(storage, U2F_TEST_CNT_BACKUP_FILE, NULL) == FSE_OK) {
+        // Previous run was interrupted, backup holds real counter
+        storage_common_remove(storage, U2F_TEST_CNT_FILE);
+        u2f_test_has_backup = true;
+    } else {
+        u2f_test_has_backup =
+            storage_common_rename(storage, U2F_TEST_CNT_FILE, U2F_TEST_CNT_BACKUP_FILE) ==
+            FSE_OK;
+    }
+    storage_common_remove(storage, U2F_TEST_CNT_TEMP_FILE);
+}
+
+static void u2f_test_teardown() {
+    storage_common_remove(storage, U2F_TEST_CNT_FILE);
+    storage_common_remove(storage, U2F_TEST_CNT_TEMP_FILE);
+    if(u2f_test_has_backup) {
+        storage_common_rename(storage, U2F_TEST_CNT_BACKUP_FILE, U2F_TEST_CNT_FILE);
+    }
+    furi_record_close("storage");
+}
+
+static bool u2f_test_write_file(const char* path, const char* data) {
+    File* file = storage_file_alloc(storage);
+    bool result = storage_file_open(file, path, FSAM_WRITE, FSOM_CREATE_ALWAYS) &&
+                  (storage_file_write(file, data, strlen(data)) == strlen(data));
+    storage_file_close(file);
+    storage_file_free(file);
+    return result;
+}
+
+MU_TEST(u2f_test_cnt_write_read) {
+    uint32_t counter = 0;
+    mu_check(!u2f_data_cnt_exists());
+    mu_check(!u2f_data_cnt_read(&counter));
+
+    mu_check(u2f_data_cnt_write(100));
+    mu_check(u2f_data_cnt_read(&counter));
+    mu_assert_int_eq(100, counter);
+
+    // Old file is replaced, temporary file doesn't stay
+    mu_check(u2f_data_cnt_write(132));
+    mu_check(u2f_data_cnt_read(&counter));
+    mu_assert_int_eq(132, counter);
+    mu_check(storage_common_stat(storage, U2F_TEST_CNT_TEMP_FILE, NULL) == FSE_NOT_EXIST);
+}
+
+MU_TEST(u2f_test_cnt_interrupted_write) {
+    uint32_t counter = 0;
+    mu_check(u2f_data_cnt_write(42));
+
+    // Power loss after old file removal: complete temporary file is used
+    mu_check(storage_common_rename(storage, U2F_TEST_CNT_FILE, U2F_TEST_CNT_TEMP_FILE) == FSE_OK);
+    mu_check(u2f_data_cnt_exists());
+    mu_check(u2f_data_cnt_read(&counter));
+    mu_assert_int_eq(42, counter);
+    mu_check(storage_common_stat(storage, U2F_TEST_CNT_FILE, NULL) == FSE_OK);
+
+    // Power loss while temporary file is written: old counter stays
+    mu_check(u2f_test_write_file(U2F_TEST_CNT_TEMP_FILE, "Filetype: Flipper U2F Co"));
+    mu_check(u2f_data_cnt_read(&counter));
+    mu_assert_int_eq(42, counter);
+
+    // Leftover temporary file doesn't prevent next write
+    mu_check(u2f_data_cnt_write(43));
+    mu_check(u2f_data_cnt_read(&counter));
+    mu_assert_int_eq(43, counter);
+}
+
+MU_TEST(u2f_test_cnt_interrupted_first_write) {
+    uint32_t counter = 0;
+
+    // Power loss while first counter is written: no valid counter existed, it can be reset
+    mu_check(u2f_test_write_file(U2F_TEST_CNT_TEMP_FILE, "Filetype: Flipper U2F Co"));
+    mu_check(!u2f_data_cnt_read(&counter));
+    mu_check(!u2f_data_cnt_exists());
+    mu_check(storage_common_stat(storage, U2F_TEST_CNT_TEMP_FILE, NULL) == FSE_NOT_EXIST);
+
+    // Complete, but not valid temporary file is discarded too
+    mu_check(u2f_test_write_file(
+        U2F_TEST_CNT_TEMP_FILE,
+        "Filetype: Flipper U2F Counter File\nVersion: 1\n"
+        "IV: 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00\n"
+        "Data: 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 "
+        "00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 "
+        "00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00\n"));
+    mu_check(!u2f_data_cnt_read(&counter));
+    mu_check(!u2f_data_cnt_exists());
+
+    mu_check(u2f_data_cnt_write(0));
+    mu_check(u2f_data_cnt_read(&counter));
+    mu_assert_int_eq(0, counter);
+}
+
+MU_TEST(u2f_test_cnt_damaged) {
+    uint32_t counter = 0;
+    mu_check(u2f_test_write_file(
+        U2F_TEST_CNT_FILE, "Filetype: Flipper U2F Counter File\nVersion: 1\nIV: 00 11"));
+
+    // Damaged counter is reported as existing, so it is not reset to 0
+    mu_check(!u2f_data_cnt_read(&counter));
+    mu_check(u2f_data_cnt_exists());
+}
+
+MU_TEST_SUITE(u2f_data_suite) {
+    MU_SUITE_CONFIGURE(&u2f_test_setup, &u2f_test_teardown);
+
+    MU_RUN_TEST(u2f_test_cnt_write_read);
+    MU_RUN_TEST(u2f_test_cnt_interrupted_write);
+    MU_RUN_TEST(u2f_test_cnt_interrupted_first_write);
+    MU_RUN_TEST(u2f_test_cnt_damaged);
+}
+
+int run_minunit_test_u2f_data() {
+    MU_RUN_SUITE(u2f_data_suite);
+    return MU_EXIT_CODE;
+}
@@ -7,6 +7,7 @@
 
 #include "toolbox/sha256.h"
 #include "toolbox/hmac_sha256.h"
+#include "toolbox/sha256_uecc.h"
 #include "micro-ecc/uECC.h"
 
 #define TAG "U2F"
@@ -16,6 +17,9 @@
 #define U2F_CMD_AUTHENTICATE 0x02
 #define U2F_CMD_VERSION 0x03
 
+// Counter values reserved by one storage write
+#define U2F_COUNTER_RESERVE 32
+
 typedef enum {
     U2fCheckOnly = 0x07, // "check-only" - only check key handle, don't send auth response
     U2fEnforce =
@@ -80,6 +84,7 @@ struct U2fData {
     uint8_t device_key[32];
     uint8_t cert_key[32];
     uint32_t counter;
+    uint32_t counter_reserved; // Stored counter value, all values below it can be used
     const struct uECC_Curve_t* p_curve;
     bool ready;
     bool user_present;
@@ -92,12 +97,25 @@ static int u2f_uecc_random(uint8_t* dest, unsigned size) {
     return 1;
 }
 
+/* Deterministic ECDSA (RFC 6979): nonce is derived from key and hash,
+ * signature doesn't depend on RNG quality */
+static void
+    u2f_ecc_sign(U2fData* U2F, const uint8_t* key, const uint8_t* hash, uint8_t* signature) {
+    sha256_uecc_context hash_ctx;
+    sha256_uecc_init(&hash_ctx);
+    uECC_sign_deterministic(key, hash, 32, &hash_ctx.uECC, signature, U2F->p_curve);
+}
+
 U2fData* u2f_alloc() {
     return malloc(sizeof(U2fData));
 }
 
 void u2f_free(U2fData* U2F) {
     furi_assert(U2F);
+    // Give back unused reserved values
+    if(U2F->ready && (U2F->counter != U2F->counter_reserved)) {
+        u2f_data_cnt_write(U2F->counter);
+    }
     free(U2F);
 }
 
@@ -120,13 +138,19 @@ bool u2f_init(U2fData* U2F) {
         }
     }
     if(u2f_data_cnt_read(&U2F->counter) == false) {
-        FURI_LOG_W(TAG, "Counter loading error, resetting counter");
+        // Counter must never go back: damaged counter is not reset
+        if(u2f_data_cnt_exists()) {
+            FURI_LOG_E(TAG, "Counter file is damaged");
+            return false;
+        }
+        FURI_LOG_W(TAG, "Counter not found, resetting counter");
         U2F->counter = 0;
         if(u2f_data_cnt_write(0) == false) {
             FURI_LOG_E(TAG, "Counter write failed");
             return false;
         }
     }
+    U2F->counter_reserved = U2F->counter;
 
     U2F->p_curve = uECC_secp256r1();
     uECC_set_rng(u2f_uecc_random);
@@ -233,7 +257,7 @@ static uint16_t u2f_register(U2fData* U2F, uint8_t* buf) {
     sha256_update(&sha_ctx, (uint8_t*)&pub_key, 65);
     sha256_finish(&sha_ctx, hash);
 
-    uECC_sign(U2F->cert_key, hash, 32, signature, U2F->p_curve);
+    u2f_ecc_sign(U2F, U2F->cert_key, hash, signature);
 
     // Encode response message
     resp->reserved = 0x05;
@@ -306,7 +330,19 @@ static uint16_t u2f_authenticate(U2fData* U2F, uint8_t* buf) {
         return 2;
     }
 
-    uECC_sign(priv_key, hash, 32, signature, U2F->p_curve);
+    /* Counter must never go back, even after power loss. Instead of writing every value
+     * we store upper bound of values that can be used and update it when it's reached */
+    if(U2F->counter >= U2F->counter_reserved) {
+        if(u2f_data_cnt_write(U2F->counter + U2F_COUNTER_RESERVE)) {
+            U2F->counter_reserved = U2F->counter + U2F_COUNTER_RESERVE;
+        } else {
+            FURI_LOG_E(TAG, "Counter write failed");
+            memcpy(&buf[0], state_not_supported, 2);
+            return 2;
+        }
+    }
+
+    u2f_ecc_sign(U2F, priv_key, hash, signature);
 
     resp->user_present = flags;
     resp->counter = U2F->counter;
@@ -315,7 +351,6 @@ static uint16_t u2f_authenticate(U2fData* U2F, uint8_t* buf) {
 
     FURI_LOG_D(TAG, "Counter: %lu", U2F->counter);
     U2F->counter++;
-    u2f_data_cnt_write(U2F->counter);
 
     if(U2F->callback != NULL) U2F->callback(U2fNotifyAuthSuccess, U2F->context);
 
@@ -12,6 +12,7 @@
 #define U2F_CERT_KEY_FILE U2F_DATA_FOLDER "assets/cert_key.u2f"
 #define U2F_KEY_FILE U2F_DATA_FOLDER "key.u2f"
 #define U2F_CNT_FILE U2F_DATA_FOLDER "cnt.u2f"
+#define U2F_CNT_TEMP_FILE U2F_DATA_FOLDER "cnt.tmp"
 
 #define U2F_DATA_FILE_ENCRYPTION_KEY_SLOT_FACTORY 2
 #define U2F_DATA_FILE_ENCRYPTION_KEY_SLOT_UNIQUE 11
@@ -355,22 +356,27 @@ bool u2f_data_key_generate(uint8_t* device_key) {
     return state;
 }
 
-bool u2f_data_cnt_read(uint32_t* cnt_val) {
-    furi_assert(cnt_val);
+bool u2f_data_cnt_exists() {
+    Storage* storage = furi_record_open("storage");
+    bool exists = (storage_common_stat(storage, U2F_CNT_FILE, NULL) == FSE_OK) ||
+                  (storage_common_stat(storage, U2F_CNT_TEMP_FILE, NULL) == FSE_OK);
+    furi_record_close("storage");
+    return exists;
+}
 
+/* Reads encrypted counter from file, false if file is missing or incomplete */
+static bool u2f_data_cnt_file_read(
+    FlipperFormat* flipper_format,
+    const char* path,
+    uint8_t* iv,
+    uint8_t* cnt_encr) {
     bool state = false;
-    uint8_t iv[16];
-    U2fCounterData cnt;
-    uint8_t cnt_encr[48];
     uint32_t version = 0;
 
     string_t filetype;
     string_init(filetype);
 
-    Storage* storage = furi_record_open("storage");
-    FlipperFormat* flipper_format = flipper_format_file_alloc(storage);
-
-    if(flipper_format_file_open_existing(flipper_format, U2F_CNT_FILE)) {
+    if(flipper_format_file_open_existing(flipper_format, path)) {
         do {
             if(!flipper_format_read_header(flipper_format, filetype, &version)) {
                 FURI_LOG_E(TAG, "Missing or incorrect header");
@@ -389,6 +395,38 @@ bool u2f_data_cnt_read(uint32_t* cnt_val) {
                 FURI_LOG_E(TAG, "Missing data");
                 break;
             }
+            state = true;
+        } while(0);
+    }
+    flipper_format_file_close(flipper_format);
+    string_clear(filetype);
+    return state;
+}
+
+bool u2f_data_cnt_read(uint32_t* cnt_val) {
+    furi_assert(cnt_val);
+
+    bool state = false;
+    uint8_t iv[16];
+    U2fCounterData cnt;
+    uint8_t cnt_encr[48];
+
+    Storage* storage = furi_record_open("storage");
+    FlipperFormat* flipper_format = flipper_format_file_alloc(storage);
+
+    bool temp_used = false;
+    bool damaged = false;
+    bool loaded = u2f_data_cnt_file_read(flipper_format, U2F_CNT_FILE, iv, cnt_encr);
+    if(!loaded && storage_common_stat(storage, U2F_CNT_FILE, NULL) == FSE_NOT_EXIST &&
+       storage_common_stat(storage, U2F_CNT_TEMP_FILE, NULL) == FSE_OK) {
+        // Write was interrupted after old file removal or while first counter was written
+        temp_used = true;
+        loaded = u2f_data_cnt_file_read(flipper_format, U2F_CNT_TEMP_FILE, iv, cnt_encr);
+        damaged = !loaded;
+    }
+
+    if(loaded) {
+        do {
             if(!furi_hal_crypto_store_load_key(U2F_DATA_FILE_ENCRYPTION_KEY_SLOT_UNIQUE, iv)) {
                 FURI_LOG_E(TAG, "Unable to load encryption key");
                 break;
@@ -403,12 +441,26 @@ bool u2f_data_cnt_read(uint32_t* cnt_val) {
             if(cnt.control == U2F_COUNTER_CONTROL_VAL) {
                 *cnt_val = cnt.counter;
                 state = true;
+            } else {
+                FURI_LOG_E(TAG, "Control value mismatch");
+                damaged = true;
             }
         } while(0);
     }
+
+    if(temp_used && state) {
+        // Temporary file is complete and valid, it replaces removed old file
+        if(storage_common_rename(storage, U2F_CNT_TEMP_FILE, U2F_CNT_FILE) != FSE_OK) {
+            FURI_LOG_E(TAG, "Unable to restore counter file");
+        }
+    } else if(temp_used && damaged) {
+        // Old file is removed only after temporary one is written: no valid counter existed
+        FURI_LOG_W(TAG, "Discarding incomplete counter file");
+        storage_common_remove(storage, U2F_CNT_TEMP_FILE);
+    }
+
     flipper_format_free(flipper_format);
     furi_record_close("storage");
-    string_clear(filetype);
     return state;
 }
 
@@ -438,7 +490,8 @@ bool u2f_data_cnt_write(uint32_t cnt_val) {
     Storage* storage = furi_record_open("storage");
     FlipperFormat* flipper_format = flipper_format_file_alloc(storage);
 
-    if(flipper_format_file_open_always(flipper_format, U2F_CNT_FILE)) {
+    // Counter goes to temporary file, then replaces old one: torn write must not reset it
+    if(flipper_format_file_open_always(flipper_format, U2F_CNT_TEMP_FILE)) {
         do {
             if(!flipper_format_write_header_cstr(
                    flipper_format, U2F_COUNTER_FILE_TYPE, U2F_COUNTER_VERSION))
@@ -448,8 +501,14 @@ bool u2f_data_cnt_write(uint32_t cnt_val) {
             state = true;
         } while(0);
     }
-
+    state &= flipper_format_file_close(flipper_format);
     flipper_format_free(flipper_format);
+
+    if(state) {
+        FS_Error error = storage_common_remove(storage, U2F_CNT_FILE);
+        state = (error == FSE_OK || error == FSE_NOT_EXIST) &&
+                (storage_common_rename(storage, U2F_CNT_TEMP_FILE, U2F_CNT_FILE) == FSE_OK);
+    }
     furi_record_close("storage");
 
     return state;
@@ -18,6 +18,8 @@ bool u2f_data_key_load(uint8_t* device_key);
 
 bool u2f_data_key_generate(uint8_t* device_key);
 
+bool u2f_data_cnt_exists();
+
 bool u2f_data_cnt_read(uint32_t* cnt);
 
 bool u2f_data_cnt_write(uint32_t cnt);
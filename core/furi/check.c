@@ -1,5 +1,6 @@
 #include "check.h"
 #include "common_defines.h"
+#include "log.h"
 
 #include <furi_hal_console.h>
 #include <furi_hal_power.h>
@@ -41,6 +42,9 @@ void furi_crash(const char* message) {
         message = "Fatal Error";
     }
 
+    // Messages logged right before crash are still queued
+    furi_log_flush();
+
     furi_hal_console_puts("\r\n\033[0;31m[CRASH]");
     __furi_print_name();
     furi_hal_console_puts(message);
@@ -1,48 +1,207 @@
 #include "log.h"
 #include "check.h"
+#include "common_defines.h"
 #include <cmsis_os2.h>
 #include <furi_hal.h>
+#include <string.h>
 
 #define FURI_LOG_LEVEL_DEFAULT FuriLogLevelInfo
 
+/* Queue length, power of 2. Slots take 32 * 144 = 4608 bytes of .bss */
+#define FURI_LOG_SLOT_COUNT 32
+/* Formatted payload size, including terminator. Longer payload ends with "..." */
+#define FURI_LOG_PAYLOAD_SIZE 128
+#define FURI_LOG_TRUNCATED "..."
+/* Payload plus timestamp, level prefix with colors and tag */
+#define FURI_LOG_LINE_SIZE (FURI_LOG_PAYLOAD_SIZE + 64)
+
+#define FURI_LOG_THREAD_STACK_SIZE 1024
+#define FURI_LOG_THREAD_FLAG_PENDING (0x1)
+
+/* Slot sequence tells its state: equal to queue position it is free for
+ * producer at that position, position + 1 is written and ready for log thread.
+ * Log thread sets it to position + FURI_LOG_SLOT_COUNT after output. */
+typedef struct {
+    volatile uint32_t sequence;
+    uint32_t timestamp;
+    FuriLogLevel level;
+    const char* tag;
+    char payload[FURI_LOG_PAYLOAD_SIZE];
+} FuriLogSlot;
+
 typedef struct {
     FuriLogLevel log_level;
     FuriLogPuts puts;
     FuriLogTimestamp timetamp;
-    osMutexId_t mutex;
+
+    FuriLogSlot slots[FURI_LOG_SLOT_COUNT];
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    volatile uint32_t dropped;
+    osThreadId_t thread;
 } FuriLogParams;
 
 static FuriLogParams furi_log;
 
+static const char* const furi_log_prefixes[] = {
+    [FuriLogLevelError] = FURI_LOG_CLR_E "[E]",
+    [FuriLogLevelWarn] = FURI_LOG_CLR_W "[W]",
+    [FuriLogLevelInfo] = FURI_LOG_CLR_I "[I]",
+    [FuriLogLevelDebug] = FURI_LOG_CLR_D "[D]",
+    [FuriLogLevelTrace] = FURI_LOG_CLR_T "[T]",
+};
+
+static void furi_log_write(const FuriLogSlot* slot) {
+    char line[FURI_LOG_LINE_SIZE];
+    snprintf(
+        line,
+        sizeof(line),
+        "%lu %s[%s]: " FURI_LOG_CLR_RESET "%s\r\n",
+        slot->timestamp,
+        furi_log_prefixes[slot->level],
+        slot->tag,
+        slot->payload);
+    furi_log.puts(line);
+}
+
+static bool furi_log_write_next() {
+    uint32_t position = furi_log.tail;
+    FuriLogSlot* slot = &furi_log.slots[position % FURI_LOG_SLOT_COUNT];
+
+    if(__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != position + 1) {
+        return false;
+    }
+
+    furi_log_write(slot);
+    furi_log.tail = position + 1;
+    __atomic_store_n(&slot->sequence, position + FURI_LOG_SLOT_COUNT, __ATOMIC_RELEASE);
+    return true;
+}
+
+static void furi_log_format(char* payload, const char* format, va_list args) {
+    int length = vsnprintf(payload, FURI_LOG_PAYLOAD_SIZE, format, args);
+    if(length >= FURI_LOG_PAYLOAD_SIZE) {
+        memcpy(
+            &payload[FURI_LOG_PAYLOAD_SIZE - sizeof(FURI_LOG_TRUNCATED)],
+            FURI_LOG_TRUNCATED,
+            sizeof(FURI_LOG_TRUNCATED));
+    }
+}
+
+static void furi_log_write_dropped(uint32_t dropped) {
+    FuriLogSlot slot = {
+        .timestamp = furi_log.timetamp(),
+        .level = FuriLogLevelWarn,
+        .tag = "Log",
+    };
+    snprintf(slot.payload, sizeof(slot.payload), "%lu messages dropped", dropped);
+    furi_log_write(&slot);
+}
+
+static void furi_log_thread(void* context) {
+    UNUSED(context);
+    uint32_t dropped_reported = 0;
+
+    while(1) {
+        osThreadFlagsWait(FURI_LOG_THREAD_FLAG_PENDING, osFlagsWaitAny, osWaitForever);
+        while(furi_log_write_next()) {
+        }
+
+        uint32_t dropped = __atomic_load_n(&furi_log.dropped, __ATOMIC_RELAXED);
+        if(dropped != dropped_reported) {
+            furi_log_write_dropped(dropped - dropped_reported);
+            dropped_reported = dropped;
+        }
+    }
+}
+
 void furi_log_init() {
     // Set default logging parameters
     furi_log.log_level = FURI_LOG_LEVEL_DEFAULT;
     furi_log.puts = furi_hal_console_puts;
     furi_log.timetamp = furi_hal_get_tick;
-    furi_log.mutex = osMutexNew(NULL);
+
+    for(uint32_t i = 0; i < FURI_LOG_SLOT_COUNT; i++) {
+        furi_log.slots[i].sequence = i;
+    }
+    furi_log.head = 0;
+    furi_log.tail = 0;
+    furi_log.dropped = 0;
+
+    const osThreadAttr_t attr = {
+        .name = "LogWorker",
+        .stack_size = FURI_LOG_THREAD_STACK_SIZE,
+        .priority = osPriorityLow,
+    };
+    furi_log.thread = osThreadNew(furi_log_thread, NULL, &attr);
+    furi_check(furi_log.thread);
 }
 
-void furi_log_print(FuriLogLevel level, const char* format, ...) {
-    if(level <= furi_log.log_level && osMutexAcquire(furi_log.mutex, osWaitForever) == osOK) {
-        string_t string;
+void furi_log_print(FuriLogLevel level, const char* tag, const char* format, ...) {
+    if(level > furi_log.log_level || level <= FuriLogLevelNone) {
+        return;
+    }
+
+    va_list args;
+    va_start(args, format);
 
-        // Timestamp
-        string_init_printf(string, "%lu ", furi_log.timetamp());
-        furi_log.puts(string_get_cstr(string));
-        string_clear(string);
+    if(osKernelGetState() != osKernelRunning) {
+        // Single context before kernel start, nothing to defer output to
+        FuriLogSlot slot = {.timestamp = furi_log.timetamp(), .level = level, .tag = tag};
+        furi_log_format(slot.payload, format, args);
+        furi_log_write(&slot);
+    } else {
+        // Reserve position: slot is free if log thread is done with its previous lap
+        uint32_t position = __atomic_load_n(&furi_log.head, __ATOMIC_RELAXED);
+        FuriLogSlot* slot = NULL;
+        while(1) {
+            slot = &furi_log.slots[position % FURI_LOG_SLOT_COUNT];
+            int32_t diff =
+                (int32_t)(__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) - position);
+            if(diff == 0) {
+                if(__atomic_compare_exchange_n(
+                       &furi_log.head,
+                       &position,
+                       position + 1,
+                       true,
+                       __ATOMIC_RELAXED,
+                       __ATOMIC_RELAXED)) {
+                    break;
+                }
+            } else if(diff < 0) {
+                slot = NULL;
+                break;
+            } else {
+                position = __atomic_load_n(&furi_log.head, __ATOMIC_RELAXED);
+            }
+        }
 
-        va_list args;
-        va_start(args, format);
-        string_init_vprintf(string, format, args);
-        va_end(args);
+        if(slot) {
+            slot->timestamp = furi_log.timetamp();
+            slot->level = level;
+            slot->tag = tag;
+            furi_log_format(slot->payload, format, args);
+            __atomic_store_n(&slot->sequence, position + 1, __ATOMIC_RELEASE);
+        } else {
+            __atomic_add_fetch(&furi_log.dropped, 1, __ATOMIC_RELAXED);
+        }
+        osThreadFlagsSet(furi_log.thread, FURI_LOG_THREAD_FLAG_PENDING);
+    }
 
-        furi_log.puts(string_get_cstr(string));
-        string_clear(string);
+    va_end(args);
+}
 
-        osMutexRelease(furi_log.mutex);
+void furi_log_flush() {
+    if(furi_log.puts) {
+        while(furi_log_write_next()) {
+        }
     }
 }
 
+uint32_t furi_log_get_dropped() {
+    return __atomic_load_n(&furi_log.dropped, __ATOMIC_RELAXED);
+}
+
 void furi_log_set_level(FuriLogLevel level) {
     if(level == FuriLogLevelDefault) {
         level = FURI_LOG_LEVEL_DEFAULT;
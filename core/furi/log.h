@@ -37,26 +37,49 @@ typedef enum {
 typedef void (*FuriLogPuts)(const char* data);
 typedef uint32_t (*FuriLogTimestamp)(void);
 
+/** Initialize logging and start log thread. For internal use only.
+ */
 void furi_log_init();
-void furi_log_print(FuriLogLevel level, const char* format, ...);
+
+/** Log message, usually through FURI_LOG_* macros
+ *
+ * Message is formatted into a fixed size slot of a lock-free queue and is
+ * written by log thread later, caller doesn't wait for output and doesn't
+ * allocate. Messages are written synchronously until kernel is started.
+ * Queue takes about 4.6 KB of RAM, log thread stack 1 KB.
+ *
+ * @param      level   message level
+ * @param      tag     message tag, pointer is kept until message is written
+ * @param      format  payload format, payload over 127 chars is cut and ends with "..."
+ * @note       Thread safe. Message is dropped if queue is full. Not meant for
+ *             ISR: payload is formatted with vsnprintf in caller context.
+ */
+void furi_log_print(FuriLogLevel level, const char* tag, const char* format, ...);
+
+/** Write queued messages from caller context. For internal use only,
+ * called by crash handler with interrupts disabled.
+ */
+void furi_log_flush();
+
+/** Get dropped messages count
+ *
+ * @return     messages dropped on queue overflow since start
+ */
+uint32_t furi_log_get_dropped();
+
 void furi_log_set_level(FuriLogLevel level);
 FuriLogLevel furi_log_get_level();
 void furi_log_set_puts(FuriLogPuts puts);
 void furi_log_set_timestamp(FuriLogTimestamp timestamp);
 
-#define FURI_LOG_FORMAT(log_letter, tag, format) \
-    FURI_LOG_CLR_##log_letter "[" #log_letter "][" tag "]: " FURI_LOG_CLR_RESET format "\r\n"
-#define FURI_LOG_SHOW(tag, format, log_level, log_letter, ...) \
-    furi_log_print(log_level, FURI_LOG_FORMAT(log_letter, tag, format), ##__VA_ARGS__)
-
-#define FURI_LOG_E(tag, format, ...) \
-    FURI_LOG_SHOW(tag, format, FuriLogLevelError, E, ##__VA_ARGS__)
-#define FURI_LOG_W(tag, format, ...) FURI_LOG_SHOW(tag, format, FuriLogLevelWarn, W, ##__VA_ARGS__)
-#define FURI_LOG_I(tag, format, ...) FURI_LOG_SHOW(tag, format, FuriLogLevelInfo, I, ##__VA_ARGS__)
-#define FURI_LOG_D(tag, format, ...) \
-    FURI_LOG_SHOW(tag, format, FuriLogLevelDebug, D, ##__VA_ARGS__)
-#define FURI_LOG_T(tag, format, ...) \
-    FURI_LOG_SHOW(tag, format, FuriLogLevelTrace, T, ##__VA_ARGS__)
+#define FURI_LOG_SHOW(tag, format, log_level, ...) \
+    furi_log_print(log_level, tag, format, ##__VA_ARGS__)
+
+#define FURI_LOG_E(tag, format, ...) FURI_LOG_SHOW(tag, format, FuriLogLevelError, ##__VA_ARGS__)
+#define FURI_LOG_W(tag, format, ...) FURI_LOG_SHOW(tag, format, FuriLogLevelWarn, ##__VA_ARGS__)
+#define FURI_LOG_I(tag, format, ...) FURI_LOG_SHOW(tag, format, FuriLogLevelInfo, ##__VA_ARGS__)
+#define FURI_LOG_D(tag, format, ...) FURI_LOG_SHOW(tag, format, FuriLogLevelDebug, ##__VA_ARGS__)
+#define FURI_LOG_T(tag, format, ...) FURI_LOG_SHOW(tag, format, FuriLogLevelTrace, ##__VA_ARGS__)
 
 #ifdef __cplusplus
 }
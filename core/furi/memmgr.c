@@ -1,4 +1,5 @@
 #include "memmgr.h"
+#include "memmgr_heap.h"
 #include <string.h>
 
 extern void* pvPortMalloc(size_t xSize);
@@ -47,7 +48,7 @@ char* strdup(const char* s) {
 }
 
 size_t memmgr_get_free_heap(void) {
-    return xPortGetFreeHeapSize();
+    return xPortGetFreeHeapSize() + memmgr_heap_get_pool_free();
 }
 
 size_t memmgr_get_minimum_free_heap(void) {
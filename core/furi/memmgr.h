@@ -19,13 +19,13 @@ extern "C" {
 
 /** Get free heap size
  *
- * @return     free heap size in bytes
+ * @return     free heap size in bytes, free small allocation pool space included
  */
 size_t memmgr_get_free_heap(void);
 
 /** Get heap watermark
  *
- * @return     minimum heap in bytes
+ * @return     minimum heap in bytes, small allocation pools excluded
  */
 size_t memmgr_get_minimum_free_heap(void);
 
@@ -126,6 +126,42 @@ DICT_DEF2(
 /* Thread allocation tracing storage */
 static MemmgrHeapThreadDict_t memmgr_heap_thread_dict = {0};
 static volatile uint32_t memmgr_heap_thread_trace_depth = 0;
+/* Successful allocations since start */
+static volatile size_t memmgr_heap_alloc_count = 0;
+
+/* Small allocation pools. Pool arena is reserved at the start of heap space and
+split into pages, page serves one size class while it has allocated slots.
+Slots have no block header, pointer range tells slot from heap block.
+Arena takes 1/MEMMGR_HEAP_POOL_HEAP_SHARE of heap space, so it follows heap size
+of the target and large blocks keep most of the heap. */
+#define MEMMGR_HEAP_POOL_PAGE_SIZE 512
+#define MEMMGR_HEAP_POOL_PAGE_COUNT_MAX 32
+#define MEMMGR_HEAP_POOL_HEAP_SHARE 16
+#define MEMMGR_HEAP_POOL_PAGE_FREE 0xFF
+
+/* Multiples of portBYTE_ALIGNMENT dividing page without waste, at most 32 slots per page */
+static const uint16_t memmgr_heap_pool_sizes[MEMMGR_HEAP_POOL_CLASSES] = {16, 32, 64, 128, 256};
+
+typedef struct {
+    uint8_t pool; /* size class or MEMMGR_HEAP_POOL_PAGE_FREE */
+    uint32_t free_mask; /* bit per free slot */
+} MemmgrHeapPoolPage;
+
+typedef struct {
+    uint8_t page; /* page to allocate from first */
+    size_t used;
+    uint32_t hits;
+    uint32_t misses;
+} MemmgrHeapPool;
+
+static uint8_t* memmgr_heap_pool_arena = NULL;
+static size_t memmgr_heap_pool_page_count = 0;
+static size_t memmgr_heap_pool_size = 0;
+static MemmgrHeapPoolPage memmgr_heap_pool_pages[MEMMGR_HEAP_POOL_PAGE_COUNT_MAX];
+static MemmgrHeapPool memmgr_heap_pools[MEMMGR_HEAP_POOL_CLASSES];
+/* Bytes in allocated slots */
+static size_t memmgr_heap_pool_used = 0;
+static volatile bool memmgr_heap_pool_enabled = true;
 
 /* Initialize tracing storage on start */
 void memmgr_heap_init() {
@@ -208,6 +244,124 @@ static inline void traceFREE(void* pointer, size_t size) {
     }
 }
 
+/* Returns arena size taken from heap space */
+static size_t memmgr_heap_pool_init(uint8_t* arena, size_t heap_size) {
+    memmgr_heap_pool_arena = arena;
+    memmgr_heap_pool_page_count = MIN(
+        heap_size / MEMMGR_HEAP_POOL_HEAP_SHARE / MEMMGR_HEAP_POOL_PAGE_SIZE,
+        (size_t)MEMMGR_HEAP_POOL_PAGE_COUNT_MAX);
+    memmgr_heap_pool_size = memmgr_heap_pool_page_count * MEMMGR_HEAP_POOL_PAGE_SIZE;
+    for(size_t i = 0; i < memmgr_heap_pool_page_count; i++) {
+        memmgr_heap_pool_pages[i].pool = MEMMGR_HEAP_POOL_PAGE_FREE;
+        memmgr_heap_pool_pages[i].free_mask = 0;
+    }
+    return memmgr_heap_pool_size;
+}
+
+static uint32_t memmgr_heap_pool_full_mask(uint8_t pool) {
+    size_t slots = MEMMGR_HEAP_POOL_PAGE_SIZE / memmgr_heap_pool_sizes[pool];
+    return (slots >= 32) ? UINT32_MAX : ((1UL << slots) - 1);
+}
+
+static inline bool memmgr_heap_pool_contains(void* pointer) {
+    return memmgr_heap_pool_arena && ((uint8_t*)pointer >= memmgr_heap_pool_arena) &&
+           ((uint8_t*)pointer < memmgr_heap_pool_arena + memmgr_heap_pool_size);
+}
+
+/* Called with scheduler suspended, NULL if size doesn't fit pools or pool is full */
+static void* memmgr_heap_pool_alloc(size_t size) {
+    if(!memmgr_heap_pool_enabled || memmgr_heap_pool_arena == NULL || size == 0 ||
+       size > memmgr_heap_pool_sizes[MEMMGR_HEAP_POOL_CLASSES - 1]) {
+        return NULL;
+    }
+
+    uint8_t pool = 0;
+    while(memmgr_heap_pool_sizes[pool] < size) {
+        pool++;
+    }
+    MemmgrHeapPool* pool_data = &memmgr_heap_pools[pool];
+
+    // Page from last allocation, then any page of the class, then a free one
+    size_t page = pool_data->page;
+    if(memmgr_heap_pool_pages[page].pool != pool || !memmgr_heap_pool_pages[page].free_mask) {
+        size_t free_page = memmgr_heap_pool_page_count;
+        for(page = 0; page < memmgr_heap_pool_page_count; page++) {
+            if(memmgr_heap_pool_pages[page].pool == pool &&
+               memmgr_heap_pool_pages[page].free_mask) {
+                break;
+            }
+            if(memmgr_heap_pool_pages[page].pool == MEMMGR_HEAP_POOL_PAGE_FREE &&
+               free_page == memmgr_heap_pool_page_count) {
+                free_page = page;
+            }
+        }
+
+        if(page == memmgr_heap_pool_page_count) {
+            if(free_page == memmgr_heap_pool_page_count) {
+                pool_data->misses++;
+                return NULL;
+            }
+            page = free_page;
+            memmgr_heap_pool_pages[page].pool = pool;
+            memmgr_heap_pool_pages[page].free_mask = memmgr_heap_pool_full_mask(pool);
+        }
+        pool_data->page = page;
+    }
+
+    MemmgrHeapPoolPage* page_data = &memmgr_heap_pool_pages[page];
+    uint32_t slot = __builtin_ctz(page_data->free_mask);
+    page_data->free_mask &= ~(1UL << slot);
+
+    pool_data->used++;
+    pool_data->hits++;
+    memmgr_heap_pool_used += memmgr_heap_pool_sizes[pool];
+
+    return memmgr_heap_pool_arena + page * MEMMGR_HEAP_POOL_PAGE_SIZE +
+           slot * memmgr_heap_pool_sizes[pool];
+}
+
+/* Called with scheduler suspended */
+static void memmgr_heap_pool_free(void* pointer) {
+    size_t offset = (uint8_t*)pointer - memmgr_heap_pool_arena;
+    MemmgrHeapPoolPage* page_data = &memmgr_heap_pool_pages[offset / MEMMGR_HEAP_POOL_PAGE_SIZE];
+    furi_check(page_data->pool < MEMMGR_HEAP_POOL_CLASSES);
+
+    uint8_t pool = page_data->pool;
+    size_t size = memmgr_heap_pool_sizes[pool];
+    offset %= MEMMGR_HEAP_POOL_PAGE_SIZE;
+    uint32_t slot = offset / size;
+    uint32_t full_mask = memmgr_heap_pool_full_mask(pool);
+
+    // Pointer to slot start, slot is allocated
+    furi_check((offset % size) == 0);
+    furi_check(full_mask & (1UL << slot));
+    furi_check(!(page_data->free_mask & (1UL << slot)));
+
+    traceFREE(pointer, size);
+    memset(pointer, 0, size);
+    page_data->free_mask |= 1UL << slot;
+    memmgr_heap_pools[pool].used--;
+    memmgr_heap_pool_used -= size;
+
+    // Empty page can serve other class
+    if(page_data->free_mask == full_mask) {
+        page_data->pool = MEMMGR_HEAP_POOL_PAGE_FREE;
+        page_data->free_mask = 0;
+    }
+}
+
+void memmgr_heap_set_pool_enabled(bool enabled) {
+    memmgr_heap_pool_enabled = enabled;
+}
+
+size_t memmgr_heap_get_pool_free() {
+    return memmgr_heap_pool_size - memmgr_heap_pool_used;
+}
+
+size_t memmgr_heap_get_alloc_count() {
+    return memmgr_heap_alloc_count;
+}
+
 size_t memmgr_heap_get_max_free_block() {
     size_t max_free_size = 0;
     BlockLink_t* pxBlock;
@@ -239,6 +393,45 @@ void memmgr_heap_printf_free_blocks() {
     //osKernelUnlock();
 }
 
+void memmgr_heap_get_stats(MemmgrHeapStats* stats) {
+    furi_assert(stats);
+    memset(stats, 0, sizeof(MemmgrHeapStats));
+    osKernelLock();
+
+    stats->free_size = xFreeBytesRemaining;
+    stats->pool_free_size = memmgr_heap_get_pool_free();
+    BlockLink_t* pxBlock = xStart.pxNextFreeBlock;
+    while(pxBlock->pxNextFreeBlock != NULL) {
+        size_t bin = 0;
+        while((bin < MEMMGR_HEAP_HISTOGRAM_BINS - 1) && (pxBlock->xBlockSize >= (32U << bin))) {
+            bin++;
+        }
+        stats->free_block_histogram[bin]++;
+        stats->free_blocks++;
+        stats->max_free_block = MAX(stats->max_free_block, pxBlock->xBlockSize);
+        pxBlock = pxBlock->pxNextFreeBlock;
+    }
+
+    stats->pool_pages = memmgr_heap_pool_page_count;
+    for(size_t i = 0; i < MEMMGR_HEAP_POOL_CLASSES; i++) {
+        stats->pools[i].size = memmgr_heap_pool_sizes[i];
+        stats->pools[i].used = memmgr_heap_pools[i].used;
+        stats->pools[i].hits = memmgr_heap_pools[i].hits;
+        stats->pools[i].misses = memmgr_heap_pools[i].misses;
+    }
+    for(size_t i = 0; i < memmgr_heap_pool_page_count; i++) {
+        uint8_t pool = memmgr_heap_pool_pages[i].pool;
+        if(pool < MEMMGR_HEAP_POOL_CLASSES) {
+            stats->pools[pool].pages++;
+            stats->pools[pool].slots += MEMMGR_HEAP_POOL_PAGE_SIZE / memmgr_heap_pool_sizes[pool];
+        } else {
+            stats->pool_free_pages++;
+        }
+    }
+
+    osKernelUnlock();
+}
+
 #ifdef HEAP_PRINT_DEBUG
 char* ultoa(unsigned long num, char* str, int radix) {
     char temp[33]; // at radix 2 the string is at most 32 + 1 null long.
@@ -353,11 +546,14 @@ void* pvPortMalloc(size_t xWantedSize) {
 
     vTaskSuspendAll();
     {
+        /* Small allocations are served by pools while they have free slots. */
+        pvReturn = memmgr_heap_pool_alloc(xWantedSize);
+
         /* Check the requested block size is not so large that the top bit is
         set.  The top bit of the block size member of the BlockLink_t structure
         is used to determine who owns the block - the application or the
         kernel, so it must be free. */
-        if((xWantedSize & xBlockAllocatedBit) == 0) {
+        if((pvReturn == NULL) && ((xWantedSize & xBlockAllocatedBit) == 0)) {
             /* The wanted size is increased so it can contain a BlockLink_t
             structure in addition to the requested amount of bytes. */
             if(xWantedSize > 0) {
@@ -421,12 +617,6 @@ void* pvPortMalloc(size_t xWantedSize) {
 
                     xFreeBytesRemaining -= pxBlock->xBlockSize;
 
-                    if(xFreeBytesRemaining < xMinimumEverFreeBytesRemaining) {
-                        xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
-                    } else {
-                        mtCOVERAGE_TEST_MARKER();
-                    }
-
                     /* The block is being returned - it is allocated and owned
                     by the application and has no "next" block. */
                     pxBlock->xBlockSize |= xBlockAllocatedBit;
@@ -445,12 +635,22 @@ void* pvPortMalloc(size_t xWantedSize) {
             mtCOVERAGE_TEST_MARKER();
         }
 
+        if(pvReturn) {
+            memmgr_heap_alloc_count++;
+            if(xFreeBytesRemaining < xMinimumEverFreeBytesRemaining) {
+                xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+            }
+        }
         traceMALLOC(pvReturn, xWantedSize);
     }
     (void)xTaskResumeAll();
 
 #ifdef HEAP_PRINT_DEBUG
-    print_heap_malloc(print_heap_block, print_heap_block->xBlockSize & ~xBlockAllocatedBit);
+    if(print_heap_block) {
+        print_heap_malloc(print_heap_block, print_heap_block->xBlockSize & ~xBlockAllocatedBit);
+    } else {
+        print_heap_malloc(pvReturn, to_wipe);
+    }
 #endif
 
 #if(configUSE_MALLOC_FAILED_HOOK == 1)
@@ -476,7 +676,16 @@ void vPortFree(void* pv) {
     uint8_t* puc = (uint8_t*)pv;
     BlockLink_t* pxLink;
 
-    if(pv != NULL) {
+    if(memmgr_heap_pool_contains(pv)) {
+#ifdef HEAP_PRINT_DEBUG
+        print_heap_free(pv);
+#endif
+        vTaskSuspendAll();
+        {
+            memmgr_heap_pool_free(pv);
+        }
+        (void)xTaskResumeAll();
+    } else if(pv != NULL) {
         /* The memory being freed will have an BlockLink_t structure immediately
         before it. */
         puc -= xHeapStructSize;
@@ -558,6 +767,12 @@ static void prvHeapInit(void) {
 
     pucAlignedHeap = (uint8_t*)uxAddress;
 
+    /* Pool arena takes the start of heap space, blocks follow it. Reads past
+    the end of a slot still stay in heap. */
+    size_t xPoolSize = memmgr_heap_pool_init(pucAlignedHeap, xTotalHeapSize);
+    pucAlignedHeap += xPoolSize;
+    xTotalHeapSize -= xPoolSize;
+
     /* xStart is used to hold a pointer to the first item in the list of free
     blocks.  The void cast is used to prevent compiler warnings. */
     xStart.pxNextFreeBlock = (void*)pucAlignedHeap;
@@ -579,8 +794,8 @@ static void prvHeapInit(void) {
     pxFirstFreeBlock->pxNextFreeBlock = pxEnd;
 
     /* Only one block exists - and it covers the entire usable heap space. */
-    xMinimumEverFreeBytesRemaining = pxFirstFreeBlock->xBlockSize;
     xFreeBytesRemaining = pxFirstFreeBlock->xBlockSize;
+    xMinimumEverFreeBytesRemaining = pxFirstFreeBlock->xBlockSize;
 
     /* Work out the position of the top bit in a size_t variable. */
     xBlockAllocatedBit = ((size_t)1) << ((sizeof(size_t) * heapBITS_PER_BYTE) - 1);
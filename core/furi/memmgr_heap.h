@@ -6,6 +6,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <cmsis_os2.h>
 
 #ifdef __cplusplus
@@ -14,6 +15,32 @@ extern "C" {
 
 #define MEMMGR_HEAP_UNKNOWN 0xFFFFFFFF
 
+/** Size classes of small allocation pools */
+#define MEMMGR_HEAP_POOL_CLASSES 5
+/** Free block histogram bins, bin i counts blocks smaller than 32 << i bytes
+ * and not counted by previous bins, last bin counts the rest */
+#define MEMMGR_HEAP_HISTOGRAM_BINS 12
+
+typedef struct {
+    size_t size; /**< slot size, bytes */
+    size_t pages; /**< pool pages serving this class */
+    size_t slots; /**< slots in those pages */
+    size_t used; /**< slots allocated */
+    uint32_t hits; /**< allocations served by pool */
+    uint32_t misses; /**< allocations passed to heap, pool was full */
+} MemmgrHeapPoolStats;
+
+typedef struct {
+    size_t free_size; /**< heap free bytes, same as xPortGetFreeHeapSize */
+    size_t pool_free_size; /**< free bytes in pool slots and pages */
+    size_t max_free_block; /**< largest heap free block */
+    size_t free_blocks; /**< heap free blocks count */
+    size_t free_block_histogram[MEMMGR_HEAP_HISTOGRAM_BINS];
+    size_t pool_pages; /**< pool pages total */
+    size_t pool_free_pages; /**< pool pages not serving any class */
+    MemmgrHeapPoolStats pools[MEMMGR_HEAP_POOL_CLASSES];
+} MemmgrHeapStats;
+
 /** Memmgr heap enable thread allocation tracking
  *
  * @param      thread_id  - thread id to track
@@ -34,6 +61,18 @@ void memmgr_heap_disable_thread_trace(osThreadId_t thread_id);
  */
 size_t memmgr_heap_get_thread_memory(osThreadId_t thread_id);
 
+/** Memmgr heap get allocations count
+ *
+ * @return     successful allocations since start, all threads
+ */
+size_t memmgr_heap_get_alloc_count();
+
+/** Memmgr heap get free space of small allocation pools
+ *
+ * @return     bytes in free pool slots and pages, not included in heap free size
+ */
+size_t memmgr_heap_get_pool_free();
+
 /** Memmgr heap get the max contiguous block size on the heap
  *
  * @return     size_t max contiguous block size
@@ -44,6 +83,19 @@ size_t memmgr_heap_get_max_free_block();
  */
 void memmgr_heap_printf_free_blocks();
 
+/** Memmgr heap get fragmentation and pool statistics
+ *
+ * @param      stats  - statistics to fill
+ */
+void memmgr_heap_get_stats(MemmgrHeapStats* stats);
+
+/** Memmgr heap enable or disable small allocation pools, for diagnostics.
+ * Slots allocated before are still freed to pools.
+ *
+ * @param      enabled  - true to serve small allocations from pools
+ */
+void memmgr_heap_set_pool_enabled(bool enabled);
+
 #ifdef __cplusplus
 }
 #endif
@@ -2,28 +2,118 @@
 #include "memmgr.h"
 #include "check.h"
 
-#include <m-list.h>
 #include <cmsis_os2.h>
+#include <string.h>
 
 struct FuriPubSubSubscription {
     FuriPubSubCallback callback;
     void* callback_context;
+    volatile bool active;
+    FuriPubSubSubscription* next_retired;
 };
 
-LIST_DEF(FuriPubSubSubscriptionList, FuriPubSubSubscription, M_POD_OPLIST);
+/* Immutable list of subscribers: subscribe and unsubscribe make a new copy,
+ * publishers keep using the copy they started with. */
+typedef struct FuriPubSubSnapshot {
+    struct FuriPubSubSnapshot* next_retired;
+    size_t size;
+    FuriPubSubSubscription* items[];
+} FuriPubSubSnapshot;
+
+/* Lives on publisher stack while callbacks are called */
+typedef struct FuriPubSubPublisher {
+    osThreadId_t thread;
+    FuriPubSubSnapshot* snapshot;
+    FuriPubSubSubscription* volatile item;
+    struct FuriPubSubPublisher* next;
+} FuriPubSubPublisher;
 
 struct FuriPubSub {
-    FuriPubSubSubscriptionList_t items;
+    FuriPubSubSnapshot* snapshot;
+    FuriPubSubPublisher* publishers;
+    // Freed when no publisher holds them, so at most one per publisher is left
+    FuriPubSubSnapshot* retired_snapshots;
+    FuriPubSubSubscription* retired_items;
     osMutexId_t mutex;
 };
 
+static FuriPubSubSnapshot* furi_pubsub_snapshot_alloc(size_t size) {
+    FuriPubSubSnapshot* snapshot =
+        malloc(sizeof(FuriPubSubSnapshot) + size * sizeof(FuriPubSubSubscription*));
+    snapshot->next_retired = NULL;
+    snapshot->size = size;
+    return snapshot;
+}
+
+static void furi_pubsub_snapshot_replace(FuriPubSub* pubsub, FuriPubSubSnapshot* snapshot) {
+    pubsub->snapshot->next_retired = pubsub->retired_snapshots;
+    pubsub->retired_snapshots = pubsub->snapshot;
+    pubsub->snapshot = snapshot;
+}
+
+static bool furi_pubsub_snapshot_is_held(FuriPubSub* pubsub, FuriPubSubSnapshot* snapshot) {
+    for(FuriPubSubPublisher* publisher = pubsub->publishers; publisher;
+        publisher = publisher->next) {
+        if(publisher->snapshot == snapshot) return true;
+    }
+    return false;
+}
+
+static bool furi_pubsub_item_is_held(FuriPubSub* pubsub, FuriPubSubSubscription* item) {
+    for(FuriPubSubPublisher* publisher = pubsub->publishers; publisher;
+        publisher = publisher->next) {
+        for(size_t i = 0; i < publisher->snapshot->size; i++) {
+            if(publisher->snapshot->items[i] == item) return true;
+        }
+    }
+    return false;
+}
+
+static void furi_pubsub_reclaim(FuriPubSub* pubsub) {
+    FuriPubSubSnapshot** snapshot = &pubsub->retired_snapshots;
+    while(*snapshot) {
+        FuriPubSubSnapshot* retired = *snapshot;
+        if(furi_pubsub_snapshot_is_held(pubsub, retired)) {
+            snapshot = &retired->next_retired;
+        } else {
+            *snapshot = retired->next_retired;
+            free(retired);
+        }
+    }
+
+    // Retired item is only referenced by retired snapshots
+    FuriPubSubSubscription** item = &pubsub->retired_items;
+    while(*item) {
+        FuriPubSubSubscription* retired = *item;
+        if(furi_pubsub_item_is_held(pubsub, retired)) {
+            item = &retired->next_retired;
+        } else {
+            *item = retired->next_retired;
+            free(retired);
+        }
+    }
+}
+
+static bool furi_pubsub_is_running(FuriPubSub* pubsub, FuriPubSubSubscription* item) {
+    osThreadId_t thread = osThreadGetId();
+    for(FuriPubSubPublisher* publisher = pubsub->publishers; publisher;
+        publisher = publisher->next) {
+        // Callback may unsubscribe itself
+        if(publisher->item == item && publisher->thread != thread) return true;
+    }
+    return false;
+}
+
 FuriPubSub* furi_pubsub_alloc() {
     FuriPubSub* pubsub = malloc(sizeof(FuriPubSub));
 
     pubsub->mutex = osMutexNew(NULL);
     furi_assert(pubsub->mutex);
 
-    FuriPubSubSubscriptionList_init(pubsub->items);
+    pubsub->snapshot = furi_pubsub_snapshot_alloc(0);
+    pubsub->publishers = NULL;
+    pubsub->retired_snapshots = NULL;
+    pubsub->retired_items = NULL;
 
     return pubsub;
 }
@@ -31,9 +121,11 @@ FuriPubSub* furi_pubsub_alloc() {
 void furi_pubsub_free(FuriPubSub* pubsub) {
     furi_assert(pubsub);
 
-    furi_check(FuriPubSubSubscriptionList_size(pubsub->items) == 0);
+    furi_check(pubsub->snapshot->size == 0);
+    furi_check(pubsub->publishers == NULL);
 
-    FuriPubSubSubscriptionList_clear(pubsub->items);
+    furi_pubsub_reclaim(pubsub);
+    free(pubsub->snapshot);
 
     furi_check(osMutexDelete(pubsub->mutex) == osOK);
 
@@ -42,13 +134,22 @@ void furi_pubsub_free(FuriPubSub* pubsub) {
 
 FuriPubSubSubscription*
     furi_pubsub_subscribe(FuriPubSub* pubsub, FuriPubSubCallback callback, void* callback_context) {
-    furi_check(osMutexAcquire(pubsub->mutex, osWaitForever) == osOK);
-    // put uninitialized item to the list
-    FuriPubSubSubscription* item = FuriPubSubSubscriptionList_push_raw(pubsub->items);
-
-    // initialize item
+    FuriPubSubSubscription* item = malloc(sizeof(FuriPubSubSubscription));
     item->callback = callback;
     item->callback_context = callback_context;
+    item->active = true;
+    item->next_retired = NULL;
+
+    furi_check(osMutexAcquire(pubsub->mutex, osWaitForever) == osOK);
+
+    FuriPubSubSnapshot* snapshot = furi_pubsub_snapshot_alloc(pubsub->snapshot->size + 1);
+    memcpy(
+        snapshot->items,
+        pubsub->snapshot->items,
+        pubsub->snapshot->size * sizeof(FuriPubSubSubscription*));
+    snapshot->items[pubsub->snapshot->size] = item;
+    furi_pubsub_snapshot_replace(pubsub, snapshot);
+    furi_pubsub_reclaim(pubsub);
 
     furi_check(osMutexRelease(pubsub->mutex) == osOK);
 
@@ -60,36 +161,70 @@ void furi_pubsub_unsubscribe(FuriPubSub* pubsub, FuriPubSubSubscription* pubsub_
     furi_assert(pubsub_subscription);
 
     furi_check(osMutexAcquire(pubsub->mutex, osWaitForever) == osOK);
-    bool result = false;
-
-    // iterate over items
-    FuriPubSubSubscriptionList_it_t it;
-    for(FuriPubSubSubscriptionList_it(it, pubsub->items); !FuriPubSubSubscriptionList_end_p(it);
-        FuriPubSubSubscriptionList_next(it)) {
-        const FuriPubSubSubscription* item = FuriPubSubSubscriptionList_cref(it);
-
-        // if the iterator is equal to our element
-        if(item == pubsub_subscription) {
-            FuriPubSubSubscriptionList_remove(pubsub->items, it);
-            result = true;
+
+    FuriPubSubSnapshot* current = pubsub->snapshot;
+    FuriPubSubSnapshot* snapshot = NULL;
+    for(size_t i = 0; i < current->size; i++) {
+        if(current->items[i] == pubsub_subscription) {
+            snapshot = furi_pubsub_snapshot_alloc(current->size - 1);
+            memcpy(snapshot->items, current->items, i * sizeof(FuriPubSubSubscription*));
+            memcpy(
+                &snapshot->items[i],
+                &current->items[i + 1],
+                (current->size - i - 1) * sizeof(FuriPubSubSubscription*));
             break;
         }
     }
+    furi_check(snapshot);
+
+    // Publishers that already have the old snapshot skip inactive subscription
+    pubsub_subscription->active = false;
+    furi_pubsub_snapshot_replace(pubsub, snapshot);
+    pubsub_subscription->next_retired = pubsub->retired_items;
+    pubsub->retired_items = pubsub_subscription;
+
+    // Callback context must stay valid until callback returns in other threads
+    while(furi_pubsub_is_running(pubsub, pubsub_subscription)) {
+        furi_check(osMutexRelease(pubsub->mutex) == osOK);
+        osDelay(1);
+        furi_check(osMutexAcquire(pubsub->mutex, osWaitForever) == osOK);
+    }
+
+    furi_pubsub_reclaim(pubsub);
 
     furi_check(osMutexRelease(pubsub->mutex) == osOK);
-    furi_check(result);
 }
 
 void furi_pubsub_publish(FuriPubSub* pubsub, void* message) {
+    FuriPubSubPublisher publisher = {
+        .thread = osThreadGetId(),
+        .item = NULL,
+    };
+
     furi_check(osMutexAcquire(pubsub->mutex, osWaitForever) == osOK);
+    FuriPubSubSnapshot* snapshot = pubsub->snapshot;
+    publisher.snapshot = snapshot;
+    publisher.next = pubsub->publishers;
+    pubsub->publishers = &publisher;
+    furi_check(osMutexRelease(pubsub->mutex) == osOK);
 
-    // iterate over subscribers
-    FuriPubSubSubscriptionList_it_t it;
-    for(FuriPubSubSubscriptionList_it(it, pubsub->items); !FuriPubSubSubscriptionList_end_p(it);
-        FuriPubSubSubscriptionList_next(it)) {
-        const FuriPubSubSubscription* item = FuriPubSubSubscriptionList_cref(it);
-        item->callback(message, item->callback_context);
+    // Callbacks are called without lock, snapshot is not freed while publisher holds it
+    for(size_t i = 0; i < snapshot->size; i++) {
+        FuriPubSubSubscription* item = snapshot->items[i];
+        // Mark item first: unsubscribe clears active first, then looks for running callbacks
+        publisher.item = item;
+        if(item->active) {
+            item->callback(message, item->callback_context);
+        }
     }
+    publisher.item = NULL;
 
+    furi_check(osMutexAcquire(pubsub->mutex, osWaitForever) == osOK);
+    FuriPubSubPublisher** it = &pubsub->publishers;
+    while(*it != &publisher) {
+        it = &(*it)->next;
+    }
+    *it = publisher.next;
+    furi_pubsub_reclaim(pubsub);
     furi_check(osMutexRelease(pubsub->mutex) == osOK);
 }
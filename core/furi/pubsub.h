@@ -43,7 +43,8 @@ FuriPubSubSubscription*
 /** Unsubscribe from FuriPubSub
  * 
  * No use of `pubsub_subscription` allowed after call of this method
- * Threadsafe, Reentrable.
+ * Threadsafe, Reentrable, can be called from subscription callback.
+ * Waits for the callback to return in other threads.
  *
  * @param      pubsub               pointer to FuriPubSub instance
  * @param      pubsub_subscription  pointer to FuriPubSubSubscription instance
@@ -53,6 +54,8 @@ void furi_pubsub_unsubscribe(FuriPubSub* pubsub, FuriPubSubSubscription* pubsub_
 /** Publish message to FuriPubSub
  *
  * Threadsafe, Reentrable.
+ * Callbacks are called without lock, subscriptions made during publish
+ * receive next message.
  * 
  * @param      pubsub   pointer to FuriPubSub instance
  * @param      message  message pointer to publish
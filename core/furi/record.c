@@ -3,22 +3,23 @@
 #include "memmgr.h"
 
 #include <cmsis_os2.h>
-#include <m-string.h>
-#include <m-dict.h>
+#include <m-array.h>
 
 #define FURI_RECORD_FLAG_READY (0x1)
 
-typedef struct {
+struct FuriRecordHandle {
+    const char* name;
     osEventFlagsId_t flags;
     void* data;
     size_t holders_count;
-} FuriRecordData;
+};
 
-DICT_DEF2(FuriRecordDataDict, string_t, STRING_OPLIST, FuriRecordData, M_POD_OPLIST)
+/* Handles are never freed, pointers to them stay valid after destroy */
+ARRAY_DEF(FuriRecordHandleArray, FuriRecordHandle*, M_PTR_OPLIST)
 
 typedef struct {
     osMutexId_t mutex;
-    FuriRecordDataDict_t records;
+    FuriRecordHandleArray_t records;
 } FuriRecord;
 
 static FuriRecord* furi_record = NULL;
@@ -27,21 +28,7 @@ void furi_record_init() {
     furi_record = malloc(sizeof(FuriRecord));
     furi_record->mutex = osMutexNew(NULL);
     furi_check(furi_record->mutex);
-    FuriRecordDataDict_init(furi_record->records);
-}
-
-static FuriRecordData* furi_record_data_get_or_create(string_t name_str) {
-    furi_assert(furi_record);
-    FuriRecordData* record_data = FuriRecordDataDict_get(furi_record->records, name_str);
-    if(!record_data) {
-        FuriRecordData new_record;
-        new_record.flags = osEventFlagsNew(NULL);
-        new_record.data = NULL;
-        new_record.holders_count = 0;
-        FuriRecordDataDict_set_at(furi_record->records, name_str, new_record);
-        record_data = FuriRecordDataDict_get(furi_record->records, name_str);
-    }
-    return record_data;
+    FuriRecordHandleArray_init(furi_record->records);
 }
 
 static void furi_record_lock() {
@@ -52,107 +39,121 @@ static void furi_record_unlock() {
     furi_check(osMutexRelease(furi_record->mutex) == osOK);
 }
 
+static FuriRecordHandle* furi_record_find(const char* name) {
+    for(size_t i = 0; i < FuriRecordHandleArray_size(furi_record->records); i++) {
+        FuriRecordHandle* handle = *FuriRecordHandleArray_get(furi_record->records, i);
+        if(strcmp(handle->name, name) == 0) {
+            return handle;
+        }
+    }
+    return NULL;
+}
+
+FuriRecordHandle* furi_record_get_handle(const char* name) {
+    furi_assert(furi_record);
+    furi_assert(name);
+
+    furi_record_lock();
+
+    FuriRecordHandle* handle = furi_record_find(name);
+    if(!handle) {
+        handle = malloc(sizeof(FuriRecordHandle));
+        handle->name = strdup(name);
+        handle->flags = osEventFlagsNew(NULL);
+        furi_check(handle->flags);
+        handle->data = NULL;
+        handle->holders_count = 0;
+        FuriRecordHandleArray_push_back(furi_record->records, handle);
+    }
+
+    furi_record_unlock();
+
+    return handle;
+}
+
 bool furi_record_exists(const char* name) {
     furi_assert(furi_record);
     furi_assert(name);
 
     bool ret = false;
 
-    string_t name_str;
-    string_init_set_str(name_str, name);
-
     furi_record_lock();
-    ret = (FuriRecordDataDict_get(furi_record->records, name_str) != NULL);
+    FuriRecordHandle* handle = furi_record_find(name);
+    ret = handle && (handle->data || handle->holders_count);
     furi_record_unlock();
 
-    string_clear(name_str);
-
     return ret;
 }
 
-void furi_record_create(const char* name, void* data) {
-    furi_assert(furi_record);
-
-    string_t name_str;
-    string_init_set_str(name_str, name);
+void furi_record_create_handle(FuriRecordHandle* handle, void* data) {
+    furi_assert(handle);
 
     furi_record_lock();
 
-    // Get record data and fill it
-    FuriRecordData* record_data = furi_record_data_get_or_create(name_str);
-    furi_assert(record_data->data == NULL);
-    record_data->data = data;
-    osEventFlagsSet(record_data->flags, FURI_RECORD_FLAG_READY);
+    furi_assert(handle->data == NULL);
+    handle->data = data;
+    osEventFlagsSet(handle->flags, FURI_RECORD_FLAG_READY);
 
     furi_record_unlock();
-
-    string_clear(name_str);
 }
 
-bool furi_record_destroy(const char* name) {
-    furi_assert(furi_record);
+bool furi_record_destroy_handle(FuriRecordHandle* handle) {
+    furi_assert(handle);
 
     bool ret = false;
 
-    string_t name_str;
-    string_init_set_str(name_str, name);
-
     furi_record_lock();
 
-    FuriRecordData* record_data = FuriRecordDataDict_get(furi_record->records, name_str);
-    furi_assert(record_data);
-    if(record_data->holders_count == 0) {
-        furi_check(osOK == osEventFlagsDelete(record_data->flags));
-        FuriRecordDataDict_erase(furi_record->records, name_str);
+    if(handle->holders_count == 0) {
+        handle->data = NULL;
+        osEventFlagsClear(handle->flags, FURI_RECORD_FLAG_READY);
         ret = true;
     }
 
     furi_record_unlock();
 
-    string_clear(name_str);
-
     return ret;
 }
 
-void* furi_record_open(const char* name) {
-    furi_assert(furi_record);
-
-    string_t name_str;
-    string_init_set_str(name_str, name);
+void* furi_record_open_handle(FuriRecordHandle* handle) {
+    furi_assert(handle);
 
     furi_record_lock();
-
-    FuriRecordData* record_data = furi_record_data_get_or_create(name_str);
-    record_data->holders_count++;
-
+    handle->holders_count++;
     furi_record_unlock();
 
     // Wait for record to become ready
     furi_check(
         osEventFlagsWait(
-            record_data->flags,
+            handle->flags,
             FURI_RECORD_FLAG_READY,
             osFlagsWaitAny | osFlagsNoClear,
             osWaitForever) == FURI_RECORD_FLAG_READY);
 
-    string_clear(name_str);
-
-    return record_data->data;
+    return handle->data;
 }
 
-void furi_record_close(const char* name) {
-    furi_assert(furi_record);
-
-    string_t name_str;
-    string_init_set_str(name_str, name);
+void furi_record_close_handle(FuriRecordHandle* handle) {
+    furi_assert(handle);
 
     furi_record_lock();
+    furi_assert(handle->holders_count);
+    handle->holders_count--;
+    furi_record_unlock();
+}
 
-    FuriRecordData* record_data = FuriRecordDataDict_get(furi_record->records, name_str);
-    furi_assert(record_data);
-    record_data->holders_count--;
+void furi_record_create(const char* name, void* data) {
+    furi_record_create_handle(furi_record_get_handle(name), data);
+}
 
-    furi_record_unlock();
+bool furi_record_destroy(const char* name) {
+    return furi_record_destroy_handle(furi_record_get_handle(name));
+}
+
+void* furi_record_open(const char* name) {
+    return furi_record_open_handle(furi_record_get_handle(name));
+}
 
-    string_clear(name_str);
+void furi_record_close(const char* name) {
+    furi_record_close_handle(furi_record_get_handle(name));
 }
@@ -11,11 +11,26 @@
 extern "C" {
 #endif
 
+/** Record handle, interned record name. Valid until reboot, even after
+ * record is destroyed. Operations on it don't allocate or look names up.
+ */
+typedef struct FuriRecordHandle FuriRecordHandle;
+
 /** Initialize record storage For internal use only.
  */
 void furi_record_init();
 
-/** Check if record exists
+/** Get record handle, same name always gives same handle
+ *
+ * @param      name  record name
+ *
+ * @return     record handle
+ * @note       Thread safe. Allocates on first call for the name, keep the
+ *             handle instead of calling it on hot paths.
+ */
+FuriRecordHandle* furi_record_get_handle(const char* name);
+
+/** Check if record exists: created, or opened and waited for
  *
  * @param      name  record name
  * @note       Thread safe. Create and destroy must be executed from the same
@@ -61,6 +76,39 @@ void* furi_record_open(const char* name);
  */
 void furi_record_close(const char* name);
 
+/** Create record by handle
+ *
+ * @param      handle  record handle
+ * @param      data    data pointer
+ * @note       Same as furi_record_create
+ */
+void furi_record_create_handle(FuriRecordHandle* handle, void* data);
+
+/** Destroy record by handle, handle itself stays valid
+ *
+ * @param      handle  record handle
+ *
+ * @return     true if successful, false if still have holders
+ * @note       Same as furi_record_destroy
+ */
+bool furi_record_destroy_handle(FuriRecordHandle* handle);
+
+/** Open record by handle
+ *
+ * @param      handle  record handle
+ *
+ * @return     pointer to the record
+ * @note       Same as furi_record_open
+ */
+void* furi_record_open_handle(FuriRecordHandle* handle);
+
+/** Close record by handle
+ *
+ * @param      handle  record handle
+ * @note       Same as furi_record_close
+ */
+void furi_record_close_handle(FuriRecordHandle* handle);
+
 #ifdef __cplusplus
 }
 #endif
@@ -14,6 +14,9 @@ typedef struct {
     osMutexId_t buff_size_mtx;
     uint32_t buff_size;
     uint16_t bytes_ready_to_receive;
+    volatile bool tx_notify;
+    volatile bool tx_notify_valid;
+    volatile bool tx_indication_pending;
     SerialServiceEventCallback callback;
     void* context;
 } SerialSvc;
@@ -37,7 +40,14 @@ static SVCCTL_EvtAckStatus_t serial_svc_event_handler(void* event) {
     if(event_pckt->evt == HCI_VENDOR_SPECIFIC_DEBUG_EVT_CODE) {
         if(blecore_evt->ecode == ACI_GATT_ATTRIBUTE_MODIFIED_VSEVT_CODE) {
             attribute_modified = (aci_gatt_attribute_modified_event_rp0*)blecore_evt->data;
-            if(attribute_modified->Attr_Handle == serial_svc->rx_char_handle + 2) {
+            if(attribute_modified->Attr_Handle == serial_svc->tx_char_handle + 2) {
+                // TX descriptor: client chooses notifications or indications
+                serial_svc->tx_notify = attribute_modified->Attr_Data[0] & 0x01;
+                serial_svc->tx_notify_valid = true;
+                serial_svc->tx_indication_pending = false;
+                FURI_LOG_D(TAG, "TX notifications %s", serial_svc->tx_notify ? "on" : "off");
+                ret = SVCCTL_EvtAckFlowEnable;
+            } else if(attribute_modified->Attr_Handle == serial_svc->rx_char_handle + 2) {
                 // Descriptor handle
                 ret = SVCCTL_EvtAckFlowEnable;
                 FURI_LOG_D(TAG, "RX descriptor event");
@@ -68,6 +78,7 @@ static SVCCTL_EvtAckStatus_t serial_svc_event_handler(void* event) {
             }
         } else if(blecore_evt->ecode == ACI_GATT_SERVER_CONFIRMATION_VSEVT_CODE) {
             FURI_LOG_T(TAG, "Ack received", blecore_evt->ecode);
+            serial_svc->tx_indication_pending = false;
             if(serial_svc->callback) {
                 SerialServiceEvent event = {
                     .event = SerialServiceEventTypeDataSent,
@@ -75,6 +86,16 @@ static SVCCTL_EvtAckStatus_t serial_svc_event_handler(void* event) {
                 serial_svc->callback(event, serial_svc->context);
             }
             ret = SVCCTL_EvtAckFlowEnable;
+        } else if(blecore_evt->ecode == ACI_GATT_TX_POOL_AVAILABLE_VSEVT_CODE) {
+            // Stack has free TX buffers again after notification was rejected
+            FURI_LOG_T(TAG, "TX pool available");
+            if(serial_svc->callback) {
+                SerialServiceEvent event = {
+                    .event = SerialServiceEventTypeDataSent,
+                };
+                serial_svc->callback(event, serial_svc->context);
+            }
+            // Not acked: event is common for all services
         }
     }
     return ret;
@@ -115,9 +136,9 @@ void serial_svc_start() {
         UUID_TYPE_128,
         (const Char_UUID_t*)char_tx_uuid,
         SERIAL_SVC_DATA_LEN_MAX,
-        CHAR_PROP_READ | CHAR_PROP_INDICATE,
+        CHAR_PROP_READ | CHAR_PROP_INDICATE | CHAR_PROP_NOTIFY,
         ATTR_PERMISSION_AUTHEN_READ,
-        GATT_DONT_NOTIFY_EVENTS,
+        GATT_NOTIFY_ATTRIBUTE_WRITE,
         10,
         CHAR_VALUE_LEN_VARIABLE,
         &serial_svc->tx_char_handle);
@@ -150,6 +171,10 @@ void serial_svc_set_callbacks(
     furi_assert(serial_svc);
     serial_svc->callback = callback;
     serial_svc->context = context;
+    // New session: indication of previous connection is never confirmed,
+    // bonded client's TX descriptor is restored by stack without event
+    serial_svc->tx_notify_valid = false;
+    serial_svc->tx_indication_pending = false;
     serial_svc->buff_size = buff_size;
     serial_svc->bytes_ready_to_receive = buff_size;
     uint32_t buff_size_reversed = REVERSE_BYTES_U32(serial_svc->buff_size);
@@ -212,9 +237,39 @@ bool serial_svc_is_started() {
     return serial_svc != NULL;
 }
 
-bool serial_svc_update_tx(uint8_t* data, uint16_t data_len) {
+static void serial_svc_read_tx_descriptor() {
+    uint8_t descriptor[2] = {0};
+    uint16_t length = 0;
+    uint16_t value_length = 0;
+    tBleStatus result = aci_gatt_read_handle_value(
+        serial_svc->tx_char_handle + 2,
+        0,
+        sizeof(descriptor),
+        &length,
+        &value_length,
+        descriptor);
+    if(result) {
+        FURI_LOG_E(TAG, "Failed reading TX descriptor: %d", result);
+        serial_svc->tx_notify = false;
+    } else {
+        serial_svc->tx_notify = descriptor[0] & 0x01;
+    }
+    serial_svc->tx_notify_valid = true;
+}
+
+/* Notifications are queued by stack while it has free TX buffers, so many packets are in
+ * flight during one connection event. Indication has to be confirmed before next one. */
+SerialServiceTxStatus serial_svc_update_tx(uint8_t* data, uint16_t data_len) {
     if(data_len > SERIAL_SVC_DATA_LEN_MAX) {
-        return false;
+        return SerialServiceTxStatusError;
+    }
+
+    if(!serial_svc->tx_notify_valid) {
+        serial_svc_read_tx_descriptor();
+    }
+    bool notify = serial_svc->tx_notify;
+    if(!notify && serial_svc->tx_indication_pending) {
+        return SerialServiceTxStatusBusy;
     }
 
     for(uint16_t remained = data_len; remained > 0;) {
@@ -222,21 +277,32 @@ bool serial_svc_update_tx(uint8_t* data, uint16_t data_len) {
         uint16_t value_offset = data_len - remained;
         remained -= value_len;
 
+        uint8_t update_type = 0x00;
+        if(remained == 0) {
+            update_type = notify ? 0x01 : 0x02;
+            if(!notify) serial_svc->tx_indication_pending = true;
+        }
+
         tBleStatus result = aci_gatt_update_char_value_ext(
             0,
             serial_svc->svc_handle,
             serial_svc->tx_char_handle,
-            remained ? 0x00 : 0x02,
+            update_type,
             data_len,
             value_offset,
             value_len,
             data + value_offset);
 
-        if(result) {
+        if(result == BLE_STATUS_INSUFFICIENT_RESOURCES) {
+            // TX window is full, ACI_GATT_TX_POOL_AVAILABLE_VSEVT_CODE will follow
+            serial_svc->tx_indication_pending = false;
+            return SerialServiceTxStatusBusy;
+        } else if(result) {
             FURI_LOG_E(TAG, "Failed updating TX characteristic: %d", result);
-            return false;
+            serial_svc->tx_indication_pending = false;
+            return SerialServiceTxStatusError;
         }
     }
 
-    return true;
+    return SerialServiceTxStatusOk;
 }
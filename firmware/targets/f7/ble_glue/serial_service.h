@@ -20,6 +20,12 @@ typedef struct {
     uint16_t size;
 } SerialServiceData;
 
+typedef enum {
+    SerialServiceTxStatusOk,
+    SerialServiceTxStatusBusy, /**< TX window is full, retry on SerialServiceEventTypeDataSent */
+    SerialServiceTxStatusError,
+} SerialServiceTxStatus;
+
 typedef struct {
     SerialServiceEventType event;
     SerialServiceData data;
@@ -40,7 +46,7 @@ void serial_svc_stop();
 
 bool serial_svc_is_started();
 
-bool serial_svc_update_tx(uint8_t* data, uint16_t data_len);
+SerialServiceTxStatus serial_svc_update_tx(uint8_t* data, uint16_t data_len);
 
 #ifdef __cplusplus
 }
@@ -5,6 +5,7 @@
 #include <shci.h>
 
 #include <stm32wbxx.h>
+#include <string.h>
 
 #define FURI_HAL_TAG "FuriHalFlash"
 #define FURI_HAL_CRITICAL_MSG "Critical flash operation fail"
@@ -96,7 +97,7 @@ static void furi_hal_flash_lock(void) {
     furi_check(READ_BIT(FLASH->CR, FLASH_CR_LOCK) != 0U);
 }
 
-static void furi_hal_flash_begin_with_core2(bool erase_flag) {
+static void furi_hal_flash_acquire_with_core2(bool erase_flag) {
     // Take flash controller ownership
     while(LL_HSEM_1StepLock(HSEM, CFG_HW_FLASH_SEMID) != 0) {
         osThreadYield();
@@ -111,7 +112,9 @@ static void furi_hal_flash_begin_with_core2(bool erase_flag) {
     // 64mHz 5us core2 flag protection
     for(volatile uint32_t i = 0; i < 35; i++)
         ;
+}
 
+static void furi_hal_flash_block_core2() {
     while(true) {
         // Wait till flash controller become usable
         while(LL_FLASH_IsActiveFlag_OperationSuspended()) {
@@ -139,6 +142,11 @@ static void furi_hal_flash_begin_with_core2(bool erase_flag) {
     }
 }
 
+static void furi_hal_flash_begin_with_core2(bool erase_flag) {
+    furi_hal_flash_acquire_with_core2(erase_flag);
+    furi_hal_flash_block_core2();
+}
+
 static void furi_hal_flash_begin(bool erase_flag) {
     // Acquire dangerous ops mutex
     furi_hal_bt_lock_core2();
@@ -151,13 +159,15 @@ static void furi_hal_flash_begin(bool erase_flag) {
     }
 }
 
-static void furi_hal_flash_end_with_core2(bool erase_flag) {
+static void furi_hal_flash_unblock_core2() {
     // Funky ops are ok at this point
     LL_HSEM_ReleaseLock(HSEM, CFG_HW_BLOCK_FLASH_REQ_BY_CPU2_SEMID, 0);
 
     // Task switching is ok
     taskEXIT_CRITICAL();
+}
 
+static void furi_hal_flash_release_with_core2(bool erase_flag) {
     // Doesn't make much sense, does it?
     while(READ_BIT(FLASH->SR, FLASH_SR_BSY)) {
         osThreadYield();
@@ -173,6 +183,11 @@ static void furi_hal_flash_end_with_core2(bool erase_flag) {
     LL_HSEM_ReleaseLock(HSEM, CFG_HW_FLASH_SEMID, 0);
 }
 
+static void furi_hal_flash_end_with_core2(bool erase_flag) {
+    furi_hal_flash_unblock_core2();
+    furi_hal_flash_release_with_core2(erase_flag);
+}
+
 static void furi_hal_flash_end(bool erase_flag) {
     // If Core2 is running use IPC locking
     if(furi_hal_bt_is_alive()) {
@@ -238,11 +253,13 @@ bool furi_hal_flash_wait_last_operation(uint32_t timeout) {
     /* Now update error variable to only error value */
     error &= FURI_HAL_FLASH_SR_ERRORS;
 
-    furi_check(error == 0);
-
     /* clear error flags */
     CLEAR_BIT(FLASH->SR, error);
 
+    if(error != 0) {
+        return false;
+    }
+
     /* Wait for control register to be written */
     countdown = timeout;
     while(READ_BIT(FLASH->SR, FLASH_SR_CFGBSY)) {
@@ -283,6 +300,21 @@ bool furi_hal_flash_erase(uint8_t page) {
     return true;
 }
 
+static bool furi_hal_flash_program_dword(size_t address, uint64_t data) {
+    /* Program first word */
+    *(uint32_t*)address = (uint32_t)data;
+
+    // Barrier to ensure programming is performed in 2 steps, in right order
+    // (independently of compiler optimization behavior)
+    __ISB();
+
+    /* Program second word */
+    *(uint32_t*)(address + 4U) = (uint32_t)(data >> 32U);
+
+    /* Wait for last operation to be completed */
+    return furi_hal_flash_wait_last_operation(FURI_HAL_FLASH_TIMEOUT);
+}
+
 bool furi_hal_flash_write_dword(size_t address, uint64_t data) {
     furi_hal_flash_begin(false);
 
@@ -296,23 +328,71 @@ bool furi_hal_flash_write_dword(size_t address, uint64_t data) {
     /* Set PG bit */
     SET_BIT(FLASH->CR, FLASH_CR_PG);
 
-    /* Program first word */
-    *(uint32_t*)address = (uint32_t)data;
+    furi_check(furi_hal_flash_program_dword(address, data));
 
-    // Barrier to ensure programming is performed in 2 steps, in right order
-    // (independently of compiler optimization behavior)
-    __ISB();
+    /* If the program operation is completed, disable the PG or FSTPG Bit */
+    CLEAR_BIT(FLASH->CR, FLASH_CR_PG);
 
-    /* Program second word */
-    *(uint32_t*)(address + 4U) = (uint32_t)(data >> 32U);
+    furi_hal_flash_end(false);
 
-    /* Wait for last operation to be completed */
-    furi_check(furi_hal_flash_wait_last_operation(FURI_HAL_FLASH_TIMEOUT));
+    return true;
+}
+
+bool furi_hal_flash_program_burst(size_t address, const uint8_t* data, size_t size) {
+    /* Check the parameters */
+    furi_check(size % FURI_HAL_FLASH_WRITE_BLOCK == 0);
+    furi_check(IS_ADDR_ALIGNED_64BITS(address));
+    if(size == 0) return true;
+    furi_check(IS_FLASH_PROGRAM_ADDRESS(address));
+    furi_check(IS_FLASH_PROGRAM_ADDRESS(address + size - FURI_HAL_FLASH_WRITE_BLOCK));
+
+    // Acquire dangerous ops mutex
+    furi_hal_bt_lock_core2();
+
+    // Flash controller ownership is taken once for the whole burst
+    bool core2_alive = furi_hal_bt_is_alive();
+    if(core2_alive) {
+        furi_hal_flash_acquire_with_core2(false);
+    } else {
+        furi_hal_flash_unlock();
+    }
+
+    /* Set PG bit */
+    SET_BIT(FLASH->CR, FLASH_CR_PG);
+
+    bool result = true;
+    for(size_t offset = 0; result && (offset < size); offset += FURI_HAL_FLASH_WRITE_BLOCK) {
+        // Controller state is checked before core2 is blocked, so exit on error can't stall it.
+        // Error flags are cleared, next operation must start with valid controller state.
+        if(!furi_hal_flash_wait_last_operation(FURI_HAL_FLASH_TIMEOUT)) {
+            result = false;
+            break;
+        }
+
+        // Source buffer may be unaligned
+        uint64_t dword;
+        memcpy(&dword, data + offset, sizeof(dword));
+
+        // Core2 is blocked per dword to keep critical section as short as in single write
+        if(core2_alive) furi_hal_flash_block_core2();
+        result = furi_hal_flash_program_dword(address + offset, dword);
+        if(core2_alive) furi_hal_flash_unblock_core2();
+    }
 
     /* If the program operation is completed, disable the PG or FSTPG Bit */
     CLEAR_BIT(FLASH->CR, FLASH_CR_PG);
 
-    furi_hal_flash_end(false);
+    /* Flush the caches to be sure of the data consistency */
+    furi_hal_flush_cache();
 
-    return true;
+    if(core2_alive) {
+        furi_hal_flash_release_with_core2(false);
+    } else {
+        furi_hal_flash_lock();
+    }
+
+    // Release dangerous ops mutex
+    furi_hal_bt_unlock_core2();
+
+    return result;
 }
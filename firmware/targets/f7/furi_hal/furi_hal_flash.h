@@ -78,3 +78,19 @@ bool furi_hal_flash_erase(uint8_t page);
  * @return     true on success
  */
 bool furi_hal_flash_write_dword(size_t address, uint64_t data);
+
+/** Program data in one burst
+ *
+ * Flash controller is unlocked and core2 handshake is done once per call,
+ * so it is much faster than multiple furi_hal_flash_write_dword calls.
+ *
+ * @warning locking operation with critical section, stales execution
+ *
+ * @param      address  destination address, must be double word aligned.
+ * @param      data     data to write, may be unaligned
+ * @param      size     data size in bytes, must be multiple of write block size
+ *
+ * @return     true on success, false if flash controller reported error or
+ *             timeout, programming is stopped at first failed double word
+ */
+bool furi_hal_flash_program_burst(size_t address, const uint8_t* data, size_t size);
@@ -2,6 +2,7 @@
 #include "furi_hal_usb_i.h"
 #include "furi_hal_usb.h"
 #include "furi_hal_usb_hid.h"
+#include "furi_hal_usb_hid_i.h"
 #include <furi.h>
 
 #include "usb.h"
@@ -15,7 +16,6 @@
 #define HID_EP_OUT 0x01
 #define HID_EP_SZ 0x10
 
-#define HID_KB_MAX_KEYS 6
 #define HID_CONSUMER_MAX_KEYS 2
 
 #define HID_PAGE_CONSUMER 0x0C
@@ -24,6 +24,8 @@
 #define HID_VID_DEFAULT 0x046D
 #define HID_PID_DEFAULT 0xC529
 
+#define HID_POLL_INTERVAL_DEFAULT 10
+
 struct HidIadDescriptor {
     struct usb_iad_descriptor hid_iad;
     struct usb_interface_descriptor hid;
@@ -136,7 +138,7 @@ static struct usb_device_descriptor hid_device_desc = {
 };
 
 /* Device configuration descriptor */
-static const struct HidConfigDescriptor hid_cfg_desc = {
+static struct HidConfigDescriptor hid_cfg_desc = {
     .config =
         {
             .bLength = sizeof(struct usb_config_descriptor),
@@ -190,7 +192,7 @@ static const struct HidConfigDescriptor hid_cfg_desc = {
                     .bEndpointAddress = HID_EP_IN,
                     .bmAttributes = USB_EPTYPE_INTERRUPT,
                     .wMaxPacketSize = HID_EP_SZ,
-                    .bInterval = 10,
+                    .bInterval = HID_POLL_INTERVAL_DEFAULT,
                 },
             .hid_ep_out =
                 {
@@ -212,13 +214,6 @@ struct HidReportMouse {
     int8_t wheel;
 } __attribute__((packed));
 
-struct HidReportKB {
-    uint8_t report_id;
-    uint8_t mods;
-    uint8_t reserved;
-    uint8_t btn[HID_KB_MAX_KEYS];
-} __attribute__((packed));
-
 struct HidReportConsumer {
     uint8_t report_id;
     uint16_t btn[HID_CONSUMER_MAX_KEYS];
@@ -264,6 +259,9 @@ static bool hid_connected = false;
 static HidStateCallback callback;
 static void* cb_ctx;
 static uint8_t led_state;
+static uint8_t hid_poll_interval = HID_POLL_INTERVAL_DEFAULT;
+
+static HidKbQueue hid_kb_queue;
 
 bool furi_hal_hid_is_connected() {
     return hid_connected;
@@ -362,6 +360,160 @@ bool furi_hal_hid_consumer_key_release(uint16_t button) {
     return hid_send_report(ReportIdConsumer);
 }
 
+bool furi_hal_hid_kb_pack_key(
+    struct HidReportKB* report,
+    uint16_t button,
+    HidKbReportCallback callback,
+    void* context) {
+    uint8_t key = button & 0xFF;
+    uint8_t mods = button >> 8;
+
+    // Pressed key must be released before next press, modifiers apply to all pressed keys
+    bool release = (report->mods != mods) || (key == KEY_NONE);
+    bool full = true;
+    for(uint8_t key_nb = 0; key_nb < HID_KB_MAX_KEYS; key_nb++) {
+        if(report->btn[key_nb] == key) release = true;
+        if(report->btn[key_nb] == 0) full = false;
+    }
+    if(full) release = true;
+
+    if(release) {
+        if(!furi_hal_hid_kb_pack_release(report, callback, context)) return false;
+    }
+
+    report->mods = mods;
+    if(key == KEY_NONE) {
+        // Modifiers only: nothing to pack with
+        if(!callback(report, context)) return false;
+        return furi_hal_hid_kb_pack_release(report, callback, context);
+    }
+
+    for(uint8_t key_nb = 0; key_nb < HID_KB_MAX_KEYS; key_nb++) {
+        if(report->btn[key_nb] == 0) {
+            report->btn[key_nb] = key;
+            break;
+        }
+    }
+    return callback(report, context);
+}
+
+bool furi_hal_hid_kb_pack_release(
+    struct HidReportKB* report,
+    HidKbReportCallback callback,
+    void* context) {
+    bool pressed = (report->mods != 0);
+    for(uint8_t key_nb = 0; key_nb < HID_KB_MAX_KEYS; key_nb++) {
+        if(report->btn[key_nb] != 0) pressed = true;
+        report->btn[key_nb] = 0;
+    }
+    report->mods = 0;
+
+    if(pressed) return callback(report, context);
+    return true;
+}
+
+void furi_hal_hid_kb_queue_init(
+    HidKbQueue* queue,
+    osSemaphoreId_t endpoint,
+    HidKbQueueWriteCallback write,
+    void* context) {
+    queue->head = 0;
+    queue->count = 0;
+    queue->active = false;
+    queue->free_slots = osSemaphoreNew(HID_KB_QUEUE_SIZE, HID_KB_QUEUE_SIZE, NULL);
+    queue->endpoint = endpoint;
+    queue->write = write;
+    queue->context = context;
+}
+
+void furi_hal_hid_kb_queue_deinit(HidKbQueue* queue) {
+    osSemaphoreDelete(queue->free_slots);
+    queue->free_slots = NULL;
+}
+
+/* Send next queued keyboard report, called by TX callback or by endpoint semaphore holder */
+static bool furi_hal_hid_kb_queue_send_next(HidKbQueue* queue) {
+    bool sent = false;
+    FURI_CRITICAL_ENTER();
+    if(queue->count > 0) {
+        queue->write(&queue->reports[queue->head], queue->context);
+        queue->head = (queue->head + 1) % HID_KB_QUEUE_SIZE;
+        queue->count--;
+        sent = true;
+    }
+    FURI_CRITICAL_EXIT();
+
+    if(sent) osSemaphoreRelease(queue->free_slots);
+    return sent;
+}
+
+void furi_hal_hid_kb_queue_reset(HidKbQueue* queue, bool active) {
+    FURI_CRITICAL_ENTER();
+    uint8_t count = queue->count;
+    queue->count = 0;
+    queue->active = active;
+    FURI_CRITICAL_EXIT();
+
+    for(; count > 0; count--) {
+        osSemaphoreRelease(queue->free_slots);
+    }
+}
+
+bool furi_hal_hid_kb_queue_push(HidKbQueue* queue, const struct HidReportKB* report) {
+    if(queue->active == false) return false;
+
+    // Wait for free slot, queue is reset on disconnect
+    furi_check(osSemaphoreAcquire(queue->free_slots, osWaitForever) == osOK);
+    if(queue->active == false) {
+        osSemaphoreRelease(queue->free_slots);
+        return false;
+    }
+
+    FURI_CRITICAL_ENTER();
+    uint8_t slot = (queue->head + queue->count) % HID_KB_QUEUE_SIZE;
+    memcpy(&queue->reports[slot], report, sizeof(struct HidReportKB));
+    queue->count++;
+    FURI_CRITICAL_EXIT();
+
+    // Start transmission if endpoint is idle, the rest is sent from TX complete callback
+    if(osSemaphoreAcquire(queue->endpoint, 0) == osOK) {
+        if(!furi_hal_hid_kb_queue_send_next(queue)) osSemaphoreRelease(queue->endpoint);
+    }
+    return true;
+}
+
+void furi_hal_hid_kb_queue_tx_complete(HidKbQueue* queue) {
+    if(!furi_hal_hid_kb_queue_send_next(queue)) osSemaphoreRelease(queue->endpoint);
+}
+
+static void hid_kb_queue_write(const struct HidReportKB* report, void* context) {
+    UNUSED(context);
+    usbd_ep_write(usb_dev, HID_EP_IN, (void*)report, sizeof(struct HidReportKB));
+}
+
+static bool hid_kb_queue_report(const struct HidReportKB* report, void* context) {
+    UNUSED(context);
+    return furi_hal_hid_kb_queue_push(&hid_kb_queue, report);
+}
+
+bool furi_hal_hid_kb_queue_key(uint16_t button) {
+    return furi_hal_hid_kb_pack_key(&hid_report.keyboard, button, hid_kb_queue_report, NULL);
+}
+
+bool furi_hal_hid_kb_queue_flush() {
+    bool state = furi_hal_hid_kb_pack_release(&hid_report.keyboard, hid_kb_queue_report, NULL);
+    if((hid_semaphore == NULL) || (hid_connected == false)) return false;
+
+    // Endpoint is released when queue is empty
+    furi_check(osSemaphoreAcquire(hid_semaphore, osWaitForever) == osOK);
+    osSemaphoreRelease(hid_semaphore);
+    return state && hid_connected;
+}
+
+void furi_hal_hid_set_poll_interval(uint8_t interval) {
+    hid_poll_interval = (interval > 0) ? interval : HID_POLL_INTERVAL_DEFAULT;
+}
+
 static void* hid_set_string_descr(char* str) {
     furi_assert(str);
 
@@ -377,6 +529,8 @@ static void* hid_set_string_descr(char* str) {
 static void hid_init(usbd_device* dev, FuriHalUsbInterface* intf, void* ctx) {
     FuriHalUsbHidConfig* cfg = (FuriHalUsbHidConfig*)ctx;
     if(hid_semaphore == NULL) hid_semaphore = osSemaphoreNew(1, 1, NULL);
+    if(hid_kb_queue.free_slots == NULL)
+        furi_hal_hid_kb_queue_init(&hid_kb_queue, hid_semaphore, hid_kb_queue_write, NULL);
     usb_dev = dev;
     hid_report.keyboard.report_id = ReportIdKeyboard;
     hid_report.mouse.report_id = ReportIdMouse;
@@ -388,6 +542,7 @@ static void hid_init(usbd_device* dev, FuriHalUsbInterface* intf, void* ctx) {
     usb_hid.str_prod_descr = NULL;
     usb_hid.dev_descr->idVendor = HID_VID_DEFAULT;
     usb_hid.dev_descr->idProduct = HID_PID_DEFAULT;
+    hid_cfg_desc.iad_0.hid_ep_in.bInterval = hid_poll_interval;
 
     if(cfg != NULL) {
         usb_hid.dev_descr->idVendor = cfg->vid;
@@ -420,6 +575,7 @@ static void hid_deinit(usbd_device* dev) {
 
 static void hid_on_wakeup(usbd_device* dev) {
     if(hid_connected == false) {
+        furi_hal_hid_kb_queue_reset(&hid_kb_queue, true);
         hid_connected = true;
         if(callback != NULL) callback(true, cb_ctx);
     }
@@ -428,6 +584,7 @@ static void hid_on_wakeup(usbd_device* dev) {
 static void hid_on_suspend(usbd_device* dev) {
     if(hid_connected == true) {
         hid_connected = false;
+        furi_hal_hid_kb_queue_reset(&hid_kb_queue, false);
         osSemaphoreRelease(hid_semaphore);
         if(callback != NULL) callback(false, cb_ctx);
     }
@@ -451,7 +608,7 @@ static bool hid_send_report(uint8_t report_id) {
 
 static void hid_txrx_ep_callback(usbd_device* dev, uint8_t event, uint8_t ep) {
     if(event == usbd_evt_eptx) {
-        osSemaphoreRelease(hid_semaphore);
+        furi_hal_hid_kb_queue_tx_complete(&hid_kb_queue);
     } else {
         struct HidReportLED leds;
         usbd_ep_read(usb_dev, ep, &leds, 2);
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <cmsis_os2.h>
+
+#define HID_KB_MAX_KEYS 6
+#define HID_KB_QUEUE_SIZE 16
+
+struct HidReportKB {
+    uint8_t report_id;
+    uint8_t mods;
+    uint8_t reserved;
+    uint8_t btn[HID_KB_MAX_KEYS];
+} __attribute__((packed));
+
+/** Keyboard report output callback
+ *
+ * @param      report   report to send, valid only during the call
+ * @param      context  callback context
+ *
+ * @return     true on success
+ */
+typedef bool (*HidKbReportCallback)(const struct HidReportKB* report, void* context);
+
+/** Add key stroke to keyboard report
+ *
+ * Key stays pressed after the stroke: next different key is added to the same
+ * report, host sees it as a new key press. Keys are released only when key
+ * repeats, modifiers change or report is full. Report after the last stroke
+ * must be released with furi_hal_hid_kb_pack_release.
+ *
+ * @param      report    keyboard report
+ * @param      button    key code with modifiers
+ * @param      callback  report output callback
+ * @param      context   callback context
+ *
+ * @return     true if all reports were sent
+ */
+bool furi_hal_hid_kb_pack_key(
+    struct HidReportKB* report,
+    uint16_t button,
+    HidKbReportCallback callback,
+    void* context);
+
+/** Release all keys of keyboard report
+ *
+ * @param      report    keyboard report
+ * @param      callback  report output callback, not called if nothing is pressed
+ * @param      context   callback context
+ *
+ * @return     true on success
+ */
+bool furi_hal_hid_kb_pack_release(
+    struct HidReportKB* report,
+    HidKbReportCallback callback,
+    void* context);
+
+/** Keyboard report endpoint write callback
+ *
+ * @param      report   report to write, valid only during the call
+ * @param      context  callback context
+ */
+typedef void (*HidKbQueueWriteCallback)(const struct HidReportKB* report, void* context);
+
+/** Keyboard reports waiting for transmission, one report per TX complete event */
+typedef struct {
+    struct HidReportKB reports[HID_KB_QUEUE_SIZE];
+    uint8_t head;
+    uint8_t count;
+    volatile bool active;
+    osSemaphoreId_t free_slots;
+    osSemaphoreId_t endpoint;
+    HidKbQueueWriteCallback write;
+    void* context;
+} HidKbQueue;
+
+/** Init keyboard report queue, queue is inactive until reset
+ *
+ * @param      queue     queue instance
+ * @param      endpoint  endpoint semaphore, held while queue is being sent
+ * @param      write     endpoint write callback
+ * @param      context   callback context
+ */
+void furi_hal_hid_kb_queue_init(
+    HidKbQueue* queue,
+    osSemaphoreId_t endpoint,
+    HidKbQueueWriteCallback write,
+    void* context);
+
+/** Deinit keyboard report queue
+ *
+ * @param      queue  queue instance
+ */
+void furi_hal_hid_kb_queue_deinit(HidKbQueue* queue);
+
+/** Drop queued reports and wake up waiting producer
+ *
+ * @param      queue   queue instance
+ * @param      active  true if reports are accepted after reset
+ */
+void furi_hal_hid_kb_queue_reset(HidKbQueue* queue, bool active);
+
+/** Queue report, waits for free slot
+ * Transmission is started if endpoint is free
+ *
+ * @param      queue   queue instance
+ * @param      report  report to queue
+ *
+ * @return     false if queue is inactive
+ */
+bool furi_hal_hid_kb_queue_push(HidKbQueue* queue, const struct HidReportKB* report);
+
+/** Endpoint TX complete event, called from USB interrupt
+ * Next report is written, endpoint semaphore is released when queue is empty
+ *
+ * @param      queue  queue instance
+ */
+void furi_hal_hid_kb_queue_tx_complete(HidKbQueue* queue);
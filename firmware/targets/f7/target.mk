@@ -134,6 +134,17 @@ ifeq ($(INVERT_RFID_IN), 1)
 CFLAGS += -DINVERT_RFID_IN
 endif
 
+# Internal storage LittleFS profile overrides, defaults are in storage_int.h
+ifneq ($(STORAGE_INT_CACHE_SIZE),)
+CFLAGS += -DSTORAGE_INT_CACHE_SIZE=$(STORAGE_INT_CACHE_SIZE)
+endif
+ifneq ($(STORAGE_INT_LOOKAHEAD_SIZE),)
+CFLAGS += -DSTORAGE_INT_LOOKAHEAD_SIZE=$(STORAGE_INT_LOOKAHEAD_SIZE)
+endif
+ifneq ($(STORAGE_INT_BLOCK_CYCLES),)
+CFLAGS += -DSTORAGE_INT_BLOCK_CYCLES=$(STORAGE_INT_BLOCK_CYCLES)
+endif
+
 FURI_HAL_DIR = $(TARGET_DIR)/furi_hal
 CFLAGS += -I$(FURI_HAL_DIR)
 C_SOURCES += $(wildcard $(FURI_HAL_DIR)/*.c)
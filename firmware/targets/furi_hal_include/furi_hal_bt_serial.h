@@ -35,6 +35,7 @@ void furi_hal_bt_serial_notify_buffer_is_empty();
  * @param data  data buffer
  * @param size  data buffer size
  *
- * @return      true on success
+ * @return      SerialServiceTxStatusOk on success, SerialServiceTxStatusBusy if TX window
+ *              is full and data must be sent again after SerialServiceEventTypeDataSent
  */
-bool furi_hal_bt_serial_tx(uint8_t* data, uint16_t size);
+SerialServiceTxStatus furi_hal_bt_serial_tx(uint8_t* data, uint16_t size);
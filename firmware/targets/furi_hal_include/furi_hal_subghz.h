@@ -99,6 +99,12 @@ void furi_hal_subghz_write_packet(const uint8_t* data, uint8_t size);
  */
 bool furi_hal_subghz_rx_pipe_not_empty();
 
+/** Check if recieve FIFO is overflowed, RX must be flushed to recover
+ *
+ * @return     true if overflowed
+ */
+bool furi_hal_subghz_is_rx_overflow();
+
 /** Check if recieved data crc is valid
  *
  * @return     true if valid
@@ -347,4 +347,25 @@ bool furi_hal_hid_consumer_key_press(uint16_t button);
  *
  * @param      button  key code
  */
-bool furi_hal_hid_consumer_key_release(uint16_t button);
\ No newline at end of file
+bool furi_hal_hid_consumer_key_release(uint16_t button);
+
+/** Queue key stroke and send HID reports from USB interrupt
+ *
+ * Only reports needed to type keys in right order are sent: different keys
+ * are added to the same report without release. Keys may stay pressed until
+ * furi_hal_hid_kb_queue_flush, call it before any delay.
+ *
+ * @param      button  key code
+ */
+bool furi_hal_hid_kb_queue_key(uint16_t button);
+
+/** Release all queued keys and wait until queue is sent
+ *
+ */
+bool furi_hal_hid_kb_queue_flush();
+
+/** Set keyboard endpoint polling interval, applied on next HID interface init
+ *
+ * @param      interval  polling interval in ms, 0 - default
+ */
+void furi_hal_hid_set_poll_interval(uint8_t interval);
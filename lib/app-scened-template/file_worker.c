@@ -1,13 +1,21 @@
-#include "file_worker.h"
+#include "file_worker_i.h"
 #include <m-string.h>
 #include <lib/toolbox/hex.h>
 #include <dialogs/dialogs.h>
 #include <furi.h>
 
+// Storage reads up to 512 bytes at a time
+#define FILE_WORKER_READ_BUFFER_SIZE 512
+
 struct FileWorker {
     Storage* api;
     bool silent;
     File* file;
+    // Data read ahead from file, file position is at the end of buffer
+    uint8_t read_buffer[FILE_WORKER_READ_BUFFER_SIZE];
+    uint16_t read_buffer_size;
+    uint16_t read_buffer_offset;
+    uint32_t storage_reads;
 };
 
 bool file_worker_check_common_errors(FileWorker* file_worker);
@@ -19,12 +27,19 @@ bool file_worker_write_internal(
     uint16_t bytes_to_write);
 bool file_worker_tell_internal(FileWorker* file_worker, uint64_t* position);
 bool file_worker_seek_internal(FileWorker* file_worker, uint64_t position, bool from_start);
+static void file_worker_read_buffer_reset(FileWorker* file_worker);
+static bool file_worker_read_buffer_fill(FileWorker* file_worker);
+static bool file_worker_read_buffer_sync(FileWorker* file_worker);
+static uint16_t
+    file_worker_storage_read(FileWorker* file_worker, void* buffer, uint16_t bytes_to_read);
 
 FileWorker* file_worker_alloc(bool _silent) {
     FileWorker* file_worker = malloc(sizeof(FileWorker));
     file_worker->silent = _silent;
     file_worker->api = furi_record_open("storage");
     file_worker->file = storage_file_alloc(file_worker->api);
+    file_worker->storage_reads = 0;
+    file_worker_read_buffer_reset(file_worker);
 
     return file_worker;
 }
@@ -40,6 +55,7 @@ bool file_worker_open(
     const char* filename,
     FS_AccessMode access_mode,
     FS_OpenMode open_mode) {
+    file_worker_read_buffer_reset(file_worker);
     bool result = storage_file_open(file_worker->file, filename, access_mode, open_mode);
 
     if(!result) {
@@ -51,6 +67,7 @@ bool file_worker_open(
 }
 
 bool file_worker_close(FileWorker* file_worker) {
+    file_worker_read_buffer_reset(file_worker);
     if(storage_file_is_open(file_worker->file)) {
         storage_file_close(file_worker->file);
     }
@@ -115,41 +132,32 @@ bool file_worker_read(FileWorker* file_worker, void* buffer, uint16_t bytes_to_r
 
 bool file_worker_read_until(FileWorker* file_worker, string_t str_result, char separator) {
     string_reset(str_result);
-    const uint8_t buffer_size = 32;
-    uint8_t buffer[buffer_size];
 
-    do {
-        uint16_t read_count = storage_file_read(file_worker->file, buffer, buffer_size);
-        if(storage_file_get_error(file_worker->file) != FSE_OK) {
-            file_worker_show_error_internal(file_worker, "Cannot read\nfile");
-            return false;
+    while(true) {
+        if(file_worker->read_buffer_offset == file_worker->read_buffer_size) {
+            if(!file_worker_read_buffer_fill(file_worker)) {
+                return false;
+            }
+            if(file_worker->read_buffer_size == 0) {
+                break;
+            }
         }
 
-        bool result = false;
-        for(uint16_t i = 0; i < read_count; i++) {
-            if(buffer[i] == separator) {
-                uint64_t position;
-                if(!file_worker_tell_internal(file_worker, &position)) {
-                    return false;
-                }
-
-                position = position - read_count + i + 1;
-
-                if(!file_worker_seek_internal(file_worker, position, true)) {
-                    return false;
-                }
+        const uint8_t* data = &file_worker->read_buffer[file_worker->read_buffer_offset];
+        uint16_t data_size = file_worker->read_buffer_size - file_worker->read_buffer_offset;
+        const uint8_t* separator_ptr = memchr(data, separator, data_size);
+        uint16_t line_size = separator_ptr ? (separator_ptr - data) : data_size;
 
-                result = true;
-                break;
-            } else {
-                string_push_back(str_result, buffer[i]);
-            }
+        for(uint16_t i = 0; i < line_size; i++) {
+            string_push_back(str_result, data[i]);
         }
+        file_worker->read_buffer_offset += line_size;
 
-        if(result || read_count == 0) {
+        if(separator_ptr) {
+            file_worker->read_buffer_offset++;
             break;
         }
-    } while(true);
+    }
 
     return file_worker_check_common_errors(file_worker);
 }
@@ -271,7 +279,15 @@ void file_worker_show_error_internal(FileWorker* file_worker, const char* error_
 }
 
 bool file_worker_read_internal(FileWorker* file_worker, void* buffer, uint16_t bytes_to_read) {
-    uint16_t read_count = storage_file_read(file_worker->file, buffer, bytes_to_read);
+    uint16_t unread_size = file_worker->read_buffer_size - file_worker->read_buffer_offset;
+    uint16_t read_count = MIN(bytes_to_read, unread_size);
+    memcpy(buffer, &file_worker->read_buffer[file_worker->read_buffer_offset], read_count);
+    file_worker->read_buffer_offset += read_count;
+
+    if(read_count < bytes_to_read) {
+        read_count += file_worker_storage_read(
+            file_worker, (uint8_t*)buffer + read_count, bytes_to_read - read_count);
+    }
 
     if(storage_file_get_error(file_worker->file) != FSE_OK || read_count != bytes_to_read) {
         file_worker_show_error_internal(file_worker, "Cannot read\nfile");
@@ -285,6 +301,10 @@ bool file_worker_write_internal(
     FileWorker* file_worker,
     const void* buffer,
     uint16_t bytes_to_write) {
+    if(!file_worker_read_buffer_sync(file_worker)) {
+        return false;
+    }
+
     uint16_t write_count = storage_file_write(file_worker->file, buffer, bytes_to_write);
 
     if(storage_file_get_error(file_worker->file) != FSE_OK || write_count != bytes_to_write) {
@@ -296,7 +316,8 @@ bool file_worker_write_internal(
 }
 
 bool file_worker_tell_internal(FileWorker* file_worker, uint64_t* position) {
-    *position = storage_file_tell(file_worker->file);
+    *position = storage_file_tell(file_worker->file) -
+                (file_worker->read_buffer_size - file_worker->read_buffer_offset);
 
     if(storage_file_get_error(file_worker->file) != FSE_OK) {
         file_worker_show_error_internal(file_worker, "Cannot tell\nfile offset");
@@ -307,6 +328,12 @@ bool file_worker_tell_internal(FileWorker* file_worker, uint64_t* position) {
 }
 
 bool file_worker_seek_internal(FileWorker* file_worker, uint64_t position, bool from_start) {
+    if(from_start) {
+        file_worker_read_buffer_reset(file_worker);
+    } else if(!file_worker_read_buffer_sync(file_worker)) {
+        return false;
+    }
+
     storage_file_seek(file_worker->file, position, from_start);
     if(storage_file_get_error(file_worker->file) != FSE_OK) {
         file_worker_show_error_internal(file_worker, "Cannot seek\nfile");
@@ -316,6 +343,51 @@ bool file_worker_seek_internal(FileWorker* file_worker, uint64_t position, bool
     return true;
 }
 
+static uint16_t
+    file_worker_storage_read(FileWorker* file_worker, void* buffer, uint16_t bytes_to_read) {
+    file_worker->storage_reads++;
+    return storage_file_read(file_worker->file, buffer, bytes_to_read);
+}
+
+uint32_t file_worker_get_storage_reads(FileWorker* file_worker) {
+    return file_worker->storage_reads;
+}
+
+static void file_worker_read_buffer_reset(FileWorker* file_worker) {
+    file_worker->read_buffer_size = 0;
+    file_worker->read_buffer_offset = 0;
+}
+
+static bool file_worker_read_buffer_fill(FileWorker* file_worker) {
+    file_worker->read_buffer_offset = 0;
+    file_worker->read_buffer_size = file_worker_storage_read(
+        file_worker, file_worker->read_buffer, FILE_WORKER_READ_BUFFER_SIZE);
+
+    if(storage_file_get_error(file_worker->file) != FSE_OK) {
+        file_worker_read_buffer_reset(file_worker);
+        file_worker_show_error_internal(file_worker, "Cannot read\nfile");
+        return false;
+    }
+
+    return true;
+}
+
+/** Move file position back to the first unread byte of buffer and drop buffer */
+static bool file_worker_read_buffer_sync(FileWorker* file_worker) {
+    uint16_t unread_size = file_worker->read_buffer_size - file_worker->read_buffer_offset;
+    file_worker_read_buffer_reset(file_worker);
+    if(unread_size == 0) {
+        return true;
+    }
+
+    uint64_t position;
+    if(!file_worker_tell_internal(file_worker, &position)) {
+        return false;
+    }
+
+    return file_worker_seek_internal(file_worker, position - unread_size, true);
+}
+
 bool file_worker_read_until_buffered(
     FileWorker* file_worker,
     string_t str_result,
@@ -334,6 +406,11 @@ bool file_worker_read_until_buffered(
     bool max_length_exceeded = false;
     size_t max_length = string_capacity(str_result) - 1;
 
+    if(!file_worker_read_buffer_sync(file_worker)) {
+        *file_buf_cnt = 0;
+        return false;
+    }
+
     while(1) {
         if(*file_buf_cnt > 0) {
             size_t end_index = 0;
@@ -363,8 +440,8 @@ bool file_worker_read_until_buffered(
             if(found_eol) break;
         }
 
-        *file_buf_cnt += storage_file_read(
-            file_worker->file, &file_buf[*file_buf_cnt], file_buf_size - *file_buf_cnt);
+        *file_buf_cnt += file_worker_storage_read(
+            file_worker, &file_buf[*file_buf_cnt], file_buf_size - *file_buf_cnt);
         if(storage_file_get_error(file_worker->file) != FSE_OK) {
             file_worker_show_error_internal(file_worker, "Cannot read\nfile");
             string_reset(str_result);
@@ -97,6 +97,7 @@ bool file_worker_read(FileWorker* file_worker, void* buffer, uint16_t bytes_to_r
 /**
  * @brief Reads data from a file until separator or EOF is found. 
  * Moves seek pointer to the next symbol after the separator. The separator is not included in the result.
+ * File is read ahead in blocks, other FileWorker calls see the position right after the separator.
  * 
  * @param file_worker FileWorker instance 
  * @param result 
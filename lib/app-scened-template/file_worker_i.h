@@ -0,0 +1,24 @@
+/**
+ * @file file_worker_i.h
+ * FileWorker internal API
+ */
+
+#pragma once
+
+#include "file_worker.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Get count of storage reads done since file_worker_alloc, to check read ahead efficiency
+ * 
+ * @param file_worker 
+ * @return uint32_t 
+ */
+uint32_t file_worker_get_storage_reads(FileWorker* file_worker);
+
+#ifdef __cplusplus
+}
+#endif
@@ -9,12 +9,11 @@
 
 static void infrared_common_decoder_reset_state(InfraredCommonDecoder* decoder);
 
-static inline size_t consume_samples(uint32_t* array, size_t len, size_t shift) {
-    furi_assert(len >= shift);
-    len -= shift;
-    for(int i = 0; i < len; ++i) array[i] = array[i + shift];
-
-    return len;
+static inline void consume_samples(InfraredCommonDecoder* decoder, uint8_t shift) {
+    furi_assert(decoder->timings_cnt >= shift);
+    decoder->timings_head =
+        (decoder->timings_head + shift) & (INFRARED_COMMON_DECODER_TIMINGS_SIZE - 1);
+    decoder->timings_cnt -= shift;
 }
 
 static inline void accumulate_lsb(InfraredCommonDecoder* decoder, bool bit) {
@@ -42,7 +41,7 @@ static bool infrared_check_preamble(InfraredCommonDecoder* decoder) {
 
     // align to start at Mark timing
     if(!start_level) {
-        decoder->timings_cnt = consume_samples(decoder->timings, decoder->timings_cnt, 1);
+        consume_samples(decoder, 1);
     }
 
     if(decoder->protocol->timings.preamble_mark == 0) {
@@ -50,16 +49,15 @@ static bool infrared_check_preamble(InfraredCommonDecoder* decoder) {
     }
 
     while((!result) && (decoder->timings_cnt >= 2)) {
-        float preamble_tolerance = decoder->protocol->timings.preamble_tolerance;
-        uint16_t preamble_mark = decoder->protocol->timings.preamble_mark;
-        uint16_t preamble_space = decoder->protocol->timings.preamble_space;
+        uint32_t mark = infrared_common_decoder_get_timing(decoder, 0);
+        uint32_t space = infrared_common_decoder_get_timing(decoder, 1);
 
-        if((MATCH_TIMING(decoder->timings[0], preamble_mark, preamble_tolerance)) &&
-           (MATCH_TIMING(decoder->timings[1], preamble_space, preamble_tolerance))) {
+        if(infrared_timing_match(mark, &decoder->ranges.preamble_mark) &&
+           infrared_timing_match(space, &decoder->ranges.preamble_space)) {
             result = true;
         }
 
-        decoder->timings_cnt = consume_samples(decoder->timings, decoder->timings_cnt, 2);
+        consume_samples(decoder, 2);
     }
 
     return result;
@@ -78,7 +76,7 @@ static InfraredStatus infrared_common_decode_bits(InfraredCommonDecoder* decoder
 
     while(decoder->timings_cnt && (status == InfraredStatusOk)) {
         bool level = (decoder->level + decoder->timings_cnt + 1) % 2;
-        uint32_t timing = decoder->timings[0];
+        uint32_t timing = infrared_common_decoder_get_timing(decoder, 0);
 
         if(timings->min_split_time && !level) {
             if(timing > timings->min_split_time) {
@@ -102,7 +100,7 @@ static InfraredStatus infrared_common_decode_bits(InfraredCommonDecoder* decoder
         if(status == InfraredStatusError) {
             break;
         }
-        decoder->timings_cnt = consume_samples(decoder->timings, decoder->timings_cnt, 1);
+        consume_samples(decoder, 1);
 
         /* check if largest protocol version can be decoded */
         if(level && (decoder->protocol->databit_len[0] == decoder->databit_cnt) &&
@@ -121,27 +119,26 @@ InfraredStatus
     furi_assert(decoder);
 
     InfraredStatus status = InfraredStatusOk;
-    uint32_t bit_tolerance = decoder->protocol->timings.bit_tolerance;
-    uint16_t bit1_mark = decoder->protocol->timings.bit1_mark;
-    uint16_t bit1_space = decoder->protocol->timings.bit1_space;
-    uint16_t bit0_mark = decoder->protocol->timings.bit0_mark;
-    uint16_t bit0_space = decoder->protocol->timings.bit0_space;
+    const InfraredTimings* timings = &decoder->protocol->timings;
+    const InfraredCommonDecoderRanges* ranges = &decoder->ranges;
+    bool same_marks = (timings->bit1_mark == timings->bit0_mark);
 
-    bool analyze_timing = level ^ (bit1_mark == bit0_mark);
-    uint16_t bit1 = level ? bit1_mark : bit1_space;
-    uint16_t bit0 = level ? bit0_mark : bit0_space;
-    uint16_t no_info_timing = (bit1_mark == bit0_mark) ? bit1_mark : bit1_space;
+    bool analyze_timing = level ^ same_marks;
+    const InfraredTimingRange* bit1 = level ? &ranges->bit1_mark : &ranges->bit1_space;
+    const InfraredTimingRange* bit0 = level ? &ranges->bit0_mark : &ranges->bit0_space;
+    const InfraredTimingRange* no_info_timing = same_marks ? &ranges->bit1_mark :
+                                                             &ranges->bit1_space;
 
     if(analyze_timing) {
-        if(MATCH_TIMING(timing, bit1, bit_tolerance)) {
+        if(infrared_timing_match(timing, bit1)) {
             accumulate_lsb(decoder, 1);
-        } else if(MATCH_TIMING(timing, bit0, bit_tolerance)) {
+        } else if(infrared_timing_match(timing, bit0)) {
             accumulate_lsb(decoder, 0);
         } else {
             status = InfraredStatusError;
         }
     } else {
-        if(!MATCH_TIMING(timing, no_info_timing, bit_tolerance)) {
+        if(!infrared_timing_match(timing, no_info_timing)) {
             status = InfraredStatusError;
         }
     }
@@ -153,14 +150,12 @@ InfraredStatus
 InfraredStatus
     infrared_common_decode_manchester(InfraredCommonDecoder* decoder, bool level, uint32_t timing) {
     furi_assert(decoder);
-    uint16_t bit = decoder->protocol->timings.bit1_mark;
-    uint16_t tolerance = decoder->protocol->timings.bit_tolerance;
 
     bool* switch_detect = &decoder->switch_detect;
     furi_assert((*switch_detect == true) || (*switch_detect == false));
 
-    bool single_timing = MATCH_TIMING(timing, bit, tolerance);
-    bool double_timing = MATCH_TIMING(timing, 2 * bit, tolerance);
+    bool single_timing = infrared_timing_match(timing, &decoder->ranges.bit1_mark);
+    bool double_timing = infrared_timing_match(timing, &decoder->ranges.bit1_mark_double);
 
     if(!single_timing && !double_timing) {
         return InfraredStatusError;
@@ -230,9 +225,11 @@ InfraredMessage*
     }
     decoder->level = level; // start with low level (Space timing)
 
-    decoder->timings[decoder->timings_cnt] = duration;
+    furi_check(decoder->timings_cnt < INFRARED_COMMON_DECODER_TIMINGS_SIZE);
+    uint8_t tail = (decoder->timings_head + decoder->timings_cnt) &
+                   (INFRARED_COMMON_DECODER_TIMINGS_SIZE - 1);
+    decoder->timings[tail] = duration;
     decoder->timings_cnt++;
-    furi_check(decoder->timings_cnt <= sizeof(decoder->timings));
 
     while(1) {
         switch(decoder->state) {
@@ -276,6 +273,37 @@ InfraredMessage*
     return message;
 }
 
+/* Same bounds as MATCH_TIMING() gives: (x > value - tolerance) && (x < value + tolerance) */
+static void infrared_common_decoder_init_range(
+    InfraredTimingRange* range,
+    uint32_t value,
+    uint32_t tolerance) {
+    range->min = (value >= tolerance) ? (value - tolerance + 1) : 0;
+    range->max = value + tolerance - 1;
+}
+
+static void infrared_common_decoder_init_ranges(InfraredCommonDecoder* decoder) {
+    const InfraredTimings* timings = &decoder->protocol->timings;
+    InfraredCommonDecoderRanges* ranges = &decoder->ranges;
+
+    infrared_common_decoder_init_range(
+        &ranges->preamble_mark, timings->preamble_mark, timings->preamble_tolerance);
+    infrared_common_decoder_init_range(
+        &ranges->preamble_space, timings->preamble_space, timings->preamble_tolerance);
+    infrared_common_decoder_init_range(
+        &ranges->bit1_mark, timings->bit1_mark, timings->bit_tolerance);
+    infrared_common_decoder_init_range(
+        &ranges->bit1_space, timings->bit1_space, timings->bit_tolerance);
+    infrared_common_decoder_init_range(
+        &ranges->bit0_mark, timings->bit0_mark, timings->bit_tolerance);
+    infrared_common_decoder_init_range(
+        &ranges->bit0_space, timings->bit0_space, timings->bit_tolerance);
+    infrared_common_decoder_init_range(
+        &ranges->bit1_mark_double, 2 * timings->bit1_mark, timings->bit_tolerance);
+    infrared_common_decoder_init_range(
+        &ranges->bit1_mark_triple, 3 * timings->bit1_mark, timings->bit_tolerance);
+}
+
 void* infrared_common_decoder_alloc(const InfraredCommonProtocolSpec* protocol) {
     furi_assert(protocol);
 
@@ -289,6 +317,9 @@ void* infrared_common_decoder_alloc(const InfraredCommonProtocolSpec* protocol)
     InfraredCommonDecoder* decoder = malloc(alloc_size);
     decoder->protocol = protocol;
     decoder->level = true;
+    decoder->timings_head = 0;
+    decoder->timings_cnt = 0;
+    infrared_common_decoder_init_ranges(decoder);
     return decoder;
 }
 
@@ -304,7 +335,7 @@ void infrared_common_decoder_reset_state(InfraredCommonDecoder* decoder) {
     decoder->message.protocol = InfraredProtocolUnknown;
     if(decoder->protocol->timings.preamble_mark == 0) {
         if(decoder->timings_cnt > 0) {
-            decoder->timings_cnt = consume_samples(decoder->timings, decoder->timings_cnt, 1);
+            consume_samples(decoder, 1);
         }
     }
 }
@@ -313,5 +344,6 @@ void infrared_common_decoder_reset(InfraredCommonDecoder* decoder) {
     furi_assert(decoder);
 
     infrared_common_decoder_reset_state(decoder);
+    decoder->timings_head = 0;
     decoder->timings_cnt = 0;
 }
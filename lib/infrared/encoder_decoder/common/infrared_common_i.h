@@ -6,6 +6,9 @@
 
 #define MATCH_TIMING(x, v, delta) (((x) < (v + delta)) && ((x) > (v - delta)))
 
+/* Must be power of 2, used as ring buffer size */
+#define INFRARED_COMMON_DECODER_TIMINGS_SIZE 8
+
 typedef struct InfraredCommonDecoder InfraredCommonDecoder;
 typedef struct InfraredCommonEncoder InfraredCommonEncoder;
 
@@ -27,6 +30,27 @@ typedef struct {
     InfraredCommonEncode encode_repeat;
 } InfraredCommonProtocolSpec;
 
+/* Inclusive bounds of timing, precalculated from nominal value and tolerance */
+typedef struct {
+    uint32_t min;
+    uint32_t max;
+} InfraredTimingRange;
+
+/* Constant range initializer with same bounds as MATCH_TIMING(), value >= tolerance */
+#define INFRARED_TIMING_RANGE(value, tolerance) \
+    { .min = (value) - (tolerance) + 1, .max = (value) + (tolerance)-1 }
+
+typedef struct {
+    InfraredTimingRange preamble_mark;
+    InfraredTimingRange preamble_space;
+    InfraredTimingRange bit1_mark;
+    InfraredTimingRange bit1_space;
+    InfraredTimingRange bit0_mark;
+    InfraredTimingRange bit0_space;
+    InfraredTimingRange bit1_mark_double;
+    InfraredTimingRange bit1_mark_triple;
+} InfraredCommonDecoderRanges;
+
 typedef enum {
     InfraredCommonDecoderStateWaitPreamble,
     InfraredCommonDecoderStateDecode,
@@ -43,9 +67,11 @@ typedef enum {
 struct InfraredCommonDecoder {
     const InfraredCommonProtocolSpec* protocol;
     void* context;
-    uint32_t timings[6];
+    InfraredCommonDecoderRanges ranges;
+    uint32_t timings[INFRARED_COMMON_DECODER_TIMINGS_SIZE];
     InfraredMessage message;
     InfraredCommonStateDecoder state;
+    uint8_t timings_head;
     uint8_t timings_cnt;
     bool switch_detect;
     bool level;
@@ -65,6 +91,17 @@ struct InfraredCommonEncoder {
     uint8_t data[];
 };
 
+static inline bool infrared_timing_match(uint32_t timing, const InfraredTimingRange* range) {
+    return (timing >= range->min) && (timing <= range->max);
+}
+
+/* Returns timing by index, counting from the oldest one stored in decoder */
+static inline uint32_t
+    infrared_common_decoder_get_timing(const InfraredCommonDecoder* decoder, uint8_t index) {
+    return decoder->timings[(decoder->timings_head + index) &
+                            (INFRARED_COMMON_DECODER_TIMINGS_SIZE - 1)];
+}
+
 InfraredMessage*
     infrared_common_decode(InfraredCommonDecoder* decoder, bool level, uint32_t duration);
 InfraredStatus
@@ -61,11 +61,11 @@ InfraredStatus infrared_decoder_rc6_decode_manchester(
     // 4th bit lasts 2x times more
     InfraredStatus status = InfraredStatusError;
     uint16_t bit = decoder->protocol->timings.bit1_mark;
-    uint16_t tolerance = decoder->protocol->timings.bit_tolerance;
+    const InfraredCommonDecoderRanges* ranges = &decoder->ranges;
 
-    bool single_timing = MATCH_TIMING(timing, bit, tolerance);
-    bool double_timing = MATCH_TIMING(timing, 2 * bit, tolerance);
-    bool triple_timing = MATCH_TIMING(timing, 3 * bit, tolerance);
+    bool single_timing = infrared_timing_match(timing, &ranges->bit1_mark);
+    bool double_timing = infrared_timing_match(timing, &ranges->bit1_mark_double);
+    bool triple_timing = infrared_timing_match(timing, &ranges->bit1_mark_triple);
 
     if(decoder->databit_cnt == 4) {
         furi_assert(decoder->switch_detect == true);
@@ -29,23 +29,34 @@ bool infrared_decoder_samsung32_interpret(InfraredCommonDecoder* decoder) {
     return result;
 }
 
+static const InfraredTimingRange infrared_samsung_repeat_mark =
+    INFRARED_TIMING_RANGE(INFRARED_SAMSUNG_REPEAT_MARK, INFRARED_SAMSUNG_PREAMBLE_TOLERANCE);
+static const InfraredTimingRange infrared_samsung_repeat_space =
+    INFRARED_TIMING_RANGE(INFRARED_SAMSUNG_REPEAT_SPACE, INFRARED_SAMSUNG_PREAMBLE_TOLERANCE);
+
 // timings start from Space (delay between message and repeat)
 InfraredStatus infrared_decoder_samsung32_decode_repeat(InfraredCommonDecoder* decoder) {
     furi_assert(decoder);
 
-    float preamble_tolerance = decoder->protocol->timings.preamble_tolerance;
-    uint32_t bit_tolerance = decoder->protocol->timings.bit_tolerance;
+    const InfraredCommonDecoderRanges* ranges = &decoder->ranges;
     InfraredStatus status = InfraredStatusError;
 
     if(decoder->timings_cnt < 6) return InfraredStatusOk;
 
-    if((decoder->timings[0] > INFRARED_SAMSUNG_REPEAT_PAUSE_MIN) &&
-       (decoder->timings[0] < INFRARED_SAMSUNG_REPEAT_PAUSE_MAX) &&
-       MATCH_TIMING(decoder->timings[1], INFRARED_SAMSUNG_REPEAT_MARK, preamble_tolerance) &&
-       MATCH_TIMING(decoder->timings[2], INFRARED_SAMSUNG_REPEAT_SPACE, preamble_tolerance) &&
-       MATCH_TIMING(decoder->timings[3], decoder->protocol->timings.bit1_mark, bit_tolerance) &&
-       MATCH_TIMING(decoder->timings[4], decoder->protocol->timings.bit1_space, bit_tolerance) &&
-       MATCH_TIMING(decoder->timings[5], decoder->protocol->timings.bit1_mark, bit_tolerance)) {
+    uint32_t pause = infrared_common_decoder_get_timing(decoder, 0);
+    uint32_t repeat_mark = infrared_common_decoder_get_timing(decoder, 1);
+    uint32_t repeat_space = infrared_common_decoder_get_timing(decoder, 2);
+    uint32_t bit1_mark = infrared_common_decoder_get_timing(decoder, 3);
+    uint32_t bit1_space = infrared_common_decoder_get_timing(decoder, 4);
+    uint32_t stop_mark = infrared_common_decoder_get_timing(decoder, 5);
+
+    if((pause > INFRARED_SAMSUNG_REPEAT_PAUSE_MIN) &&
+       (pause < INFRARED_SAMSUNG_REPEAT_PAUSE_MAX) &&
+       infrared_timing_match(repeat_mark, &infrared_samsung_repeat_mark) &&
+       infrared_timing_match(repeat_space, &infrared_samsung_repeat_space) &&
+       infrared_timing_match(bit1_mark, &ranges->bit1_mark) &&
+       infrared_timing_match(bit1_space, &ranges->bit1_space) &&
+       infrared_timing_match(stop_mark, &ranges->bit1_mark)) {
         status = InfraredStatusReady;
         decoder->timings_cnt = 0;
     } else {
@@ -117,6 +117,10 @@ C_SOURCES		+= $(wildcard $(LIB_DIR)/flipper_format/*.c)
 
 # Micro-ECC
 CFLAGS			+= -I$(LIB_DIR)/micro-ecc
+# Only secp256r1 is used: unrolled assembly for single curve and dedicated square function
+CFLAGS			+= -DuECC_OPTIMIZATION_LEVEL=3 -DuECC_SQUARE_FUNC=1
+CFLAGS			+= -DuECC_SUPPORTS_secp160r1=0 -DuECC_SUPPORTS_secp192r1=0
+CFLAGS			+= -DuECC_SUPPORTS_secp224r1=0 -DuECC_SUPPORTS_secp256k1=0
 C_SOURCES		+= $(wildcard $(LIB_DIR)/micro-ecc/*.c)
 
 # iButton and OneWire
@@ -1419,9 +1419,18 @@ int uECC_sign_deterministic(const uint8_t *private_key,
     uint8_t *V = K + hash_context->result_size;
     wordcount_t num_bytes = curve->num_bytes;
     wordcount_t num_n_words = BITS_TO_WORDS(curve->num_n_bits);
-    bitcount_t num_n_bits = curve->num_n_bits;
+    wordcount_t num_n_bytes = BITS_TO_BYTES(curve->num_n_bits);
     uECC_word_t tries;
     unsigned i;
+    /* h1 = bits2octets(h(m)) = int2octets(bits2int(h(m)) mod n), as in RFC 6979 */
+    uECC_word_t h1[uECC_MAX_WORDS];
+    uint8_t h1_bytes[uECC_MAX_WORDS * uECC_WORD_SIZE];
+    bits2int(h1, message_hash, hash_size, curve);
+    if (uECC_vli_cmp_unsafe(curve->n, h1, num_n_words) != 1) {
+        uECC_vli_sub(h1, h1, curve->n, num_n_words);
+    }
+    uECC_vli_nativeToBytes(h1_bytes, num_n_bytes, h1);
+
     for (i = 0; i < hash_context->result_size; ++i) {
         V[i] = 0x01;
         K[i] = 0;
@@ -1432,7 +1441,7 @@ int uECC_sign_deterministic(const uint8_t *private_key,
     V[hash_context->result_size] = 0x00;
     HMAC_update(hash_context, V, hash_context->result_size + 1);
     HMAC_update(hash_context, private_key, num_bytes);
-    HMAC_update(hash_context, message_hash, hash_size);
+    HMAC_update(hash_context, h1_bytes, num_n_bytes);
     HMAC_finish(hash_context, K, K);
 
     update_V(hash_context, K, V);
@@ -1442,30 +1451,27 @@ int uECC_sign_deterministic(const uint8_t *private_key,
     V[hash_context->result_size] = 0x01;
     HMAC_update(hash_context, V, hash_context->result_size + 1);
     HMAC_update(hash_context, private_key, num_bytes);
-    HMAC_update(hash_context, message_hash, hash_size);
+    HMAC_update(hash_context, h1_bytes, num_n_bytes);
     HMAC_finish(hash_context, K, K);
 
     update_V(hash_context, K, V);
 
     for (tries = 0; tries < uECC_RNG_MAX_TRIES; ++tries) {
         uECC_word_t T[uECC_MAX_WORDS];
-        uint8_t *T_ptr = (uint8_t *)T;
+        uint8_t T_ptr[uECC_MAX_WORDS * uECC_WORD_SIZE];
         wordcount_t T_bytes = 0;
         for (;;) {
             update_V(hash_context, K, V);
             for (i = 0; i < hash_context->result_size; ++i) {
                 T_ptr[T_bytes++] = V[i];
-                if (T_bytes >= num_n_words * uECC_WORD_SIZE) {
+                if (T_bytes >= num_n_bytes) {
                     goto filled;
                 }
             }
         }
     filled:
-        if ((bitcount_t)num_n_words * uECC_WORD_SIZE * 8 > num_n_bits) {
-            uECC_word_t mask = (uECC_word_t)-1;
-            T[num_n_words - 1] &=
-                mask >> ((bitcount_t)(num_n_words * uECC_WORD_SIZE * 8 - num_n_bits));
-        }
+        /* k = bits2int(T), big-endian as in RFC 6979 */
+        bits2int(T, T_ptr, num_n_bytes, curve);
 
         if (uECC_sign_with_k_internal(private_key, message_hash, hash_size, T, signature, curve)) {
             return 1;
@@ -0,0 +1,225 @@
+#include "subghz_tx_rx_frame.h"
+
+#include <furi.h>
+#include <furi_hal_random.h>
+
+// Header bytes
+#define SUBGHZ_TX_RX_FRAME_VERSION_POS 0
+#define SUBGHZ_TX_RX_FRAME_SENDER_ID_POS 1
+#define SUBGHZ_TX_RX_FRAME_SEQ_POS 3
+#define SUBGHZ_TX_RX_FRAME_FRAGMENT_POS 4
+// Fragment byte: fragment index in high nibble, fragments count - 1 in low nibble
+#define SUBGHZ_TX_RX_FRAME_INDEX_SHIFT 4
+#define SUBGHZ_TX_RX_FRAME_COUNT_MASK 0x0F
+
+struct SubGhzTxRxFrameEncoder {
+    const uint8_t* data;
+    size_t size;
+    size_t offset;
+    uint16_t sender_id;
+    uint8_t seq;
+    uint8_t index;
+    uint8_t count;
+};
+
+/* Reassembly state of one sender */
+typedef struct {
+    uint8_t message[SUBGHZ_TX_RX_FRAME_MESSAGE_SIZE_MAX];
+    size_t size;
+    uint32_t last_heard;
+    uint16_t sender_id;
+    bool sender_valid;
+    bool message_valid;
+    uint8_t seq;
+    uint8_t index_next;
+    uint8_t count;
+} SubGhzTxRxFrameSender;
+
+struct SubGhzTxRxFrameDecoder {
+    SubGhzTxRxFrameSender senders[SUBGHZ_TX_RX_FRAME_SENDERS_MAX];
+    const uint8_t* message;
+    uint32_t packets;
+    uint32_t lost;
+};
+
+SubGhzTxRxFrameEncoder* subghz_tx_rx_frame_encoder_alloc() {
+    SubGhzTxRxFrameEncoder* instance = malloc(sizeof(SubGhzTxRxFrameEncoder));
+    instance->data = NULL;
+    instance->size = 0;
+    instance->offset = 0;
+    // New id every session, so receivers don't take restarted sequence for duplicates
+    instance->sender_id = furi_hal_random_get();
+    instance->seq = 0;
+    instance->index = 0;
+    instance->count = 0;
+    return instance;
+}
+
+void subghz_tx_rx_frame_encoder_free(SubGhzTxRxFrameEncoder* instance) {
+    furi_assert(instance);
+    free(instance);
+}
+
+uint16_t subghz_tx_rx_frame_encoder_get_sender_id(SubGhzTxRxFrameEncoder* instance) {
+    furi_assert(instance);
+    return instance->sender_id;
+}
+
+bool subghz_tx_rx_frame_encoder_set_message(
+    SubGhzTxRxFrameEncoder* instance,
+    const uint8_t* data,
+    size_t size) {
+    furi_assert(instance);
+    if(!size || (size > SUBGHZ_TX_RX_FRAME_MESSAGE_SIZE_MAX)) return false;
+
+    instance->data = data;
+    instance->size = size;
+    instance->offset = 0;
+    instance->seq++;
+    instance->index = 0;
+    instance->count =
+        (size + SUBGHZ_TX_RX_FRAME_PAYLOAD_SIZE_MAX - 1) / SUBGHZ_TX_RX_FRAME_PAYLOAD_SIZE_MAX;
+    return true;
+}
+
+uint8_t subghz_tx_rx_frame_encoder_next(SubGhzTxRxFrameEncoder* instance, uint8_t* packet) {
+    furi_assert(instance);
+    furi_assert(packet);
+    if(instance->index >= instance->count) return 0;
+
+    size_t payload_size =
+        MIN(instance->size - instance->offset, SUBGHZ_TX_RX_FRAME_PAYLOAD_SIZE_MAX);
+    packet[SUBGHZ_TX_RX_FRAME_VERSION_POS] = SUBGHZ_TX_RX_FRAME_VERSION;
+    packet[SUBGHZ_TX_RX_FRAME_SENDER_ID_POS] = instance->sender_id & 0xFF;
+    packet[SUBGHZ_TX_RX_FRAME_SENDER_ID_POS + 1] = instance->sender_id >> 8;
+    packet[SUBGHZ_TX_RX_FRAME_SEQ_POS] = instance->seq;
+    packet[SUBGHZ_TX_RX_FRAME_FRAGMENT_POS] = (instance->index << SUBGHZ_TX_RX_FRAME_INDEX_SHIFT) |
+                                              (instance->count - 1);
+    memcpy(
+        &packet[SUBGHZ_TX_RX_FRAME_HEADER_SIZE], &instance->data[instance->offset], payload_size);
+
+    instance->offset += payload_size;
+    instance->index++;
+    return payload_size + SUBGHZ_TX_RX_FRAME_HEADER_SIZE;
+}
+
+SubGhzTxRxFrameDecoder* subghz_tx_rx_frame_decoder_alloc() {
+    SubGhzTxRxFrameDecoder* instance = malloc(sizeof(SubGhzTxRxFrameDecoder));
+    subghz_tx_rx_frame_decoder_reset(instance);
+    return instance;
+}
+
+void subghz_tx_rx_frame_decoder_free(SubGhzTxRxFrameDecoder* instance) {
+    furi_assert(instance);
+    free(instance);
+}
+
+void subghz_tx_rx_frame_decoder_reset(SubGhzTxRxFrameDecoder* instance) {
+    furi_assert(instance);
+    for(size_t i = 0; i < SUBGHZ_TX_RX_FRAME_SENDERS_MAX; i++) {
+        instance->senders[i].size = 0;
+        instance->senders[i].last_heard = 0;
+        instance->senders[i].sender_valid = false;
+        instance->senders[i].message_valid = false;
+        instance->senders[i].index_next = 0;
+        instance->senders[i].count = 0;
+    }
+    instance->message = instance->senders[0].message;
+    instance->packets = 0;
+    instance->lost = 0;
+}
+
+/* Finds sender state, or takes free or least recently heard one */
+static SubGhzTxRxFrameSender*
+    subghz_tx_rx_frame_decoder_get_sender(SubGhzTxRxFrameDecoder* instance, uint16_t sender_id) {
+    SubGhzTxRxFrameSender* sender = &instance->senders[0];
+    for(size_t i = 0; i < SUBGHZ_TX_RX_FRAME_SENDERS_MAX; i++) {
+        SubGhzTxRxFrameSender* candidate = &instance->senders[i];
+        if(candidate->sender_valid && (candidate->sender_id == sender_id)) {
+            return candidate;
+        }
+        if(!candidate->sender_valid) {
+            if(sender->sender_valid) sender = candidate;
+        } else if(sender->sender_valid && (candidate->last_heard < sender->last_heard)) {
+            sender = candidate;
+        }
+    }
+
+    if(sender->sender_valid) {
+        // Tail of forgotten sender message
+        instance->lost += sender->count - sender->index_next;
+    }
+    sender->sender_valid = false;
+    sender->sender_id = sender_id;
+    return sender;
+}
+
+size_t subghz_tx_rx_frame_decoder_push(
+    SubGhzTxRxFrameDecoder* instance,
+    const uint8_t* packet,
+    uint8_t size) {
+    furi_assert(instance);
+    furi_assert(packet);
+    if((size <= SUBGHZ_TX_RX_FRAME_HEADER_SIZE) || (size > SUBGHZ_TX_RX_FRAME_PACKET_SIZE_MAX) ||
+       (packet[SUBGHZ_TX_RX_FRAME_VERSION_POS] != SUBGHZ_TX_RX_FRAME_VERSION)) {
+        return 0;
+    }
+
+    uint16_t sender_id = packet[SUBGHZ_TX_RX_FRAME_SENDER_ID_POS] |
+                         (packet[SUBGHZ_TX_RX_FRAME_SENDER_ID_POS + 1] << 8);
+    uint8_t seq = packet[SUBGHZ_TX_RX_FRAME_SEQ_POS];
+    uint8_t index = packet[SUBGHZ_TX_RX_FRAME_FRAGMENT_POS] >> SUBGHZ_TX_RX_FRAME_INDEX_SHIFT;
+    uint8_t count = (packet[SUBGHZ_TX_RX_FRAME_FRAGMENT_POS] & SUBGHZ_TX_RX_FRAME_COUNT_MASK) + 1;
+    if(index >= count) return 0;
+
+    SubGhzTxRxFrameSender* sender = subghz_tx_rx_frame_decoder_get_sender(instance, sender_id);
+    sender->last_heard = ++instance->packets;
+
+    if(!sender->sender_valid || (seq != sender->seq)) {
+        if(sender->sender_valid) {
+            // Tail of previous message and messages in between
+            instance->lost += sender->count - sender->index_next;
+            instance->lost += (uint8_t)(seq - sender->seq - 1);
+        }
+        sender->sender_valid = true;
+        sender->message_valid = true;
+        sender->seq = seq;
+        sender->index_next = 0;
+        sender->count = count;
+        sender->size = 0;
+    } else if((index < sender->index_next) || (count != sender->count)) {
+        // Duplicate or malformed
+        return 0;
+    }
+
+    if(index > sender->index_next) {
+        instance->lost += index - sender->index_next;
+        sender->message_valid = false;
+    }
+    sender->index_next = index + 1;
+
+    size_t message_size = 0;
+    if(sender->message_valid) {
+        size_t payload_size = size - SUBGHZ_TX_RX_FRAME_HEADER_SIZE;
+        memcpy(
+            &sender->message[sender->size],
+            &packet[SUBGHZ_TX_RX_FRAME_HEADER_SIZE],
+            payload_size);
+        sender->size += payload_size;
+        if(sender->index_next == sender->count) {
+            instance->message = sender->message;
+            message_size = sender->size;
+        }
+    }
+    return message_size;
+}
+
+const uint8_t* subghz_tx_rx_frame_decoder_get_message(SubGhzTxRxFrameDecoder* instance) {
+    furi_assert(instance);
+    return instance->message;
+}
+
+uint32_t subghz_tx_rx_frame_decoder_get_lost(SubGhzTxRxFrameDecoder* instance) {
+    furi_assert(instance);
+    return instance->lost;
+}
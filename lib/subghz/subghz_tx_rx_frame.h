@@ -0,0 +1,111 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/** Max packet size, CC1101 FIFO keeps length byte and 2 status bytes too */
+#define SUBGHZ_TX_RX_FRAME_PACKET_SIZE_MAX 60
+/** First header byte. Not valid in UTF-8 text, so plain packets of firmware
+ * without framing are ignored. That firmware shows frames as text with 5
+ * garbage bytes in front, chat between them doesn't work. */
+#define SUBGHZ_TX_RX_FRAME_VERSION 0xF1
+/** Header: version, sender id, message sequence number, fragment index and fragments count */
+#define SUBGHZ_TX_RX_FRAME_HEADER_SIZE 5
+#define SUBGHZ_TX_RX_FRAME_PAYLOAD_SIZE_MAX \
+    (SUBGHZ_TX_RX_FRAME_PACKET_SIZE_MAX - SUBGHZ_TX_RX_FRAME_HEADER_SIZE)
+#define SUBGHZ_TX_RX_FRAME_FRAGMENTS_MAX 16
+#define SUBGHZ_TX_RX_FRAME_MESSAGE_SIZE_MAX \
+    (SUBGHZ_TX_RX_FRAME_PAYLOAD_SIZE_MAX * SUBGHZ_TX_RX_FRAME_FRAGMENTS_MAX)
+/** Senders reassembled at once, each one takes SUBGHZ_TX_RX_FRAME_MESSAGE_SIZE_MAX of RAM */
+#define SUBGHZ_TX_RX_FRAME_SENDERS_MAX 4
+
+typedef struct SubGhzTxRxFrameEncoder SubGhzTxRxFrameEncoder;
+
+typedef struct SubGhzTxRxFrameDecoder SubGhzTxRxFrameDecoder;
+
+/**
+ * Allocate SubGhzTxRxFrameEncoder with random sender id
+ * @return SubGhzTxRxFrameEncoder* Pointer to a SubGhzTxRxFrameEncoder instance
+ */
+SubGhzTxRxFrameEncoder* subghz_tx_rx_frame_encoder_alloc();
+
+/**
+ * Free SubGhzTxRxFrameEncoder
+ * @param instance Pointer to a SubGhzTxRxFrameEncoder instance
+ */
+void subghz_tx_rx_frame_encoder_free(SubGhzTxRxFrameEncoder* instance);
+
+/**
+ * Get sender id, receiver reassembles messages of every sender separately
+ * @param instance  Pointer to a SubGhzTxRxFrameEncoder instance
+ * @return uint16_t sender id
+ */
+uint16_t subghz_tx_rx_frame_encoder_get_sender_id(SubGhzTxRxFrameEncoder* instance);
+
+/**
+ * Start new message, message gets next sequence number
+ * @param instance  Pointer to a SubGhzTxRxFrameEncoder instance
+ * @param data      message data, must be valid until all packets are taken
+ * @param size      message size, up to SUBGHZ_TX_RX_FRAME_MESSAGE_SIZE_MAX
+ * @return bool     true if ok
+ */
+bool subghz_tx_rx_frame_encoder_set_message(
+    SubGhzTxRxFrameEncoder* instance,
+    const uint8_t* data,
+    size_t size);
+
+/**
+ * Get next packet of message
+ * @param instance  Pointer to a SubGhzTxRxFrameEncoder instance
+ * @param packet    packet buffer, SUBGHZ_TX_RX_FRAME_PACKET_SIZE_MAX bytes
+ * @return uint8_t  packet size, 0 if whole message is taken
+ */
+uint8_t subghz_tx_rx_frame_encoder_next(SubGhzTxRxFrameEncoder* instance, uint8_t* packet);
+
+/**
+ * Allocate SubGhzTxRxFrameDecoder
+ * @return SubGhzTxRxFrameDecoder* Pointer to a SubGhzTxRxFrameDecoder instance
+ */
+SubGhzTxRxFrameDecoder* subghz_tx_rx_frame_decoder_alloc();
+
+/**
+ * Free SubGhzTxRxFrameDecoder
+ * @param instance Pointer to a SubGhzTxRxFrameDecoder instance
+ */
+void subghz_tx_rx_frame_decoder_free(SubGhzTxRxFrameDecoder* instance);
+
+/**
+ * Reset reassembly state and lost packets counter
+ * @param instance Pointer to a SubGhzTxRxFrameDecoder instance
+ */
+void subghz_tx_rx_frame_decoder_reset(SubGhzTxRxFrameDecoder* instance);
+
+/**
+ * Add received packet. Message with missing fragments is dropped, duplicated
+ * and malformed packets are ignored. If there are more than
+ * SUBGHZ_TX_RX_FRAME_SENDERS_MAX senders, least recently heard one is forgotten.
+ * @param instance  Pointer to a SubGhzTxRxFrameDecoder instance
+ * @param packet    packet data
+ * @param size      packet size
+ * @return size_t   size of reassembled message, 0 if message is not complete
+ */
+size_t subghz_tx_rx_frame_decoder_push(
+    SubGhzTxRxFrameDecoder* instance,
+    const uint8_t* packet,
+    uint8_t size);
+
+/**
+ * Get last reassembled message, valid until next packet is added
+ * @param instance  Pointer to a SubGhzTxRxFrameDecoder instance
+ * @return const uint8_t* message data
+ */
+const uint8_t* subghz_tx_rx_frame_decoder_get_message(SubGhzTxRxFrameDecoder* instance);
+
+/**
+ * Get lost packets count, detected by fragment index and sequence number
+ * gaps. Message missed as a whole is counted as one packet.
+ * @param instance  Pointer to a SubGhzTxRxFrameDecoder instance
+ * @return uint32_t lost packets count
+ */
+uint32_t subghz_tx_rx_frame_decoder_get_lost(SubGhzTxRxFrameDecoder* instance);
@@ -1,25 +1,39 @@
 #include "subghz_tx_rx_worker.h"
 
 #include <stream_buffer.h>
+#include <message_buffer.h>
 #include <furi.h>
 
 #define TAG "SubGhzTxRxWorker"
 
 #define SUBGHZ_TXRX_WORKER_BUF_SIZE 2048
-//you can not set more than 62 because it will not fit into the FIFO CC1101
-#define SUBGHZ_TXRX_WORKER_MAX_TXRX_SIZE 60
+#define SUBGHZ_TXRX_WORKER_FIFO_SIZE 64
 
 #define SUBGHZ_TXRX_WORKER_TIMEOUT_READ_WRITE_BUF 40
+// Packet air time is about 55 ms at 9.99 kBaud
+#define SUBGHZ_TXRX_WORKER_TIMEOUT_TX 200
+
+#define SUBGHZ_TXRX_WORKER_EVENT_EXIT 0x01
+#define SUBGHZ_TXRX_WORKER_EVENT_TX 0x02
+#define SUBGHZ_TXRX_WORKER_EVENT_END_OF_PACKET 0x04
+
+#define SUBGHZ_TXRX_WORKER_EVENT_ALL                               \
+    (SUBGHZ_TXRX_WORKER_EVENT_EXIT | SUBGHZ_TXRX_WORKER_EVENT_TX | \
+     SUBGHZ_TXRX_WORKER_EVENT_END_OF_PACKET)
 
 struct SubGhzTxRxWorker {
     FuriThread* thread;
-    StreamBufferHandle_t stream_tx;
+    MessageBufferHandle_t message_tx;
     StreamBufferHandle_t stream_rx;
+    SubGhzTxRxFrameEncoder* encoder;
+    SubGhzTxRxFrameDecoder* decoder;
+    uint8_t message[SUBGHZ_TX_RX_FRAME_MESSAGE_SIZE_MAX];
 
     volatile bool worker_running;
     volatile bool worker_stoping;
 
     SubGhzTxRxWorkerStatus status;
+    SubGhzTxRxWorkerStats stats;
 
     uint32_t frequency;
 
@@ -30,12 +44,27 @@ struct SubGhzTxRxWorker {
 bool subghz_tx_rx_worker_write(SubGhzTxRxWorker* instance, uint8_t* data, size_t size) {
     furi_assert(instance);
     bool ret = false;
-    size_t stream_tx_free_byte = xStreamBufferSpacesAvailable(instance->stream_tx);
-    if(size && (stream_tx_free_byte >= size)) {
-        if(xStreamBufferSend(
-               instance->stream_tx, data, size, SUBGHZ_TXRX_WORKER_TIMEOUT_READ_WRITE_BUF) ==
-           size) {
-            ret = true;
+    size_t messages =
+        (size + SUBGHZ_TX_RX_FRAME_MESSAGE_SIZE_MAX - 1) / SUBGHZ_TX_RX_FRAME_MESSAGE_SIZE_MAX;
+    size_t message_tx_free_byte = xMessageBufferSpacesAvailable(instance->message_tx);
+    if(size && (message_tx_free_byte >= size + messages * sizeof(size_t))) {
+        ret = true;
+        while(size) {
+            size_t message_size = MIN(size, SUBGHZ_TX_RX_FRAME_MESSAGE_SIZE_MAX);
+            if(xMessageBufferSend(
+                   instance->message_tx,
+                   data,
+                   message_size,
+                   SUBGHZ_TXRX_WORKER_TIMEOUT_READ_WRITE_BUF) != message_size) {
+                ret = false;
+                break;
+            }
+            data += message_size;
+            size -= message_size;
+        }
+        if(instance->worker_running) {
+            osThreadFlagsSet(
+                furi_thread_get_thread_id(instance->thread), SUBGHZ_TXRX_WORKER_EVENT_TX);
         }
     }
     return ret;
@@ -51,6 +80,12 @@ size_t subghz_tx_rx_worker_read(SubGhzTxRxWorker* instance, uint8_t* data, size_
     return xStreamBufferReceive(instance->stream_rx, data, size, 0);
 }
 
+void subghz_tx_rx_worker_get_stats(SubGhzTxRxWorker* instance, SubGhzTxRxWorkerStats* stats) {
+    furi_assert(instance);
+    furi_assert(stats);
+    *stats = instance->stats;
+}
+
 void subghz_tx_rx_worker_set_callback_have_read(
     SubGhzTxRxWorker* instance,
     SubGhzTxRxWorkerCallbackHaveRead callback,
@@ -62,63 +97,101 @@ void subghz_tx_rx_worker_set_callback_have_read(
     instance->context_have_read = context;
 }
 
-bool subghz_tx_rx_worker_rx(SubGhzTxRxWorker* instance, uint8_t* data, uint8_t* size) {
-    uint8_t timeout = 100;
-    bool ret = false;
-    if(instance->status != SubGhzTxRxWorkerStatusRx) {
-        furi_hal_subghz_rx();
-        instance->status = SubGhzTxRxWorkerStatusRx;
-        osDelay(1);
-    }
-    //waiting for reception to complete
-    while(furi_hal_gpio_read(&gpio_cc1101_g0)) {
-        osDelay(1);
-        if(!--timeout) {
-            FURI_LOG_W(TAG, "RX cc1101_g0 timeout");
-            furi_hal_subghz_flush_rx();
-            furi_hal_subghz_rx();
-            break;
+/** GDO0 falling edge: packet is received or sent, or RX FIFO is overflowed */
+static void subghz_tx_rx_worker_gdo0_isr(void* context) {
+    SubGhzTxRxWorker* instance = context;
+    osThreadFlagsSet(
+        furi_thread_get_thread_id(instance->thread), SUBGHZ_TXRX_WORKER_EVENT_END_OF_PACKET);
+}
+
+static void subghz_tx_rx_worker_rx_start(SubGhzTxRxWorker* instance) {
+    furi_hal_subghz_flush_rx();
+    osThreadFlagsClear(SUBGHZ_TXRX_WORKER_EVENT_END_OF_PACKET);
+    furi_hal_subghz_rx();
+    instance->status = SubGhzTxRxWorkerStatusRx;
+}
+
+static void subghz_tx_rx_worker_rx_message(SubGhzTxRxWorker* instance, size_t size) {
+    const uint8_t* message = subghz_tx_rx_frame_decoder_get_message(instance->decoder);
+    if(xStreamBufferSpacesAvailable(instance->stream_rx) >= size) {
+        bool callback_rx = instance->callback_have_read &&
+                           (xStreamBufferBytesAvailable(instance->stream_rx) == 0);
+        xStreamBufferSend(
+            instance->stream_rx, message, size, SUBGHZ_TXRX_WORKER_TIMEOUT_READ_WRITE_BUF);
+        if(callback_rx) {
+            instance->callback_have_read(instance->context_have_read);
         }
+    } else {
+        instance->stats.rx_overflows++;
+        FURI_LOG_W(TAG, "RX buffer overflow, %u bytes dropped", size);
     }
+}
+
+static void subghz_tx_rx_worker_rx(SubGhzTxRxWorker* instance) {
+    uint8_t packet[SUBGHZ_TXRX_WORKER_FIFO_SIZE];
+    uint8_t size = 0;
 
-    if(furi_hal_subghz_rx_pipe_not_empty()) {
-        FURI_LOG_I(
+    if(furi_hal_subghz_is_rx_overflow()) {
+        instance->stats.rx_overflows++;
+        FURI_LOG_W(TAG, "RX FIFO overflow");
+    } else if(furi_hal_subghz_rx_pipe_not_empty()) {
+        FURI_LOG_D(
             TAG, "RSSI: %03.1fdbm LQI: %d", furi_hal_subghz_get_rssi(), furi_hal_subghz_get_lqi());
         if(furi_hal_subghz_is_rx_data_crc_valid()) {
-            furi_hal_subghz_read_packet(data, size);
-            ret = true;
+            furi_hal_subghz_read_packet(packet, &size);
+            instance->stats.rx_packets++;
+            size_t message_size =
+                subghz_tx_rx_frame_decoder_push(instance->decoder, packet, size);
+            instance->stats.rx_lost = subghz_tx_rx_frame_decoder_get_lost(instance->decoder);
+            if(message_size) {
+                subghz_tx_rx_worker_rx_message(instance, message_size);
+            }
+        } else {
+            instance->stats.rx_crc_errors++;
         }
-        furi_hal_subghz_flush_rx();
-        furi_hal_subghz_rx();
     }
-    return ret;
+    subghz_tx_rx_worker_rx_start(instance);
 }
 
-void subghz_tx_rx_worker_tx(SubGhzTxRxWorker* instance, uint8_t* data, size_t size) {
-    uint8_t timeout = 200;
-    if(instance->status != SubGhzTxRxWorkerStatusIDLE) {
-        furi_hal_subghz_idle();
-    }
+static bool subghz_tx_rx_worker_tx(SubGhzTxRxWorker* instance, uint8_t* data, size_t size) {
+    bool ret = false;
+    furi_hal_subghz_idle();
+    // Leaving RX may trigger GDO0 falling edge
+    osThreadFlagsClear(SUBGHZ_TXRX_WORKER_EVENT_END_OF_PACKET);
     furi_hal_subghz_write_packet(data, size);
-    furi_hal_subghz_tx(); //start send
-    instance->status = SubGhzTxRxWorkerStatusTx;
-    while(!furi_hal_gpio_read(&gpio_cc1101_g0)) { // Wait for GDO0 to be set -> sync transmitted
-        osDelay(1);
-        if(!--timeout) {
-            FURI_LOG_W(TAG, "TX !cc1101_g0 timeout");
-            break;
-        }
-    }
-    while(furi_hal_gpio_read(&gpio_cc1101_g0)) { // Wait for GDO0 to be cleared -> end of packet
-        osDelay(1);
-        if(!--timeout) {
-            FURI_LOG_W(TAG, "TX cc1101_g0 timeout");
-            break;
+    if(furi_hal_subghz_tx()) { //start send
+        instance->status = SubGhzTxRxWorkerStatusTx;
+        uint32_t events = osThreadFlagsWait(
+            SUBGHZ_TXRX_WORKER_EVENT_END_OF_PACKET, osFlagsWaitAny, SUBGHZ_TXRX_WORKER_TIMEOUT_TX);
+        if(events & osFlagsError) {
+            FURI_LOG_W(TAG, "TX end of packet timeout");
+        } else {
+            ret = true;
         }
     }
     furi_hal_subghz_idle();
     instance->status = SubGhzTxRxWorkerStatusIDLE;
+    return ret;
+}
+
+static void subghz_tx_rx_worker_tx_messages(SubGhzTxRxWorker* instance) {
+    uint8_t packet[SUBGHZ_TX_RX_FRAME_PACKET_SIZE_MAX];
+    uint8_t packet_size = 0;
+
+    while(!xMessageBufferIsEmpty(instance->message_tx)) {
+        size_t size = xMessageBufferReceive(
+            instance->message_tx, instance->message, SUBGHZ_TX_RX_FRAME_MESSAGE_SIZE_MAX, 0);
+        if(!subghz_tx_rx_frame_encoder_set_message(instance->encoder, instance->message, size)) {
+            continue;
+        }
+        while((packet_size = subghz_tx_rx_frame_encoder_next(instance->encoder, packet))) {
+            if(subghz_tx_rx_worker_tx(instance, packet, packet_size)) {
+                instance->stats.tx_packets++;
+            }
+        }
+    }
 }
+
 /** Worker thread
  * 
  * @param context 
@@ -132,63 +205,30 @@ static int32_t subghz_tx_rx_worker_thread(void* context) {
     furi_hal_subghz_idle();
     furi_hal_subghz_load_preset(FuriHalSubGhzPresetGFSK9_99KbAsync);
     //furi_hal_subghz_load_preset(FuriHalSubGhzPresetMSK99_97KbAsync);
-    furi_hal_gpio_init(&gpio_cc1101_g0, GpioModeInput, GpioPullNo, GpioSpeedLow);
+    furi_hal_gpio_init(&gpio_cc1101_g0, GpioModeInterruptFall, GpioPullNo, GpioSpeedLow);
+    furi_hal_gpio_add_int_callback(&gpio_cc1101_g0, subghz_tx_rx_worker_gdo0_isr, instance);
 
     furi_hal_subghz_set_frequency_and_path(instance->frequency);
-    furi_hal_subghz_flush_rx();
+    subghz_tx_rx_worker_rx_start(instance);
 
-    uint8_t data[SUBGHZ_TXRX_WORKER_MAX_TXRX_SIZE + 1] = {0};
-    size_t size_tx = 0;
-    uint8_t size_rx[1] = {0};
-    uint8_t timeout_tx = 0;
-    bool callback_rx = false;
-
-    while(instance->worker_running) {
-        //transmit
-        size_tx = xStreamBufferBytesAvailable(instance->stream_tx);
-        if(size_tx > 0 && !timeout_tx) {
-            timeout_tx = 10; //20ms
-            if(size_tx > SUBGHZ_TXRX_WORKER_MAX_TXRX_SIZE) {
-                xStreamBufferReceive(
-                    instance->stream_tx,
-                    &data,
-                    SUBGHZ_TXRX_WORKER_MAX_TXRX_SIZE,
-                    SUBGHZ_TXRX_WORKER_TIMEOUT_READ_WRITE_BUF);
-                subghz_tx_rx_worker_tx(instance, data, SUBGHZ_TXRX_WORKER_MAX_TXRX_SIZE);
-            } else {
-                //todo checking that he managed to write all the data to the TX buffer
-                xStreamBufferReceive(
-                    instance->stream_tx, &data, size_tx, SUBGHZ_TXRX_WORKER_TIMEOUT_READ_WRITE_BUF);
-                subghz_tx_rx_worker_tx(instance, data, size_tx);
-            }
-        } else {
-            //recive
-            if(subghz_tx_rx_worker_rx(instance, data, size_rx)) {
-                if(xStreamBufferSpacesAvailable(instance->stream_rx) >= size_rx[0]) {
-                    if(instance->callback_have_read &&
-                       xStreamBufferBytesAvailable(instance->stream_rx) == 0) {
-                        callback_rx = true;
-                    }
-                    //todo checking that he managed to write all the data to the RX buffer
-                    xStreamBufferSend(
-                        instance->stream_rx,
-                        &data,
-                        size_rx[0],
-                        SUBGHZ_TXRX_WORKER_TIMEOUT_READ_WRITE_BUF);
-                    if(callback_rx) {
-                        instance->callback_have_read(instance->context_have_read);
-                        callback_rx = false;
-                    }
-                } else {
-                    //todo RX buffer overflow
-                }
-            }
+    while(1) {
+        if(!xMessageBufferIsEmpty(instance->message_tx)) {
+            subghz_tx_rx_worker_tx_messages(instance);
+            subghz_tx_rx_worker_rx_start(instance);
         }
 
-        if(timeout_tx) timeout_tx--;
-        osDelay(1);
+        uint32_t events =
+            osThreadFlagsWait(SUBGHZ_TXRX_WORKER_EVENT_ALL, osFlagsWaitAny, osWaitForever);
+        furi_check((events & osFlagsError) == 0);
+        if(events & SUBGHZ_TXRX_WORKER_EVENT_EXIT) break;
+
+        if(events & SUBGHZ_TXRX_WORKER_EVENT_END_OF_PACKET) {
+            subghz_tx_rx_worker_rx(instance);
+        }
     }
 
+    furi_hal_gpio_remove_int_callback(&gpio_cc1101_g0);
+    furi_hal_gpio_init(&gpio_cc1101_g0, GpioModeAnalog, GpioPullNo, GpioSpeedLow);
     furi_hal_subghz_set_path(FuriHalSubGhzPathIsolate);
     furi_hal_subghz_sleep();
 
@@ -204,10 +244,11 @@ SubGhzTxRxWorker* subghz_tx_rx_worker_alloc() {
     furi_thread_set_stack_size(instance->thread, 2048);
     furi_thread_set_context(instance->thread, instance);
     furi_thread_set_callback(instance->thread, subghz_tx_rx_worker_thread);
-    instance->stream_tx =
-        xStreamBufferCreate(sizeof(uint8_t) * SUBGHZ_TXRX_WORKER_BUF_SIZE, sizeof(uint8_t));
+    instance->message_tx = xMessageBufferCreate(sizeof(uint8_t) * SUBGHZ_TXRX_WORKER_BUF_SIZE);
     instance->stream_rx =
         xStreamBufferCreate(sizeof(uint8_t) * SUBGHZ_TXRX_WORKER_BUF_SIZE, sizeof(uint8_t));
+    instance->encoder = subghz_tx_rx_frame_encoder_alloc();
+    instance->decoder = subghz_tx_rx_frame_decoder_alloc();
 
     instance->status = SubGhzTxRxWorkerStatusIDLE;
     instance->worker_stoping = true;
@@ -218,8 +259,10 @@ SubGhzTxRxWorker* subghz_tx_rx_worker_alloc() {
 void subghz_tx_rx_worker_free(SubGhzTxRxWorker* instance) {
     furi_assert(instance);
     furi_assert(!instance->worker_running);
-    vStreamBufferDelete(instance->stream_tx);
+    vMessageBufferDelete(instance->message_tx);
     vStreamBufferDelete(instance->stream_rx);
+    subghz_tx_rx_frame_encoder_free(instance->encoder);
+    subghz_tx_rx_frame_decoder_free(instance->decoder);
     furi_thread_free(instance->thread);
 
     free(instance);
@@ -229,8 +272,10 @@ bool subghz_tx_rx_worker_start(SubGhzTxRxWorker* instance, uint32_t frequency) {
     furi_assert(instance);
     furi_assert(!instance->worker_running);
     bool res = false;
-    xStreamBufferReset(instance->stream_tx);
+    xMessageBufferReset(instance->message_tx);
     xStreamBufferReset(instance->stream_rx);
+    subghz_tx_rx_frame_decoder_reset(instance->decoder);
+    memset(&instance->stats, 0, sizeof(SubGhzTxRxWorkerStats));
 
     instance->worker_running = true;
 
@@ -249,6 +294,7 @@ void subghz_tx_rx_worker_stop(SubGhzTxRxWorker* instance) {
     furi_assert(instance->worker_running);
 
     instance->worker_running = false;
+    osThreadFlagsSet(furi_thread_get_thread_id(instance->thread), SUBGHZ_TXRX_WORKER_EVENT_EXIT);
 
     furi_thread_join(instance->thread);
 }
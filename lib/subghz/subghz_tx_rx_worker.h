@@ -1,6 +1,7 @@
 #pragma once
 
 #include <furi_hal.h>
+#include "subghz_tx_rx_frame.h"
 
 typedef void (*SubGhzTxRxWorkerCallbackHaveRead)(void* context);
 
@@ -12,8 +13,20 @@ typedef enum {
     SubGhzTxRxWorkerStatusRx,
 } SubGhzTxRxWorkerStatus;
 
+typedef struct {
+    uint32_t tx_packets;
+    uint32_t rx_packets;
+    uint32_t rx_lost; /**< packets lost on air, detected by framing */
+    uint32_t rx_crc_errors;
+    uint32_t rx_overflows; /**< packets dropped on CC1101 FIFO or RX buffer overflow */
+} SubGhzTxRxWorkerStats;
+
 /** 
- * SubGhzTxRxWorker, add data to transfer
+ * SubGhzTxRxWorker, add data to transfer. Data is sent as messages of up to
+ * SUBGHZ_TX_RX_FRAME_MESSAGE_SIZE_MAX bytes, every message is split into
+ * packets and delivered to the receiver as a whole or not at all. Framing is
+ * versioned by SUBGHZ_TX_RX_FRAME_VERSION and doesn't talk to firmware that
+ * sends plain packets.
  * @param instance  Pointer to a SubGhzTxRxWorker instance
  * @param data      *data
  * @param size      data size
@@ -37,6 +50,13 @@ size_t subghz_tx_rx_worker_available(SubGhzTxRxWorker* instance);
  */
 size_t subghz_tx_rx_worker_read(SubGhzTxRxWorker* instance, uint8_t* data, size_t size);
 
+/** 
+ * SubGhzTxRxWorker, get transfer statistics
+ * @param instance   Pointer to a SubGhzTxRxWorker instance
+ * @param stats      statistics since worker start
+ */
+void subghz_tx_rx_worker_get_stats(SubGhzTxRxWorker* instance, SubGhzTxRxWorkerStats* stats);
+
 /** 
  * Сallback SubGhzTxRxWorker when there is data to read in an empty buffer
  * @param instance Pointer to a SubGhzTxRxWorker instance
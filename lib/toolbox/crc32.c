@@ -0,0 +1,13 @@
+#include "crc32.h"
+
+uint32_t crc32_calc_buffer(uint32_t crc, const void* data, size_t size) {
+    const uint8_t* bytes = data;
+    crc = ~crc;
+    while(size--) {
+        crc ^= *bytes++;
+        for(uint8_t i = 0; i < 8; i++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+        }
+    }
+    return ~crc;
+}
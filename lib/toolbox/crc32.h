@@ -0,0 +1,20 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Update CRC32 (IEEE 802.3, same as zlib) with data
+ * @param crc CRC of previous data, 0 for first chunk
+ * @param data data pointer
+ * @param size data size
+ * @return uint32_t CRC of previous and new data
+ */
+uint32_t crc32_calc_buffer(uint32_t crc, const void* data, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
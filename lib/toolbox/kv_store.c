@@ -0,0 +1,519 @@
+#include "kv_store.h"
+#include "crc32.h"
+#include <furi.h>
+#include <m-array.h>
+#include <m-string.h>
+#include <storage/storage.h>
+
+#define TAG "KvStore"
+
+#define KV_STORE_MAGIC 0x53564B46
+#define KV_STORE_VERSION 1
+#define KV_STORE_TMP_EXTENSION ".tmp"
+
+/* Journal is compacted when it is bigger than
+ * live data multiplied by factor plus threshold */
+#define KV_STORE_COMPACT_FACTOR 2
+#define KV_STORE_COMPACT_THRESHOLD 1024
+
+#define KV_STORE_RECORD_FLAG_REMOVED (1 << 0)
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+} KvStoreHeader;
+
+typedef struct {
+    uint32_t crc; // CRC32 of rest of header, key and value
+    uint8_t key_size;
+    uint8_t flags;
+    uint16_t value_size;
+} KvStoreRecordHeader;
+
+typedef struct {
+    char* key;
+    uint8_t* value;
+    uint16_t size;
+    bool dirty;
+    bool removed;
+} KvStoreEntry;
+
+ARRAY_DEF(KvStoreEntryArray, KvStoreEntry, M_POD_OPLIST);
+
+struct KvStore {
+    string_t path;
+    Storage* storage;
+    osMutexId_t mutex;
+    osTimerId_t timer;
+    uint32_t flush_delay;
+    KvStoreFlushCallback flush_callback;
+    void* flush_context;
+    KvStoreEntryArray_t entries;
+    size_t journal_size;
+    size_t bytes_written;
+};
+
+static size_t kv_store_record_size(size_t key_size, size_t value_size) {
+    return sizeof(KvStoreRecordHeader) + key_size + value_size;
+}
+
+static KvStoreEntry* kv_store_find(KvStore* store, const char* key, size_t* index) {
+    for(size_t i = 0; i < KvStoreEntryArray_size(store->entries); i++) {
+        KvStoreEntry* entry = KvStoreEntryArray_get(store->entries, i);
+        if(strcmp(entry->key, key) == 0) {
+            if(index) *index = i;
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+static void kv_store_entry_free(KvStoreEntry* entry) {
+    free(entry->key);
+    free(entry->value);
+}
+
+static void kv_store_erase(KvStore* store, size_t index) {
+    kv_store_entry_free(KvStoreEntryArray_get(store->entries, index));
+    KvStoreEntryArray_remove_v(store->entries, index, index + 1);
+}
+
+static void kv_store_apply(
+    KvStore* store,
+    const char* key,
+    const uint8_t* value,
+    size_t size,
+    bool removed,
+    bool dirty) {
+    size_t index;
+    KvStoreEntry* entry = kv_store_find(store, key, &index);
+
+    if(removed) {
+        if(!entry) return;
+        if(dirty) {
+            // Removal record must be written before entry is dropped
+            entry->removed = true;
+            entry->dirty = true;
+        } else {
+            kv_store_erase(store, index);
+        }
+        return;
+    }
+
+    if(!entry) {
+        entry = KvStoreEntryArray_push_raw(store->entries);
+        entry->key = strdup(key);
+        entry->value = NULL;
+        entry->size = 0;
+    }
+
+    if(entry->size != size) {
+        free(entry->value);
+        entry->value = malloc(size);
+        entry->size = size;
+    }
+
+    if(size) memcpy(entry->value, value, size);
+    entry->removed = false;
+    entry->dirty = dirty;
+}
+
+static size_t kv_store_live_size(KvStore* store) {
+    size_t size = sizeof(KvStoreHeader);
+    M_EACH(entry, store->entries, KvStoreEntryArray_t) {
+        if(!entry->removed) {
+            size += kv_store_record_size(strlen(entry->key), entry->size);
+        }
+    }
+    return size;
+}
+
+static bool kv_store_write_record(KvStore* store, File* file, KvStoreEntry* entry) {
+    size_t key_size = strlen(entry->key);
+    size_t value_size = entry->removed ? 0 : entry->size;
+    size_t record_size = kv_store_record_size(key_size, value_size);
+
+    uint8_t* record = malloc(record_size);
+    KvStoreRecordHeader* header = (KvStoreRecordHeader*)record;
+    header->key_size = key_size;
+    header->flags = entry->removed ? KV_STORE_RECORD_FLAG_REMOVED : 0;
+    header->value_size = value_size;
+    memcpy(record + sizeof(KvStoreRecordHeader), entry->key, key_size);
+    if(value_size) {
+        memcpy(record + sizeof(KvStoreRecordHeader) + key_size, entry->value, value_size);
+    }
+    header->crc = crc32_calc_buffer(
+        0, record + sizeof(header->crc), record_size - sizeof(header->crc));
+
+    // One write per record, torn record is dropped on load
+    size_t written = storage_file_write(file, record, record_size);
+    store->bytes_written += written;
+    free(record);
+
+    return written == record_size;
+}
+
+static bool kv_store_write_header(KvStore* store, File* file) {
+    KvStoreHeader header = {.magic = KV_STORE_MAGIC, .version = KV_STORE_VERSION};
+    size_t written = storage_file_write(file, &header, sizeof(header));
+    store->bytes_written += written;
+    return written == sizeof(header);
+}
+
+static void kv_store_drop_removed(KvStore* store) {
+    for(size_t i = KvStoreEntryArray_size(store->entries); i > 0; i--) {
+        KvStoreEntry* entry = KvStoreEntryArray_get(store->entries, i - 1);
+        // Removal must be written to journal first
+        if(entry->removed && !entry->dirty) {
+            kv_store_erase(store, i - 1);
+        }
+    }
+}
+
+static bool kv_store_compact(KvStore* store) {
+    string_t tmp_path;
+    string_init_printf(tmp_path, "%s%s", string_get_cstr(store->path), KV_STORE_TMP_EXTENSION);
+    File* file = storage_file_alloc(store->storage);
+    bool result = false;
+
+    do {
+        if(!storage_file_open(file, string_get_cstr(tmp_path), FSAM_WRITE, FSOM_CREATE_ALWAYS))
+            break;
+        if(!kv_store_write_header(store, file)) break;
+
+        bool written = true;
+        M_EACH(entry, store->entries, KvStoreEntryArray_t) {
+            if(entry->removed) continue;
+            if(!kv_store_write_record(store, file, entry)) {
+                written = false;
+                break;
+            }
+        }
+        if(!written) break;
+        if(!storage_file_close(file)) break;
+
+        // Only complete journal is left if power is lost here, see kv_store_recover
+        if(!storage_simply_remove(store->storage, string_get_cstr(store->path))) break;
+        if(storage_common_rename(
+               store->storage, string_get_cstr(tmp_path), string_get_cstr(store->path)) !=
+           FSE_OK)
+            break;
+
+        result = true;
+    } while(false);
+
+    storage_file_free(file);
+    string_clear(tmp_path);
+
+    if(result) {
+        M_EACH(entry, store->entries, KvStoreEntryArray_t) {
+            entry->dirty = false;
+        }
+        kv_store_drop_removed(store);
+        store->journal_size = kv_store_live_size(store);
+        FURI_LOG_D(TAG, "Compacted \"%s\"", string_get_cstr(store->path));
+    } else {
+        FURI_LOG_E(TAG, "Compaction failed \"%s\"", string_get_cstr(store->path));
+    }
+
+    return result;
+}
+
+static bool kv_store_flush_internal(KvStore* store) {
+    size_t pending_size = 0;
+    M_EACH(entry, store->entries, KvStoreEntryArray_t) {
+        if(entry->dirty) {
+            pending_size +=
+                kv_store_record_size(strlen(entry->key), entry->removed ? 0 : entry->size);
+        }
+    }
+
+    if(pending_size == 0) return true;
+
+    if(store->journal_size + pending_size >
+       kv_store_live_size(store) * KV_STORE_COMPACT_FACTOR + KV_STORE_COMPACT_THRESHOLD) {
+        return kv_store_compact(store);
+    }
+
+    File* file = storage_file_alloc(store->storage);
+    bool result =
+        storage_file_open(file, string_get_cstr(store->path), FSAM_WRITE, FSOM_OPEN_APPEND);
+
+    if(result) {
+        uint64_t file_size = storage_file_size(file);
+        if(file_size < store->journal_size) {
+            // Journal is lost, e.g. by failed compaction: rewrite it completely
+            storage_file_close(file);
+            storage_file_free(file);
+            return kv_store_compact(store);
+        } else if(file_size > store->journal_size) {
+            // Torn record of failed append, records after it would be dropped on load
+            result = storage_file_seek(file, store->journal_size, true) &&
+                     storage_file_truncate(file);
+        }
+    }
+
+    if(result) {
+        M_EACH(entry, store->entries, KvStoreEntryArray_t) {
+            if(!entry->dirty) continue;
+            if(!kv_store_write_record(store, file, entry)) {
+                result = false;
+                break;
+            }
+            entry->dirty = false;
+            store->journal_size +=
+                kv_store_record_size(strlen(entry->key), entry->removed ? 0 : entry->size);
+        }
+    }
+
+    if(!result) {
+        FURI_LOG_E(
+            TAG,
+            "Write failed \"%s\". Error: \'%s\'",
+            string_get_cstr(store->path),
+            storage_file_get_error_desc(file));
+    }
+
+    storage_file_close(file);
+    storage_file_free(file);
+
+    kv_store_drop_removed(store);
+
+    return result;
+}
+
+static void kv_store_recover(KvStore* store) {
+    string_t tmp_path;
+    string_init_printf(tmp_path, "%s%s", string_get_cstr(store->path), KV_STORE_TMP_EXTENSION);
+
+    if(storage_common_stat(store->storage, string_get_cstr(tmp_path), NULL) == FSE_OK) {
+        if(storage_common_stat(store->storage, string_get_cstr(store->path), NULL) ==
+           FSE_NOT_EXIST) {
+            // Power lost after old journal was removed, new one is complete
+            storage_common_rename(
+                store->storage, string_get_cstr(tmp_path), string_get_cstr(store->path));
+        } else {
+            // Power lost during compaction, old journal is valid
+            storage_simply_remove(store->storage, string_get_cstr(tmp_path));
+        }
+    }
+
+    string_clear(tmp_path);
+}
+
+static void kv_store_load(KvStore* store) {
+    kv_store_recover(store);
+
+    File* file = storage_file_alloc(store->storage);
+    uint8_t* buffer = malloc(KV_STORE_KEY_SIZE_MAX + 1 + KV_STORE_VALUE_SIZE_MAX);
+    size_t valid_size = 0;
+
+    do {
+        if(!storage_file_open(
+               file, string_get_cstr(store->path), FSAM_READ_WRITE, FSOM_OPEN_ALWAYS)) {
+            FURI_LOG_E(
+                TAG,
+                "Open failed \"%s\". Error: \'%s\'",
+                string_get_cstr(store->path),
+                storage_file_get_error_desc(file));
+            break;
+        }
+
+        KvStoreHeader header;
+        if(storage_file_read(file, &header, sizeof(header)) != sizeof(header) ||
+           header.magic != KV_STORE_MAGIC || header.version != KV_STORE_VERSION) {
+            // New or broken journal, start from scratch
+            storage_file_seek(file, 0, true);
+            storage_file_truncate(file);
+            kv_store_write_header(store, file);
+            valid_size = sizeof(header);
+            break;
+        }
+        valid_size = sizeof(header);
+
+        while(true) {
+            KvStoreRecordHeader record;
+            if(storage_file_read(file, &record, sizeof(record)) != sizeof(record)) break;
+            if(record.key_size == 0 || record.key_size > KV_STORE_KEY_SIZE_MAX) break;
+            if(record.value_size > KV_STORE_VALUE_SIZE_MAX) break;
+
+            size_t data_size = record.key_size + record.value_size;
+            if(storage_file_read(file, buffer, data_size) != data_size) break;
+
+            uint32_t crc = crc32_calc_buffer(
+                0, (uint8_t*)&record + sizeof(record.crc), sizeof(record) - sizeof(record.crc));
+            crc = crc32_calc_buffer(crc, buffer, data_size);
+            if(crc != record.crc) break;
+
+            // Key is followed by value in buffer, move value to make room for terminator
+            memmove(buffer + record.key_size + 1, buffer + record.key_size, record.value_size);
+            buffer[record.key_size] = '\0';
+            kv_store_apply(
+                store,
+                (const char*)buffer,
+                buffer + record.key_size + 1,
+                record.value_size,
+                record.flags & KV_STORE_RECORD_FLAG_REMOVED,
+                false);
+
+            valid_size += kv_store_record_size(record.key_size, record.value_size);
+        }
+
+        uint64_t file_size = storage_file_size(file);
+        if(file_size != valid_size) {
+            FURI_LOG_W(
+                TAG,
+                "Dropping %lu bytes of incomplete records in \"%s\"",
+                (uint32_t)(file_size - valid_size),
+                string_get_cstr(store->path));
+            storage_file_seek(file, valid_size, true);
+            storage_file_truncate(file);
+        }
+    } while(false);
+
+    storage_file_close(file);
+    storage_file_free(file);
+    free(buffer);
+
+    store->journal_size = valid_size;
+}
+
+/* Runs in timer thread: no storage access here, owner thread flushes */
+static void kv_store_timer_callback(void* context) {
+    KvStore* store = context;
+    KvStoreFlushCallback callback = store->flush_callback;
+    if(callback) callback(store->flush_context);
+}
+
+static void kv_store_schedule_flush(KvStore* store) {
+    if(store->flush_delay == 0) {
+        kv_store_flush_internal(store);
+    } else if(store->flush_callback && !osTimerIsRunning(store->timer)) {
+        // Timer is not restarted, so journal is written not later than delay after first change
+        osTimerStart(store->timer, store->flush_delay);
+    }
+}
+
+KvStore* kv_store_alloc(const char* path, uint32_t flush_delay) {
+    furi_assert(path);
+
+    KvStore* store = malloc(sizeof(KvStore));
+    string_init_set_str(store->path, path);
+    store->storage = furi_record_open("storage");
+    store->mutex = osMutexNew(NULL);
+    store->timer = osTimerNew(kv_store_timer_callback, osTimerOnce, store, NULL);
+    store->flush_delay = flush_delay;
+    store->flush_callback = NULL;
+    store->flush_context = NULL;
+    store->journal_size = 0;
+    store->bytes_written = 0;
+    KvStoreEntryArray_init(store->entries);
+
+    kv_store_load(store);
+
+    return store;
+}
+
+void kv_store_free(KvStore* store) {
+    furi_assert(store);
+
+    // Send stop command and wait till timer stop, no callback comes after that
+    osTimerStop(store->timer);
+    while(osTimerIsRunning(store->timer)) osDelay(1);
+    osTimerDelete(store->timer);
+
+    // Wait till other threads release store, then write pending changes
+    furi_check(osMutexAcquire(store->mutex, osWaitForever) == osOK);
+    kv_store_flush_internal(store);
+    osMutexRelease(store->mutex);
+    osMutexDelete(store->mutex);
+
+    M_EACH(entry, store->entries, KvStoreEntryArray_t) {
+        kv_store_entry_free(entry);
+    }
+    KvStoreEntryArray_clear(store->entries);
+
+    furi_record_close("storage");
+    string_clear(store->path);
+    free(store);
+}
+
+void kv_store_set_flush_callback(KvStore* store, KvStoreFlushCallback callback, void* context) {
+    furi_assert(store);
+
+    furi_check(osMutexAcquire(store->mutex, osWaitForever) == osOK);
+    store->flush_callback = callback;
+    store->flush_context = context;
+    osMutexRelease(store->mutex);
+}
+
+bool kv_store_get(KvStore* store, const char* key, void* data, size_t size) {
+    furi_assert(store);
+    furi_assert(key);
+    furi_assert(data);
+
+    furi_check(osMutexAcquire(store->mutex, osWaitForever) == osOK);
+    KvStoreEntry* entry = kv_store_find(store, key, NULL);
+    bool result = entry && !entry->removed && (entry->size == size);
+    if(result && size) {
+        memcpy(data, entry->value, size);
+    }
+    osMutexRelease(store->mutex);
+
+    return result;
+}
+
+bool kv_store_set(KvStore* store, const char* key, const void* data, size_t size) {
+    furi_assert(store);
+    furi_assert(key);
+    furi_assert(data);
+
+    size_t key_size = strlen(key);
+    if(key_size == 0 || key_size > KV_STORE_KEY_SIZE_MAX || size > KV_STORE_VALUE_SIZE_MAX) {
+        return false;
+    }
+
+    furi_check(osMutexAcquire(store->mutex, osWaitForever) == osOK);
+    KvStoreEntry* entry = kv_store_find(store, key, NULL);
+    bool changed = !entry || entry->removed || (entry->size != size) ||
+                   (size && memcmp(entry->value, data, size) != 0);
+    if(changed) {
+        kv_store_apply(store, key, data, size, false, true);
+        kv_store_schedule_flush(store);
+    }
+    osMutexRelease(store->mutex);
+
+    return true;
+}
+
+bool kv_store_remove(KvStore* store, const char* key) {
+    furi_assert(store);
+    furi_assert(key);
+
+    furi_check(osMutexAcquire(store->mutex, osWaitForever) == osOK);
+    KvStoreEntry* entry = kv_store_find(store, key, NULL);
+    bool result = entry && !entry->removed;
+    if(result) {
+        kv_store_apply(store, key, NULL, 0, true, true);
+        kv_store_schedule_flush(store);
+    }
+    osMutexRelease(store->mutex);
+
+    return result;
+}
+
+bool kv_store_flush(KvStore* store) {
+    furi_assert(store);
+
+    osTimerStop(store->timer);
+    furi_check(osMutexAcquire(store->mutex, osWaitForever) == osOK);
+    bool result = kv_store_flush_internal(store);
+    osMutexRelease(store->mutex);
+
+    return result;
+}
+
+size_t kv_store_get_bytes_written(KvStore* store) {
+    furi_assert(store);
+    return store->bytes_written;
+}
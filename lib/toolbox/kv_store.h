@@ -0,0 +1,111 @@
+/**
+ * @file kv_store.h
+ * Journaled key-value store
+ *
+ * Values are kept in memory and appended to journal file as CRC32 protected
+ * records. Changes are coalesced: flush timer asks owner thread to write
+ * journal, only last value of every changed key is written. Journal is
+ * compacted when it grows too much. Incomplete records left by power loss are
+ * dropped on load.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Maximum key length */
+#define KV_STORE_KEY_SIZE_MAX 32
+
+/** Maximum value size */
+#define KV_STORE_VALUE_SIZE_MAX 1024
+
+typedef struct KvStore KvStore;
+
+/** Flush request callback, called from timer thread
+ * Must only notify owner thread, which calls kv_store_flush
+ */
+typedef void (*KvStoreFlushCallback)(void* context);
+
+/** Allocate store and load journal
+ *
+ * @param      path         journal file path
+ * @param      flush_delay  delay between first change and flush request in ms,
+ *                          0 - write on every change
+ *
+ * @return     KvStore instance
+ */
+KvStore* kv_store_alloc(const char* path, uint32_t flush_delay);
+
+/** Write pending changes and free store
+ *
+ * @param      store  KvStore instance
+ */
+void kv_store_free(KvStore* store);
+
+/** Set flush request callback
+ * Without callback delayed changes are written by kv_store_flush and
+ * kv_store_free only
+ *
+ * @param      store     KvStore instance
+ * @param      callback  KvStoreFlushCallback instance
+ * @param      context   callback context
+ */
+void kv_store_set_flush_callback(KvStore* store, KvStoreFlushCallback callback, void* context);
+
+/** Get value
+ *
+ * @param      store  KvStore instance
+ * @param      key    key string
+ * @param      data   pointer to value buffer
+ * @param      size   value size, must be equal to stored value size
+ *
+ * @return     true if key exists and size matches
+ */
+bool kv_store_get(KvStore* store, const char* key, void* data, size_t size);
+
+/** Set value
+ * Value is written to journal on flush, unchanged value is not written
+ *
+ * @param      store  KvStore instance
+ * @param      key    key string
+ * @param      data   pointer to value
+ * @param      size   value size
+ *
+ * @return     true on success
+ */
+bool kv_store_set(KvStore* store, const char* key, const void* data, size_t size);
+
+/** Remove key
+ *
+ * @param      store  KvStore instance
+ * @param      key    key string
+ *
+ * @return     true if key existed
+ */
+bool kv_store_remove(KvStore* store, const char* key);
+
+/** Write pending changes to journal now
+ *
+ * @param      store  KvStore instance
+ *
+ * @return     true on success
+ */
+bool kv_store_flush(KvStore* store);
+
+/** Get amount of bytes written to storage since allocation
+ *
+ * @param      store  KvStore instance
+ *
+ * @return     bytes count
+ */
+size_t kv_store_get_bytes_written(KvStore* store);
+
+#ifdef __cplusplus
+}
+#endif
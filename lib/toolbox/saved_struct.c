@@ -13,6 +13,15 @@ typedef struct {
     uint32_t timestamp;
 } SavedStructHeader;
 
+static uint8_t saved_struct_checksum(const void* data, size_t size) {
+    uint8_t checksum = 0;
+    const uint8_t* source = data;
+    for(size_t i = 0; i < size; i++) {
+        checksum += source[i];
+    }
+    return checksum;
+}
+
 bool saved_struct_save(const char* path, void* data, size_t size, uint8_t magic, uint8_t version) {
     furi_assert(path);
     furi_assert(data);
@@ -33,16 +42,10 @@ bool saved_struct_save(const char* path, void* data, size_t size, uint8_t magic,
     }
 
     if(result) {
-        // Calculate checksum
-        uint8_t checksum = 0;
-        uint8_t* source = data;
-        for(size_t i = 0; i < size; i++) {
-            checksum += source[i];
-        }
         // Set header
         header.magic = magic;
         header.version = version;
-        header.checksum = checksum;
+        header.checksum = saved_struct_checksum(data, size);
         header.flags = 0;
         header.timestamp = 0;
 
@@ -101,11 +104,7 @@ bool saved_struct_load(const char* path, void* data, size_t size, uint8_t magic,
     }
 
     if(result) {
-        uint8_t checksum = 0;
-        const uint8_t* source = (const uint8_t*)data_read;
-        for(size_t i = 0; i < size; i++) {
-            checksum += source[i];
-        }
+        uint8_t checksum = saved_struct_checksum(data_read, size);
 
         if(header.checksum != checksum) {
             FURI_LOG_E(
@@ -125,3 +124,75 @@ bool saved_struct_load(const char* path, void* data, size_t size, uint8_t magic,
 
     return result;
 }
+
+bool saved_struct_store_save(
+    KvStore* store,
+    const char* key,
+    void* data,
+    size_t size,
+    uint8_t magic,
+    uint8_t version) {
+    furi_assert(store);
+    furi_assert(key);
+    furi_assert(data);
+    furi_assert(size);
+
+    uint8_t* value = malloc(sizeof(SavedStructHeader) + size);
+    SavedStructHeader* header = (SavedStructHeader*)value;
+    header->magic = magic;
+    header->version = version;
+    header->checksum = saved_struct_checksum(data, size);
+    header->flags = 0;
+    header->timestamp = 0;
+    memcpy(value + sizeof(SavedStructHeader), data, size);
+
+    bool result = kv_store_set(store, key, value, sizeof(SavedStructHeader) + size);
+    if(!result) {
+        FURI_LOG_E(TAG, "Store failed \"%s\"", key);
+    }
+
+    free(value);
+    return result;
+}
+
+bool saved_struct_store_load(
+    KvStore* store,
+    const char* key,
+    const char* legacy_path,
+    void* data,
+    size_t size,
+    uint8_t magic,
+    uint8_t version) {
+    furi_assert(store);
+    furi_assert(key);
+    furi_assert(data);
+    furi_assert(size);
+
+    uint8_t* value = malloc(sizeof(SavedStructHeader) + size);
+    SavedStructHeader* header = (SavedStructHeader*)value;
+    bool result = kv_store_get(store, key, value, sizeof(SavedStructHeader) + size);
+
+    if(result) {
+        if(header->magic != magic || header->version != version) {
+            FURI_LOG_E(TAG, "Magic or Version mismatch of \"%s\"", key);
+            result = false;
+        } else if(
+            header->checksum != saved_struct_checksum(value + sizeof(SavedStructHeader), size)) {
+            FURI_LOG_E(TAG, "Checksum mismatch of \"%s\"", key);
+            result = false;
+        } else {
+            memcpy(data, value + sizeof(SavedStructHeader), size);
+        }
+    } else if(legacy_path && saved_struct_load(legacy_path, data, size, magic, version)) {
+        FURI_LOG_I(TAG, "Moving \"%s\" to store", legacy_path);
+        result = saved_struct_store_save(store, key, data, size, magic, version);
+        if(result && kv_store_flush(store)) {
+            Storage* storage = furi_record_open("storage");
+            storage_simply_remove(storage, legacy_path);
+            furi_record_close("storage");
+        }
+    }
+
+    free(value);
+    return result;
+}
@@ -3,7 +3,31 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include "kv_store.h"
 
 bool saved_struct_load(const char* path, void* data, size_t size, uint8_t magic, uint8_t version);
 
 bool saved_struct_save(const char* path, void* data, size_t size, uint8_t magic, uint8_t version);
+
+/** Save struct to key-value store
+ * Value has the same header as file saved by saved_struct_save
+ */
+bool saved_struct_store_save(
+    KvStore* store,
+    const char* key,
+    void* data,
+    size_t size,
+    uint8_t magic,
+    uint8_t version);
+
+/** Load struct from key-value store
+ * If key is not found, struct is loaded from legacy_path file and moved to store
+ */
+bool saved_struct_store_load(
+    KvStore* store,
+    const char* key,
+    const char* legacy_path,
+    void* data,
+    size_t size,
+    uint8_t magic,
+    uint8_t version);
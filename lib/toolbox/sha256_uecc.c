@@ -0,0 +1,28 @@
+#include "sha256_uecc.h"
+
+static void _sha256_uecc_init(const uECC_HashContext* ctx) {
+    sha256_uecc_context* context = (sha256_uecc_context*)ctx;
+    sha256_start(&context->sha_ctx);
+}
+
+static void _sha256_uecc_update(
+    const uECC_HashContext* ctx,
+    const uint8_t* message,
+    unsigned message_size) {
+    sha256_uecc_context* context = (sha256_uecc_context*)ctx;
+    sha256_update(&context->sha_ctx, message, message_size);
+}
+
+static void _sha256_uecc_finish(const uECC_HashContext* ctx, uint8_t* hash_result) {
+    sha256_uecc_context* context = (sha256_uecc_context*)ctx;
+    sha256_finish(&context->sha_ctx, hash_result);
+}
+
+void sha256_uecc_init(sha256_uecc_context* ctx) {
+    ctx->uECC.init_hash = _sha256_uecc_init;
+    ctx->uECC.update_hash = _sha256_uecc_update;
+    ctx->uECC.finish_hash = _sha256_uecc_finish;
+    ctx->uECC.block_size = 64;
+    ctx->uECC.result_size = 32;
+    ctx->uECC.tmp = ctx->tmp;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <stdint.h>
+#include "sha256.h"
+#include <uECC.h>
+
+/* SHA-256 hash context for uECC_sign_deterministic() */
+typedef struct sha256_uecc_context {
+    uECC_HashContext uECC;
+    sha256_context sha_ctx;
+    uint8_t tmp[32 * 2 + 64];
+} sha256_uecc_context;
+
+void sha256_uecc_init(sha256_uecc_context* ctx);
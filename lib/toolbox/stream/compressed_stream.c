@@ -0,0 +1,543 @@
+#include "stream.h"
+#include "stream_i.h"
+#include "compressed_stream.h"
+#include <furi.h>
+#include <lib/heatshrink/heatshrink_encoder.h>
+#include <lib/heatshrink/heatshrink_decoder.h>
+
+#define TAG "CompressedStream"
+
+#define COMPRESSED_STREAM_MAGIC 0x53435348
+#define COMPRESSED_STREAM_VERSION 1
+#define COMPRESSED_STREAM_BLOCK_SIZE 1024
+// Worst case for heatshrink is 9 bits per byte
+#define COMPRESSED_STREAM_DATA_SIZE_MAX \
+    (COMPRESSED_STREAM_BLOCK_SIZE + COMPRESSED_STREAM_BLOCK_SIZE / 8 + 1)
+
+typedef struct {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t window_bits;
+    uint8_t lookahead_bits;
+    uint8_t reserved;
+} __attribute__((packed)) CompressedStreamHeader;
+
+/* Every block is compressed separately, so blocks can be skipped on seek.
+ * Block which doesn't compress is stored as is, then data_size == raw_size. */
+typedef struct {
+    uint16_t raw_size;
+    uint16_t data_size;
+} __attribute__((packed)) CompressedStreamBlockHeader;
+
+typedef enum {
+    CompressedStreamHeaderUnknown,
+    CompressedStreamHeaderEmpty,
+    CompressedStreamHeaderValid,
+    CompressedStreamHeaderInvalid,
+} CompressedStreamHeaderState;
+
+typedef enum {
+    CompressedStreamBlockUnknown, /**< block header is not read yet */
+    CompressedStreamBlockFound, /**< block header is read, data is not loaded */
+    CompressedStreamBlockLoaded, /**< block data is in raw buffer */
+    CompressedStreamBlockTail, /**< block is being written, not in underlying stream yet */
+    CompressedStreamBlockEnd, /**< no more blocks */
+} CompressedStreamBlockState;
+
+typedef struct {
+    Stream stream_base;
+    Stream* stream;
+
+    CompressedStreamHeader header;
+    CompressedStreamHeaderState header_state;
+    heatshrink_encoder* encoder;
+    heatshrink_decoder* decoder;
+    uint8_t* codec_buffer;
+
+    CompressedStreamBlockState block_state;
+    CompressedStreamBlockHeader block;
+    size_t block_offset;
+    size_t block_position;
+    uint16_t index;
+
+    bool size_known;
+    size_t size;
+
+    uint8_t raw[COMPRESSED_STREAM_BLOCK_SIZE];
+    uint8_t data[COMPRESSED_STREAM_DATA_SIZE_MAX];
+} CompressedStream;
+
+static void compressed_stream_free(CompressedStream* stream);
+static bool compressed_stream_eof(CompressedStream* stream);
+static void compressed_stream_clean(CompressedStream* stream);
+static bool
+    compressed_stream_seek(CompressedStream* stream, int32_t offset, StreamOffset offset_type);
+static size_t compressed_stream_tell(CompressedStream* stream);
+static size_t compressed_stream_size(CompressedStream* stream);
+static size_t compressed_stream_write(CompressedStream* stream, const uint8_t* data, size_t size);
+static size_t compressed_stream_read(CompressedStream* stream, uint8_t* data, size_t size);
+static bool compressed_stream_delete_and_insert(
+    CompressedStream* stream,
+    size_t delete_size,
+    StreamWriteCB write_callback,
+    const void* ctx);
+
+const StreamVTable compressed_stream_vtable = {
+    .free = (StreamFreeFn)compressed_stream_free,
+    .eof = (StreamEOFFn)compressed_stream_eof,
+    .clean = (StreamCleanFn)compressed_stream_clean,
+    .seek = (StreamSeekFn)compressed_stream_seek,
+    .tell = (StreamTellFn)compressed_stream_tell,
+    .size = (StreamSizeFn)compressed_stream_size,
+    .write = (StreamWriteFn)compressed_stream_write,
+    .read = (StreamReadFn)compressed_stream_read,
+    .delete_and_insert = (StreamDeleteAndInsertFn)compressed_stream_delete_and_insert,
+};
+
+static bool compressed_stream_params_valid(uint8_t window_bits, uint8_t lookahead_bits) {
+    return (window_bits >= HEATSHRINK_MIN_WINDOW_BITS) &&
+           (window_bits <= HEATSHRINK_MAX_WINDOW_BITS) &&
+           (lookahead_bits >= HEATSHRINK_MIN_LOOKAHEAD_BITS) && (lookahead_bits < window_bits);
+}
+
+Stream* compressed_stream_alloc(Stream* base, uint8_t window_bits, uint8_t lookahead_bits) {
+    furi_assert(base);
+    furi_check(compressed_stream_params_valid(window_bits, lookahead_bits));
+
+    CompressedStream* stream = malloc(sizeof(CompressedStream));
+    stream->stream = base;
+    stream->header.magic = COMPRESSED_STREAM_MAGIC;
+    stream->header.version = COMPRESSED_STREAM_VERSION;
+    stream->header.window_bits = window_bits;
+    stream->header.lookahead_bits = lookahead_bits;
+    stream->header.reserved = 0;
+    stream->header_state = CompressedStreamHeaderUnknown;
+    stream->encoder = NULL;
+    stream->decoder = NULL;
+    stream->codec_buffer = NULL;
+    stream->block_state = CompressedStreamBlockUnknown;
+    stream->block_offset = sizeof(CompressedStreamHeader);
+    stream->block_position = 0;
+    stream->index = 0;
+    stream->size_known = false;
+    stream->size = 0;
+
+    stream->stream_base.vtable = &compressed_stream_vtable;
+    return (Stream*)stream;
+}
+
+static void compressed_stream_block_reset(CompressedStream* stream) {
+    stream->block_state = CompressedStreamBlockUnknown;
+    stream->block_offset = sizeof(CompressedStreamHeader);
+    stream->block_position = 0;
+    stream->index = 0;
+}
+
+static bool compressed_stream_prepare(CompressedStream* stream) {
+    if(stream->header_state != CompressedStreamHeaderUnknown) {
+        return stream->header_state != CompressedStreamHeaderInvalid;
+    }
+
+    CompressedStreamHeader header;
+    stream_rewind(stream->stream);
+    size_t header_size = stream_read(stream->stream, (uint8_t*)&header, sizeof(header));
+
+    compressed_stream_block_reset(stream);
+    if(header_size == 0 && stream_size(stream->stream) == 0) {
+        stream->header_state = CompressedStreamHeaderEmpty;
+        stream->block_state = CompressedStreamBlockEnd;
+        stream->size_known = true;
+        stream->size = 0;
+    } else if(
+        header_size == sizeof(header) && header.magic == COMPRESSED_STREAM_MAGIC &&
+        header.version == COMPRESSED_STREAM_VERSION &&
+        compressed_stream_params_valid(header.window_bits, header.lookahead_bits)) {
+        stream->header = header;
+        stream->header_state = CompressedStreamHeaderValid;
+        stream->size_known = false;
+    } else {
+        FURI_LOG_E(TAG, "Invalid header");
+        stream->header_state = CompressedStreamHeaderInvalid;
+        return false;
+    }
+
+    if(stream->codec_buffer) return true;
+
+    // Encoder and decoder are never used at the same time and share the buffer
+    const uint8_t window_bits = stream->header.window_bits;
+    const uint8_t lookahead_bits = stream->header.lookahead_bits;
+    stream->codec_buffer = malloc(2 << window_bits);
+    stream->encoder = heatshrink_encoder_alloc(stream->codec_buffer, window_bits, lookahead_bits);
+    stream->decoder = heatshrink_decoder_alloc(
+        stream->codec_buffer, 1 << window_bits, window_bits, lookahead_bits);
+    furi_check(stream->encoder && stream->decoder);
+
+    return true;
+}
+
+static bool compressed_stream_block_read_header_at(
+    CompressedStream* stream,
+    size_t offset,
+    CompressedStreamBlockHeader* block) {
+    if(!stream_seek(stream->stream, offset, StreamOffsetFromStart)) return false;
+    if(stream_read(stream->stream, (uint8_t*)block, sizeof(CompressedStreamBlockHeader)) !=
+       sizeof(CompressedStreamBlockHeader)) {
+        return false;
+    }
+    // Incomplete or damaged block ends the stream
+    return (block->raw_size > 0) && (block->raw_size <= COMPRESSED_STREAM_BLOCK_SIZE) &&
+           (block->data_size > 0) && (block->data_size <= COMPRESSED_STREAM_DATA_SIZE_MAX);
+}
+
+static void compressed_stream_block_read_header(CompressedStream* stream) {
+    furi_assert(stream->block_state == CompressedStreamBlockUnknown);
+    if(compressed_stream_block_read_header_at(stream, stream->block_offset, &stream->block)) {
+        stream->block_state = CompressedStreamBlockFound;
+    } else {
+        stream->block_state = CompressedStreamBlockEnd;
+    }
+}
+
+static void compressed_stream_block_next(CompressedStream* stream) {
+    stream->block_offset += sizeof(CompressedStreamBlockHeader) + stream->block.data_size;
+    stream->block_position += stream->block.raw_size;
+    stream->block_state = CompressedStreamBlockUnknown;
+    stream->index = 0;
+}
+
+/* Reset doesn't clear the window, but both sides must start from zeroed window */
+static void compressed_stream_codec_buffer_reset(CompressedStream* stream) {
+    memset(stream->codec_buffer, 0, 2 << stream->header.window_bits);
+}
+
+static bool compressed_stream_decode(CompressedStream* stream) {
+    heatshrink_decoder* decoder = stream->decoder;
+    heatshrink_decoder_reset(decoder);
+    compressed_stream_codec_buffer_reset(stream);
+
+    size_t sunk = 0;
+    size_t decoded = 0;
+    while((sunk < stream->block.data_size) && (decoded < stream->block.raw_size)) {
+        size_t sink_size = 0;
+        if(heatshrink_decoder_sink(
+               decoder, &stream->data[sunk], stream->block.data_size - sunk, &sink_size) < 0) {
+            return false;
+        }
+        sunk += sink_size;
+
+        HSD_poll_res poll_res;
+        do {
+            size_t poll_size = 0;
+            poll_res = heatshrink_decoder_poll(
+                decoder, &stream->raw[decoded], stream->block.raw_size - decoded, &poll_size);
+            if(poll_res < 0) return false;
+            decoded += poll_size;
+        } while((poll_res == HSDR_POLL_MORE) && (decoded < stream->block.raw_size));
+    }
+
+    return decoded == stream->block.raw_size;
+}
+
+static uint16_t compressed_stream_encode_poll(CompressedStream* stream, uint16_t encoded) {
+    HSE_poll_res poll_res;
+    do {
+        if(encoded >= COMPRESSED_STREAM_DATA_SIZE_MAX) return UINT16_MAX;
+        size_t poll_size = 0;
+        poll_res = heatshrink_encoder_poll(
+            stream->encoder,
+            &stream->data[encoded],
+            COMPRESSED_STREAM_DATA_SIZE_MAX - encoded,
+            &poll_size);
+        if(poll_res < 0) return UINT16_MAX;
+        encoded += poll_size;
+    } while(poll_res == HSER_POLL_MORE);
+
+    return encoded;
+}
+
+/* Returns compressed size or UINT16_MAX if block must be stored uncompressed */
+static uint16_t compressed_stream_encode(CompressedStream* stream) {
+    heatshrink_encoder* encoder = stream->encoder;
+    heatshrink_encoder_reset(encoder);
+    compressed_stream_codec_buffer_reset(stream);
+
+    size_t sunk = 0;
+    uint16_t encoded = 0;
+    while(sunk < stream->block.raw_size) {
+        size_t sink_size = 0;
+        if(heatshrink_encoder_sink(
+               encoder, &stream->raw[sunk], stream->block.raw_size - sunk, &sink_size) !=
+           HSER_SINK_OK) {
+            return UINT16_MAX;
+        }
+        sunk += sink_size;
+        encoded = compressed_stream_encode_poll(stream, encoded);
+        if(encoded == UINT16_MAX) return UINT16_MAX;
+    }
+
+    while(heatshrink_encoder_finish(encoder) == HSER_FINISH_MORE) {
+        encoded = compressed_stream_encode_poll(stream, encoded);
+        if(encoded == UINT16_MAX) return UINT16_MAX;
+    }
+
+    return encoded;
+}
+
+static bool compressed_stream_block_load(CompressedStream* stream) {
+    furi_assert(stream->block_state == CompressedStreamBlockFound);
+
+    bool loaded = false;
+    do {
+        size_t data_offset = stream->block_offset + sizeof(CompressedStreamBlockHeader);
+        if(!stream_seek(stream->stream, data_offset, StreamOffsetFromStart)) break;
+        if(stream_read(stream->stream, stream->data, stream->block.data_size) !=
+           stream->block.data_size) {
+            break;
+        }
+
+        if(stream->block.data_size == stream->block.raw_size) {
+            memcpy(stream->raw, stream->data, stream->block.raw_size);
+        } else if(!compressed_stream_decode(stream)) {
+            break;
+        }
+        loaded = true;
+    } while(false);
+
+    if(loaded) {
+        stream->block_state = CompressedStreamBlockLoaded;
+    } else {
+        FURI_LOG_E(TAG, "Damaged block at %u", stream->block_offset);
+        stream->block_state = CompressedStreamBlockEnd;
+    }
+
+    return loaded;
+}
+
+static bool compressed_stream_write_tail(CompressedStream* stream) {
+    if(stream->block_state != CompressedStreamBlockTail) return true;
+    if(stream->block.raw_size == 0) {
+        stream->block_state = CompressedStreamBlockEnd;
+        return true;
+    }
+
+    if(stream->header_state == CompressedStreamHeaderEmpty) {
+        stream_rewind(stream->stream);
+        size_t header_size = sizeof(CompressedStreamHeader);
+        if(stream_write(stream->stream, (uint8_t*)&stream->header, header_size) != header_size) {
+            return false;
+        }
+        stream->header_state = CompressedStreamHeaderValid;
+    }
+
+    const uint8_t* data = stream->data;
+    uint16_t data_size = compressed_stream_encode(stream);
+    if(data_size >= stream->block.raw_size) {
+        data = stream->raw;
+        data_size = stream->block.raw_size;
+    }
+    stream->block.data_size = data_size;
+
+    if(!stream_seek(stream->stream, stream->block_offset, StreamOffsetFromStart)) return false;
+    if(stream_write(
+           stream->stream, (uint8_t*)&stream->block, sizeof(CompressedStreamBlockHeader)) !=
+       sizeof(CompressedStreamBlockHeader)) {
+        return false;
+    }
+    if(stream_write(stream->stream, data, data_size) != data_size) return false;
+
+    stream->block_state = CompressedStreamBlockLoaded;
+    return true;
+}
+
+bool compressed_stream_flush(Stream* _stream) {
+    furi_assert(_stream);
+    CompressedStream* stream = (CompressedStream*)_stream;
+    furi_check(stream->stream_base.vtable == &compressed_stream_vtable);
+    return compressed_stream_write_tail(stream);
+}
+
+static void compressed_stream_free(CompressedStream* stream) {
+    if(!compressed_stream_write_tail(stream)) {
+        FURI_LOG_E(TAG, "Failed to write pending data");
+    }
+    if(stream->codec_buffer) {
+        heatshrink_encoder_free(stream->encoder);
+        heatshrink_decoder_free(stream->decoder);
+        free(stream->codec_buffer);
+    }
+    free(stream);
+}
+
+static bool compressed_stream_eof(CompressedStream* stream) {
+    return compressed_stream_tell(stream) >= compressed_stream_size(stream);
+}
+
+static void compressed_stream_clean(CompressedStream* stream) {
+    // Pending data is dropped, header is written again with the first block
+    stream_clean(stream->stream);
+    stream->header_state = CompressedStreamHeaderUnknown;
+    compressed_stream_prepare(stream);
+}
+
+/* Move rw pointer, returns false if position is past the end */
+static bool compressed_stream_move(CompressedStream* stream, size_t position) {
+    if(position == compressed_stream_tell(stream)) return true;
+    if(!compressed_stream_write_tail(stream)) return false;
+
+    if(position < stream->block_position) {
+        compressed_stream_block_reset(stream);
+    }
+
+    while(true) {
+        if(stream->block_state == CompressedStreamBlockUnknown) {
+            compressed_stream_block_read_header(stream);
+        }
+        if(stream->block_state == CompressedStreamBlockEnd) {
+            stream->index = 0;
+            return position == stream->block_position;
+        }
+        if(position < stream->block_position + stream->block.raw_size) {
+            // Block data is loaded on read
+            stream->index = position - stream->block_position;
+            return true;
+        }
+        compressed_stream_block_next(stream);
+    }
+}
+
+static bool
+    compressed_stream_seek(CompressedStream* stream, int32_t offset, StreamOffset offset_type) {
+    if(!compressed_stream_prepare(stream)) return false;
+
+    int32_t position = 0;
+    switch(offset_type) {
+    case StreamOffsetFromCurrent:
+        position = compressed_stream_tell(stream) + offset;
+        break;
+    case StreamOffsetFromStart:
+        position = offset;
+        break;
+    case StreamOffsetFromEnd:
+        position = compressed_stream_size(stream) + offset;
+        break;
+    }
+
+    if(position < 0) {
+        compressed_stream_move(stream, 0);
+        return false;
+    }
+
+    return compressed_stream_move(stream, position);
+}
+
+static size_t compressed_stream_tell(CompressedStream* stream) {
+    return stream->block_position + stream->index;
+}
+
+static size_t compressed_stream_size(CompressedStream* stream) {
+    if(!compressed_stream_prepare(stream)) return 0;
+
+    if(stream->block_state == CompressedStreamBlockTail) {
+        return stream->block_position + stream->block.raw_size;
+    }
+
+    if(!stream->size_known) {
+        // Walk block headers from current block
+        size_t offset = stream->block_offset;
+        size_t position = stream->block_position;
+        CompressedStreamBlockHeader block;
+        while(compressed_stream_block_read_header_at(stream, offset, &block)) {
+            offset += sizeof(CompressedStreamBlockHeader) + block.data_size;
+            position += block.raw_size;
+        }
+        stream->size = position;
+        stream->size_known = true;
+    }
+
+    return stream->size;
+}
+
+static size_t compressed_stream_write(CompressedStream* stream, const uint8_t* data, size_t size) {
+    if(!compressed_stream_prepare(stream)) return 0;
+
+    // Writes are allowed only at the end of the stream
+    if(stream->block_state != CompressedStreamBlockTail) {
+        while(true) {
+            if(stream->block_state == CompressedStreamBlockUnknown) {
+                compressed_stream_block_read_header(stream);
+            }
+            if(stream->block_state == CompressedStreamBlockEnd) break;
+            if(stream->index < stream->block.raw_size) return 0;
+            compressed_stream_block_next(stream);
+        }
+        stream->block_state = CompressedStreamBlockTail;
+        stream->block.raw_size = 0;
+        stream->block.data_size = 0;
+        stream->index = 0;
+    }
+
+    size_t written = 0;
+    while(written < size) {
+        size_t chunk = MIN(size - written, COMPRESSED_STREAM_BLOCK_SIZE - stream->block.raw_size);
+        memcpy(&stream->raw[stream->block.raw_size], &data[written], chunk);
+        stream->block.raw_size += chunk;
+        stream->index = stream->block.raw_size;
+
+        if(stream->block.raw_size == COMPRESSED_STREAM_BLOCK_SIZE) {
+            if(!compressed_stream_write_tail(stream)) break;
+            compressed_stream_block_next(stream);
+            stream->block_state = CompressedStreamBlockTail;
+            stream->block.raw_size = 0;
+            stream->block.data_size = 0;
+        }
+        written += chunk;
+    }
+
+    stream->size = compressed_stream_tell(stream);
+    stream->size_known = true;
+
+    return written;
+}
+
+static size_t compressed_stream_read(CompressedStream* stream, uint8_t* data, size_t size) {
+    if(!compressed_stream_prepare(stream)) return 0;
+
+    size_t read = 0;
+    while(read < size) {
+        if(stream->block_state == CompressedStreamBlockUnknown) {
+            compressed_stream_block_read_header(stream);
+        }
+        if(stream->block_state == CompressedStreamBlockEnd) break;
+        if(stream->index >= stream->block.raw_size) {
+            if(stream->block_state == CompressedStreamBlockTail) break;
+            compressed_stream_block_next(stream);
+            continue;
+        }
+        if(stream->block_state == CompressedStreamBlockFound) {
+            if(!compressed_stream_block_load(stream)) break;
+        }
+
+        size_t chunk = MIN(size - read, (size_t)(stream->block.raw_size - stream->index));
+        memcpy(&data[read], &stream->raw[stream->index], chunk);
+        stream->index += chunk;
+        read += chunk;
+    }
+
+    return read;
+}
+
+static bool compressed_stream_delete_and_insert(
+    CompressedStream* stream,
+    size_t delete_size,
+    StreamWriteCB write_callback,
+    const void* ctx) {
+    UNUSED(delete_size);
+    // Only appending is supported, there is nothing to delete at the end
+    if(compressed_stream_tell(stream) != compressed_stream_size(stream)) return false;
+
+    bool result = true;
+    if(write_callback) {
+        result = write_callback((Stream*)stream, ctx);
+    }
+    return result;
+}
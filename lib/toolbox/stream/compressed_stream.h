@@ -0,0 +1,32 @@
+#pragma once
+#include <stdlib.h>
+#include "stream.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Allocate compressed stream.
+ * Data is compressed with heatshrink on write and decompressed on read,
+ * underlying stream keeps header with compression parameters and compressed blocks.
+ * Writes are allowed only at the end of the stream, reads and seeks are allowed anywhere.
+ * Compression parameters of existing data are taken from the header.
+ * @param stream underlying stream, must be freed after compressed stream
+ * @param window_bits heatshrink window size, log2
+ * @param lookahead_bits heatshrink lookahead size, log2
+ * @return Stream*
+ */
+Stream* compressed_stream_alloc(Stream* stream, uint8_t window_bits, uint8_t lookahead_bits);
+
+/**
+ * Write pending data to underlying stream.
+ * Pending data is also written on seek and free.
+ * @param stream compressed stream
+ * @return success flag
+ */
+bool compressed_stream_flush(Stream* stream);
+
+#ifdef __cplusplus
+}
+#endif
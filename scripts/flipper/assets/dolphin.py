@@ -3,6 +3,7 @@ import logging
 import os
 import sys
 import shutil
+import struct
 from collections import Counter
 
 from flipper.utils.fff import *
@@ -10,12 +11,6 @@ from flipper.utils.templite import *
 from .icon import *
 
 
-def _convert_image_to_bm(pair: set):
-    source_filename, destination_filename = pair
-    image = file2image(source_filename)
-    image.write(destination_filename)
-
-
 def _convert_image(source_filename: str):
     image = file2image(source_filename)
     return image.data
@@ -26,6 +21,11 @@ class DolphinBubbleAnimation:
     FILE_TYPE = "Flipper Animation"
     FILE_VERSION = 1
 
+    BUNDLE_FILENAME = "animation.bundle"
+    BUNDLE_MAGIC = 0x424E4146  # FANB
+    BUNDLE_VERSION = 1
+    BUNDLE_ALIGN = {"Left": 0, "Right": 1, "Top": 2, "Bottom": 3, "Center": 4}
+
     def __init__(
         self,
         name: str,
@@ -221,14 +221,63 @@ class DolphinBubbleAnimation:
 
         file.save(meta_filename)
 
-        to_pack = []
-        for index, frame in enumerate(self.frames):
-            to_pack.append(
-                (frame, os.path.join(animation_directory, f"frame_{index}.bm"))
+        pool = multiprocessing.Pool()
+        frames = pool.map(_convert_image, self.frames)
+        for index, frame in enumerate(frames):
+            frame_filename = os.path.join(animation_directory, f"frame_{index}.bm")
+            with open(frame_filename, "wb") as frame_file:
+                frame_file.write(frame)
+
+        self.saveBundle(os.path.join(animation_directory, self.BUNDLE_FILENAME), frames)
+
+    def saveBundle(self, bundle_filename: str, frames: list):
+        # Layout: header, frames order, frame offsets, bubbles, frames
+        frames_order = bytes(self.meta["Frames order"])
+
+        frame_offsets = b""
+        frames_data = b""
+        for frame in frames:
+            frame_offsets += struct.pack("<I", len(frames_data))
+            frames_data += frame
+
+        bubbles = b""
+        for bubble in self.bubbles:
+            text = bubble["Text"].replace("\\n", "\n").encode()
+            bubbles += struct.pack(
+                "<8B",
+                bubble["Slot"],
+                bubble["X"],
+                bubble["Y"],
+                self.BUNDLE_ALIGN[bubble["AlignH"]],
+                self.BUNDLE_ALIGN[bubble["AlignV"]],
+                bubble["StartFrame"],
+                bubble["EndFrame"],
+                len(text),
             )
+            bubbles += text
+
+        meta = frames_order + frame_offsets + bubbles
+        header = struct.pack(
+            "<I8BHH2BHI",
+            self.BUNDLE_MAGIC,
+            self.BUNDLE_VERSION,
+            self.meta["Width"],
+            self.meta["Height"],
+            self.meta["Passive frames"],
+            self.meta["Active frames"],
+            self.meta["Active cycles"],
+            self.meta["Frame rate"],
+            len(frames),
+            self.meta["Duration"],
+            self.meta["Active cooldown"],
+            self.bubble_slots,
+            len(self.bubbles),
+            len(meta),
+            len(frames_data),
+        )
 
-        pool = multiprocessing.Pool()
-        pool.map(_convert_image_to_bm, to_pack)
+        with open(bundle_filename, "wb") as file:
+            file.write(header + meta + frames_data)
 
     def process(self):
         pool = multiprocessing.Pool()